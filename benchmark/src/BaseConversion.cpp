@@ -0,0 +1,192 @@
+/*
+ * @author TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+  This code benchmarks the fast base conversion of RNS polynomials, i.e., the
+  modular matrix products of math/modgemm.h, for a range of sizeQ (input
+  towers) and sizeP (output towers).
+ */
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include "palisade.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "math/modgemm.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+#if defined(HAVE_INT128) && NATIVEINT == 64
+
+static const usint BASE_CONV_RING_DIM = 1 << 14;
+
+static void BaseConvArguments(benchmark::internal::Benchmark *b) {
+  for (int sizeQ : {2, 4, 8, 16, 32}) {
+    for (int sizeP : {1, 4, 8}) {
+      b->Args({sizeQ, sizeP});
+    }
+  }
+}
+
+// sizeQ + sizeP distinct NTT-friendly primes of 55 bits
+static vector<NativeInteger> BaseConvModuli(usint count) {
+  vector<NativeInteger> moduli(count);
+  moduli[0] = FirstPrime<NativeInteger>(55, 2 * BASE_CONV_RING_DIM);
+  for (usint i = 1; i < count; i++) {
+    moduli[i] = NextPrime<NativeInteger>(moduli[i - 1], 2 * BASE_CONV_RING_DIM);
+  }
+  return moduli;
+}
+
+// the constant 2^128 / modulus of BarrettUint128ModUint64()
+static DoubleNativeInt BarrettMu(const NativeInteger &modulus) {
+  const BigInteger barrettBase128Bit("340282366920938463463374607431768211456");
+  const BigInteger twoPower64("18446744073709551616");
+  BigInteger mu = barrettBase128Bit / BigInteger(modulus);
+  uint64_t val[2];
+  val[0] = (mu % twoPower64).ConvertToInt();
+  val[1] = mu.RShift(64).ConvertToInt();
+  DoubleNativeInt result;
+  memcpy(&result, val, sizeof(DoubleNativeInt));
+  return result;
+}
+
+static void BM_ModGemm(benchmark::State &state, ModGemmKernel kernel) {
+  usint sizeQ = state.range(0);
+  usint sizeP = state.range(1);
+  usint n = BASE_CONV_RING_DIM;
+  vector<NativeInteger> moduli = BaseConvModuli(sizeQ + sizeP);
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  vector<NativeVector> in;
+  vector<const uint64_t *> inPtrs;
+  vector<uint64_t> inModuli, scale, scalePrecon, weights;
+  for (usint i = 0; i < sizeQ; i++) {
+    dug.SetModulus(moduli[i]);
+    in.push_back(dug.GenerateVector(n));
+    NativeInteger s = dug.GenerateInteger();
+    inModuli.push_back(moduli[i].ConvertToInt());
+    scale.push_back(s.ConvertToInt());
+    scalePrecon.push_back(s.PrepModMulConst(moduli[i]).ConvertToInt());
+    for (usint j = 0; j < sizeP; j++) {
+      dug.SetModulus(moduli[sizeQ + j]);
+      weights.push_back(dug.GenerateInteger().ConvertToInt());
+    }
+  }
+  for (usint i = 0; i < sizeQ; i++) {
+    inPtrs.push_back(reinterpret_cast<const uint64_t *>(&in[i][0]));
+  }
+
+  vector<vector<uint64_t>> out(sizeP, vector<uint64_t>(n));
+  vector<uint64_t *> outPtrs;
+  vector<uint64_t> outModuli;
+  vector<DoubleNativeInt> outBarrettMu;
+  for (usint j = 0; j < sizeP; j++) {
+    outPtrs.push_back(out[j].data());
+    outModuli.push_back(moduli[sizeQ + j].ConvertToInt());
+    outBarrettMu.push_back(BarrettMu(moduli[sizeQ + j]));
+  }
+
+  ModGemmArgs args;
+  args.length = n;
+  args.numIn = sizeQ;
+  args.numOut = sizeP;
+  args.in = inPtrs.data();
+  args.inModuli = inModuli.data();
+  args.scale = scale.data();
+  args.scalePrecon = scalePrecon.data();
+  args.weights = weights.data();
+  args.out = outPtrs.data();
+  args.outModuli = outModuli.data();
+  args.outBarrettMu = outBarrettMu.data();
+
+  while (state.KeepRunning()) {
+    kernel(args);
+  }
+  state.SetItemsProcessed(state.iterations() * int64_t(n) * sizeQ * sizeP);
+}
+
+BENCHMARK_CAPTURE(BM_ModGemm, tiled, &ModGemm::TiledKernel)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgNames({"sizeQ", "sizeP"})
+    ->Apply(BaseConvArguments);
+BENCHMARK_CAPTURE(BM_ModGemm, reference, &ModGemm::ReferenceKernel)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgNames({"sizeQ", "sizeP"})
+    ->Apply(BaseConvArguments);
+
+// the complete conversion of a DCRTPoly, with the current kernel
+static void BM_ApproxSwitchCRTBasis(benchmark::State &state) {
+  usint sizeQ = state.range(0);
+  usint sizeP = state.range(1);
+  usint n = BASE_CONV_RING_DIM;
+  vector<NativeInteger> moduli = BaseConvModuli(sizeQ + sizeP);
+  vector<NativeInteger> moduliQ(moduli.begin(), moduli.begin() + sizeQ);
+  vector<NativeInteger> moduliP(moduli.begin() + sizeQ, moduli.end());
+  vector<NativeInteger> rootsQ, rootsP;
+  for (auto &q : moduliQ) rootsQ.push_back(RootOfUnity(2 * n, q));
+  for (auto &p : moduliP) rootsP.push_back(RootOfUnity(2 * n, p));
+  auto paramsQ = std::make_shared<ILDCRTParams<BigInteger>>(2 * n, moduliQ,
+                                                            rootsQ);
+  auto paramsP = std::make_shared<ILDCRTParams<BigInteger>>(2 * n, moduliP,
+                                                            rootsP);
+
+  BigInteger Q(1);
+  for (auto &q : moduliQ) Q *= BigInteger(q);
+  vector<NativeInteger> QHatInvModq(sizeQ), QHatInvModqPrecon(sizeQ);
+  vector<vector<NativeInteger>> QHatModp(sizeQ, vector<NativeInteger>(sizeP));
+  for (usint i = 0; i < sizeQ; i++) {
+    BigInteger QHati = Q / BigInteger(moduliQ[i]);
+    QHatInvModq[i] = QHati.ModInverse(moduliQ[i]).ConvertToInt();
+    QHatInvModqPrecon[i] = QHatInvModq[i].PrepModMulConst(moduliQ[i]);
+    for (usint j = 0; j < sizeP; j++) {
+      QHatModp[i][j] = QHati.Mod(moduliP[j]).ConvertToInt();
+    }
+  }
+  vector<DoubleNativeInt> modpBarrettMu;
+  for (auto &p : moduliP) modpBarrettMu.push_back(BarrettMu(p));
+
+  DCRTPoly::DugType dug;
+  DCRTPoly x(dug, paramsQ, COEFFICIENT);
+
+  while (state.KeepRunning()) {
+    DCRTPoly y =
+        x.ApproxSwitchCRTBasis(paramsQ, paramsP, QHatInvModq,
+                               QHatInvModqPrecon, QHatModp, modpBarrettMu);
+  }
+}
+
+BENCHMARK(BM_ApproxSwitchCRTBasis)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgNames({"sizeQ", "sizeP"})
+    ->Apply(BaseConvArguments);
+
+#endif
+
+// execute the benchmarks
+BENCHMARK_MAIN();
@@ -35,6 +35,8 @@
 
 #include "vechelper.h"
 
+#include "utils/cpufeatures.h"
+
 #include "lattice/dcrtpoly.cpp"
 #include "lattice/elemparamfactory.h"
 #include "lattice/elemparams.cpp"
@@ -193,5 +195,199 @@ DO_VECTOR_BENCHMARK_TEMPLATE(BM_BigVec_Multeq, M4Vector)
 DO_VECTOR_BENCHMARK_TEMPLATE(BM_BigVec_Multeq, M6Vector)
 #endif
 
+// element-wise NativeVector kernels with each SIMD engine
+
+static void NativeEngineArguments(benchmark::internal::Benchmark *b) {
+  for (int64_t p : {1024, 8192, 32768}) {
+    b->ArgNames({"parm", "engine"})
+        ->Args({p, SIMD_PORTABLE})
+        ->Args({p, SIMD_AVX2})
+        ->Args({p, SIMD_AVX512})
+        ->Args({p, SIMD_AVX512IFMA});
+  }
+}
+
+// selects the engine and makes two random vectors modulo a 50-bit prime;
+// returns false if the engine is not supported
+static bool SetupNativeVecKernel(benchmark::State &state, NativeVector *a,
+                                 NativeVector *b) {
+  SIMDEngine engine = static_cast<SIMDEngine>(state.range(1));
+  if (!SIMDControls::IsSupported(engine)) {
+    state.SkipWithError("SIMD engine not supported");
+    return false;
+  }
+  SIMDControls::SetEngine(engine);
+  auto p = state.range(0);
+  NativeInteger q = FirstPrime<NativeInteger>(50, 2 * p);
+  *a = makeVector<NativeVector>(p, q);
+  *b = makeVector<NativeVector>(p, q);
+  return true;
+}
+
+static void BM_NativeVec_ModSub(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  while (state.KeepRunning()) {
+    NativeVector c = a.ModSub(b);
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_ModSub)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+static void BM_NativeVec_ModMul(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  while (state.KeepRunning()) {
+    NativeVector c = a.ModMul(b);
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_ModMul)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+static void BM_NativeVec_ModAddScalar(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  while (state.KeepRunning()) {
+    NativeVector c = a.ModAdd(b[0]);
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_ModAddScalar)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+static void BM_NativeVec_ModSubScalar(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  while (state.KeepRunning()) {
+    NativeVector c = a.ModSub(b[0]);
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_ModSubScalar)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+static void BM_NativeVec_ModMulConst(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  while (state.KeepRunning()) {
+    NativeVector c = a.ModMul(b[0]);
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_ModMulConst)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+static void BM_NativeVec_ModNegate(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  while (state.KeepRunning()) {
+    NativeVector c = a.ModNegate();
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_ModNegate)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+static void BM_NativeVec_SwitchModulus(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  NativeInteger smaller = a.GetModulus() >> 1;
+  while (state.KeepRunning()) {
+    NativeVector c(a);
+    c.SwitchModulus(smaller);
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_SwitchModulus)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+static void BM_NativeVec_ModByTwo(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  while (state.KeepRunning()) {
+    NativeVector c = a.ModByTwo();
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_ModByTwo)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+// inner products of 8 vector pairs, as in key switching: with a ModMul and a
+// ModAddEq per term, and with one fused ModMulAddEq
+static void BM_NativeVec_InnerProduct(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  std::vector<NativeVector> as(8, a), bs(8, b);
+  while (state.KeepRunning()) {
+    NativeVector c(a.GetLength(), a.GetModulus());
+    for (size_t j = 0; j < as.size(); j++) {
+      c.ModAddEq(as[j].ModMul(bs[j]));
+    }
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_InnerProduct)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
+static void BM_NativeVec_InnerProductFused(benchmark::State &state) {
+  NativeVector a, b;
+  if (!SetupNativeVecKernel(state, &a, &b)) {
+    return;
+  }
+  std::vector<NativeVector> as(8, a), bs(8, b);
+  std::vector<const NativeVector *> aPtrs, bPtrs;
+  for (size_t j = 0; j < as.size(); j++) {
+    aPtrs.push_back(&as[j]);
+    bPtrs.push_back(&bs[j]);
+  }
+  while (state.KeepRunning()) {
+    NativeVector c(a.GetLength(), a.GetModulus());
+    c.ModMulAddEq(aPtrs, bPtrs);
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+BENCHMARK(BM_NativeVec_InnerProductFused)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NativeEngineArguments);
+
 // execute the benchmarks
 BENCHMARK_MAIN();
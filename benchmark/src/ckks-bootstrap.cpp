@@ -0,0 +1,90 @@
+/*
+ * @author TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+  This code benchmarks CKKS bootstrapping (EvalBootstrap) for several ring
+  dimensions and level budgets of CoeffToSlot/SlotToCoeff. A larger level
+  budget uses fewer rotations per level of the linear transforms but
+  consumes more levels.
+ */
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include "palisade.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace lbcrypto;
+
+#if NATIVEINT == 64
+
+static void BootstrapArguments(benchmark::internal::Benchmark *b) {
+  for (int logN : {12, 13, 14}) {
+    for (int budget : {2, 3, 4}) {
+      b->Args({logN, budget});
+    }
+  }
+}
+
+static void CKKS_EvalBootstrap(benchmark::State &state) {
+  usint ringDim = 1 << state.range(0);
+  std::vector<uint32_t> levelBudget(2, state.range(1));
+
+  // 2 levels are left for computation after bootstrapping
+  CryptoContext<DCRTPoly> cc =
+      CryptoContextFactory<DCRTPoly>::genCryptoContextCKKSWithBootstrap(
+          2, 50, 8, HEStd_NotSet, ringDim, levelBudget);
+  cc->Enable(ENCRYPTION);
+  cc->Enable(SHE);
+  cc->Enable(LEVELEDSHE);
+  cc->Enable(FHE);
+
+  cc->EvalBootstrapSetup(levelBudget);
+  LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+  cc->EvalBootstrapKeyGen(kp.secretKey);
+
+  std::vector<double> input(ringDim / 2);
+  for (size_t i = 0; i < input.size(); i++) input[i] = std::sin(0.37 * i);
+  Plaintext plaintext = cc->MakeCKKSPackedPlaintext(input);
+  Ciphertext<DCRTPoly> ciphertext =
+      cc->Compress(cc->Encrypt(kp.publicKey, plaintext), 1);
+
+  while (state.KeepRunning()) {
+    Ciphertext<DCRTPoly> refreshed = cc->EvalBootstrap(ciphertext);
+  }
+
+  state.counters["towers"] = cc->GetElementParams()->GetParams().size();
+}
+
+BENCHMARK(CKKS_EvalBootstrap)
+    ->Unit(benchmark::kMillisecond)
+    ->Apply(BootstrapArguments)
+    ->ArgNames({"logN", "budget"});
+
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,106 @@
+/*
+ * @author TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution. THIS SOFTWARE IS
+ * PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+  This code benchmarks CKKS EvalSum over all slots. The radix-2 EvalSum of
+  EvalSumKeyGen(privateKey) is compared to the hoisted EvalSum with radix 2,
+  4 and 8, which needs radix - 1 rotation keys per step but only
+  log_radix(slots) sequential steps, each with a single digit decomposition.
+ */
+#include "benchmark/benchmark.h"
+
+#include "palisade.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace lbcrypto;
+
+static CryptoContext<DCRTPoly> GenerateEvalSumContext(usint ringDim) {
+  CryptoContext<DCRTPoly> cc =
+      CryptoContextFactory<DCRTPoly>::genCryptoContextCKKS(
+          3, 50, ringDim / 2, HEStd_NotSet, ringDim);
+  cc->Enable(ENCRYPTION);
+  cc->Enable(SHE);
+  cc->Enable(LEVELEDSHE);
+  return cc;
+}
+
+static Ciphertext<DCRTPoly> EncryptEvalSumInput(CryptoContext<DCRTPoly> cc,
+                                                LPPublicKey<DCRTPoly> pk) {
+  std::vector<double> input(cc->GetRingDimension() / 2);
+  for (size_t i = 0; i < input.size(); i++) input[i] = std::sin(0.37 * i);
+  return cc->Encrypt(pk, cc->MakeCKKSPackedPlaintext(input));
+}
+
+static void CKKS_EvalSum(benchmark::State &state) {
+  usint ringDim = 1 << state.range(0);
+  CryptoContext<DCRTPoly> cc = GenerateEvalSumContext(ringDim);
+
+  LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+  cc->EvalSumKeyGen(kp.secretKey);
+  auto ciphertext = EncryptEvalSumInput(cc, kp.publicKey);
+
+  while (state.KeepRunning()) {
+    Ciphertext<DCRTPoly> sum = cc->EvalSum(ciphertext, ringDim / 2);
+  }
+}
+
+BENCHMARK(CKKS_EvalSum)
+    ->Unit(benchmark::kMillisecond)
+    ->DenseRange(13, 15)
+    ->ArgName("logN");
+
+static void EvalSumRadixArguments(benchmark::internal::Benchmark *b) {
+  for (int logN : {13, 14, 15}) {
+    for (int radix : {2, 4, 8}) {
+      b->Args({logN, radix});
+    }
+  }
+}
+
+static void CKKS_EvalSumRadix(benchmark::State &state) {
+  usint ringDim = 1 << state.range(0);
+  usint radix = state.range(1);
+  CryptoContext<DCRTPoly> cc = GenerateEvalSumContext(ringDim);
+
+  LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+  cc->EvalSumRadixKeyGen(kp.secretKey, radix);
+  auto ciphertext = EncryptEvalSumInput(cc, kp.publicKey);
+
+  while (state.KeepRunning()) {
+    Ciphertext<DCRTPoly> sum = cc->EvalSum(ciphertext, ringDim / 2, radix);
+  }
+
+  state.counters["keys"] =
+      cc->GetEvalAutomorphismKeyMap(kp.secretKey->GetKeyTag()).size();
+}
+
+BENCHMARK(CKKS_EvalSumRadix)
+    ->Unit(benchmark::kMillisecond)
+    ->Apply(EvalSumRadixArguments)
+    ->ArgNames({"logN", "radix"});
+
+BENCHMARK_MAIN();
@@ -243,6 +243,29 @@ static void Native_ntt(benchmark::State &state) {
 
 BENCHMARK(Native_ntt)->Unit(benchmark::kMicrosecond);
 
+// forward transforms of polynomials that are nonzero only at multiples of the
+// stride, as in the sparse embeddings of FHEW bootstrapping
+static void Native_ntt_pruned(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysCoef;
+  usint stride = state.range(0);
+  NativePoly a;
+  size_t i = 0;
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    i++;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormatPruned(stride, a.GetRingDimension());
+  }
+}
+
+BENCHMARK(Native_ntt_pruned)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgName("stride")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16);
+
 static void DCRT_ntt(benchmark::State &state) {
   shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysCoef[state.range(0)];
   M2DCRTPoly a;
@@ -288,4 +311,85 @@ static void DCRT_intt(benchmark::State &state) {
 
 BENCHMARK(DCRT_intt)->Unit(benchmark::kMicrosecond)->Apply(DCRTArguments);
 
+// negacyclic products of polynomials in coefficient format: transforms and
+// pointwise product as separate steps versus the fused pipeline
+
+static void Native_negacyclic_mul(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysCoef;
+  NativePoly a, b, c;
+  size_t i = 0;
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+    b.SwitchFormat();
+    c = a.Times(b);
+    c.SwitchFormat();
+  }
+}
+
+BENCHMARK(Native_negacyclic_mul)->Unit(benchmark::kMicrosecond);
+
+static void Native_negacyclic_mul_fused(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysCoef;
+  NativePoly a, b, c;
+  size_t i = 0;
+
+  // the operands are copied as in the unfused variant, which transforms
+  // them in place
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    c = a.NegacyclicMultiply(b);
+  }
+}
+
+BENCHMARK(Native_negacyclic_mul_fused)->Unit(benchmark::kMicrosecond);
+
+static void DCRT_negacyclic_mul(benchmark::State &state) {
+  shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysCoef[state.range(0)];
+  M2DCRTPoly a, b, c;
+  size_t i = 0;
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+    b.SwitchFormat();
+    c = a.Times(b);
+    c.SwitchFormat();
+  }
+}
+
+BENCHMARK(DCRT_negacyclic_mul)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(DCRTArguments);
+
+static void DCRT_negacyclic_mul_fused(benchmark::State &state) {
+  shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysCoef[state.range(0)];
+  M2DCRTPoly a, b, c;
+  size_t i = 0;
+
+  // the operands are copied as in the unfused variant, which transforms
+  // them in place
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    c = a.NegacyclicMultiply(b);
+  }
+}
+
+BENCHMARK(DCRT_negacyclic_mul_fused)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(DCRTArguments);
+
 BENCHMARK_MAIN();
@@ -288,4 +288,85 @@ static void DCRT_intt(benchmark::State &state) {
 
 BENCHMARK(DCRT_intt)->Unit(benchmark::kMicrosecond)->Apply(DCRTArguments);
 
+// negacyclic products of polynomials in coefficient format: transforms and
+// pointwise product as separate steps versus the fused pipeline
+
+static void Native_negacyclic_mul(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysCoef;
+  NativePoly a, b, c;
+  size_t i = 0;
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+    b.SwitchFormat();
+    c = a.Times(b);
+    c.SwitchFormat();
+  }
+}
+
+BENCHMARK(Native_negacyclic_mul)->Unit(benchmark::kMicrosecond);
+
+static void Native_negacyclic_mul_fused(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysCoef;
+  NativePoly a, b, c;
+  size_t i = 0;
+
+  // the operands are copied as in the unfused variant, which transforms
+  // them in place
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    c = a.NegacyclicMultiply(b);
+  }
+}
+
+BENCHMARK(Native_negacyclic_mul_fused)->Unit(benchmark::kMicrosecond);
+
+static void DCRT_negacyclic_mul(benchmark::State &state) {
+  shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysCoef[state.range(0)];
+  M2DCRTPoly a, b, c;
+  size_t i = 0;
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+    b.SwitchFormat();
+    c = a.Times(b);
+    c.SwitchFormat();
+  }
+}
+
+BENCHMARK(DCRT_negacyclic_mul)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(DCRTArguments);
+
+static void DCRT_negacyclic_mul_fused(benchmark::State &state) {
+  shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysCoef[state.range(0)];
+  M2DCRTPoly a, b, c;
+  size_t i = 0;
+
+  // the operands are copied as in the unfused variant, which transforms
+  // them in place
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    c = a.NegacyclicMultiply(b);
+  }
+}
+
+BENCHMARK(DCRT_negacyclic_mul_fused)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(DCRTArguments);
+
 BENCHMARK_MAIN();
@@ -28,6 +28,8 @@
 
 #include "palisade.h"
 
+#include "math/nativentt.h"
+
 #include <iostream>
 #include <vector>
 
@@ -288,4 +290,180 @@ static void DCRT_intt(benchmark::State &state) {
 
 BENCHMARK(DCRT_intt)->Unit(benchmark::kMicrosecond)->Apply(DCRTArguments);
 
+// negacyclic products of polynomials in coefficient format: transforms and
+// pointwise product as separate steps versus the fused pipeline
+
+static void Native_negacyclic_mul(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysCoef;
+  NativePoly a, b, c;
+  size_t i = 0;
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+    b.SwitchFormat();
+    c = a.Times(b);
+    c.SwitchFormat();
+  }
+}
+
+BENCHMARK(Native_negacyclic_mul)->Unit(benchmark::kMicrosecond);
+
+static void Native_negacyclic_mul_fused(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysCoef;
+  NativePoly a, b, c;
+  size_t i = 0;
+
+  // the operands are copied as in the unfused variant, which transforms
+  // them in place
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    c = a.NegacyclicMultiply(b);
+  }
+}
+
+BENCHMARK(Native_negacyclic_mul_fused)->Unit(benchmark::kMicrosecond);
+
+static void DCRT_negacyclic_mul(benchmark::State &state) {
+  shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysCoef[state.range(0)];
+  M2DCRTPoly a, b, c;
+  size_t i = 0;
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+    b.SwitchFormat();
+    c = a.Times(b);
+    c.SwitchFormat();
+  }
+}
+
+BENCHMARK(DCRT_negacyclic_mul)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(DCRTArguments);
+
+static void DCRT_negacyclic_mul_fused(benchmark::State &state) {
+  shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysCoef[state.range(0)];
+  M2DCRTPoly a, b, c;
+  size_t i = 0;
+
+  // the operands are copied as in the unfused variant, which transforms
+  // them in place
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    b = polys->operator[](i + 1);
+    i += 2;
+    i = i & POLY_NUM_M1;
+    c = a.NegacyclicMultiply(b);
+  }
+}
+
+BENCHMARK(DCRT_negacyclic_mul_fused)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(DCRTArguments);
+
+// radix-2 versus blocked native transforms (NTT_AUTO picks the blocked one
+// at this ring dimension)
+
+static void NTTAlgorithmArguments(benchmark::internal::Benchmark *b) {
+  b->ArgName("algorithm")->Arg(NTT_RADIX2)->Arg(NTT_BLOCKED);
+}
+
+static void DCRTNTTAlgorithmArguments(benchmark::internal::Benchmark *b) {
+  for (usint t : tow_args) {
+    b->ArgNames({"towers", "algorithm"})
+        ->Args({t, NTT_RADIX2})
+        ->Args({t, NTT_BLOCKED});
+  }
+}
+
+static void Native_ntt_algorithm(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysCoef;
+  NativePoly a;
+  size_t i = 0;
+  NativeNTTEngine::SetAlgorithm(static_cast<NTTAlgorithm>(state.range(0)));
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    i++;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+  }
+
+  NativeNTTEngine::SetAlgorithm(NTT_AUTO);
+}
+
+BENCHMARK(Native_ntt_algorithm)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NTTAlgorithmArguments);
+
+static void Native_intt_algorithm(benchmark::State &state) {
+  shared_ptr<vector<NativePoly>> polys = NativepolysEval;
+  NativePoly a;
+  size_t i = 0;
+  NativeNTTEngine::SetAlgorithm(static_cast<NTTAlgorithm>(state.range(0)));
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    i++;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+  }
+
+  NativeNTTEngine::SetAlgorithm(NTT_AUTO);
+}
+
+BENCHMARK(Native_intt_algorithm)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(NTTAlgorithmArguments);
+
+static void DCRT_ntt_algorithm(benchmark::State &state) {
+  shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysCoef[state.range(0)];
+  M2DCRTPoly a;
+  size_t i = 0;
+  NativeNTTEngine::SetAlgorithm(static_cast<NTTAlgorithm>(state.range(1)));
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    i++;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+  }
+
+  NativeNTTEngine::SetAlgorithm(NTT_AUTO);
+}
+
+BENCHMARK(DCRT_ntt_algorithm)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(DCRTNTTAlgorithmArguments);
+
+static void DCRT_intt_algorithm(benchmark::State &state) {
+  shared_ptr<vector<M2DCRTPoly>> polys = DCRTpolysEval[state.range(0)];
+  M2DCRTPoly a;
+  size_t i = 0;
+  NativeNTTEngine::SetAlgorithm(static_cast<NTTAlgorithm>(state.range(1)));
+
+  while (state.KeepRunning()) {
+    a = polys->operator[](i);
+    i++;
+    i = i & POLY_NUM_M1;
+    a.SwitchFormat();
+  }
+
+  NativeNTTEngine::SetAlgorithm(NTT_AUTO);
+}
+
+BENCHMARK(DCRT_intt_algorithm)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply(DCRTNTTAlgorithmArguments);
+
 BENCHMARK_MAIN();
@@ -338,16 +338,13 @@ void RingGSWAccumulatorScheme::AddToACCAP(
   for (uint32_t j = 0; j < digitsG2; j++) dct[j].SetFormat(Format::EVALUATION);
 
   // acc = dct * input (matrix product);
-  // uses in-place * operators for the last call to dct[i] to gain performance
-  // improvement
+  // each column is a fused inner product that reduces the sum only once
+  std::vector<const NativePoly *> digits(digitsG2), keys(digitsG2);
+  for (uint32_t l = 0; l < digitsG2; l++) digits[l] = &dct[l];
   for (uint32_t j = 0; j < 2; j++) {
+    for (uint32_t l = 0; l < digitsG2; l++) keys[l] = &input[l][j];
     (*acc)[0][j].SetValuesToZero();
-    for (uint32_t l = 0; l < digitsG2; l++) {
-      if (j == 0)
-        (*acc)[0][j] += dct[l] * input[l][j];
-      else
-        (*acc)[0][j] += (dct[l] *= input[l][j]);
-    }
+    (*acc)[0][j].ModMulAddEq(digits, keys);
   }
 }
 
@@ -382,18 +379,16 @@ void RingGSWAccumulatorScheme::AddToACCGINX(
   if (index == m) index = 0;
   const NativePoly &monomial = params->GetMonomial(index);
 
-  // acc = dct * input (matrix product);
-  // uses in-place * operators for the last call to dct[i] to gain performance
-  // improvement
+  // acc += (dct * input) * monomial;
+  // the matrix product is a fused inner product per column
+  std::vector<const NativePoly *> digits(digitsG2), keys(digitsG2);
+  for (uint32_t l = 0; l < digitsG2; l++) digits[l] = &dct[l];
+  NativePoly temp1(polyParams, Format::EVALUATION, true);
   for (uint32_t j = 0; j < 2; j++) {
-    NativePoly temp1 = (j < 1) ? dct[0] * input[0][j] : (dct[0] *= input[0][j]);
-    for (uint32_t l = 1; l < digitsG2; l++) {
-      if (j == 0)
-        temp1 += dct[l] * input[l][j];
-      else
-        temp1 += (dct[l] *= input[l][j]);
-    }
-    (*acc)[0][j] += (temp1 *= monomial);
+    for (uint32_t l = 0; l < digitsG2; l++) keys[l] = &input[l][j];
+    temp1.SetValuesToZero();
+    temp1.ModMulAddEq(digits, keys);
+    (*acc)[0][j].ModMulAddEq(temp1, monomial);
   }
 }
 
@@ -444,7 +439,9 @@ std::shared_ptr<RingGSWCiphertext> RingGSWAccumulatorScheme::BootstrapCore(
   res[0] = NativePoly(polyParams, Format::EVALUATION, true);
   res[1] = NativePoly(polyParams, Format::COEFFICIENT, false);
   res[1].SetValues(std::move(m), Format::COEFFICIENT);
-  res[1].SetFormat(Format::EVALUATION);
+  // only the multiples of factor are nonzero, so the pruned transform costs
+  // about as much as one of dimension q/2
+  res[1].SwitchFormatPruned(factor, N);
 
   // main accumulation computation
   // the following loop is the bottleneck of bootstrapping/binary gate
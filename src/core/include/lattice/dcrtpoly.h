@@ -24,6 +24,7 @@
 #ifndef LBCRYPTO_LATTICE_DCRTPOLY_H
 #define LBCRYPTO_LATTICE_DCRTPOLY_H
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -31,6 +32,7 @@
 #include <vector>
 
 #include "math/backend.h"
+#include "math/scaleandround.h"
 #include "utils/inttypes.h"
 
 #include "utils/exception.h"
@@ -78,6 +80,43 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
 
   static const std::string GetElementName() { return "DCRTPolyImpl"; }
 
+  /**
+   * @brief Scratch storage of the key-switching routines ApproxModUp(),
+   * ApproxModDown(), ApproxSwitchCRTBasis() and DropLastElementAndScale():
+   * the temporary towers and tables they need besides their result. The
+   * buffers grow to the largest shape they are used with and are reused
+   * afterwards, so the overloads of these routines that take a workspace
+   * and write into an existing result do not allocate in steady state
+   * (in builds with 128-bit integers and 64-bit native integers).
+   *
+   * A workspace may be used by one thread at a time; GetThreadWorkspace()
+   * provides one per thread.
+   */
+  struct Workspace {
+    // temporary towers
+    std::vector<PolyType> towers;
+
+    // tables of the base conversions
+    std::vector<const uint64_t *> in;
+    std::vector<uint64_t *> out;
+    std::vector<uint64_t> inModuli;
+    std::vector<uint64_t> scale;
+    std::vector<uint64_t> scalePrecon;
+    std::vector<uint64_t> weights;
+    std::vector<uint64_t> outModuli;
+
+    // the parameters left by DropLastElement() for the parameters seen so
+    // far, so that they are only created once per level
+    std::vector<std::pair<shared_ptr<Params>, shared_ptr<Params>>>
+        droppedParams;
+  };
+
+  /**
+   * @return the workspace of the calling thread; the overloads of the
+   * key-switching routines without a workspace use it.
+   */
+  static Workspace &GetThreadWorkspace();
+
   // CONSTRUCTORS
 
   /**
@@ -283,6 +322,160 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
     return res;
   }
 
+  class ConstTowerRange;
+  class TowerRange;
+
+  /**
+   * @brief Non-owning view of the towers startTower to endTower of the
+   * DCRTPoly (see ConstTowerRange).
+   */
+  ConstTowerRange Towers(usint startTower, usint endTower) const {
+    return ConstTowerRange(*this, startTower, endTower);
+  }
+
+  /**
+   * @brief Non-owning, mutable view of the towers startTower to endTower of
+   * the DCRTPoly (see TowerRange).
+   */
+  TowerRange Towers(usint startTower, usint endTower) {
+    return TowerRange(*this, startTower, endTower);
+  }
+
+  /**
+   * @brief Read-only view of the consecutive towers startTower to endTower of
+   * a DCRTPoly, i.e., of the polynomial modulo the product of their moduli;
+   * the view of the first towers is the polynomial at a lower level. A view
+   * does not copy the towers: it is valid as long as the DCRTPoly is neither
+   * destroyed nor resized. Views are accepted by the arithmetic operators of
+   * DCRTPoly, can be copied into a DCRTPoly with the DCRTPolyImpl(const
+   * ConstTowerRange &) constructor and are serialized as the DCRTPoly with
+   * the same towers.
+   */
+  class ConstTowerRange {
+   public:
+    /**
+     * @brief View of all towers of element.
+     */
+    ConstTowerRange(const DCRTPolyType &element)  // NOLINT
+        : ConstTowerRange(element, 0, element.GetNumOfElements(), true) {}
+
+    ConstTowerRange(const DCRTPolyType &element, usint startTower,
+                    usint endTower)
+        : ConstTowerRange(element, startTower, endTower - startTower + 1,
+                          endTower >= startTower) {}
+
+    usint GetNumOfElements() const { return m_size; }
+
+    usint GetStartTower() const { return m_start; }
+
+    usint GetRingDimension() const { return m_element->GetRingDimension(); }
+
+    /**
+     * @return the format of the towers, which is that of the DCRTPoly.
+     */
+    Format GetFormat() const { return m_element->m_format; }
+
+    const PolyType &GetElementAtIndex(usint i) const {
+      if (i >= m_size)
+        PALISADE_THROW(math_error, "Index: " + std::to_string(i) +
+                                       " is out of range for tower range of "
+                                       "size " +
+                                       std::to_string(m_size) + ".");
+      return m_element->m_vectors[m_start + i];
+    }
+
+    /**
+     * @return the parameters of the towers; for the first towers of the
+     * DCRTPoly they are those left by DropLastElements().
+     */
+    shared_ptr<Params> GetParams() const {
+      const shared_ptr<Params> &params = m_element->GetParams();
+      usint count = params->GetParams().size();
+      if (m_start == 0) {
+        return m_size == count
+                   ? params
+                   : DroppedParams(&GetThreadWorkspace(), params,
+                                   count - m_size);
+      }
+      std::vector<std::shared_ptr<ILNativeParams>> towerParams(
+          params->GetParams().begin() + m_start,
+          params->GetParams().begin() + m_start + m_size);
+      return std::make_shared<Params>(params->GetCyclotomicOrder(),
+                                      towerParams);
+    }
+
+    template <class Archive>
+    void save(Archive &ar, std::uint32_t const version) const {
+      ar(::cereal::make_nvp("v", TowerArchive{this}));
+      ar(::cereal::make_nvp("f", GetFormat()));
+      ar(::cereal::make_nvp("p", GetParams()));
+    }
+
+    std::string SerializedObjectName() const { return "DCRTPoly"; }
+    static uint32_t SerializedVersion() { return 1; }
+
+   protected:
+    ConstTowerRange(const DCRTPolyType &element, usint start, usint size,
+                    bool valid)
+        : m_element(&element), m_start(start), m_size(size) {
+      if (!valid || start + size > element.GetNumOfElements())
+        PALISADE_THROW(math_error, "invalid range of towers");
+    }
+
+    // writes the towers as the std::vector of towers of a DCRTPoly
+    struct TowerArchive {
+      const ConstTowerRange *range;
+
+      template <class Archive>
+      void save(Archive &ar) const {
+        ar(::cereal::make_size_tag(
+            static_cast<::cereal::size_type>(range->m_size)));
+        for (usint i = 0; i < range->m_size; i++)
+          ar(range->m_element->m_vectors[range->m_start + i]);
+      }
+    };
+
+    const DCRTPolyType *m_element;
+    usint m_start;
+    usint m_size;
+  };
+
+  /**
+   * @brief Mutable view of consecutive towers of a DCRTPoly (see
+   * ConstTowerRange); operations on it update these towers of the DCRTPoly
+   * in place. The towers of a DCRTPoly share one format, so a view cannot
+   * switch the format of its towers: switch the format of the DCRTPoly, or
+   * of a copy made with DCRTPolyImpl(const ConstTowerRange &).
+   */
+  class TowerRange : public ConstTowerRange {
+   public:
+    TowerRange(DCRTPolyType &element, usint startTower, usint endTower)
+        : ConstTowerRange(element, startTower, endTower),
+          m_mutableElement(&element) {}
+
+    PolyType &ElementAtIndex(usint i) {
+      if (i >= this->m_size)
+        PALISADE_THROW(math_error, "Index: " + std::to_string(i) +
+                                       " is out of range for tower range of "
+                                       "size " +
+                                       std::to_string(this->m_size) + ".");
+      return m_mutableElement->m_vectors[this->m_start + i];
+    }
+
+    const TowerRange &operator+=(const ConstTowerRange &rhs);
+    const TowerRange &operator-=(const ConstTowerRange &rhs);
+    const TowerRange &operator*=(const ConstTowerRange &rhs);
+
+   private:
+    DCRTPolyType *m_mutableElement;
+  };
+
+  /**
+   * @brief Copies the towers of a view into a new DCRTPoly, over the
+   * parameters returned by ConstTowerRange::GetParams().
+   */
+  explicit DCRTPolyImpl(const ConstTowerRange &towers);
+
   /**
    * @brief Clone the object, but have it contain nothing
    * @return new Element
@@ -550,6 +743,18 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
    */
   const DCRTPolyType &operator-=(const DCRTPolyType &rhs);
 
+  /**
+   * @brief Tower-wise addition, subtraction and multiplication by a view of
+   * towers with the same moduli, e.g., the first towers of a polynomial at a
+   * lower level.
+   *
+   * @param &rhs the view of the towers to add, subtract or multiply by.
+   * @return is the result of the operation.
+   */
+  const DCRTPolyType &operator+=(const ConstTowerRange &rhs);
+  const DCRTPolyType &operator-=(const ConstTowerRange &rhs);
+  const DCRTPolyType &operator*=(const ConstTowerRange &rhs);
+
   /**
    * @brief Permutes coefficients in a polynomial. Moves the ith index to the
    * first one, it only supports odd indices.
@@ -557,30 +762,48 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
    * @param &i is the element to perform the automorphism transform with.
    * @return is the result of the automorphism transform.
    */
-  DCRTPolyType AutomorphismTransform(const usint &i) const {
-    DCRTPolyType result(*this);
-    for (usint k = 0; k < m_vectors.size(); k++) {
-      result.m_vectors[k] = m_vectors[k].AutomorphismTransform(i);
-    }
-    return result;
-  }
+  DCRTPolyType AutomorphismTransform(const usint &i) const;
 
   /**
    * @brief Performs an automorphism transform operation using precomputed bit
    * reversal indices.
    *
    * @param &i is the element to perform the automorphism transform with.
-   * @param &map a vector with precomputed indices
+   * @param &map a vector with precomputed indices, see
+   * GetAutomorphismPermutation()
    * @return is the result of the automorphism transform.
    */
   DCRTPolyType AutomorphismTransform(usint i,
-                                     const std::vector<usint> &map) const {
-    DCRTPolyType result(*this);
-    for (usint k = 0; k < m_vectors.size(); k++) {
-      result.m_vectors[k] = m_vectors[k].AutomorphismTransform(i, map);
-    }
-    return result;
-  }
+                                     const std::vector<usint> &map) const;
+
+  /**
+   * @brief Performs the automorphism transform of the sum of this element and
+   * addend, permuting while adding so that neither the sum nor a permuted copy
+   * of either operand is formed. Key switching for rotations uses it to apply
+   * the automorphism to the key-switched ciphertext. Only the EVALUATION
+   * representation is supported.
+   *
+   * @param i is the element to perform the automorphism transform with.
+   * @param &addend the element to add before the transform, with the same
+   * towers as this element.
+   * @return is the result of the automorphism transform.
+   */
+  DCRTPolyType AutomorphismTransformSum(usint i,
+                                        const DCRTPolyType &addend) const;
+
+  /**
+   * @brief Same as AutomorphismTransformSum(), for an addend that has only
+   * the first towers of this element; the missing towers are taken as zero.
+   * Hoisted rotations use it to add P * c0, which has no towers of P, to an
+   * element over the extended basis Q_l * P.
+   *
+   * @param i is the element to perform the automorphism transform with.
+   * @param &addend the element to add before the transform, with at most as
+   * many towers as this element.
+   * @return is the result of the automorphism transform.
+   */
+  DCRTPolyType AutomorphismTransformSumPrefix(
+      usint i, const DCRTPolyType &addend) const;
 
   /**
    * @brief Transpose the ring element using the automorphism operation
@@ -614,6 +837,16 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
    */
   DCRTPolyType Times(const DCRTPolyType &element) const;
 
+  /**
+   * @brief Computes the negacyclic product of this element in
+   * Format::COEFFICIENT and another one, tower by tower (see
+   * PolyImpl::NegacyclicMultiply()).
+   *
+   * @param &element is the element to multiply with, in either format.
+   * @return is the result of the multiplication, in Format::COEFFICIENT.
+   */
+  DCRTPolyType NegacyclicMultiply(const DCRTPolyType &element) const;
+
   /**
    * @brief Performs a subtraction operation and returns the result.
    *
@@ -772,6 +1005,27 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
    */
   const DCRTPolyType &operator*=(const DCRTPolyType &element);
 
+  /**
+   * @brief Fused multiply-accumulate: this += a * b, tower by tower.
+   *
+   * @param &a, &b are the elements to multiply.
+   * @return is the result of the multiply-accumulate operation.
+   */
+  const DCRTPolyType &ModMulAddEq(const DCRTPolyType &a,
+                                  const DCRTPolyType &b);
+
+  /**
+   * @brief Fused inner product: this += sum_j a[j] * b[j], tower by tower
+   * (see PolyImpl::ModMulAddEq()). All elements are in Format::EVALUATION
+   * and have the same towers.
+   *
+   * @param &a, &b are the elements to multiply; both have the same number of
+   * entries and none of them may be this element.
+   * @return is the result of the multiply-accumulate operation.
+   */
+  const DCRTPolyType &ModMulAddEq(const std::vector<const DCRTPolyType *> &a,
+                                  const std::vector<const DCRTPolyType *> &b);
+
   /**
    * @brief Get value of element at index i.
    *
@@ -910,6 +1164,15 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
       const std::vector<NativeInteger> &qlInvModq,
       const std::vector<NativeInteger> &qlInvModqPrecon);
 
+  /**
+   * @brief Same as above, with the temporary towers taken from \p ws.
+   */
+  void DropLastElementAndScale(
+      const std::vector<NativeInteger> &QlQlInvModqlDivqlModq,
+      const std::vector<NativeInteger> &QlQlInvModqlDivqlModqPrecon,
+      const std::vector<NativeInteger> &qlInvModq,
+      const std::vector<NativeInteger> &qlInvModqPrecon, Workspace *ws);
+
   /**
    * @brief ModReduces reduces the DCRTPoly element's composite modulus by
    * dropping the last modulus from the chain of moduli as well as dropping the
@@ -999,6 +1262,19 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
       const std::vector<std::vector<NativeInteger>> &QHatModp,
       const std::vector<DoubleNativeInt> &modpBarrettMu) const;
 
+  /**
+   * @brief Same as above, but writes into \p result, whose towers are reused
+   * if they have the ring dimension of this element; \p result may not be
+   * this element.
+   */
+  void ApproxSwitchCRTBasis(const shared_ptr<Params> paramsQ,
+                            const shared_ptr<Params> paramsP,
+                            const vector<NativeInteger> &QHatInvModq,
+                            const vector<NativeInteger> &QHatInvModqPrecon,
+                            const vector<vector<NativeInteger>> &QHatModp,
+                            const vector<DoubleNativeInt> &modpBarrettMu,
+                            DCRTPolyType *result, Workspace *ws) const;
+
   /**
    * @brief Performs approximate modulus raising:
    * {X}_{Q} -> {X'}_{Q,P}.
@@ -1030,6 +1306,21 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
                    const vector<vector<NativeInteger>> &QHatModp,
                    const vector<DoubleNativeInt> &modpBarrettMu);
 
+  /**
+   * @brief Same as above, but leaves this element unchanged and writes
+   * {X + alpha*Q}_{Q,P} into \p result, whose towers are reused if they
+   * have the ring dimension of this element; \p result may not be this
+   * element.
+   */
+  void ApproxModUp(const shared_ptr<Params> paramsQ,
+                   const shared_ptr<Params> paramsP,
+                   const shared_ptr<Params> paramsQP,
+                   const vector<NativeInteger> &QHatInvModq,
+                   const vector<NativeInteger> &QHatInvModqPrecon,
+                   const vector<vector<NativeInteger>> &QHatModp,
+                   const vector<DoubleNativeInt> &modpBarrettMu,
+                   DCRTPolyType *result, Workspace *ws) const;
+
   /**
    * @brief Performs approximate modulus reduction:
    * {X}_{Q,P} -> {\approx(X/P)}_{Q}.
@@ -1071,6 +1362,25 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
       const NativeInteger &t = 0,
       const vector<NativeInteger> &tModqPrecon = vector<NativeInteger>()) const;
 
+  /**
+   * @brief Same as above, but writes into \p result, whose towers are reused
+   * if they have the ring dimension of this element; \p result may not be
+   * this element. Pass t = 0 and empty vectors for the BGVrns-only inputs.
+   */
+  void ApproxModDown(const shared_ptr<Params> paramsQ,
+                     const shared_ptr<Params> paramsP,
+                     const vector<NativeInteger> &PInvModq,
+                     const vector<NativeInteger> &PInvModqPrecon,
+                     const vector<NativeInteger> &PHatInvModp,
+                     const vector<NativeInteger> &PHatInvModpPrecon,
+                     const vector<vector<NativeInteger>> &PHatModq,
+                     const vector<DoubleNativeInt> &modqBarrettMu,
+                     const vector<NativeInteger> &tInvModp,
+                     const vector<NativeInteger> &tInvModpPrecon,
+                     const NativeInteger &t,
+                     const vector<NativeInteger> &tModqPrecon,
+                     DCRTPolyType *result, Workspace *ws) const;
+
   /**
    * @brief Performs CRT basis switching:
    * {X}_{Q} -> {X}_{P}
@@ -1166,6 +1476,9 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
    * @param &tQHatInvModqDivqFrac precomputed values for Frac{t*QHatInv_i/q_i}
    * @param &tQHatInvBDivqFrac precomputed values for Frac{t*QHatInv_i*B/q_i}
    * used when CRT moduli are 45..60 bits long
+   * @param kernel the kernel of ScaleAndRoundKernels::SelectKernel() for
+   * these moduli, e.g., selected along with the other precomputations; it is
+   * selected here if not given
    * @return the result of computation as a polynomial with native 64-bit
    * coefficients
    */
@@ -1176,7 +1489,8 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
       const std::vector<NativeInteger> &tQHatInvModqBDivqModt,
       const std::vector<NativeInteger> &tQHatInvModqBDivqModtPrecon,
       const std::vector<double> &tQHatInvModqDivqFrac,
-      const std::vector<double> &tQHatInvModqBDivqFrac) const;
+      const std::vector<double> &tQHatInvModqBDivqFrac,
+      ScaleAndRoundKernel kernel = nullptr) const;
 
   /**
    * @brief Computes approximate scale and round:
@@ -1391,6 +1705,81 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
    */
   void SwitchFormat();
 
+  /**
+   * @brief Sets the format of the element, performing or cancelling a switch
+   * deferred by DeferFormat().
+   * @param format the format/representation to set.
+   */
+  void SetFormat(const Format format);
+
+  /**
+   * @brief Same as SwitchFormat(), with pruned transforms for polynomials
+   * whose coefficients are zero except at multiples of \p stride below
+   * \p degree (see PolyImpl::SwitchFormatPruned()).
+   */
+  void SwitchFormatPruned(usint stride, usint degree);
+
+  /**
+   * @brief Switches the format of several DCRTPolys at once, transforming
+   * all their towers in one batch (see PolyImpl::SwitchFormat()).
+   *
+   * @param &elements the polynomials to convert.
+   */
+  static void SwitchFormat(const std::vector<DCRTPolyImpl *> &elements);
+
+  /**
+   * @brief Counts of tower transforms (NTTs and inverse NTTs) done by
+   * SwitchFormat() and of those skipped by lazy format switching.
+   */
+  struct FormatSwitchCounts {
+    uint64_t performed;
+    uint64_t elided;
+  };
+
+  /**
+   * @brief Turns lazy format switching on or off for all DCRTPolys. While it
+   * is off, DeferFormat() is the same as SetFormat() and no counts are kept.
+   */
+  static void SetLazyFormat(bool lazy);
+
+  /**
+   * @return true if lazy format switching is on.
+   */
+  static bool IsLazyFormat();
+
+  /**
+   * @return the transforms performed and elided since the last
+   * ResetFormatSwitchCounts().
+   */
+  static FormatSwitchCounts GetFormatSwitchCounts();
+
+  static void ResetFormatSwitchCounts();
+
+  /**
+   * @brief Requests a switch to \p format without transforming the towers,
+   * when lazy format switching is on. GetFormat() and the towers keep the
+   * current format until ResolveFormat(), SetFormat() or SwitchFormat() is
+   * called. The deferred switch is never performed if it is undone by
+   * DeferFormat() or SetFormat(), or if the towers are overwritten or
+   * dropped first.
+   *
+   * @param format the requested format.
+   */
+  void DeferFormat(const Format format);
+
+  /**
+   * @return the format requested by DeferFormat(), or GetFormat() if no
+   * switch is deferred.
+   */
+  Format GetDeferredFormat() const {
+    return m_formatDeferred ? OtherFormat(m_format) : m_format;
+  }
+
+  /**
+   * @brief Performs the switch deferred by DeferFormat(), if any.
+   */
+  void ResolveFormat();
+
   /**
    * @brief Switch modulus and adjust the values
    *
@@ -1561,6 +1950,34 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
     return a.Times(b);
   }
 
+  /**
+   * @brief Element-tower range addition, subtraction and multiplication
+   * operators (see operator+=(const ConstTowerRange &)).
+   * @param a the element.
+   * @param b the view of towers with the moduli of a.
+   * @return the result of the operation.
+   */
+  friend inline DCRTPolyType operator+(const DCRTPolyType &a,
+                                       const ConstTowerRange &b) {
+    DCRTPolyType result(a);
+    result += b;
+    return result;
+  }
+
+  friend inline DCRTPolyType operator-(const DCRTPolyType &a,
+                                       const ConstTowerRange &b) {
+    DCRTPolyType result(a);
+    result -= b;
+    return result;
+  }
+
+  friend inline DCRTPolyType operator*(const DCRTPolyType &a,
+                                       const ConstTowerRange &b) {
+    DCRTPolyType result(a);
+    result *= b;
+    return result;
+  }
+
   /**
    * @brief Element-integer multiplication operator.
    * @param a element to multiply.
@@ -1631,12 +2048,70 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
     ar(::cereal::make_nvp("v", m_vectors));
     ar(::cereal::make_nvp("f", m_format));
     ar(::cereal::make_nvp("p", m_params));
+    m_formatDeferred = false;
   }
 
   std::string SerializedObjectName() const { return "DCRTPoly"; }
   static uint32_t SerializedVersion() { return 1; }
 
  private:
+  static std::atomic<bool> &LazyFormatFlag();
+  static std::atomic<uint64_t> *FormatSwitchCounters();
+
+  static Format OtherFormat(Format format) {
+    return format == Format::COEFFICIENT ? Format::EVALUATION
+                                         : Format::COEFFICIENT;
+  }
+
+  // Adds to the counts reported by GetFormatSwitchCounts(); does nothing
+  // unless lazy format switching is on.
+  static void CountFormatSwitches(uint64_t performed, uint64_t elided);
+
+  // Drops the deferred format switch of towers about to be overwritten or
+  // dropped.
+  void DiscardFormatSwitch() {
+    if (m_formatDeferred) {
+      CountFormatSwitches(0, m_vectors.size());
+      m_formatDeferred = false;
+    }
+  }
+
+  // Gives *result the towers of params in format, reusing the towers it
+  // already has; their values are not meaningful afterwards.
+  static void PrepareTowers(DCRTPolyType *result,
+                            const shared_ptr<Params> &params, Format format);
+
+  // Gives ws at least count temporary towers.
+  static void PrepareWorkspaceTowers(Workspace *ws, usint count);
+
+  // tower <- tower * towerScale + [last]_{q} * lastScale, where q is the
+  // modulus of tower, last is in coefficient representation and the second
+  // term is brought to the format of tower in temp
+  static void RescaleTower(const PolyType &last, const NativeInteger &lastScale,
+                           const NativeInteger &lastScalePrecon,
+                           const NativeInteger &towerScale,
+                           const NativeInteger &towerScalePrecon,
+                           PolyType *tower, PolyType *temp);
+
+  // the temporary tower of the calling thread in a parallel loop over towers,
+  // after the first skip towers of ws
+  static PolyType &LoopWorkspaceTower(Workspace *ws, usint skip);
+
+  // params without their last count towers, created once per workspace
+  static shared_ptr<Params> DroppedParams(Workspace *ws,
+                                          const shared_ptr<Params> &params,
+                                          usint count);
+
+  // ApproxSwitchCRTBasis() from the sizeIn towers at in to the sizeOut
+  // towers at out, which already have the parameters of the new basis
+  static void ApproxSwitchCRTBasisTowers(
+      const PolyType *in, usint sizeIn,
+      const vector<NativeInteger> &QHatInvModq,
+      const vector<NativeInteger> &QHatInvModqPrecon,
+      const vector<vector<NativeInteger>> &QHatModp,
+      const vector<DoubleNativeInt> &modpBarrettMu, PolyType *out,
+      usint sizeOut, Workspace *ws);
+
   shared_ptr<Params> m_params;
 
   // array of vectors used for double-CRT presentation
@@ -1644,6 +2119,10 @@ class DCRTPolyImpl : public ILElement<DCRTPolyImpl<VecType>, VecType> {
 
   // Either Format::EVALUATION (0) or Format::COEFFICIENT (1)
   Format m_format;
+
+  // set when DeferFormat() requested a switch to the other format that has
+  // not been performed
+  bool m_formatDeferred = false;
 };
 }  // namespace lbcrypto
 
@@ -30,6 +30,7 @@
 #include "lattice/elemparams.h"
 #include "math/backend.h"
 #include "math/nbtheory.h"
+#include "math/nttplan.h"
 #include "utils/inttypes.h"
 
 namespace lbcrypto {
@@ -66,7 +67,9 @@ class ILParamsImpl : public ElemParams<IntType> {
                const IntType &rootOfUnity, const IntType &bigModulus = 0,
                const IntType &bigRootOfUnity = 0)
       : ElemParams<IntType>(order, modulus, rootOfUnity, bigModulus,
-                            bigRootOfUnity) {}
+                            bigRootOfUnity) {
+    InitNTTPlan();
+  }
 
   /**
    * @brief Constructor for the case of partially pre-computed parameters.
@@ -77,6 +80,7 @@ class ILParamsImpl : public ElemParams<IntType> {
   ILParamsImpl(const usint order, const IntType &modulus)
       : ElemParams<IntType>(order, modulus) {
     this->rootOfUnity = RootOfUnity<IntType>(order, modulus);
+    InitNTTPlan();
   }
 
   /**
@@ -84,7 +88,8 @@ class ILParamsImpl : public ElemParams<IntType> {
    *
    * @param &rhs the input set of parameters which is copied.
    */
-  ILParamsImpl(const ILParamsImpl &rhs) : ElemParams<IntType>(rhs) {}
+  ILParamsImpl(const ILParamsImpl &rhs)
+      : ElemParams<IntType>(rhs), m_nttPlan(rhs.m_nttPlan) {}
 
   /**
    * @brief Assignment Operator.
@@ -94,6 +99,7 @@ class ILParamsImpl : public ElemParams<IntType> {
    */
   const ILParamsImpl &operator=(const ILParamsImpl &rhs) {
     ElemParams<IntType>::operator=(rhs);
+    m_nttPlan = rhs.m_nttPlan;
     return *this;
   }
 
@@ -102,7 +108,8 @@ class ILParamsImpl : public ElemParams<IntType> {
    *
    * @param &rhs the input set of parameters which is copied.
    */
-  ILParamsImpl(const ILParamsImpl &&rhs) : ElemParams<IntType>(rhs) {}
+  ILParamsImpl(const ILParamsImpl &&rhs)
+      : ElemParams<IntType>(rhs), m_nttPlan(rhs.m_nttPlan) {}
 
   /**
    * @brief Standard Destructor method.
@@ -123,7 +130,25 @@ class ILParamsImpl : public ElemParams<IntType> {
     return ElemParams<IntType>::operator==(rhs);
   }
 
+  /**
+   * @brief Getter for the precomputed NTT tables of this modulus.
+   *
+   * @return the shared, immutable plan used by PolyImpl::SwitchFormat(), or
+   * nullptr if there is none (non-native integers, non-power-of-two
+   * cyclotomic orders, or no root of unity).
+   */
+  const std::shared_ptr<const NativeNTTPlan> &GetNTTPlan() const {
+    return m_nttPlan;
+  }
+
  private:
+  void InitNTTPlan() {
+    m_nttPlan = GetNativeNTTPlan(this->rootOfUnity, this->cyclotomicOrder,
+                                 this->ciphertextModulus);
+  }
+
+  std::shared_ptr<const NativeNTTPlan> m_nttPlan;
+
   std::ostream &doprint(std::ostream &out) const {
     out << "ILParams ";
     ElemParams<IntType>::doprint(out);
@@ -145,6 +170,7 @@ class ILParamsImpl : public ElemParams<IntType> {
                          " is from a later version of the library");
     }
     ar(::cereal::base_class<ElemParams<IntType>>(this));
+    InitNTTPlan();
   }
 
   std::string SerializedObjectName() const { return "ILParms"; }
@@ -496,6 +496,19 @@ class PolyImpl : public ILElement<PolyImpl<VecType>, VecType> {
    */
   PolyImpl Times(const PolyImpl &element) const;
 
+  /**
+   * @brief Computes the negacyclic product, i.e., the product in
+   * Z_q[X]/(X^n+1), of this element in Format::COEFFICIENT and another one.
+   * The result is the same as converting both to Format::EVALUATION, calling
+   * Times() and converting back, but for native power-of-two polynomials the
+   * transforms and the product run as one pipeline without intermediate
+   * vectors (see NativeNTTEngine::NegacyclicMultiply()).
+   *
+   * @param &element is the element to multiply with, in either format.
+   * @return is the result of the multiplication, in Format::COEFFICIENT.
+   */
+  PolyImpl NegacyclicMultiply(const PolyImpl &element) const;
+
   /**
    * @brief Performs += operation with a Integer and returns the result.
    *
@@ -552,6 +565,26 @@ class PolyImpl : public ILElement<PolyImpl<VecType>, VecType> {
    */
   const PolyImpl &operator*=(const PolyImpl &element);
 
+  /**
+   * @brief Fused multiply-accumulate: this += a * b, in Format::EVALUATION.
+   *
+   * @param &a, &b are the elements to multiply.
+   * @return is the result of the multiply-accumulate operation.
+   */
+  const PolyImpl &ModMulAddEq(const PolyImpl &a, const PolyImpl &b);
+
+  /**
+   * @brief Fused inner product: this += sum_j a[j] * b[j], in
+   * Format::EVALUATION. Native vectors accumulate all products before
+   * reducing (see NativeVector::ModMulAddEq()).
+   *
+   * @param &a, &b are the elements to multiply; both have the same number of
+   * entries and none of them may be this element.
+   * @return is the result of the multiply-accumulate operation.
+   */
+  const PolyImpl &ModMulAddEq(const std::vector<const PolyImpl *> &a,
+                              const std::vector<const PolyImpl *> &b);
+
   /**
    * @brief Equality operator compares this element to the input element.
    *
@@ -619,11 +652,25 @@ class PolyImpl : public ILElement<PolyImpl<VecType>, VecType> {
    * reversal indices.
    *
    * @param &i is the element to perform the automorphism transform with.
-   * @param &map a vector with precomputed indices
+   * @param &map a vector with precomputed indices, see
+   * GetAutomorphismPermutation()
    * @return is the result of the automorphism transform.
    */
   PolyImpl AutomorphismTransform(usint i, const std::vector<usint> &map) const;
 
+  /**
+   * @brief Performs the automorphism transform of the sum of this element and
+   * addend in one pass, without forming the sum.
+   *
+   * @param i is the element to perform the automorphism transform with.
+   * @param &map a vector with precomputed indices, see
+   * GetAutomorphismPermutation()
+   * @param &addend the element to add before the transform.
+   * @return is the result of the automorphism transform.
+   */
+  PolyImpl AutomorphismTransformSum(usint i, const std::vector<usint> &map,
+                                    const PolyImpl &addend) const;
+
   /**
    * @brief Interpolates based on the Chinese Remainder Transform Interpolation.
    * Does nothing for PolyImpl. Needed to support the linear CRT interpolation
@@ -685,12 +732,67 @@ class PolyImpl : public ILElement<PolyImpl<VecType>, VecType> {
                      const Integer &modulusArb = Integer(0),
                      const Integer &rootOfUnityArb = Integer(0));
 
+  /**
+   * @brief Switch modulus and adjust the values, taking existing parameters
+   * for the new modulus instead of creating them; unlike the above, this
+   * does not allocate.
+   *
+   * @param &params the parameters of the new modulus.
+   */
+  void SwitchModulus(const std::shared_ptr<Params> &params);
+
+  /**
+   * @brief Sets the format without converting the values, for callers that
+   * write the values in that format themselves.
+   *
+   * @param format the new format.
+   */
+  void OverrideFormat(Format format) { m_format = format; }
+
+  /**
+   * @brief Sets the parameters without converting the values, for callers
+   * that write the values for the new parameters themselves.
+   *
+   * @param &params the new parameters, of the same ring dimension.
+   */
+  void OverrideParams(const std::shared_ptr<Params> &params) {
+    if (m_values) m_values->SetModulus(params->GetModulus());
+    m_params = params;
+  }
+
   /**
    * @brief Convert from Coefficient to Format::EVALUATION or vice versa; calls
    * FFT and inverse FFT.
    */
   void SwitchFormat();
 
+  /**
+   * @brief Same as SwitchFormat(), with pruned transforms for polynomials
+   * whose coefficients are zero except at multiples of \p stride below
+   * \p degree, e.g., sparse embeddings of a smaller ring: the forward
+   * transform ignores the other coefficients and the inverse one only
+   * computes the coefficients at those positions (see
+   * NumberTheoreticTransform::ForwardTransformToBitReversePrunedInPlace()).
+   * For power-of-two cyclotomics the cost then scales with n/stride rather
+   * than n; other cyclotomics use the full transforms.
+   *
+   * @param stride a power of two that divides the ring dimension n.
+   * @param degree a bound in [1, n] on the indices of the nonzero
+   * coefficients.
+   */
+  void SwitchFormatPruned(usint stride, usint degree);
+
+  /**
+   * @brief Switches the format of several polynomials at once. For native
+   * polynomials the transforms are batched with
+   * NativeNTTPlan::ForwardTransformBatch(), which also splits single
+   * transforms across threads.
+   *
+   * @param &elements the polynomials to convert; each is switched
+   * independently of the format of the others.
+   */
+  static void SwitchFormat(const std::vector<PolyImpl *> &elements);
+
   /**
    * @brief Make the element values sparse. Sets every index not equal to zero
    * mod the wFactor to zero.
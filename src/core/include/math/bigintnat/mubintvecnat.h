@@ -397,6 +397,20 @@ class NativeVector
    */
   const NativeVector &ModSubEq(const NativeVector &b);
 
+  /**
+   * Modulus negation.
+   *
+   * @return is the result of the modulus negation operation.
+   */
+  NativeVector ModNegate() const;
+
+  /**
+   * Modulus negation. In-place variant.
+   *
+   * @return is the result of the modulus negation operation.
+   */
+  const NativeVector &ModNegateEq();
+
   /**
    * Scalar modular multiplication.
    * See the comments in the cpp files for details of the implementation.
@@ -431,6 +445,26 @@ class NativeVector
    */
   const NativeVector &ModMulEq(const NativeVector &b);
 
+  /**
+   * Fused modulus multiply-accumulate: this += a * b, element-wise.
+   *
+   * @param &a, &b are the vectors to multiply.
+   * @return is the result of the multiply-accumulate operation.
+   */
+  const NativeVector &ModMulAddEq(const NativeVector &a, const NativeVector &b);
+
+  /**
+   * Fused modulus inner product: this += sum_j a[j] * b[j], element-wise.
+   * The products are accumulated in 128-bit values and reduced only when
+   * needed, which is much cheaper than a ModMulEq and a ModAddEq per term.
+   *
+   * @param &a, &b are the vectors to multiply; both have the same number of
+   * entries and none of them may be this vector.
+   * @return is the result of the multiply-accumulate operation.
+   */
+  const NativeVector &ModMulAddEq(const std::vector<const NativeVector *> &a,
+                                  const std::vector<const NativeVector *> &b);
+
   /**
    * Vector multiplication without applying the modulus operation.
    *
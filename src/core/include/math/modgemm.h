@@ -0,0 +1,128 @@
+// @file modgemm.h Modular matrix products for RNS base conversion.
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef LBCRYPTO_MATH_MODGEMM_H
+#define LBCRYPTO_MATH_MODGEMM_H
+
+#include <cstdint>
+
+#include "math/backend.h"
+#include "utils/inttypes.h"
+
+namespace lbcrypto {
+
+#if defined(HAVE_INT128) && NATIVEINT == 64
+
+/**
+ * @brief Operands of a modular matrix product, the core of every fast base
+ * conversion of RNS polynomials:
+ *
+ *   out_j[k] = sum_i y_i[k] * weights[i * numOut + j] mod outModuli[j],
+ *
+ * where y_i[k] = [in_i[k] * scale[i]]_{inModuli[i]} if a scaling is given
+ * and y_i[k] = in_i[k] otherwise. Viewed as matrices, this is the
+ * (numOut x numIn) weight matrix times the (numIn x length) input matrix.
+ *
+ * The products are summed in 128 bits and every output value is reduced
+ * once, so numIn * max(y) * max(weights) must be below 2^128 (e.g., up to
+ * 256 inputs with 60-bit residues and weights). The output rows may not
+ * alias the input rows.
+ */
+struct ModGemmArgs {
+  // number of coefficients in every row
+  usint length = 0;
+  usint numIn = 0;
+  usint numOut = 0;
+
+  // the numIn input rows
+  const uint64_t *const *in = nullptr;
+  // optional scaling of the inputs by Shoup's method: either all three
+  // arrays (of numIn values, moduli below 2^62) or none are given
+  const uint64_t *inModuli = nullptr;
+  const uint64_t *scale = nullptr;
+  const uint64_t *scalePrecon = nullptr;
+
+  // the numIn x numOut weights, row-major
+  const uint64_t *weights = nullptr;
+
+  // the numOut output rows, their moduli and the constants 2^128 / modulus
+  // of BarrettUint128ModUint64()
+  uint64_t *const *out = nullptr;
+  const uint64_t *outModuli = nullptr;
+  const DoubleNativeInt *outBarrettMu = nullptr;
+};
+
+/**
+ * A modular matrix product kernel; see ModGemmArgs.
+ */
+typedef void (*ModGemmKernel)(const ModGemmArgs &args);
+
+/**
+ * @brief The modular matrix product kernel used by the base conversions of
+ * DCRTPolyImpl. The default kernel is TiledKernel(); SetKernel() plugs in
+ * another implementation, e.g., a platform-specific one.
+ */
+class ModGemm {
+ public:
+  /**
+   * Computes the product with the current kernel.
+   */
+  static void Multiply(const ModGemmArgs &args) { GetKernel()(args); }
+
+  /**
+   * @return the current kernel.
+   */
+  static ModGemmKernel GetKernel();
+
+  /**
+   * Replaces the kernel used by Multiply(); nullptr restores TiledKernel().
+   */
+  static void SetKernel(ModGemmKernel kernel);
+
+  /**
+   * Splits the coefficients into tiles of TILE_SIZE that are distributed
+   * over the OpenMP threads. The scaled inputs of a tile are kept in a
+   * per-thread buffer and every output row of the tile is accumulated with
+   * unit-stride passes over that buffer. On the SIMD_AVX512IFMA engine,
+   * scaled inputs with all moduli below 2^50 are multiplied with IFMA.
+   */
+  static void TiledKernel(const ModGemmArgs &args);
+
+  /**
+   * Computes the output values one coefficient at a time; this is the
+   * formulation the base conversions used before, kept as a reference for
+   * tests and benchmarks.
+   */
+  static void ReferenceKernel(const ModGemmArgs &args);
+
+  // number of coefficients in the tiles of TiledKernel(); a tile of up to
+  // ~30 input rows fits in the L2 cache
+  static const usint TILE_SIZE = 256;
+};
+
+#endif
+
+}  // namespace lbcrypto
+
+#endif
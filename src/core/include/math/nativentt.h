@@ -0,0 +1,305 @@
+// @file nativentt.h Vectorized number theoretic transforms on 64-bit native vectors
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LBCRYPTO_MATH_NATIVENTT_H
+#define LBCRYPTO_MATH_NATIVENTT_H
+
+#include <cstdint>
+#include <iostream>
+
+#include "utils/cpufeatures.h"
+#include "utils/inttypes.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief Lists the loop structures of the native transforms
+ */
+enum NTTAlgorithm {
+  NTT_AUTO = 0,    // NTT_BLOCKED for large rings, NTT_RADIX2 otherwise
+  NTT_RADIX2 = 1,  // one pass over the vector per stage
+  NTT_BLOCKED = 2  // radix-4 passes, then stages inside cache-sized blocks
+};
+
+inline std::ostream &operator<<(std::ostream &s, NTTAlgorithm a) {
+  switch (a) {
+    case NTT_AUTO:
+      s << "NTT_AUTO";
+      break;
+    case NTT_RADIX2:
+      s << "NTT_RADIX2";
+      break;
+    case NTT_BLOCKED:
+      s << "NTT_BLOCKED";
+      break;
+    default:
+      s << "UKNOWN";
+      break;
+  }
+  return s;
+}
+
+/**
+ * @brief Number theoretic transform kernels working directly on the uint64_t
+ * storage of 64-bit native vectors.
+ *
+ * The butterflies follow Harvey's lazy reduction strategy
+ * (https://arxiv.org/pdf/1205.2926.pdf): intermediate values are kept in
+ * [0,4q) (forward) or [0,2q) (inverse) and only reduced to [0,q) once at the
+ * end, so the modulus has to be smaller than 2^62. The multiplications by
+ * twiddle factors use Shoup's precomputations, i.e., the tables produced by
+ * NativeInteger::PrepModMulConst().
+ *
+ * Each call is dispatched to the engine selected in SIMDControls; the AVX2
+ * and AVX-512 engines vectorize every stage whose butterfly span is at least
+ * the vector width and run the remaining stages with the portable kernel.
+ *
+ * For large rings the radix-2 loop streams the whole vector through the
+ * cache once per stage. The blocked algorithm instead merges the first
+ * stages pairwise into radix-4 passes, which halves the number of sweeps over
+ * memory, until the vector splits into independent blocks of
+ * CACHE_BLOCK_SIZE coefficients; all the remaining stages of a block then run
+ * while it stays in the L1/L2 cache. The inverse transform mirrors these
+ * steps. Both algorithms produce identical outputs.
+ */
+class NativeNTTEngine {
+ public:
+  /**
+   * Largest modulus size (in bits) supported by the lazy reduction.
+   */
+  static const usint MAX_MODULUS_BITS = 61;
+
+  /**
+   * Number of coefficients of the blocks the blocked algorithm transforms
+   * in cache.
+   */
+  static const usint CACHE_BLOCK_SIZE = 1 << 12;
+
+  /**
+   * Smallest transform size for which NTT_AUTO selects the blocked
+   * algorithm.
+   */
+  static const usint BLOCKED_THRESHOLD = 1 << 15;
+
+  /**
+   * @return the algorithm currently used by the transforms (NTT_AUTO unless
+   * overridden).
+   */
+  static NTTAlgorithm GetAlgorithm();
+
+  /**
+   * Selects the algorithm used by the transforms, e.g., to compare them in
+   * benchmarks. NTT_AUTO restores the default choice based on the ring
+   * dimension.
+   *
+   * @param algorithm the algorithm to use.
+   */
+  static void SetAlgorithm(NTTAlgorithm algorithm);
+
+  /**
+   * In-place forward transform in the ring Z_q[X]/(X^n+1), using the same
+   * bit-reversed conventions as
+   * NumberTheoreticTransform::ForwardTransformToBitReverseInPlace().
+   *
+   * @param rootOfUnityTable n-th roots of unity in bit-reversed order.
+   * @param preconRootOfUnityTable Shoup's precomputations for the table.
+   * @param modulus the prime modulus q < 2^61.
+   * @param n the transform size (a power of two).
+   * @param[in,out] element the n coefficients in [0,q).
+   */
+  static void ForwardTransformToBitReverseInPlace(
+      const uint64_t *rootOfUnityTable, const uint64_t *preconRootOfUnityTable,
+      uint64_t modulus, usint n, uint64_t *element);
+
+  /**
+   * In-place inverse transform in the ring Z_q[X]/(X^n+1), using the same
+   * bit-reversed conventions as
+   * NumberTheoreticTransform::InverseTransformFromBitReverseInPlace().
+   *
+   * @param rootOfUnityInverseTable inverse roots of unity in bit-reversed
+   * order.
+   * @param preconRootOfUnityInverseTable Shoup's precomputations for the
+   * table.
+   * @param cycloOrderInv n^{-1} mod q.
+   * @param preconCycloOrderInv Shoup's precomputation for n^{-1}.
+   * @param modulus the prime modulus q < 2^61.
+   * @param n the transform size (a power of two).
+   * @param[in,out] element the n values in [0,q).
+   */
+  static void InverseTransformFromBitReverseInPlace(
+      const uint64_t *rootOfUnityInverseTable,
+      const uint64_t *preconRootOfUnityInverseTable, uint64_t cycloOrderInv,
+      uint64_t preconCycloOrderInv, uint64_t modulus, usint n,
+      uint64_t *element);
+
+  /**
+   * Same as above, but dispatched to an explicitly given engine instead of
+   * the one selected in SIMDControls. Used by tests and benchmarks.
+   */
+  static void ForwardTransformToBitReverseInPlace(
+      SIMDEngine engine, const uint64_t *rootOfUnityTable,
+      const uint64_t *preconRootOfUnityTable, uint64_t modulus, usint n,
+      uint64_t *element);
+
+  static void InverseTransformFromBitReverseInPlace(
+      SIMDEngine engine, const uint64_t *rootOfUnityInverseTable,
+      const uint64_t *preconRootOfUnityInverseTable, uint64_t cycloOrderInv,
+      uint64_t preconCycloOrderInv, uint64_t modulus, usint n,
+      uint64_t *element);
+
+  /**
+   * Negacyclic product element * other in Z_q[X]/(X^n+1), i.e., forward
+   * transform, pointwise product and inverse transform in one call. The last
+   * forward stage, the product and the first inverse stage are done in a
+   * single pass over the coefficients, and with the blocked algorithm every
+   * cache block is multiplied as soon as its forward stages are done, so
+   * that no intermediate vector makes a round trip through memory.
+   *
+   * @param rootOfUnityTable, preconRootOfUnityTable, rootOfUnityInverseTable,
+   * preconRootOfUnityInverseTable, cycloOrderInv, preconCycloOrderInv the
+   * tables of the forward and inverse transforms (see above).
+   * @param modulus the prime modulus q < 2^61.
+   * @param n the transform size (a power of two).
+   * @param otherTransformed true if \p other is already in evaluation
+   * representation.
+   * @param other the n values of the second operand in [0,q).
+   * @param[in,out] element the n coefficients of the first operand in [0,q),
+   * replaced with the coefficients of the product.
+   */
+  static void NegacyclicMultiply(const uint64_t *rootOfUnityTable,
+                                 const uint64_t *preconRootOfUnityTable,
+                                 const uint64_t *rootOfUnityInverseTable,
+                                 const uint64_t *preconRootOfUnityInverseTable,
+                                 uint64_t cycloOrderInv,
+                                 uint64_t preconCycloOrderInv,
+                                 uint64_t modulus, usint n,
+                                 bool otherTransformed,
+                                 const uint64_t *other, uint64_t *element);
+
+  /**
+   * @return true if \p stride and \p degree describe a valid zero structure
+   * for the pruned transforms of size \p n below.
+   */
+  static bool IsValidPruning(usint n, usint stride, usint degree) {
+    return stride != 0 && (stride & (stride - 1)) == 0 && n % stride == 0 &&
+           degree != 0 && degree <= n;
+  }
+
+  /**
+   * Pruned forward transform of an input whose only nonzero coefficients
+   * sit at multiples of \p stride below \p degree (e.g., a sparse embedding
+   * of a smaller ring, or a low-degree polynomial); the other coefficients
+   * are ignored. With D the smallest power of two >= max(stride, degree),
+   * the first log2(n/D) stages only copy values and the last log2(stride)
+   * stages only duplicate them, so just the (n/stride) * log2(D/stride)
+   * butterflies in between are computed, on a compacted copy of each block.
+   *
+   * @param stride a power of two that divides n.
+   * @param degree a bound in [1, n] on the degree of the input plus one.
+   * @see ForwardTransformToBitReverseInPlace() for the other parameters.
+   */
+  static void ForwardTransformToBitReversePrunedInPlace(
+      const uint64_t *rootOfUnityTable, const uint64_t *preconRootOfUnityTable,
+      uint64_t modulus, usint n, usint stride, usint degree,
+      uint64_t *element);
+
+  /**
+   * Pruned inverse transform that only computes the coefficients at
+   * multiples of \p stride below D (see above), which includes all those
+   * below \p degree, and sets all others to zero. Mirroring the forward
+   * case, the first log2(stride) stages reduce to sums of stride values and
+   * the last log2(n/D) stages to sums of the n/D blocks.
+   *
+   * @see InverseTransformFromBitReverseInPlace() for the other parameters.
+   */
+  static void InverseTransformFromBitReversePrunedInPlace(
+      const uint64_t *rootOfUnityInverseTable,
+      const uint64_t *preconRootOfUnityInverseTable, uint64_t cycloOrderInv,
+      uint64_t preconCycloOrderInv, uint64_t modulus, usint n, usint stride,
+      usint degree, uint64_t *element);
+
+  // Building blocks for splitting one transform among several threads
+  // (see NativeNTTPlan::ForwardTransformBatch()). After the first log2(B)
+  // stages of the forward transform, the vector consists of B independent
+  // blocks of n/B coefficients; the inverse transform runs the same steps in
+  // reverse order. So a forward transform split into B blocks is
+  //   for m = 1, 2, ..., B/2: ForwardTransformStageSlice() over [0, n/(2m))
+  //   for b = 0, ..., B-1: ForwardTransformBlock()
+  // and an inverse one is
+  //   for b = 0, ..., B-1: InverseTransformBlock()
+  //   for m = B/2, ..., 2, 1: InverseTransformStageSlice() over [0, n/(2m))
+  //   InverseTransformScale() over [0, n)
+  // where the calls inside each step are independent of each other. The
+  // slices are best kept at multiples of 8 so that they stay vectorized.
+
+  /**
+   * Runs the butterflies with offsets [begin, end) of every group of the
+   * forward stage with m groups (each group spans n/m coefficients).
+   * Values stay in [0,4q).
+   */
+  static void ForwardTransformStageSlice(const uint64_t *rootOfUnityTable,
+                                         const uint64_t *preconRootOfUnityTable,
+                                         uint64_t modulus, usint n, usint m,
+                                         usint begin, usint end,
+                                         uint64_t *element);
+
+  /**
+   * Runs the remaining forward stages on block \p block of \p numBlocks and
+   * reduces its coefficients to [0,q).
+   */
+  static void ForwardTransformBlock(const uint64_t *rootOfUnityTable,
+                                    const uint64_t *preconRootOfUnityTable,
+                                    uint64_t modulus, usint n, usint numBlocks,
+                                    usint block, uint64_t *element);
+
+  /**
+   * Runs the first inverse stages (those with at least \p numBlocks groups)
+   * on block \p block of \p numBlocks. Values are left in [0,2q).
+   */
+  static void InverseTransformBlock(
+      const uint64_t *rootOfUnityInverseTable,
+      const uint64_t *preconRootOfUnityInverseTable, uint64_t modulus, usint n,
+      usint numBlocks, usint block, uint64_t *element);
+
+  /**
+   * Runs the butterflies with offsets [begin, end) of every group of the
+   * inverse stage with m groups. Values stay in [0,2q).
+   */
+  static void InverseTransformStageSlice(
+      const uint64_t *rootOfUnityInverseTable,
+      const uint64_t *preconRootOfUnityInverseTable, uint64_t modulus, usint n,
+      usint m, usint begin, usint end, uint64_t *element);
+
+  /**
+   * Multiplies the coefficients [begin, end) by n^{-1} and reduces them to
+   * [0,q), which completes the inverse transform.
+   */
+  static void InverseTransformScale(uint64_t cycloOrderInv,
+                                    uint64_t preconCycloOrderInv,
+                                    uint64_t modulus, usint begin, usint end,
+                                    uint64_t *element);
+};
+
+}  // namespace lbcrypto
+
+#endif
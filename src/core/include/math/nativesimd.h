@@ -0,0 +1,356 @@
+// @file nativesimd.h Modular arithmetic primitives shared by the native kernels
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LBCRYPTO_MATH_NATIVESIMD_H
+#define LBCRYPTO_MATH_NATIVESIMD_H
+
+#include <cstdint>
+
+#include "config_core.h"
+#include "utils/cpufeatures.h"
+
+#ifdef PALISADE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace lbcrypto {
+
+/**
+ * Building blocks of the vectorized kernels on 64-bit native vectors (the
+ * NTT engine and the element-wise vector arithmetic). They are not meant to
+ * be used outside of these kernels.
+ */
+namespace nativesimd {
+
+inline uint64_t MulHi64(uint64_t a, uint64_t b) {
+#if defined(HAVE_INT128)
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+  uint64_t aLo = static_cast<uint32_t>(a), aHi = a >> 32;
+  uint64_t bLo = static_cast<uint32_t>(b), bHi = b >> 32;
+  uint64_t loHi = aLo * bHi, hiLo = aHi * bLo;
+  uint64_t cross = ((aLo * bLo) >> 32) + static_cast<uint32_t>(loHi) +
+                   static_cast<uint32_t>(hiLo);
+  return aHi * bHi + (loHi >> 32) + (hiLo >> 32) + (cross >> 32);
+#endif
+}
+
+// Shoup's modular multiplication by a constant w with precomputation wPrecon;
+// the result is in [0,2q) for any 64-bit x
+inline uint64_t MulShoupLazy(uint64_t x, uint64_t w, uint64_t wPrecon,
+                             uint64_t q) {
+  return w * x - MulHi64(wPrecon, x) * q;
+}
+
+inline uint64_t ReduceOnce(uint64_t x, uint64_t bound) {
+  return (x >= bound) ? x - bound : x;
+}
+
+// floor((2^128 - 1) / q), i.e., floor(2^128 / q) unless q is a power of two,
+// for Barrett reduction of 128-bit values
+struct BarrettRatio {
+  uint64_t hi;
+  uint64_t lo;
+};
+
+inline BarrettRatio ComputeBarrettRatio(uint64_t q) {
+  BarrettRatio r;
+#if defined(HAVE_INT128)
+  unsigned __int128 ratio = ~static_cast<unsigned __int128>(0) / q;
+  r.hi = static_cast<uint64_t>(ratio >> 64);
+  r.lo = static_cast<uint64_t>(ratio);
+#else
+  r.hi = ~uint64_t(0) / q;
+  uint64_t rem = ~uint64_t(0) % q;
+  r.lo = 0;
+  for (int bit = 63; bit >= 0; --bit) {
+    bool carry = (rem >> 63) != 0;
+    rem = (rem << 1) | 1;
+    if (carry || rem >= q) {
+      rem -= q;
+      r.lo |= uint64_t(1) << bit;
+    }
+  }
+#endif
+  return r;
+}
+
+// the quotient estimate floor((hi:lo) * (r.hi:r.lo) / 2^128); for hi < q it
+// fits in 64 bits and is at most two below floor((hi:lo) / q)
+inline uint64_t BarrettQuotient(uint64_t lo, uint64_t hi,
+                                const BarrettRatio &r) {
+  uint64_t carry = MulHi64(lo, r.lo);
+  uint64_t mid = lo * r.hi;
+  uint64_t sum = mid + carry;
+  uint64_t upper = MulHi64(lo, r.hi) + (sum < mid);
+  uint64_t cross = hi * r.lo;
+  uint64_t sum2 = sum + cross;
+  carry = MulHi64(hi, r.lo) + (sum2 < cross);
+  return hi * r.hi + upper + carry;
+}
+
+// (hi * 2^64 + lo) mod q for hi < q < 2^62
+inline uint64_t ReduceWide(uint64_t lo, uint64_t hi, uint64_t q,
+                           const BarrettRatio &r) {
+  uint64_t rem = lo - BarrettQuotient(lo, hi, r) * q;
+  return ReduceOnce(ReduceOnce(rem, q << 1), q);
+}
+
+// Moduli below this bound have a 52-bit fast path: the lazily reduced values
+// of the kernels (below 4q) fit in 52 bits, which is what the AVX-512 IFMA
+// multipliers take and what a double holds exactly, so the AVX2 engine
+// multiplies in double precision with FMA and the AVX-512 IFMA engine with
+// IFMA
+const uint64_t SMALL_MODULUS_BOUND = uint64_t(1) << 50;
+
+inline bool IsSmallModulus(uint64_t q) { return q < SMALL_MODULUS_BOUND; }
+
+#ifdef PALISADE_SIMD_X86
+
+// AVX2 has no 64-bit multiplier, so the products are assembled from
+// 32x32-bit partial products; all values stay below 2^63, which allows the
+// signed 64-bit comparison
+
+PALISADE_TARGET_AVX2 inline __m256i MulHi64AVX2(__m256i a, __m256i b) {
+  const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+  __m256i aHi = _mm256_srli_epi64(a, 32);
+  __m256i bHi = _mm256_srli_epi64(b, 32);
+  __m256i loLo = _mm256_mul_epu32(a, b);
+  __m256i loHi = _mm256_mul_epu32(a, bHi);
+  __m256i hiLo = _mm256_mul_epu32(aHi, b);
+  __m256i hiHi = _mm256_mul_epu32(aHi, bHi);
+  __m256i cross = _mm256_add_epi64(_mm256_srli_epi64(loLo, 32),
+                                   _mm256_and_si256(loHi, mask));
+  cross = _mm256_add_epi64(cross, _mm256_and_si256(hiLo, mask));
+  __m256i hi = _mm256_add_epi64(hiHi, _mm256_srli_epi64(loHi, 32));
+  hi = _mm256_add_epi64(hi, _mm256_srli_epi64(hiLo, 32));
+  return _mm256_add_epi64(hi, _mm256_srli_epi64(cross, 32));
+}
+
+PALISADE_TARGET_AVX2 inline __m256i MulLo64AVX2(__m256i a, __m256i b) {
+  __m256i loLo = _mm256_mul_epu32(a, b);
+  __m256i loHi = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+  __m256i hiLo = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+  return _mm256_add_epi64(
+      loLo, _mm256_slli_epi64(_mm256_add_epi64(loHi, hiLo), 32));
+}
+
+PALISADE_TARGET_AVX2 inline __m256i ReduceOnceAVX2(__m256i x,
+                                                   __m256i bound) {
+  __m256i diff = _mm256_sub_epi64(x, bound);
+  __m256i isNeg = _mm256_cmpgt_epi64(_mm256_setzero_si256(), diff);
+  return _mm256_blendv_epi8(diff, x, isNeg);
+}
+
+PALISADE_TARGET_AVX2 inline __m256i MulShoupLazyAVX2(__m256i x, __m256i w,
+                                                     __m256i wPrecon,
+                                                     __m256i q) {
+  __m256i quot = MulHi64AVX2(wPrecon, x);
+  return _mm256_sub_epi64(MulLo64AVX2(w, x), MulLo64AVX2(quot, q));
+}
+
+PALISADE_TARGET_AVX2 inline __m256i LoadAVX2(const uint64_t *p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+PALISADE_TARGET_AVX2 inline void StoreAVX2(uint64_t *p, __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+// The double-precision path: an integer below 2^52 is converted exactly by
+// placing it in the mantissa of 2^52, the product x * y is split exactly into
+// h + l with FMA, and the quotient by q is estimated from a floating-point
+// product; the remainder h - c * q + l is then an exact integer below 2^52 in
+// absolute value, which is brought into range by adding or subtracting q
+
+PALISADE_TARGET_AVX2 inline __m256d ToDoubleAVX2(__m256i x) {
+  const __m256d two52 = _mm256_set1_pd(4503599627370496.0);
+  return _mm256_sub_pd(
+      _mm256_castsi256_pd(_mm256_or_si256(x, _mm256_castpd_si256(two52))),
+      two52);
+}
+
+PALISADE_TARGET_AVX2 inline __m256i ToIntAVX2(__m256d x) {
+  const __m256d two52 = _mm256_set1_pd(4503599627370496.0);
+  return _mm256_xor_si256(_mm256_castpd_si256(_mm256_add_pd(x, two52)),
+                          _mm256_castpd_si256(two52));
+}
+
+// x * y mod q in [0,q) for x, y < q < 2^50 and qInv = 1/q; the estimate of
+// the quotient is off by at most one
+PALISADE_TARGET_AVX2 inline __m256d MulModFMA(__m256d x, __m256d y,
+                                              __m256d q, __m256d qInv) {
+  __m256d h = _mm256_mul_pd(x, y);
+  __m256d l = _mm256_fmsub_pd(x, y, h);
+  __m256d c = _mm256_round_pd(_mm256_mul_pd(h, qInv),
+                              _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  __m256d r = _mm256_add_pd(_mm256_fnmadd_pd(c, q, h), l);
+  r = _mm256_add_pd(
+      r, _mm256_and_pd(_mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ), q));
+  return _mm256_sub_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, q, _CMP_GE_OQ), q));
+}
+
+// the double-precision counterpart of Shoup's multiplication: x * w mod q in
+// [0,2q) for x < 4q, w < q < 2^50 and wRatio ~ w/q, the Shoup precomputation
+// scaled by 2^-64; the rounded quotient estimate is off by less than two
+PALISADE_TARGET_AVX2 inline __m256d MulShoupLazyFMA(__m256d x, __m256d w,
+                                                    __m256d wRatio,
+                                                    __m256d twoQ,
+                                                    __m256d q) {
+  __m256d h = _mm256_mul_pd(x, w);
+  __m256d l = _mm256_fmsub_pd(x, w, h);
+  __m256d c = _mm256_round_pd(_mm256_mul_pd(x, wRatio),
+                              _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256d r = _mm256_add_pd(_mm256_fnmadd_pd(c, q, h), l);
+  return _mm256_add_pd(
+      r,
+      _mm256_and_pd(_mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ), twoQ));
+}
+
+// the scale factor from a Shoup precomputation to the ratio w/q
+const double SHOUP_TO_RATIO = 1.0 / 18446744073709551616.0;
+
+// AVX-512DQ provides the low 64-bit product; the high half is still
+// assembled from 32x32-bit partial products
+
+// GCC reports the self-initialized value behind _mm512_undefined_epi32() used
+// by the AVX-512 intrinsics as possibly uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+PALISADE_TARGET_AVX512 inline __m512i MulHi64AVX512(__m512i a, __m512i b) {
+  const __m512i mask = _mm512_set1_epi64(0xffffffff);
+  __m512i aHi = _mm512_srli_epi64(a, 32);
+  __m512i bHi = _mm512_srli_epi64(b, 32);
+  __m512i loLo = _mm512_mul_epu32(a, b);
+  __m512i loHi = _mm512_mul_epu32(a, bHi);
+  __m512i hiLo = _mm512_mul_epu32(aHi, b);
+  __m512i hiHi = _mm512_mul_epu32(aHi, bHi);
+  __m512i cross = _mm512_add_epi64(_mm512_srli_epi64(loLo, 32),
+                                   _mm512_and_si512(loHi, mask));
+  cross = _mm512_add_epi64(cross, _mm512_and_si512(hiLo, mask));
+  __m512i hi = _mm512_add_epi64(hiHi, _mm512_srli_epi64(loHi, 32));
+  hi = _mm512_add_epi64(hi, _mm512_srli_epi64(hiLo, 32));
+  return _mm512_add_epi64(hi, _mm512_srli_epi64(cross, 32));
+}
+
+// x - bound wraps around for x < bound, so the unsigned minimum selects the
+// reduced value
+PALISADE_TARGET_AVX512 inline __m512i ReduceOnceAVX512(__m512i x,
+                                                       __m512i bound) {
+  return _mm512_min_epu64(x, _mm512_sub_epi64(x, bound));
+}
+
+PALISADE_TARGET_AVX512 inline __m512i MulShoupLazyAVX512(__m512i x,
+                                                         __m512i w,
+                                                         __m512i wPrecon,
+                                                         __m512i q) {
+  __m512i quot = MulHi64AVX512(wPrecon, x);
+  return _mm512_sub_epi64(_mm512_mullo_epi64(w, x),
+                          _mm512_mullo_epi64(quot, q));
+}
+
+#ifdef WITH_NATIVE_IFMA
+
+// AVX-512 IFMA multiplies the low 52 bits of the lanes and adds the low
+// (madd52lo) or high (madd52hi) 52 bits of the 104-bit product to the
+// accumulator; all operands of the helpers below are under 2^52
+
+PALISADE_TARGET_AVX512IFMA inline __m512i Mask52IFMA() {
+  return _mm512_set1_epi64((uint64_t(1) << 52) - 1);
+}
+
+// Shoup's multiplication with the 52-bit precomputation floor(w * 2^52 / q),
+// i.e., the 64-bit one shifted right by 12 bits: the result is in [0,2q) for
+// x < 2^52, so the subtraction of quot * q can be done modulo 2^52 by adding
+// quot * negQ with negQ = 2^52 - q
+PALISADE_TARGET_AVX512IFMA inline __m512i MulShoupLazyIFMA(__m512i x,
+                                                           __m512i w,
+                                                           __m512i wPrecon52,
+                                                           __m512i negQ) {
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i quot = _mm512_madd52hi_epu64(zero, x, wPrecon52);
+  __m512i r = _mm512_madd52lo_epu64(zero, x, w);
+  r = _mm512_madd52lo_epu64(r, quot, negQ);
+  return _mm512_and_si512(r, Mask52IFMA());
+}
+
+// Barrett reduction on 52-bit limbs for q < 2^50 of bit length n: with
+// mu = floor(2^(2n) / q) the quotient estimate of a product below q^2 is at
+// most two below the exact one
+struct BarrettIFMA {
+  __m512i q;
+  __m512i negQ;
+  __m512i mu;
+  __m128i shiftLo;    // n - 1
+  __m128i shiftHi;    // 53 - n
+  __m128i shiftMuLo;  // n + 1
+  __m128i shiftMuHi;  // 51 - n
+};
+
+PALISADE_TARGET_AVX512IFMA inline BarrettIFMA ComputeBarrettIFMA(uint64_t q) {
+  int n = 64 - __builtin_clzll(q);
+  BarrettIFMA b;
+  b.q = _mm512_set1_epi64(q);
+  b.negQ = _mm512_set1_epi64((uint64_t(1) << 52) - q);
+  b.mu = _mm512_set1_epi64(
+      static_cast<uint64_t>((static_cast<unsigned __int128>(1) << (2 * n)) / q));
+  b.shiftLo = _mm_cvtsi32_si128(n - 1);
+  b.shiftHi = _mm_cvtsi32_si128(53 - n);
+  b.shiftMuLo = _mm_cvtsi32_si128(n + 1);
+  b.shiftMuHi = _mm_cvtsi32_si128(51 - n);
+  return b;
+}
+
+// x * y mod q in [0,q) for x, y < q
+PALISADE_TARGET_AVX512IFMA inline __m512i MulModIFMA(__m512i x, __m512i y,
+                                                     const BarrettIFMA &b) {
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i lo = _mm512_madd52lo_epu64(zero, x, y);
+  __m512i hi = _mm512_madd52hi_epu64(zero, x, y);
+  __m512i c = _mm512_or_si512(_mm512_srl_epi64(lo, b.shiftLo),
+                              _mm512_sll_epi64(hi, b.shiftHi));
+  __m512i cLo = _mm512_madd52lo_epu64(zero, c, b.mu);
+  __m512i cHi = _mm512_madd52hi_epu64(zero, c, b.mu);
+  c = _mm512_or_si512(_mm512_srl_epi64(cLo, b.shiftMuLo),
+                      _mm512_sll_epi64(cHi, b.shiftMuHi));
+  __m512i r =
+      _mm512_and_si512(_mm512_madd52lo_epu64(lo, c, b.negQ), Mask52IFMA());
+  return ReduceOnceAVX512(ReduceOnceAVX512(r, b.q), b.q);
+}
+
+#endif  // WITH_NATIVE_IFMA
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // PALISADE_SIMD_X86
+
+}  // namespace nativesimd
+
+}  // namespace lbcrypto
+
+#endif
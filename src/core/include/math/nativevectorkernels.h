@@ -0,0 +1,149 @@
+// @file nativevectorkernels.h Vectorized element-wise arithmetic on 64-bit native vectors
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LBCRYPTO_MATH_NATIVEVECTORKERNELS_H
+#define LBCRYPTO_MATH_NATIVEVECTORKERNELS_H
+
+#include <cstdint>
+
+#include "utils/cpufeatures.h"
+#include "utils/inttypes.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief Element-wise modular arithmetic working directly on the uint64_t
+ * storage of 64-bit native vectors; NativeVector uses these kernels for its
+ * modular operations in builds with 64-bit native integers.
+ *
+ * Each call is dispatched to the engine selected in SIMDControls. The inputs
+ * are reduced, i.e., in [0,q), unless stated otherwise, the outputs are
+ * always reduced, and the moduli have to be smaller than 2^60
+ * (MAX_MODULUS_SIZE). The result may alias any of the inputs.
+ */
+class NativeVectorKernels {
+ public:
+  /**
+   * result[i] = a[i] + b[i] mod q.
+   */
+  static void ModAdd(const uint64_t *a, const uint64_t *b, uint64_t *result,
+                     usint n, uint64_t modulus);
+
+  /**
+   * result[i] = a[i] + b mod q.
+   */
+  static void ModAddScalar(const uint64_t *a, uint64_t b, uint64_t *result,
+                           usint n, uint64_t modulus);
+
+  /**
+   * result[i] = a[i] - b[i] mod q.
+   */
+  static void ModSub(const uint64_t *a, const uint64_t *b, uint64_t *result,
+                     usint n, uint64_t modulus);
+
+  /**
+   * result[i] = a[i] - b mod q.
+   */
+  static void ModSubScalar(const uint64_t *a, uint64_t b, uint64_t *result,
+                           usint n, uint64_t modulus);
+
+  /**
+   * result[i] = -a[i] mod q.
+   */
+  static void ModNegate(const uint64_t *a, uint64_t *result, usint n,
+                        uint64_t modulus);
+
+  /**
+   * result[i] = a[i] * b[i] mod q with the generalized Barrett reduction of
+   * NativeInteger::ModMulFast().
+   *
+   * @param mu the Barrett constant, i.e., NativeInteger::ComputeMu() of the
+   * modulus.
+   */
+  static void ModMul(const uint64_t *a, const uint64_t *b, uint64_t *result,
+                     usint n, uint64_t modulus, uint64_t mu);
+
+  /**
+   * result[i] = a[i] * b mod q with Shoup's multiplication by a constant.
+   *
+   * @param bPrecon the precomputation NativeInteger::PrepModMulConst() of b.
+   */
+  static void ModMulScalar(const uint64_t *a, uint64_t b, uint64_t bPrecon,
+                           uint64_t *result, usint n, uint64_t modulus);
+
+  /**
+   * Multiply-accumulate of k vector pairs: result[i] += sum_j a[j][i] *
+   * b[j][i] mod q. The products are summed in 128-bit accumulators, which
+   * are reduced once for every 2^64/q - 1 terms (i.e., at least 15 terms
+   * for moduli below 2^60) instead of once per product and addition.
+   *
+   * @param a, b the k vectors of each operand; the result may not alias
+   * any of them.
+   * @param k the number of vector pairs.
+   * @param[in,out] result the accumulated values.
+   */
+  static void ModMulAdd(const uint64_t *const *a, const uint64_t *const *b,
+                        usint k, uint64_t *result, usint n, uint64_t modulus);
+
+  /**
+   * Maps values in [0,oldModulus) to newModulus with the centered convention
+   * of NativeVector::SwitchModulus(): a[i] > oldModulus/2 is treated as
+   * a[i] - oldModulus. If the new modulus is larger, the outputs are
+   * in [0,newModulus); otherwise they are reduced from any input below 2^63.
+   */
+  static void SwitchModulus(const uint64_t *a, uint64_t *result, usint n,
+                            uint64_t oldModulus, uint64_t newModulus);
+
+  /**
+   * result[i] = SwitchModulus(a)[i] * b mod newModulus, in one pass over
+   * blocks that stay in the L1 cache.
+   *
+   * @param bPrecon the precomputation NativeInteger::PrepModMulConst() of b
+   * for the new modulus.
+   */
+  static void SwitchModulusAndScale(const uint64_t *a, uint64_t *result,
+                                    usint n, uint64_t oldModulus,
+                                    uint64_t newModulus, uint64_t b,
+                                    uint64_t bPrecon);
+
+  /**
+   * result[i] = a[i] * b + c[i] mod q, in one pass over blocks that stay in
+   * the L1 cache.
+   *
+   * @param bPrecon the precomputation NativeInteger::PrepModMulConst() of b.
+   */
+  static void ModMulScalarAdd(const uint64_t *a, uint64_t b, uint64_t bPrecon,
+                              const uint64_t *c, uint64_t *result, usint n,
+                              uint64_t modulus);
+
+  /**
+   * result[i] = a[i] mod 2 with the centered convention of
+   * NativeVector::ModByTwo().
+   */
+  static void ModByTwo(const uint64_t *a, uint64_t *result, usint n,
+                       uint64_t modulus);
+};
+
+}  // namespace lbcrypto
+
+#endif
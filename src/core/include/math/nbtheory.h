@@ -501,6 +501,19 @@ uint32_t FindAutomorphismIndexCyclic(int32_t i, uint32_t m, uint32_t g);
  */
 void PrecomputeAutoMap(uint32_t n, uint32_t k, std::vector<uint32_t> *precomp);
 
+/**
+ * Get the slot permutation of the automorphism X -> X^k in the EVALUATION
+ * representation of the m-th cyclotomic ring: slot j of the transformed
+ * element holds slot perm[j] of the input. The permutation depends only on m
+ * and k, so it is computed once and shared by all towers and parameter sets
+ * of cyclotomic order m.
+ * @param m cyclotomic order
+ * @param k automorphism index, coprime to m
+ * @return the cached permutation
+ */
+const std::vector<uint32_t> &GetAutomorphismPermutation(uint32_t m,
+                                                        uint32_t k);
+
 }  // namespace lbcrypto
 
 #endif
@@ -0,0 +1,344 @@
+// @file nttplan.h Immutable per-modulus precomputations for the native NTT.
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LBCRYPTO_MATH_NTTPLAN_H
+#define LBCRYPTO_MATH_NTTPLAN_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "math/backend.h"
+#include "utils/inttypes.h"
+
+#ifdef WITH_INTEL_HEXL
+#include "hexl/hexl.hpp"
+#endif
+
+namespace lbcrypto {
+
+/**
+ * @brief Precomputed, immutable tables for the negacyclic NTT modulo a single
+ * native prime q, i.e., in Z_q[X]/(X^n+1) with n = cycloOrder/2.
+ *
+ * The bit-reversed forward and inverse twiddle factors and their Shoup
+ * precomputations are stored back to back in one 64-byte aligned block,
+ * together with n^{-1} mod q. Since a plan never changes after construction,
+ * it can be shared by any number of parameter objects and threads, and
+ * transforming with it needs neither a table lookup nor a lock. Plans are
+ * attached to ILNativeParams (and hence to every tower of ILDCRTParams), see
+ * ILParamsImpl::GetNTTPlan().
+ */
+class NativeNTTPlan {
+ public:
+  /**
+   * Builds the tables for the given (power-of-two) cyclotomic order.
+   *
+   * @param &rootOfUnity a primitive cycloOrder-th root of unity modulo q.
+   * @param cycloOrder the cyclotomic order 2n.
+   * @param &modulus the prime modulus q.
+   */
+  NativeNTTPlan(const NativeInteger &rootOfUnity, usint cycloOrder,
+                const NativeInteger &modulus);
+
+  NativeNTTPlan(const NativeNTTPlan &) = delete;
+  NativeNTTPlan &operator=(const NativeNTTPlan &) = delete;
+
+  /**
+   * Returns the shared plan for the given parameters, building it on first
+   * use. Plans are only created for power-of-two cyclotomic orders, moduli
+   * q = 1 mod cycloOrder and nontrivial roots of unity in [0,q); nullptr is
+   * returned otherwise.
+   *
+   * The lookup is meant to be done once, when parameters are created; the
+   * transforms themselves only dereference the returned plan.
+   */
+  static std::shared_ptr<const NativeNTTPlan> Get(
+      const NativeInteger &rootOfUnity, usint cycloOrder,
+      const NativeInteger &modulus);
+
+  const NativeInteger &GetModulus() const { return m_modulus; }
+  const NativeInteger &GetRootOfUnity() const { return m_rootOfUnity; }
+  usint GetCyclotomicOrder() const { return m_cycloOrder; }
+  usint GetRingDimension() const { return m_cycloOrder >> 1; }
+
+  /**
+   * In-place forward transform, with the same conventions as
+   * ChineseRemainderTransformFTT::ForwardTransformToBitReverseInPlace().
+   *
+   * @param[in,out] *element a vector of length n modulo q.
+   */
+  void ForwardTransformToBitReverseInPlace(NativeVector *element) const;
+
+  /**
+   * In-place inverse transform, with the same conventions as
+   * ChineseRemainderTransformFTT::InverseTransformFromBitReverseInPlace().
+   *
+   * @param[in,out] *element a vector of length n modulo q.
+   */
+  void InverseTransformFromBitReverseInPlace(NativeVector *element) const;
+
+  /**
+   * Pruned forward transform of a vector whose only nonzero coefficients are
+   * at multiples of \p stride below \p degree, see
+   * NumberTheoreticTransform::ForwardTransformToBitReversePrunedInPlace().
+   */
+  void ForwardTransformToBitReversePrunedInPlace(usint stride, usint degree,
+                                                 NativeVector *element) const;
+
+  /**
+   * Pruned inverse transform that only computes the coefficients at
+   * multiples of \p stride below \p degree, see
+   * NumberTheoreticTransform::InverseTransformFromBitReversePrunedInPlace().
+   */
+  void InverseTransformFromBitReversePrunedInPlace(usint stride, usint degree,
+                                                   NativeVector *element) const;
+
+  /**
+   * In-place negacyclic product of two vectors of coefficients, i.e., forward
+   * transform, pointwise product and inverse transform fused into one
+   * pipeline (see NativeNTTEngine::NegacyclicMultiply()).
+   *
+   * @param[in,out] *element the coefficients of the first operand, replaced
+   * with those of the product.
+   * @param &other the second operand.
+   * @param otherTransformed true if \p other is in evaluation representation
+   * rather than in coefficient representation.
+   */
+  void NegacyclicMultiplyInPlace(NativeVector *element,
+                                 const NativeVector &other,
+                                 bool otherTransformed) const;
+
+  /**
+   * Forward transforms several vectors at once, e.g., all towers of one or
+   * more DCRTPolys. When there are fewer vectors than threads, every transform
+   * is also split into blocks that different threads work on (see
+   * NativeNTTEngine::ForwardTransformBlock()), so that a handful of towers can
+   * still keep all cores busy.
+   *
+   * @param &plans the plan for each vector.
+   * @param &elements the vectors, all of the same length, to transform in
+   * place.
+   * @return false, without transforming anything, if some vector cannot be
+   * transformed with its plan (see IsCompatible()).
+   */
+  static bool ForwardTransformBatch(
+      const std::vector<const NativeNTTPlan *> &plans,
+      const std::vector<NativeVector *> &elements);
+
+  /**
+   * Inverse counterpart of ForwardTransformBatch().
+   */
+  static bool InverseTransformBatch(
+      const std::vector<const NativeNTTPlan *> &plans,
+      const std::vector<NativeVector *> &elements);
+
+  /**
+   * @return true if \p element can be transformed with this plan, i.e., it
+   * has length n and modulus q.
+   */
+  bool IsCompatible(const NativeVector &element) const {
+    return element.GetLength() == GetRingDimension() &&
+           element.GetModulus() == m_modulus;
+  }
+
+ private:
+  // checks that every element can be transformed by the native kernels with
+  // its plan, and that all elements have the same length
+  static bool IsBatchable(const std::vector<const NativeNTTPlan *> &plans,
+                          const std::vector<NativeVector *> &elements);
+
+  NativeInteger m_rootOfUnity;
+  NativeInteger m_modulus;
+  usint m_cycloOrder;
+
+  // Backing storage for the table block; m_tables points to its first 64-byte
+  // aligned word. The block holds, n words each and in this order: the forward
+  // twiddles, their precomputations, the inverse twiddles and their
+  // precomputations. It is empty when the native kernels cannot be used for
+  // this modulus, in which case the transforms fall back to
+  // ChineseRemainderTransformFTT.
+  std::unique_ptr<uint64_t[]> m_storage;
+  const uint64_t *m_tables;
+  uint64_t m_cycloOrderInv;
+  uint64_t m_preconCycloOrderInv;
+
+#ifdef WITH_INTEL_HEXL
+  std::unique_ptr<intel::hexl::NTT> m_intelNtt;
+#endif
+};
+
+/**
+ * Looks up the NTT plan for parameters over IntType. Only native integers
+ * have plans; the generic version returns nullptr.
+ */
+template <typename IntType>
+inline std::shared_ptr<const NativeNTTPlan> GetNativeNTTPlan(
+    const IntType &rootOfUnity, usint cycloOrder, const IntType &modulus) {
+  return nullptr;
+}
+
+inline std::shared_ptr<const NativeNTTPlan> GetNativeNTTPlan(
+    const NativeInteger &rootOfUnity, usint cycloOrder,
+    const NativeInteger &modulus) {
+  return NativeNTTPlan::Get(rootOfUnity, cycloOrder, modulus);
+}
+
+/**
+ * Transforms \p element in place with \p plan, if there is a plan and it
+ * applies to the element.
+ *
+ * @return true if the transform was done, false if the caller has to fall
+ * back to ChineseRemainderTransformFTT.
+ */
+template <typename VecType>
+inline bool ForwardTransformWithPlan(const NativeNTTPlan *plan,
+                                     VecType *element) {
+  return false;
+}
+
+inline bool ForwardTransformWithPlan(const NativeNTTPlan *plan,
+                                     NativeVector *element) {
+  if (plan == nullptr || !plan->IsCompatible(*element)) {
+    return false;
+  }
+  plan->ForwardTransformToBitReverseInPlace(element);
+  return true;
+}
+
+template <typename VecType>
+inline bool InverseTransformWithPlan(const NativeNTTPlan *plan,
+                                     VecType *element) {
+  return false;
+}
+
+inline bool InverseTransformWithPlan(const NativeNTTPlan *plan,
+                                     NativeVector *element) {
+  if (plan == nullptr || !plan->IsCompatible(*element)) {
+    return false;
+  }
+  plan->InverseTransformFromBitReverseInPlace(element);
+  return true;
+}
+
+/**
+ * Pruned versions of the above (see
+ * NativeNTTPlan::ForwardTransformToBitReversePrunedInPlace()).
+ */
+template <typename VecType>
+inline bool ForwardTransformPrunedWithPlan(const NativeNTTPlan *plan,
+                                           usint stride, usint degree,
+                                           VecType *element) {
+  return false;
+}
+
+inline bool ForwardTransformPrunedWithPlan(const NativeNTTPlan *plan,
+                                           usint stride, usint degree,
+                                           NativeVector *element) {
+  if (plan == nullptr || !plan->IsCompatible(*element)) {
+    return false;
+  }
+  plan->ForwardTransformToBitReversePrunedInPlace(stride, degree, element);
+  return true;
+}
+
+template <typename VecType>
+inline bool InverseTransformPrunedWithPlan(const NativeNTTPlan *plan,
+                                           usint stride, usint degree,
+                                           VecType *element) {
+  return false;
+}
+
+inline bool InverseTransformPrunedWithPlan(const NativeNTTPlan *plan,
+                                           usint stride, usint degree,
+                                           NativeVector *element) {
+  if (plan == nullptr || !plan->IsCompatible(*element)) {
+    return false;
+  }
+  plan->InverseTransformFromBitReversePrunedInPlace(stride, degree, element);
+  return true;
+}
+
+/**
+ * Replaces \p element with its negacyclic product with \p other using
+ * NativeNTTPlan::NegacyclicMultiplyInPlace(), if there is a plan and it
+ * applies to both vectors.
+ *
+ * @return true if the product was computed, false if the caller has to fall
+ * back to transforming and multiplying the vectors separately.
+ */
+template <typename VecType>
+inline bool NegacyclicMultiplyWithPlan(const NativeNTTPlan *plan,
+                                       VecType *element, const VecType &other,
+                                       bool otherTransformed) {
+  return false;
+}
+
+inline bool NegacyclicMultiplyWithPlan(const NativeNTTPlan *plan,
+                                       NativeVector *element,
+                                       const NativeVector &other,
+                                       bool otherTransformed) {
+  if (plan == nullptr || !plan->IsCompatible(*element) ||
+      !plan->IsCompatible(other)) {
+    return false;
+  }
+  plan->NegacyclicMultiplyInPlace(element, other, otherTransformed);
+  return true;
+}
+
+/**
+ * Batched versions of the above: transform all \p elements with
+ * NativeNTTPlan::ForwardTransformBatch() (or InverseTransformBatch()).
+ *
+ * @return true if the transforms were done, false if the caller has to fall
+ * back to transforming the elements one by one.
+ */
+template <typename VecType>
+inline bool ForwardTransformWithPlans(
+    const std::vector<const NativeNTTPlan *> &plans,
+    const std::vector<VecType *> &elements) {
+  return false;
+}
+
+inline bool ForwardTransformWithPlans(
+    const std::vector<const NativeNTTPlan *> &plans,
+    const std::vector<NativeVector *> &elements) {
+  return NativeNTTPlan::ForwardTransformBatch(plans, elements);
+}
+
+template <typename VecType>
+inline bool InverseTransformWithPlans(
+    const std::vector<const NativeNTTPlan *> &plans,
+    const std::vector<VecType *> &elements) {
+  return false;
+}
+
+inline bool InverseTransformWithPlans(
+    const std::vector<const NativeNTTPlan *> &plans,
+    const std::vector<NativeVector *> &elements) {
+  return NativeNTTPlan::InverseTransformBatch(plans, elements);
+}
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,113 @@
+// @file scaleandround.h Kernels of the RNS scaling and rounding by t/Q.
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef LBCRYPTO_MATH_SCALEANDROUND_H
+#define LBCRYPTO_MATH_SCALEANDROUND_H
+
+#include <cstdint>
+
+#include "utils/inttypes.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief Operands of the scaling and rounding of a polynomial x given by its
+ * residues x_i modulo q_1,...,q_numIn (Halevi-Polyakov-Shoup):
+ *
+ *   out[k] = round(t/Q * x[k]) mod t
+ *          = (sum_i x_i[k] * modt[i] + round(sum_i x_i[k] * frac[i])) mod t,
+ *
+ * with modt[i] = [floor(t * (Q/q_i)^{-1} / q_i)]_t and frac[i] the
+ * fractional part of t * (Q/q_i)^{-1} / q_i. If the residues are too long
+ * for the floating-point sum to be exact enough, they are split as
+ * x_i = xHi_i * B + xLo_i with B = 2^splitShift and modtB, fracB are the
+ * corresponding values for t * (Q/q_i)^{-1} * B / q_i.
+ */
+struct ScaleAndRoundArgs {
+  // number of coefficients
+  usint length = 0;
+  usint numIn = 0;
+
+  // the numIn residue rows
+  const uint64_t *const *in = nullptr;
+
+  uint64_t t = 0;
+
+  const uint64_t *modt = nullptr;
+  // Shoup precomputations of modt for t
+  const uint64_t *modtPrecon = nullptr;
+  const double *frac = nullptr;
+
+  // only used by the kernels that split the residues
+  usint splitShift = 0;
+  const uint64_t *modtB = nullptr;
+  const uint64_t *modtBPrecon = nullptr;
+  const double *fracB = nullptr;
+
+  uint64_t *out = nullptr;
+};
+
+/**
+ * A scaling and rounding kernel; see ScaleAndRoundArgs.
+ */
+typedef void (*ScaleAndRoundKernel)(const ScaleAndRoundArgs &args);
+
+/**
+ * @brief The kernels of DCRTPolyImpl::ScaleAndRound() used in BFVrns
+ * decryption. There is one kernel per parameter regime: whether t is a power
+ * of two, whether the residues are split and whether the integer sum needs
+ * modular reductions. SelectKernel() picks the kernel from the sizes of the
+ * moduli, so that it can be done once per parameter set and the inner loops
+ * do not branch.
+ *
+ * The kernels process the coefficients in blocks of BLOCK_SIZE, tower by
+ * tower with unit-stride loops over the block; the residues are converted
+ * to double exactly with integer operations (they are below 2^52 in every
+ * regime), so both the integer and the floating-point sums vectorize.
+ */
+class ScaleAndRoundKernels {
+ public:
+  /**
+   * @param qMSB the bit length of the moduli q_i, which are assumed to have
+   * the same size.
+   * @param numIn the number of moduli.
+   * @param t the plaintext modulus.
+   * @return the kernel for these sizes; it needs modtB, modtBPrecon and
+   * fracB iff SplitsResidues(qMSB, numIn).
+   */
+  static ScaleAndRoundKernel SelectKernel(usint qMSB, usint numIn, uint64_t t);
+
+  /**
+   * @return whether the kernels for these sizes split the residues, at
+   * qMSB / 2 bits.
+   */
+  static bool SplitsResidues(usint qMSB, usint numIn);
+
+  // number of coefficients processed at once
+  static const usint BLOCK_SIZE = 256;
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -30,13 +30,16 @@
 #include <complex>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include "math/backend.h"
 #include "math/nbtheory.h"
+#include "utils/serializable.h"
 #include "utils/utilities.h"
 
 #ifdef WITH_INTEL_HEXL
@@ -254,6 +257,45 @@ class NumberTheoreticTransform {
       const NativeVector& preconRootOfUnityInverseTable,
       const IntType& cycloOrderInv, const NativeInteger& preconCycloOrderInv,
       VecType* element);
+
+  /**
+   * In-place forward transform with input pruning: the same as
+   * ForwardTransformToBitReverseInPlace() for an input whose only nonzero
+   * coefficients are at multiples of \p stride below \p degree, e.g., a
+   * sparse embedding of a ring of dimension n/stride. Coefficients elsewhere
+   * are treated as zero. For 64-bit native vectors the cost is proportional
+   * to the number of possibly nonzero coefficients rather than to n log n
+   * (see NativeNTTEngine::ForwardTransformToBitReversePrunedInPlace()).
+   *
+   * @param &rootOfUnityTable, &preconRootOfUnityTable as in
+   * ForwardTransformToBitReverseInPlace().
+   * @param stride a power of two that divides n.
+   * @param degree a bound in [1, n] on the input degree plus one.
+   * @param[in,out] &element is the input/output of the transform of type VecType and length n.
+   */
+  static void ForwardTransformToBitReversePrunedInPlace(
+      const VecType& rootOfUnityTable,
+      const NativeVector& preconRootOfUnityTable, usint stride, usint degree,
+      VecType* element);
+
+  /**
+   * In-place inverse transform with output pruning: only the output
+   * coefficients at multiples of \p stride below \p degree are guaranteed to
+   * be computed (the remaining ones may be set to zero), which suffices if
+   * the result is known to be sparse or only those coefficients are used.
+   *
+   * @param &rootOfUnityInverseTable, &preconRootOfUnityInverseTable,
+   * &cycloOrderInv, &preconCycloOrderInv as in
+   * InverseTransformFromBitReverseInPlace().
+   * @param stride a power of two that divides n.
+   * @param degree a bound in [1, n] on the indices of the needed outputs.
+   * @param[in,out] &element is the input/output of the transform of type VecType and length n.
+   */
+  static void InverseTransformFromBitReversePrunedInPlace(
+      const VecType& rootOfUnityInverseTable,
+      const NativeVector& preconRootOfUnityInverseTable,
+      const IntType& cycloOrderInv, const NativeInteger& preconCycloOrderInv,
+      usint stride, usint degree, VecType* element);
 };
 
 /**
@@ -341,6 +383,35 @@ class ChineseRemainderTransformFTT {
                                                     const usint CycloOrder,
                                                     VecType* element);
 
+  /**
+   * In-place forward transform of an input whose only nonzero coefficients
+   * are at multiples of \p stride below \p degree.
+   *
+   * @param &rootOfUnity, CycloOrder as in ForwardTransformToBitReverseInPlace().
+   * @param stride a power of two that divides n.
+   * @param degree a bound in [1, n] on the input degree plus one.
+   * @param[in,out] &element is the input/output of the transform of type VecType and length n.
+   * @see NumberTheoreticTransform::ForwardTransformToBitReversePrunedInPlace()
+   */
+  static void ForwardTransformToBitReversePrunedInPlace(
+      const IntType& rootOfUnity, const usint CycloOrder, usint stride,
+      usint degree, VecType* element);
+
+  /**
+   * In-place inverse transform that only computes the output coefficients at
+   * multiples of \p stride below \p degree.
+   *
+   * @param &rootOfUnity, CycloOrder as in
+   * InverseTransformFromBitReverseInPlace().
+   * @param stride a power of two that divides n.
+   * @param degree a bound in [1, n] on the indices of the needed outputs.
+   * @param[in,out] &element is the input/output of the transform of type VecType and length n.
+   * @see NumberTheoreticTransform::InverseTransformFromBitReversePrunedInPlace()
+   */
+  static void InverseTransformFromBitReversePrunedInPlace(
+      const IntType& rootOfUnity, const usint CycloOrder, usint stride,
+      usint degree, VecType* element);
+
   /**
    * Precomputation of root of unity tables for transforms in the ring
    * Z_q[X]/(X^n+1)
@@ -375,6 +446,10 @@ class ChineseRemainderTransformFTT {
 
   // private:
 
+  // The tables below serve direct callers of this class. Polynomials whose
+  // parameters carry a NativeNTTPlan (see ILParamsImpl::GetNTTPlan()) are
+  // transformed with the plan and never touch these maps.
+
   /// map to store the cyclo order inverse with modulus as a key
   /// For inverse FTT, we also need #m_cycloOrderInversePreconTableByModulus (this is to use an N-size NTT for FTT instead of 2N-size NTT).
   static std::map<IntType, VecType> m_cycloOrderInverseTableByModulus;
@@ -519,8 +594,197 @@ class BluesteinFFT {
   static std::map<IntType, ModulusRoot<IntType>> m_defaultNTTModulusRoot;
 };
 
+/**
+ * @brief Precomputed, immutable tables for the Chinese Remainder Transform in
+ * the m-th cyclotomic ring Z_q[X]/(Phi_m(X)) for arbitrary m.
+ *
+ * A plan holds everything ChineseRemainderTransformArb needs for one ring
+ * modulus q, 2m-th root of unity and auxiliary NTT modulus: the root of unity
+ * tables of the auxiliary NTT, the Bluestein powers and the transforms of
+ * their inverses (RB tables) for both directions, the coprimes of m and, for
+ * orders that are neither a prime nor twice a prime, the tables of the
+ * NTT-based reduction modulo Phi_m(X). Building these costs much more than a
+ * transform, so plans are built once, shared read-only by all threads (see
+ * Get()), and can be serialized so that a process can load them instead of
+ * recomputing them (see Register()).
+ */
+template <typename VecType>
+class ArbNTTPlan : public Serializable {
+  using IntType = typename VecType::Integer;
+
+ public:
+  /**
+   * Empty plan, to deserialize into.
+   */
+  ArbNTTPlan() : m_cycloOrder(0), m_nttDim(0), m_divisionDim(0) {}
+
+  /**
+   * Builds the tables for the given ring.
+   *
+   * @param cycloOrder the cyclotomic order m.
+   * @param &modulus the ring modulus q.
+   * @param &rootOfUnity a primitive 2m-th root of unity modulo q.
+   * @param &nttModulus the modulus of the auxiliary power-of-two NTT.
+   * @param &nttRootOfUnity a root of unity modulo nttModulus whose order is
+   * the auxiliary NTT dimension, the smallest power of two >= 2m - 1.
+   */
+  ArbNTTPlan(usint cycloOrder, const IntType& modulus,
+             const IntType& rootOfUnity, const IntType& nttModulus,
+             const IntType& nttRootOfUnity);
+
+  /**
+   * Returns the shared plan for the given parameters (see ArbNTTPlan()),
+   * building it on first use, e.g., on the first arbitrary-cyclotomic
+   * PolyImpl::SwitchFormat(). A missing plan is built without holding the
+   * lock on the shared plans.
+   */
+  static std::shared_ptr<const ArbNTTPlan> Get(usint cycloOrder,
+                                               const IntType& modulus,
+                                               const IntType& rootOfUnity,
+                                               const IntType& nttModulus,
+                                               const IntType& nttRootOfUnity);
+
+  /**
+   * Makes \p plan, e.g., one deserialized from a file written by another
+   * process, the one returned by Get() for its parameters, so that it is not
+   * rebuilt.
+   */
+  static void Register(std::shared_ptr<const ArbNTTPlan> plan);
+
+  /**
+   * Drops all shared plans. Plans still referenced elsewhere stay valid.
+   */
+  static void Reset();
+
+  /**
+   * Forward transform, see ChineseRemainderTransformArb::ForwardTransform().
+   *
+   * @param &element a vector of length phi(m) modulo q.
+   * @return the transform of \p element.
+   */
+  VecType ForwardTransform(const VecType& element) const;
+
+  /**
+   * Inverse transform, see ChineseRemainderTransformArb::InverseTransform().
+   *
+   * @param &element a vector of length phi(m) modulo q.
+   * @return the inverse transform of \p element.
+   */
+  VecType InverseTransform(const VecType& element) const;
+
+  usint GetCyclotomicOrder() const { return m_cycloOrder; }
+  const IntType& GetModulus() const { return m_modulus; }
+  const IntType& GetRootOfUnity() const { return m_rootOfUnity; }
+  const IntType& GetNTTModulus() const { return m_nttModulus; }
+  const IntType& GetNTTRootOfUnity() const { return m_nttRootOfUnity; }
+
+  bool operator==(const ArbNTTPlan& other) const;
+  bool operator!=(const ArbNTTPlan& other) const { return !(*this == other); }
+
+  template <class Archive>
+  void save(Archive& ar, std::uint32_t const version) const {
+    ar(::cereal::make_nvp("co", m_cycloOrder));
+    ar(::cereal::make_nvp("q", m_modulus));
+    ar(::cereal::make_nvp("ru", m_rootOfUnity));
+    ar(::cereal::make_nvp("nq", m_nttModulus));
+    ar(::cereal::make_nvp("nr", m_nttRootOfUnity));
+    ar(::cereal::make_nvp("nd", m_nttDim));
+    ar(::cereal::make_nvp("nt", m_nttRootTable));
+    ar(::cereal::make_nvp("nti", m_nttRootInverseTable));
+    ar(::cereal::make_nvp("pw", m_powers));
+    ar(::cereal::make_nvp("pwi", m_powersInverse));
+    ar(::cereal::make_nvp("rb", m_RB));
+    ar(::cereal::make_nvp("rbi", m_RBInverse));
+    ar(::cereal::make_nvp("coi", m_cycloOrderInverse));
+    ar(::cereal::make_nvp("tl", m_totientList));
+    ar(::cereal::make_nvp("dd", m_divisionDim));
+    ar(::cereal::make_nvp("dt", m_divisionRootTable));
+    ar(::cereal::make_nvp("dti", m_divisionRootInverseTable));
+    ar(::cereal::make_nvp("cp", m_cyclotomicPolyNTT));
+    ar(::cereal::make_nvp("cpr", m_cyclotomicPolyReverseNTT));
+  }
+
+  template <class Archive>
+  void load(Archive& ar, std::uint32_t const version) {
+    if (version > SerializedVersion()) {
+      PALISADE_THROW(deserialize_error,
+                     "serialized object version " + std::to_string(version) +
+                         " is from a later version of the library");
+    }
+    ar(::cereal::make_nvp("co", m_cycloOrder));
+    ar(::cereal::make_nvp("q", m_modulus));
+    ar(::cereal::make_nvp("ru", m_rootOfUnity));
+    ar(::cereal::make_nvp("nq", m_nttModulus));
+    ar(::cereal::make_nvp("nr", m_nttRootOfUnity));
+    ar(::cereal::make_nvp("nd", m_nttDim));
+    ar(::cereal::make_nvp("nt", m_nttRootTable));
+    ar(::cereal::make_nvp("nti", m_nttRootInverseTable));
+    ar(::cereal::make_nvp("pw", m_powers));
+    ar(::cereal::make_nvp("pwi", m_powersInverse));
+    ar(::cereal::make_nvp("rb", m_RB));
+    ar(::cereal::make_nvp("rbi", m_RBInverse));
+    ar(::cereal::make_nvp("coi", m_cycloOrderInverse));
+    ar(::cereal::make_nvp("tl", m_totientList));
+    ar(::cereal::make_nvp("dd", m_divisionDim));
+    ar(::cereal::make_nvp("dt", m_divisionRootTable));
+    ar(::cereal::make_nvp("dti", m_divisionRootInverseTable));
+    ar(::cereal::make_nvp("cp", m_cyclotomicPolyNTT));
+    ar(::cereal::make_nvp("cpr", m_cyclotomicPolyReverseNTT));
+  }
+
+  std::string SerializedObjectName() const { return "ArbNTTPlan"; }
+  static uint32_t SerializedVersion() { return 1; }
+
+ private:
+  // the Bluestein transform of a vector of length m with the given tables
+  VecType Bluestein(const VecType& element, const VecType& powers,
+                    const VecType& RB) const;
+
+  // reduction modulo Phi_m(X) of a polynomial of degree < m
+  VecType Reduce(const VecType& element) const;
+
+  usint m_cycloOrder;
+  IntType m_modulus;
+  IntType m_rootOfUnity;
+  IntType m_nttModulus;
+  IntType m_nttRootOfUnity;
+
+  // dimension and root of unity tables of the auxiliary NTT
+  usint m_nttDim;
+  VecType m_nttRootTable;
+  VecType m_nttRootInverseTable;
+
+  // root^{i^2 mod 2m} for i < m, and the NTT of the padded root^{-i^2} for
+  // -m < i < m (RB), for the root of unity and for its inverse
+  VecType m_powers;
+  VecType m_powersInverse;
+  VecType m_RB;
+  VecType m_RBInverse;
+
+  IntType m_cycloOrderInverse;
+  std::vector<usint> m_totientList;
+
+  // tables for the NTT-based reduction modulo Phi_m(X); empty (and
+  // m_divisionDim = 0) if m is a prime or twice a prime
+  usint m_divisionDim;
+  VecType m_divisionRootTable;
+  VecType m_divisionRootInverseTable;
+  VecType m_cyclotomicPolyNTT;
+  VecType m_cyclotomicPolyReverseNTT;
+
+  // plans shared by Get(), keyed by cyclotomic order and the pairs (modulus,
+  // root of unity) of the ring and of the auxiliary NTT
+  static std::map<std::pair<usint, ModulusRootPair<IntType>>,
+                  std::shared_ptr<const ArbNTTPlan>>
+      m_plans;
+  static std::mutex m_plansMutex;
+};
+
 /**
  * @brief Chinese Remainder Transform for arbitrary cyclotomics.
+ *
+ * The transforms look up the shared ArbNTTPlan of their parameters (see
+ * ArbNTTPlan::Get()) and only read its tables.
  */
 template <typename VecType>
 class ChineseRemainderTransformArb {
@@ -528,7 +792,8 @@ class ChineseRemainderTransformArb {
 
  public:
   /**
-   * Sets the cyclotomic polynomial.
+   * Sets the cyclotomic polynomial. Plans compute the cyclotomic polynomial
+   * themselves, so this is no longer needed and only kept for compatibility.
    *
    */
   static void SetCylotomicPolynomial(const VecType& poly, const IntType& mod);
@@ -591,22 +856,6 @@ class ChineseRemainderTransformArb {
                                        const IntType& nttMod,
                                        const IntType& nttRoot);
 
-  /**
-   * @brief Sets the precomputed root of unity and modulus needed for NTT
-   * operation and computes m_cyclotomicPolyReveseNTTMap,m_cyclotomicPolyNTTMap.
-   * Always called after setting the cyclotomic polynomial.
-   * @param cycloOrder is the cyclotomic order of the polynomial ring.
-   * @param modulus is the modulus of the polynomial ring.
-   * @param nttMod is the modulus needed for the NTT operation in forward
-   * Bluestein transform.
-   * @param nttRoot is the root of unity needed for the NTT operation in forward
-   * Bluestein transform.
-   */
-  static void SetPreComputedNTTDivisionModulus(usint cyclotoOrder,
-                                               const IntType& modulus,
-                                               const IntType& nttMod,
-                                               const IntType& nttRoot);
-
   /**
    * @brief Computes the inverse of the cyclotomic polynomial using
    * Newton-Iteration method.
@@ -616,60 +865,6 @@ class ChineseRemainderTransformArb {
    */
   static VecType InversePolyMod(const VecType& cycloPoly,
                                 const IntType& modulus, usint power);
-
- private:
-  /**
-   * @brief Padding zeroes to a vector
-   * @param &element is the input of type VecType to be padded with zeros.
-   * @param cycloOrder is the cyclotomic order of the ring
-   * @param forward is a flag for forward/inverse transform padding.
-   * @return is result vector with &element values with padded zeros to it
-   */
-  static VecType Pad(const VecType& element, const usint cycloOrder,
-                     bool forward);
-
-  /**
-   * @brief Dropping elements from a vector
-   * @param &element is the input of type VecType.
-   * @param cycloOrder is the cyclotomic order of the ring
-   * @param forward is a flag for forward/inverse transform dropping.
-   * @param &bigMod is a modulus used to precompute the root of unity tables if
-   * needed. The tables are used in the inverse dropping computations
-   * @param &bigRoot is a root of unity used to precompute the root of unity
-   * tables if needed. The tables are used in the inverse dropping computations
-   * @return is result vector with &element values with dropped elements from it
-   */
-  static VecType Drop(const VecType& element, const usint cycloOrder,
-                      bool forward, const IntType& bigMod,
-                      const IntType& bigRoot);
-
-  // map to store the cyclotomic polynomial with polynomial ring's modulus as
-  // key.
-  static std::map<IntType, VecType> m_cyclotomicPolyMap;
-
-  // map to store the forward NTT transform of the inverse of cyclotomic
-  // polynomial with polynomial ring's modulus as key.
-  static std::map<IntType, VecType> m_cyclotomicPolyReverseNTTMap;
-
-  // map to store the forward NTT transform of the cyclotomic polynomial with
-  // polynomial ring's modulus as key.
-  static std::map<IntType, VecType> m_cyclotomicPolyNTTMap;
-
-  // map to store the root of unity table used in NTT based polynomial division.
-  static std::map<IntType, VecType> m_rootOfUnityDivisionTableByModulus;
-
-  // map to store the root of unity table for computing forward NTT of inverse
-  // cyclotomic polynomial used in NTT based polynomial division.
-  static std::map<IntType, VecType> m_rootOfUnityDivisionInverseTableByModulus;
-
-  // modulus used in NTT based polynomial division.
-  static std::map<IntType, IntType> m_DivisionNTTModulus;
-
-  // root of unity used in NTT based polynomial division.
-  static std::map<IntType, IntType> m_DivisionNTTRootOfUnity;
-
-  // dimension of the NTT transform in NTT based polynomial division.
-  static std::map<usint, usint> m_nttDivisionDim;
 };
 }  // namespace lbcrypto
 
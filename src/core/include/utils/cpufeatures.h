@@ -0,0 +1,115 @@
+// @file cpufeatures.h Runtime selection of the vectorized native kernels
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LBCRYPTO_UTILS_CPUFEATURES_H
+#define LBCRYPTO_UTILS_CPUFEATURES_H
+
+#include <iostream>
+
+// x86-64 builds with GCC or clang compile the AVX2/AVX-512 kernels using
+// function-level target attributes, so no global -m flags are needed and the
+// instruction set is chosen when the library runs
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(__EMSCRIPTEN__)
+#define PALISADE_SIMD_X86 1
+#define PALISADE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define PALISADE_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#define PALISADE_TARGET_AVX512IFMA \
+  __attribute__((target("avx512f,avx512dq,avx512ifma")))
+#endif
+
+namespace lbcrypto {
+
+/**
+ * @brief Lists the instruction sets the native vectorized kernels (NTT and
+ * element-wise arithmetic on 64-bit native vectors) can be dispatched to
+ */
+enum SIMDEngine {
+  SIMD_AUTO = 0,      // the best engine supported by the running CPU
+  SIMD_PORTABLE = 1,  // scalar 64-bit code, available on every platform
+  SIMD_AVX2 = 2,      // AVX2 + FMA
+  SIMD_AVX512 = 3,    // AVX-512F + AVX-512DQ
+  SIMD_AVX512IFMA = 4  // AVX-512 with the 52-bit IFMA multiplies
+};
+
+inline std::ostream &operator<<(std::ostream &s, SIMDEngine e) {
+  switch (e) {
+    case SIMD_AUTO:
+      s << "SIMD_AUTO";
+      break;
+    case SIMD_PORTABLE:
+      s << "SIMD_PORTABLE";
+      break;
+    case SIMD_AVX2:
+      s << "SIMD_AVX2";
+      break;
+    case SIMD_AVX512:
+      s << "SIMD_AVX512";
+      break;
+    case SIMD_AVX512IFMA:
+      s << "SIMD_AVX512IFMA";
+      break;
+    default:
+      s << "UKNOWN";
+      break;
+  }
+  return s;
+}
+
+/**
+ * @brief Runtime selection of the instruction set used by the native
+ * vectorized kernels. The engine is detected once from the CPU on first use
+ * and can be overridden (e.g., for benchmarking or testing) with SetEngine().
+ */
+class SIMDControls {
+ public:
+  /**
+   * Checks whether both this build and the running CPU support an engine.
+   *
+   * @param engine the engine to check; SIMD_AUTO is always supported.
+   * @return true if the kernels can be dispatched to the engine.
+   */
+  static bool IsSupported(SIMDEngine engine);
+
+  /**
+   * @return the best engine supported by the running CPU.
+   */
+  static SIMDEngine GetBestEngine();
+
+  /**
+   * @return the engine currently used by the kernels (never SIMD_AUTO).
+   */
+  static SIMDEngine GetEngine();
+
+  /**
+   * Selects the engine used by the kernels; SIMD_AUTO restores the best
+   * supported one. Throws a config_error if the engine is not supported.
+   *
+   * @param engine the engine to use.
+   */
+  static void SetEngine(SIMDEngine engine);
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -22,6 +22,7 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 
@@ -30,6 +31,9 @@
 #endif
 
 #include "lattice/dcrtpoly.h"
+#include "math/modgemm.h"
+#include "math/nativevectorkernels.h"
+#include "math/nativentt.h"
 #include "utils/debug.h"
 
 using std::shared_ptr;
@@ -37,6 +41,86 @@ using std::string;
 
 namespace lbcrypto {
 
+#if NATIVEINT == 64
+// the uint64_t storage of a 64-bit native tower
+static inline uint64_t *TowerData(NativePoly &tower) {
+  return reinterpret_cast<uint64_t *>(&tower[0]);
+}
+
+static inline const uint64_t *TowerData(const NativePoly &tower) {
+  return reinterpret_cast<const uint64_t *>(&tower[0]);
+}
+
+// the first count values as words, into existing storage
+static inline void AssignWords(const std::vector<NativeInteger> &values,
+                               usint count, std::vector<uint64_t> *words) {
+  words->resize(count);
+  for (usint i = 0; i < count; i++) {
+    (*words)[i] = values[i].ConvertToInt();
+  }
+}
+
+static inline std::vector<uint64_t> ToWords(
+    const std::vector<NativeInteger> &values) {
+  std::vector<uint64_t> words;
+  AssignWords(values, values.size(), &words);
+  return words;
+}
+
+// the first numIn x numOut entries of a matrix indexed by [i][j], or by
+// [j][i] if transposed, as the row-major weights of ModGemmArgs
+static inline void AssignWeights(
+    const std::vector<std::vector<NativeInteger>> &matrix, usint numIn,
+    usint numOut, std::vector<uint64_t> *weights, bool transposed = false) {
+  weights->resize(size_t(numIn) * numOut);
+  for (usint i = 0; i < numIn; i++) {
+    for (usint j = 0; j < numOut; j++) {
+      (*weights)[size_t(i) * numOut + j] =
+          (transposed ? matrix[j][i] : matrix[i][j]).ConvertToInt();
+    }
+  }
+}
+
+static inline std::vector<uint64_t> ToWeights(
+    const std::vector<std::vector<NativeInteger>> &matrix, usint numIn,
+    usint numOut, bool transposed = false) {
+  std::vector<uint64_t> weights;
+  AssignWeights(matrix, numIn, numOut, &weights, transposed);
+  return weights;
+}
+
+// 0.5 + sum_i frac[i] * in[i][k] for the n coefficients, in blocks that
+// are summed tower by tower
+static inline void RoundingSums(const std::vector<const uint64_t *> &in,
+                                const std::vector<double> &frac, usint n,
+                                double *sums) {
+  const usint BLOCK = 256;
+  const usint numBlocks = (n + BLOCK - 1) / BLOCK;
+#pragma omp parallel for
+  for (usint b = 0; b < numBlocks; b++) {
+    const usint begin = b * BLOCK;
+    const usint count = std::min(BLOCK, n - begin);
+    double *nu = sums + begin;
+    std::fill(nu, nu + count, 0.5);
+    for (usint i = 0; i < in.size(); i++) {
+      const uint64_t *x = in[i] + begin;
+      for (usint k = 0; k < count; k++) {
+        nu[k] += frac[i] * x[k];
+      }
+    }
+  }
+}
+#endif
+
+// the number of threads a parallel loop started by the calling thread may use
+static inline usint MaxLoopThreads() {
+#ifdef PARALLEL
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
 /*CONSTRUCTORS*/
 template <typename VecType>
 DCRTPolyImpl<VecType>::DCRTPolyImpl() {
@@ -360,6 +444,73 @@ DCRTPolyImpl<VecType>::DCRTPolyImpl(const DCRTPolyImpl &&element) {
   m_params = std::move(element.m_params);
 }
 
+template <typename VecType>
+DCRTPolyImpl<VecType>::DCRTPolyImpl(const ConstTowerRange &towers) {
+  m_format = towers.GetFormat();
+  m_params = towers.GetParams();
+  m_vectors.reserve(towers.GetNumOfElements());
+  for (usint i = 0; i < towers.GetNumOfElements(); i++) {
+    m_vectors.push_back(towers.GetElementAtIndex(i));
+  }
+}
+
+template <typename VecType>
+DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::AutomorphismTransform(
+    const usint &i) const {
+  if (m_format == Format::EVALUATION) {
+    return AutomorphismTransform(
+        i, GetAutomorphismPermutation(m_params->GetCyclotomicOrder(), i));
+  }
+
+  DCRTPolyImpl result(m_params, m_format);
+#pragma omp parallel for
+  for (usint k = 0; k < m_vectors.size(); k++) {
+    result.m_vectors[k] = m_vectors[k].AutomorphismTransform(i);
+  }
+  return result;
+}
+
+template <typename VecType>
+DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::AutomorphismTransform(
+    usint i, const std::vector<usint> &map) const {
+  DCRTPolyImpl result(m_params, m_format);
+#pragma omp parallel for
+  for (usint k = 0; k < m_vectors.size(); k++) {
+    result.m_vectors[k] = m_vectors[k].AutomorphismTransform(i, map);
+  }
+  return result;
+}
+
+template <typename VecType>
+DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::AutomorphismTransformSum(
+    usint i, const DCRTPolyImpl &addend) const {
+  if (m_vectors.size() != addend.m_vectors.size()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot add");
+  }
+  return AutomorphismTransformSumPrefix(i, addend);
+}
+
+template <typename VecType>
+DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::AutomorphismTransformSumPrefix(
+    usint i, const DCRTPolyImpl &addend) const {
+  if (m_vectors.size() < addend.m_vectors.size()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot add");
+  }
+  const std::vector<usint> &map =
+      GetAutomorphismPermutation(m_params->GetCyclotomicOrder(), i);
+
+  DCRTPolyImpl result(m_params, m_format);
+  usint sizeAddend = addend.m_vectors.size();
+#pragma omp parallel for
+  for (usint k = 0; k < m_vectors.size(); k++) {
+    result.m_vectors[k] =
+        (k < sizeAddend)
+            ? m_vectors[k].AutomorphismTransformSum(i, map, addend.m_vectors[k])
+            : m_vectors[k].AutomorphismTransform(i, map);
+  }
+  return result;
+}
+
 template <typename VecType>
 DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::CloneParametersOnly() const {
   DCRTPolyImpl res(this->m_params, this->m_format);
@@ -389,7 +540,9 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::CloneWithNoise(
 // DESTRUCTORS
 
 template <typename VecType>
-DCRTPolyImpl<VecType>::~DCRTPolyImpl() {}
+DCRTPolyImpl<VecType>::~DCRTPolyImpl() {
+  if (m_formatDeferred) CountFormatSwitches(0, m_vectors.size());
+}
 
 // GET ACCESSORS
 template <typename VecType>
@@ -670,6 +823,84 @@ const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator-=(
   return *this;
 }
 
+template <typename VecType>
+const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator+=(
+    const ConstTowerRange &rhs) {
+  if (m_vectors.size() != rhs.GetNumOfElements()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot add");
+  }
+#pragma omp parallel for
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    m_vectors[i] += rhs.GetElementAtIndex(i);
+  }
+  return *this;
+}
+
+template <typename VecType>
+const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator-=(
+    const ConstTowerRange &rhs) {
+  if (m_vectors.size() != rhs.GetNumOfElements()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot subtract");
+  }
+#pragma omp parallel for
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    m_vectors[i] -= rhs.GetElementAtIndex(i);
+  }
+  return *this;
+}
+
+template <typename VecType>
+const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator*=(
+    const ConstTowerRange &rhs) {
+  if (m_vectors.size() != rhs.GetNumOfElements()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot multiply");
+  }
+#pragma omp parallel for
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    m_vectors[i] *= rhs.GetElementAtIndex(i);
+  }
+  return *this;
+}
+
+template <typename VecType>
+const typename DCRTPolyImpl<VecType>::TowerRange &
+DCRTPolyImpl<VecType>::TowerRange::operator+=(const ConstTowerRange &rhs) {
+  if (this->m_size != rhs.GetNumOfElements()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot add");
+  }
+#pragma omp parallel for
+  for (usint i = 0; i < this->m_size; i++) {
+    ElementAtIndex(i) += rhs.GetElementAtIndex(i);
+  }
+  return *this;
+}
+
+template <typename VecType>
+const typename DCRTPolyImpl<VecType>::TowerRange &
+DCRTPolyImpl<VecType>::TowerRange::operator-=(const ConstTowerRange &rhs) {
+  if (this->m_size != rhs.GetNumOfElements()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot subtract");
+  }
+#pragma omp parallel for
+  for (usint i = 0; i < this->m_size; i++) {
+    ElementAtIndex(i) -= rhs.GetElementAtIndex(i);
+  }
+  return *this;
+}
+
+template <typename VecType>
+const typename DCRTPolyImpl<VecType>::TowerRange &
+DCRTPolyImpl<VecType>::TowerRange::operator*=(const ConstTowerRange &rhs) {
+  if (this->m_size != rhs.GetNumOfElements()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot multiply");
+  }
+#pragma omp parallel for
+  for (usint i = 0; i < this->m_size; i++) {
+    ElementAtIndex(i) *= rhs.GetElementAtIndex(i);
+  }
+  return *this;
+}
+
 template <typename VecType>
 const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator*=(
     const DCRTPolyImpl &element) {
@@ -681,6 +912,46 @@ const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator*=(
   return *this;
 }
 
+template <typename VecType>
+const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::ModMulAddEq(
+    const DCRTPolyImpl &a, const DCRTPolyImpl &b) {
+  return ModMulAddEq(std::vector<const DCRTPolyImpl *>(1, &a),
+                     std::vector<const DCRTPolyImpl *>(1, &b));
+}
+
+template <typename VecType>
+const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::ModMulAddEq(
+    const std::vector<const DCRTPolyImpl *> &a,
+    const std::vector<const DCRTPolyImpl *> &b) {
+  if (a.size() != b.size()) {
+    PALISADE_THROW(math_error,
+                   "ModMulAddEq called with different numbers of operands");
+  }
+  for (usint j = 0; j < a.size(); j++) {
+    if (a[j]->m_vectors.size() != m_vectors.size() ||
+        b[j]->m_vectors.size() != m_vectors.size()) {
+      PALISADE_THROW(math_error, "tower size mismatch; cannot multiply");
+    }
+    if (a[j]->m_format != Format::EVALUATION ||
+        b[j]->m_format != Format::EVALUATION) {
+      PALISADE_THROW(not_implemented_error,
+                     "ModMulAddEq for DCRTPoly is supported only in "
+                     "Format::EVALUATION format.");
+    }
+  }
+
+#pragma omp parallel for
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    std::vector<const PolyType *> aTowers(a.size()), bTowers(b.size());
+    for (usint j = 0; j < a.size(); j++) {
+      aTowers[j] = &a[j]->m_vectors[i];
+      bTowers[j] = &b[j]->m_vectors[i];
+    }
+    m_vectors[i].ModMulAddEq(aTowers, bTowers);
+  }
+  return *this;
+}
+
 template <typename VecType>
 bool DCRTPolyImpl<VecType>::operator==(const DCRTPolyImpl &rhs) const {
   if (GetCyclotomicOrder() != rhs.GetCyclotomicOrder()) return false;
@@ -702,6 +973,7 @@ template <typename VecType>
 const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator=(
     const DCRTPolyImpl &rhs) {
   if (this != &rhs) {
+    DiscardFormatSwitch();
     m_vectors = rhs.m_vectors;
     m_format = rhs.m_format;
     m_params = rhs.m_params;
@@ -716,6 +988,9 @@ const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator=(
     m_vectors = std::move(rhs.m_vectors);
     m_format = std::move(rhs.m_format);
     m_params = std::move(rhs.m_params);
+    DiscardFormatSwitch();
+    m_formatDeferred = rhs.m_formatDeferred;
+    rhs.m_formatDeferred = false;
   }
   return *this;
 }
@@ -921,6 +1196,26 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::Times(
   return tmp;
 }
 
+template <typename VecType>
+DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::NegacyclicMultiply(
+    const DCRTPolyImpl &element) const {
+  if (m_vectors.size() != element.m_vectors.size()) {
+    PALISADE_THROW(math_error, "tower size mismatch; cannot multiply");
+  }
+  if (m_format != Format::COEFFICIENT) {
+    PALISADE_THROW(not_implemented_error,
+                   "NegacyclicMultiply for DCRTPoly is supported only in "
+                   "Format::COEFFICIENT format.");
+  }
+  DCRTPolyImpl<VecType> tmp(*this);
+
+#pragma omp parallel for
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    tmp.m_vectors[i] = m_vectors[i].NegacyclicMultiply(element.m_vectors[i]);
+  }
+  return tmp;
+}
+
 template <typename VecType>
 DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::Times(
     const Integer &element) const {
@@ -993,6 +1288,7 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::DivideAndRound(
 template <typename VecType>
 const DCRTPolyImpl<VecType> &DCRTPolyImpl<VecType>::operator*=(
     const Integer &element) {
+  // scaling commutes with the transforms
   for (usint i = 0; i < this->m_vectors.size(); i++) {
     this->m_vectors.at(i) *=
         (element.Mod(this->m_vectors[i].GetModulus())).ConvertToInt();
@@ -1035,11 +1331,126 @@ bool DCRTPolyImpl<VecType>::IsEmpty() const {
   return true;
 }
 
+template <typename VecType>
+typename DCRTPolyImpl<VecType>::Workspace &
+DCRTPolyImpl<VecType>::GetThreadWorkspace() {
+  static thread_local Workspace ws;
+  return ws;
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::PrepareTowers(DCRTPolyType *result,
+                                          const shared_ptr<Params> &params,
+                                          Format format) {
+  result->DiscardFormatSwitch();
+  const auto &towerParams = params->GetParams();
+  std::vector<PolyType> &towers = result->m_vectors;
+  if (towers.size() > towerParams.size()) {
+    towers.erase(towers.begin() + towerParams.size(), towers.end());
+  }
+  for (usint i = 0; i < towerParams.size(); i++) {
+    if (i == towers.size()) {
+      towers.emplace_back(towerParams[i], format, true);
+    } else if (towers[i].IsEmpty() || towers[i].GetLength() !=
+                                          towerParams[i]->GetRingDimension()) {
+      towers[i] = PolyType(towerParams[i], format, true);
+    } else {
+      towers[i].SwitchModulus(towerParams[i]);
+      towers[i].OverrideFormat(format);
+    }
+  }
+  result->m_params = params;
+  result->m_format = format;
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::PrepareWorkspaceTowers(Workspace *ws,
+                                                   usint count) {
+  if (ws->towers.size() < count) ws->towers.resize(count);
+}
+
+template <typename VecType>
+typename DCRTPolyImpl<VecType>::PolyType &
+DCRTPolyImpl<VecType>::LoopWorkspaceTower(Workspace *ws, usint skip) {
+#ifdef PARALLEL
+  return ws->towers[skip + omp_get_thread_num()];
+#else
+  return ws->towers[skip];
+#endif
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::RescaleTower(const PolyType &last,
+                                         const NativeInteger &lastScale,
+                                         const NativeInteger &lastScalePrecon,
+                                         const NativeInteger &towerScale,
+                                         const NativeInteger &towerScalePrecon,
+                                         PolyType *tower, PolyType *temp) {
+  const auto &params = tower->GetParams();
+#if NATIVEINT == 64 && !defined(WITH_INTEL_HEXL)
+  usint n = last.GetLength();
+  if (temp->IsEmpty() || temp->GetLength() != n) {
+    *temp = PolyType(params, Format::COEFFICIENT, true);
+  } else {
+    temp->OverrideParams(params);
+    temp->OverrideFormat(Format::COEFFICIENT);
+  }
+  uint64_t q = params->GetModulus().ConvertToInt();
+  NativeVectorKernels::SwitchModulusAndScale(
+      TowerData(last), TowerData(*temp), n,
+      last.GetModulus().ConvertToInt(), q, lastScale.ConvertToInt(),
+      lastScalePrecon.ConvertToInt());
+  if (tower->GetFormat() == Format::EVALUATION) temp->SwitchFormat();
+  NativeVectorKernels::ModMulScalarAdd(
+      TowerData(*tower), towerScale.ConvertToInt(),
+      towerScalePrecon.ConvertToInt(), TowerData(*temp), TowerData(*tower), n,
+      q);
+#else
+  *temp = last;
+  temp->SwitchModulus(params);
+  *temp *= lastScale;
+  if (tower->GetFormat() == Format::EVALUATION) temp->SwitchFormat();
+#ifdef WITH_INTEL_HEXL
+  uint64_t *op1 = reinterpret_cast<uint64_t *>(&(*tower)[0]);
+  uint64_t *op3 = reinterpret_cast<uint64_t *>(&(*temp)[0]);
+  intel::hexl::EltwiseFMAMod(op1, op1, towerScale.ConvertToInt(), op3,
+                             tower->GetLength(),
+                             params->GetModulus().ConvertToInt(), 1);
+#else
+  *tower *= towerScale;
+  *tower += *temp;
+#endif
+#endif
+}
+
+template <typename VecType>
+shared_ptr<typename DCRTPolyImpl<VecType>::Params>
+DCRTPolyImpl<VecType>::DroppedParams(Workspace *ws,
+                                     const shared_ptr<Params> &params,
+                                     usint count) {
+  // a few levels of a few parameter chains
+  static const size_t MAX_DROPPED_PARAMS = 64;
+
+  size_t size = params->GetParams().size() - count;
+  for (const auto &entry : ws->droppedParams) {
+    if (entry.first == params && entry.second->GetParams().size() == size)
+      return entry.second;
+  }
+
+  auto dropped = std::make_shared<Params>(*params);
+  for (usint j = 0; j < count; j++) dropped->PopLastParam();
+  if (ws->droppedParams.size() == MAX_DROPPED_PARAMS)
+    ws->droppedParams.erase(ws->droppedParams.begin());
+  ws->droppedParams.emplace_back(params, dropped);
+  return dropped;
+}
+
 template <typename VecType>
 void DCRTPolyImpl<VecType>::DropLastElement() {
   if (m_vectors.size() == 0) {
     PALISADE_THROW(math_error, "Last element being removed from empty list");
   }
+  if (m_formatDeferred) CountFormatSwitches(0, 1);
   m_vectors.resize(m_vectors.size() - 1);
 
   DCRTPolyImpl::Params *newP = new DCRTPolyImpl::Params(*m_params);
@@ -1055,6 +1466,7 @@ void DCRTPolyImpl<VecType>::DropLastElements(size_t i) {
                    "perform the modulus reduction");
   }
 
+  if (m_formatDeferred) CountFormatSwitches(0, i);
   m_vectors.resize(m_vectors.size() - i);
   DCRTPolyImpl::Params *newP = new DCRTPolyImpl::Params(*m_params);
   for (size_t j = 0; j < i; j++) newP->PopLastParam();
@@ -1068,48 +1480,45 @@ void DCRTPolyImpl<VecType>::DropLastElementAndScale(
     const std::vector<NativeInteger> &QlQlInvModqlDivqlModqPrecon,
     const std::vector<NativeInteger> &qlInvModq,
     const std::vector<NativeInteger> &qlInvModqPrecon) {
+  DropLastElementAndScale(QlQlInvModqlDivqlModq, QlQlInvModqlDivqlModqPrecon,
+                          qlInvModq, qlInvModqPrecon, &GetThreadWorkspace());
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::DropLastElementAndScale(
+    const std::vector<NativeInteger> &QlQlInvModqlDivqlModq,
+    const std::vector<NativeInteger> &QlQlInvModqlDivqlModqPrecon,
+    const std::vector<NativeInteger> &qlInvModq,
+    const std::vector<NativeInteger> &qlInvModqPrecon, Workspace *ws) {
   usint sizeQl = m_vectors.size();
+  if (sizeQl == 0) {
+    PALISADE_THROW(math_error, "Last element being removed from empty list");
+  }
 
-  // last tower that will be dropped
-  PolyType lastPoly(m_vectors[sizeQl - 1]);
+  // the last tower that will be dropped goes to ws->towers[0], taking over
+  // its storage; every thread of the loop below has one more tower for the
+  // extra terms
+  PrepareWorkspaceTowers(ws, 1 + MaxLoopThreads());
+  // the towers are rescaled in the format they are in, so a deferred format
+  // switch stays deferred
+  if (m_formatDeferred) CountFormatSwitches(0, 1);
+  PolyType &lastPoly = ws->towers[0];
+  std::swap(lastPoly, m_vectors[sizeQl - 1]);
 
   // drop the last tower
-  DropLastElement();
+  m_vectors.pop_back();
+  m_params = DroppedParams(ws, m_params, 1);
 
+  // one inverse NTT of the dropped tower; each remaining tower then gets
+  // x_i * ql^{-1} + NTT([x_l]_{q_i} * (Q_l/q_l)^{-1} / q_l) in one pass
   lastPoly.SetFormat(Format::COEFFICIENT);
-  DCRTPolyType extra(m_params, COEFFICIENT, true);
-
-#pragma omp parallel for
-  for (usint i = 0; i < extra.m_vectors.size(); i++) {
-    auto temp = lastPoly;
-    temp.SwitchModulus(m_vectors[i].GetModulus(),
-                       m_vectors[i].GetRootOfUnity());
-    extra.m_vectors[i] = (temp *= QlQlInvModqlDivqlModq[i]);
-  }
-
-  if (this->GetFormat() == Format::EVALUATION)
-    extra.SetFormat(Format::EVALUATION);
 
-#ifdef WITH_INTEL_HEXL
-  usint ringDim = GetRingDimension();
-  for (usint i = 0; i < m_vectors.size(); i++) {
-    const NativeInteger &qi = m_vectors[i].GetModulus();
-    PolyType &m_veci = m_vectors[i];
-    PolyType &extra_m_veci = extra.m_vectors[i];
-    const auto multOp = qlInvModq[i];
-    uint64_t *op1 = reinterpret_cast<uint64_t *>(&m_veci[0]);
-    uint64_t op2 = multOp.ConvertToInt();
-    uint64_t *op3 = reinterpret_cast<uint64_t *>(&extra_m_veci[0]);
-    intel::hexl::EltwiseFMAMod(op1, op1, op2, op3, ringDim, qi.ConvertToInt(),
-                               1);
-  }
-#else
 #pragma omp parallel for
   for (usint i = 0; i < m_vectors.size(); i++) {
-    m_vectors[i] *= qlInvModq[i];
-    m_vectors[i] += extra.m_vectors[i];
+    RescaleTower(lastPoly, QlQlInvModqlDivqlModq[i],
+                 QlQlInvModqlDivqlModqPrecon[i], qlInvModq[i],
+                 qlInvModqPrecon[i], &m_vectors[i], &LoopWorkspaceTower(ws, 1));
   }
-#endif
 
   this->SetFormat(Format::EVALUATION);
 }
@@ -1142,47 +1551,35 @@ void DCRTPolyImpl<VecType>::ModReduce(
     const std::vector<NativeInteger> &qlInvModq,
     const std::vector<NativeInteger> &qlInvModqPrecon) {
   usint sizeQl = m_vectors.size();
+  if (sizeQl == 0) {
+    PALISADE_THROW(math_error, "Last element being removed from empty list");
+  }
+
+  // the same fused rescaling as DropLastElementAndScale(), with
+  // (x_i + t * [delta]_{q_i}) * ql^{-1} = x_i * ql^{-1} + [delta]_{q_i} * t *
+  // ql^{-1}
+  Workspace &ws = GetThreadWorkspace();
+  PrepareWorkspaceTowers(&ws, 1 + MaxLoopThreads());
+  // the towers are rescaled in the format they are in, so a deferred format
+  // switch stays deferred
+  if (m_formatDeferred) CountFormatSwitches(0, 1);
+  PolyType &delta = ws.towers[0];
+  std::swap(delta, m_vectors[sizeQl - 1]);
 
-  // last tower that will be dropped
-  PolyType delta(m_vectors[sizeQl - 1]);
+  m_vectors.pop_back();
+  m_params = DroppedParams(&ws, m_params, 1);
 
   // Pull tower to be dropped in COEFFICIENT FORMAT
   delta.SetFormat(Format::COEFFICIENT);
+  delta *= negtInvModq;
 
-  DropLastElement();
-
-  if (m_format == Format::EVALUATION) {
-    DCRTPolyType extra(m_params, COEFFICIENT, true);
-
-    delta *= negtInvModq;
-
-#pragma omp parallel for
-    for (usint i = 0; i < m_vectors.size(); i++) {
-      auto temp = delta;
-      temp.SwitchModulus(m_vectors[i].GetModulus(),
-                         m_vectors[i].GetRootOfUnity());
-      extra.m_vectors[i] = temp;
-    }
-
-    extra.SetFormat(Format::EVALUATION);
-
-#pragma omp parallel for
-    for (usint i = 0; i < m_vectors.size(); i++) {
-      extra.m_vectors[i] *= t;
-      m_vectors[i] += extra.m_vectors[i];
-      m_vectors[i] *= qlInvModq[i];
-    }
-
-  } else {
-    delta *= negtInvModq;
 #pragma omp parallel for
-    for (usint i = 0; i < m_vectors.size(); i++) {
-      auto temp = delta;
-      temp.SwitchModulus(m_vectors[i].GetModulus(),
-                         m_vectors[i].GetRootOfUnity());
-      m_vectors[i] += (temp *= t);
-      m_vectors[i] *= qlInvModq[i];
-    }
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    const NativeInteger &qi = m_vectors[i].GetModulus();
+    NativeInteger tqlInvModqi = t.ModMul(qlInvModq[i], qi);
+    RescaleTower(delta, tqlInvModqi, tqlInvModqi.PrepModMulConst(qi),
+                 qlInvModq[i], qlInvModqPrecon[i], &m_vectors[i],
+                 &LoopWorkspaceTower(&ws, 1));
   }
 }
 
@@ -1479,7 +1876,62 @@ DCRTPolyImpl<VecType>::GetExtendedCRTBasis(
                                                 moduliQP, rootsQP);
 }
 
+template <typename VecType>
+void DCRTPolyImpl<VecType>::ApproxSwitchCRTBasisTowers(
+    const PolyType *in, usint sizeIn, const vector<NativeInteger> &QHatInvModq,
+    const vector<NativeInteger> &QHatInvModqPrecon,
+    const vector<vector<NativeInteger>> &QHatModp,
+    const vector<DoubleNativeInt> &modpBarrettMu, PolyType *out, usint sizeOut,
+    Workspace *ws) {
 #if defined(HAVE_INT128) && NATIVEINT == 64 && !defined(__EMSCRIPTEN__)
+  ws->in.resize(sizeIn);
+  ws->inModuli.resize(sizeIn);
+  for (usint i = 0; i < sizeIn; i++) {
+    ws->in[i] = TowerData(in[i]);
+    ws->inModuli[i] = in[i].GetModulus().ConvertToInt();
+  }
+  AssignWords(QHatInvModq, sizeIn, &ws->scale);
+  AssignWords(QHatInvModqPrecon, sizeIn, &ws->scalePrecon);
+  AssignWeights(QHatModp, sizeIn, sizeOut, &ws->weights);
+
+  ws->out.resize(sizeOut);
+  ws->outModuli.resize(sizeOut);
+  for (usint j = 0; j < sizeOut; j++) {
+    ws->out[j] = TowerData(out[j]);
+    ws->outModuli[j] = out[j].GetModulus().ConvertToInt();
+  }
+
+  // sum_i [x_i * (Q/q_i)^{-1}]_{q_i} * (Q/q_i) mod p_j
+  ModGemmArgs args;
+  args.length = in[0].GetLength();
+  args.numIn = sizeIn;
+  args.numOut = sizeOut;
+  args.in = ws->in.data();
+  args.inModuli = ws->inModuli.data();
+  args.scale = ws->scale.data();
+  args.scalePrecon = ws->scalePrecon.data();
+  args.weights = ws->weights.data();
+  args.out = ws->out.data();
+  args.outModuli = ws->outModuli.data();
+  args.outBarrettMu = modpBarrettMu.data();
+  ModGemm::Multiply(args);
+#else
+  for (usint i = 0; i < sizeIn; i++) {
+    auto xQHatInvModqi = in[i] * QHatInvModq[i];
+#pragma omp parallel for
+    for (usint j = 0; j < sizeOut; j++) {
+      auto temp = xQHatInvModqi;
+      temp.SwitchModulus(out[j].GetParams());
+      temp *= QHatModp[i][j];
+      if (i == 0)
+        out[j] = temp;
+      else
+        out[j] += temp;
+    }
+  }
+#endif
+}
+
 template <typename VecType>
 DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::ApproxSwitchCRTBasis(
     const shared_ptr<DCRTPolyImpl::Params> paramsQ,
@@ -1488,67 +1940,30 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::ApproxSwitchCRTBasis(
     const vector<NativeInteger> &QHatInvModqPrecon,
     const vector<vector<NativeInteger>> &QHatModp,
     const vector<DoubleNativeInt> &modpBarrettMu) const {
-  DCRTPolyType ans(paramsP, m_format, true);
-
-  usint ringDim = GetRingDimension();
-  usint sizeQ = (m_vectors.size() > paramsQ->GetParams().size())
-                    ? paramsQ->GetParams().size()
-                    : m_vectors.size();
-  usint sizeP = ans.m_vectors.size();
-
-#pragma omp parallel for
-  for (usint ri = 0; ri < ringDim; ri++) {
-    vector<DoubleNativeInt> sum(sizeP);
-    for (usint i = 0; i < sizeQ; i++) {
-      const NativeInteger &xi = m_vectors[i][ri];
-      const NativeInteger &qi = m_vectors[i].GetModulus();
-      NativeInteger xQHatInvModqi =
-          xi.ModMulFastConst(QHatInvModq[i], qi, QHatInvModqPrecon[i]);
-      for (usint j = 0; j < sizeP; j++) {
-        sum[j] +=
-            Mul128(xQHatInvModqi.ConvertToInt(), QHatModp[i][j].ConvertToInt());
-      }
-    }
-
-    for (usint j = 0; j < sizeP; j++) {
-      const NativeInteger &pj = ans.m_vectors[j].GetModulus();
-      ans.m_vectors[j][ri] =
-          BarrettUint128ModUint64(sum[j], pj.ConvertToInt(), modpBarrettMu[j]);
-    }
-  }
-
+  DCRTPolyType ans;
+  ApproxSwitchCRTBasis(paramsQ, paramsP, QHatInvModq, QHatInvModqPrecon,
+                       QHatModp, modpBarrettMu, &ans, &GetThreadWorkspace());
   return ans;
 }
-#else
+
 template <typename VecType>
-DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::ApproxSwitchCRTBasis(
+void DCRTPolyImpl<VecType>::ApproxSwitchCRTBasis(
     const shared_ptr<DCRTPolyImpl::Params> paramsQ,
     const shared_ptr<DCRTPolyImpl::Params> paramsP,
     const vector<NativeInteger> &QHatInvModq,
     const vector<NativeInteger> &QHatInvModqPrecon,
     const vector<vector<NativeInteger>> &QHatModp,
-    const vector<DoubleNativeInt> &modpBarrettMu) const {
-  DCRTPolyType ans(paramsP, m_format, true);
-
+    const vector<DoubleNativeInt> &modpBarrettMu, DCRTPolyType *result,
+    Workspace *ws) const {
   usint sizeQ = (m_vectors.size() > paramsQ->GetParams().size())
                     ? paramsQ->GetParams().size()
                     : m_vectors.size();
-  usint sizeP = ans.m_vectors.size();
-
-  for (usint i = 0; i < sizeQ; i++) {
-    auto xQHatInvModqi = m_vectors[i] * QHatInvModq[i];
-#pragma omp parallel for
-    for (usint j = 0; j < sizeP; j++) {
-      auto temp = xQHatInvModqi;
-      temp.SwitchModulus(ans.m_vectors[j].GetModulus(),
-                         ans.m_vectors[j].GetRootOfUnity());
-      ans.m_vectors[j] += (temp *= QHatModp[i][j]);
-    }
-  }
-
-  return ans;
+  PrepareTowers(result, paramsP, m_format);
+  ApproxSwitchCRTBasisTowers(m_vectors.data(), sizeQ, QHatInvModq,
+                             QHatInvModqPrecon, QHatModp, modpBarrettMu,
+                             result->m_vectors.data(),
+                             result->m_vectors.size(), ws);
 }
-#endif
 
 template <typename VecType>
 void DCRTPolyImpl<VecType>::ApproxModUp(
@@ -1557,47 +1972,59 @@ void DCRTPolyImpl<VecType>::ApproxModUp(
     const vector<NativeInteger> &QHatInvModqPrecon,
     const vector<vector<NativeInteger>> &QHatModp,
     const vector<DoubleNativeInt> &modpBarrettMu) {
-  std::vector<PolyType> polyInNTT;
-  // if the input polynomial is in evaluation representation, store it for
-  // later use to reduce the number of NTTs
-  if (m_format == Format::EVALUATION) {
-    polyInNTT = m_vectors;
-    this->SetFormat(Format::COEFFICIENT);
-  }
+  DCRTPolyType ans;
+  ApproxModUp(paramsQ, paramsP, paramsQP, QHatInvModq, QHatInvModqPrecon,
+              QHatModp, modpBarrettMu, &ans, &GetThreadWorkspace());
+  *this = std::move(ans);
+}
 
+template <typename VecType>
+void DCRTPolyImpl<VecType>::ApproxModUp(
+    const shared_ptr<Params> paramsQ, const shared_ptr<Params> paramsP,
+    const shared_ptr<Params> paramsQP, const vector<NativeInteger> &QHatInvModq,
+    const vector<NativeInteger> &QHatInvModqPrecon,
+    const vector<vector<NativeInteger>> &QHatModp,
+    const vector<DoubleNativeInt> &modpBarrettMu, DCRTPolyType *result,
+    Workspace *ws) const {
   usint sizeQ = m_vectors.size();
   usint sizeP = paramsP->GetParams().size();
-  usint sizeQP = paramsQP->GetParams().size();
 
-  DCRTPolyType partP =
-      ApproxSwitchCRTBasis(paramsQ, paramsP, QHatInvModq, QHatInvModqPrecon,
-                           QHatModp, modpBarrettMu);
-
-  m_vectors.resize(sizeQP);
+  PrepareTowers(result, paramsQP, Format::EVALUATION);
+  std::vector<PolyType> &towers = result->m_vectors;
 
+  // the towers for Q are this element in evaluation representation; the
+  // base conversion needs them in coefficient representation, so if this
+  // element is in evaluation representation, the converted copies go to the
+  // workspace to reduce the number of NTTs
+  const PolyType *polyInCoeff = m_vectors.data();
+  if (m_format == Format::EVALUATION) {
+    PrepareWorkspaceTowers(ws, sizeQ);
 #pragma omp parallel for
-  // populate the towers corresponding to CRT basis P and convert them to
-  // evaluation representation
-  for (size_t j = 0; j < sizeP; j++) {
-    m_vectors[sizeQ + j] = partP.m_vectors[j];
-    m_vectors[sizeQ + j].SetFormat(Format::EVALUATION);
-  }
-  // if the input polynomial was in evaluation representation, use the towers
-  // for Q from it
-  if (polyInNTT.size() > 0) {
-    for (size_t i = 0; i < sizeQ; i++) {
-      m_vectors[i] = polyInNTT[i];
+    for (usint i = 0; i < sizeQ; i++) {
+      towers[i] = m_vectors[i];
+      ws->towers[i] = m_vectors[i];
+      ws->towers[i].SetFormat(Format::COEFFICIENT);
     }
+    polyInCoeff = ws->towers.data();
   } else {
-// else call NTT for the towers for Q
 #pragma omp parallel for
-    for (size_t i = 0; i < sizeQ; i++) {
-      m_vectors[i].SwitchFormat();
+    for (usint i = 0; i < sizeQ; i++) {
+      towers[i] = m_vectors[i];
+      towers[i].SwitchFormat();
     }
   }
 
-  m_format = Format::EVALUATION;
-  m_params = paramsQP;
+  ApproxSwitchCRTBasisTowers(polyInCoeff, sizeQ, QHatInvModq,
+                             QHatInvModqPrecon, QHatModp, modpBarrettMu,
+                             &towers[sizeQ], sizeP, ws);
+
+  // convert the towers corresponding to CRT basis P to evaluation
+  // representation
+#pragma omp parallel for
+  for (usint j = 0; j < sizeP; j++) {
+    towers[sizeQ + j].OverrideFormat(Format::COEFFICIENT);
+    towers[sizeQ + j].SwitchFormat();
+  }
 }
 
 template <typename VecType>
@@ -1612,52 +2039,63 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::ApproxModDown(
     const vector<NativeInteger> &tInvModp,
     const vector<NativeInteger> &tInvModpPrecon, const NativeInteger &t,
     const vector<NativeInteger> &tModqPrecon) const {
+  DCRTPolyType ans;
+  ApproxModDown(paramsQ, paramsP, PInvModq, PInvModqPrecon, PHatInvModp,
+                PHatInvModpPrecon, PHatModq, modqBarrettMu, tInvModp,
+                tInvModpPrecon, t, tModqPrecon, &ans, &GetThreadWorkspace());
+  return ans;
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::ApproxModDown(
+    const shared_ptr<Params> paramsQ, const shared_ptr<Params> paramsP,
+    const vector<NativeInteger> &PInvModq,
+    const vector<NativeInteger> &PInvModqPrecon,
+    const vector<NativeInteger> &PHatInvModp,
+    const vector<NativeInteger> &PHatInvModpPrecon,
+    const vector<vector<NativeInteger>> &PHatModq,
+    const vector<DoubleNativeInt> &modqBarrettMu,
+    const vector<NativeInteger> &tInvModp,
+    const vector<NativeInteger> &tInvModpPrecon, const NativeInteger &t,
+    const vector<NativeInteger> &tModqPrecon, DCRTPolyType *result,
+    Workspace *ws) const {
   usint sizeQP = m_vectors.size();
   usint sizeP = paramsP->GetParams().size();
   usint sizeQ = sizeQP - sizeP;
 
-  DCRTPolyType partP(paramsP, m_format, true);
-
-  for (usint i = sizeQ, j = 0; i < sizeQP; i++, j++) {
-    partP.m_vectors[j] = m_vectors[i];
-  }
-
-  partP.SetFormat(COEFFICIENT);
-
-  // Multiply everything by -t^(-1) mod P (BGVrns only)
-  if (t > 0) {
+  // the towers for P in coefficient representation
+  PrepareWorkspaceTowers(ws, sizeP);
 #pragma omp parallel for
-    for (usint j = 0; j < sizeP; j++) {
-      partP.m_vectors[j] *= tInvModp[j];
-    }
+  for (usint j = 0; j < sizeP; j++) {
+    PolyType &partP = ws->towers[j];
+    partP = m_vectors[sizeQ + j];
+    partP.SetFormat(Format::COEFFICIENT);
+    // Multiply everything by -t^(-1) mod P (BGVrns only)
+    if (t > 0) partP *= tInvModp[j];
   }
 
-  DCRTPolyType partPSwitchedToQ =
-      partP.ApproxSwitchCRTBasis(paramsP, paramsQ, PHatInvModp,
-                                 PHatInvModpPrecon, PHatModq, modqBarrettMu);
-
-  // Combine the switched DCRTPoly with the Q part of this to get the result
-  DCRTPolyType ans(paramsQ, EVALUATION, true);
   uint32_t diffQ = paramsQ->GetParams().size() - sizeQ;
-  if (diffQ > 0) ans.DropLastElements(diffQ);
+  PrepareTowers(result,
+                diffQ > 0 ? DroppedParams(ws, paramsQ, diffQ) : paramsQ,
+                Format::EVALUATION);
+  std::vector<PolyType> &towers = result->m_vectors;
 
-  // Multiply everything by t mod Q (BGVrns only)
-  if (t > 0) {
-#pragma omp parallel for
-    for (usint i = 0; i < sizeQ; i++) {
-      partPSwitchedToQ.m_vectors[i] *= t;
-    }
-  }
-
-  partPSwitchedToQ.SetFormat(EVALUATION);
+  ApproxSwitchCRTBasisTowers(ws->towers.data(), sizeP, PHatInvModp,
+                             PHatInvModpPrecon, PHatModq, modqBarrettMu,
+                             towers.data(), sizeQ, ws);
 
+  // Combine the switched towers with the Q part of this to get the result:
+  // (x - [x]_P) * P^{-1} = ([x]_P - x) * (-P^{-1})
 #pragma omp parallel for
   for (usint i = 0; i < sizeQ; i++) {
-    auto diff = m_vectors[i] - partPSwitchedToQ.m_vectors[i];
-    ans.m_vectors[i] = diff * PInvModq[i];
+    PolyType &partPSwitchedToQ = towers[i];
+    partPSwitchedToQ.OverrideFormat(Format::COEFFICIENT);
+    // Multiply everything by t mod Q (BGVrns only)
+    if (t > 0) partPSwitchedToQ *= t;
+    partPSwitchedToQ.SwitchFormat();
+    partPSwitchedToQ -= m_vectors[i];
+    partPSwitchedToQ *= partPSwitchedToQ.GetModulus() - PInvModq[i];
   }
-
-  return ans;
 }
 
 #if defined(HAVE_INT128) && NATIVEINT == 64
@@ -1676,47 +2114,65 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::SwitchCRTBasis(
   usint sizeQ = m_vectors.size();
   usint sizeP = ans.m_vectors.size();
 
-#pragma omp parallel for
-  for (usint ri = 0; ri < ringDim; ri++) {
-    std::vector<NativeInteger> xQHatInvModq(sizeQ);
-    double nu = 0.5;
+  vector<const uint64_t *> in(sizeQ);
+  vector<uint64_t> moduliQ(sizeQ);
+  for (usint i = 0; i < sizeQ; i++) {
+    in[i] = TowerData(m_vectors[i]);
+    moduliQ[i] = m_vectors[i].GetModulus().ConvertToInt();
+  }
+  vector<uint64_t> scale = ToWords(QHatInvModq);
+  vector<uint64_t> scalePrecon = ToWords(QHatInvModqPrecon);
+  vector<uint64_t> weights = ToWeights(QHatModp, sizeQ, sizeP, true);
 
-    // Compute alpha and vector of x_i terms
+  vector<uint64_t *> out(sizeP);
+  vector<uint64_t> moduliP(sizeP);
+  for (usint j = 0; j < sizeP; j++) {
+    out[j] = TowerData(ans.m_vectors[j]);
+    moduliP[j] = ans.m_vectors[j].GetModulus().ConvertToInt();
+  }
+
+  // first round - compute "fast conversion"
+  ModGemmArgs args;
+  args.length = ringDim;
+  args.numIn = sizeQ;
+  args.numOut = sizeP;
+  args.in = in.data();
+  args.inModuli = moduliQ.data();
+  args.scale = scale.data();
+  args.scalePrecon = scalePrecon.data();
+  args.weights = weights.data();
+  args.out = out.data();
+  args.outModuli = moduliP.data();
+  args.outBarrettMu = modpBarrettMu.data();
+  ModGemm::Multiply(args);
+
+  // second round - remove q-overflows, counted by
+  // alpha = round(sum_i [x_i (Q/q_i)^{-1}]_{q_i} / q_i), 0 <= alpha <= sizeQ,
+  // over the same tiles of coefficients as the product
+  const usint tileSize = ModGemm::TILE_SIZE;
+  usint numTiles = (ringDim + tileSize - 1) / tileSize;
+#pragma omp parallel for
+  for (usint t = 0; t < numTiles; t++) {
+    usint k0 = t * tileSize;
+    usint len = std::min(tileSize, ringDim - k0);
+    std::vector<double> nu(len, 0.5);
     for (usint i = 0; i < sizeQ; i++) {
-      //      const NativeInteger &xi = m_vectors[i][ri];
       const NativeInteger &qi = m_vectors[i].GetModulus();
-
-      // computes [x_i (Q/q_i)^{-1}]_{q_i}
-      xQHatInvModq[i] = m_vectors[i][ri].ModMulFastConst(QHatInvModq[i], qi,
-                                                         QHatInvModqPrecon[i]);
-
-      // computes [x_i (Q/q_i)^{-1}]_{q_i} / q_i
-      // to keep track of the number of q-overflows
-      nu += static_cast<double>(xQHatInvModq[i].ConvertToInt()) * qInv[i];
+      for (usint k = 0; k < len; k++) {
+        NativeInteger xQHatInvModqi = m_vectors[i][k0 + k].ModMulFastConst(
+            QHatInvModq[i], qi, QHatInvModqPrecon[i]);
+        nu[k] += static_cast<double>(xQHatInvModqi.ConvertToInt()) * qInv[i];
+      }
     }
 
-    // alpha corresponds to the number of overflows, 0 <= alpha <= sizeQ
-    usint alpha = static_cast<usint>(nu);
-
-    const std::vector<NativeInteger> &alphaQModpri = alphaQModp[alpha];
-
     for (usint j = 0; j < sizeP; j++) {
-      DoubleNativeInt curValue = 0;
-
       const NativeInteger &pj = ans.m_vectors[j].GetModulus();
-      const std::vector<NativeInteger> &QHatModpj = QHatModp[j];
-      // first round - compute "fast conversion"
-      for (usint i = 0; i < sizeQ; i++) {
-        curValue +=
-            Mul128(xQHatInvModq[i].ConvertToInt(), QHatModpj[i].ConvertToInt());
+      for (usint k = 0; k < len; k++) {
+        const std::vector<NativeInteger> &alphaQModpri =
+            alphaQModp[static_cast<usint>(nu[k])];
+        ans.m_vectors[j][k0 + k] =
+            ans.m_vectors[j][k0 + k].ModSubFast(alphaQModpri[j], pj);
       }
-
-      const NativeInteger &curNativeValue =
-          NativeInteger(BarrettUint128ModUint64(curValue, pj.ConvertToInt(),
-                                                modpBarrettMu[j]));
-
-      // second round - remove q-overflows
-      ans.m_vectors[j][ri] = curNativeValue.ModSubFast(alphaQModpri[j], pj);
     }
   }
 
@@ -1845,18 +2301,50 @@ PolyImpl<NativeVector> DCRTPolyImpl<VecType>::ScaleAndRound(
     const std::vector<NativeInteger> &tQHatInvModqBDivqModt,
     const std::vector<NativeInteger> &tQHatInvModqBDivqModtPrecon,
     const std::vector<double> &tQHatInvModqDivqFrac,
-    const std::vector<double> &tQHatInvModqDivqBFrac) const {
+    const std::vector<double> &tQHatInvModqDivqBFrac,
+    ScaleAndRoundKernel kernel) const {
   usint ringDim = GetRingDimension();
   usint sizeQ = m_vectors.size();
 
   // MSB of q_i
   usint qMSB = m_vectors[0].GetModulus().GetMSB();
+
+  typename PolyType::Vector coefficients(ringDim, t.ConvertToInt());
+#if NATIVEINT == 64
+  if (kernel == nullptr) {
+    kernel = ScaleAndRoundKernels::SelectKernel(qMSB, sizeQ, t.ConvertToInt());
+  }
+  std::vector<const uint64_t *> in(sizeQ);
+  for (usint i = 0; i < sizeQ; i++) {
+    in[i] = TowerData(m_vectors[i]);
+  }
+  std::vector<uint64_t> modt = ToWords(tQHatInvModqDivqModt);
+  std::vector<uint64_t> modtPrecon = ToWords(tQHatInvModqDivqModtPrecon);
+  std::vector<uint64_t> modtB, modtBPrecon;
+
+  ScaleAndRoundArgs args;
+  args.length = ringDim;
+  args.numIn = sizeQ;
+  args.in = in.data();
+  args.t = t.ConvertToInt();
+  args.modt = modt.data();
+  args.modtPrecon = modtPrecon.data();
+  args.frac = tQHatInvModqDivqFrac.data();
+  if (ScaleAndRoundKernels::SplitsResidues(qMSB, sizeQ)) {
+    modtB = ToWords(tQHatInvModqBDivqModt);
+    modtBPrecon = ToWords(tQHatInvModqBDivqModtPrecon);
+    args.splitShift = qMSB >> 1;
+    args.modtB = modtB.data();
+    args.modtBPrecon = modtBPrecon.data();
+    args.fracB = tQHatInvModqDivqBFrac.data();
+  }
+  args.out = reinterpret_cast<uint64_t *>(&coefficients[0]);
+  kernel(args);
+#else
   // MSB of t
   usint tMSB = t.GetMSB();
   // MSB of sizeQ
   usint sizeQMSB = GetMSB64(sizeQ);
-
-  typename PolyType::Vector coefficients(ringDim, t.ConvertToInt());
   // For power of two t we can do modulo reduction easily
   if (IsPowerOfTwo(t.ConvertToInt())) {
     uint64_t tMinus1 = t.ConvertToInt() - 1;
@@ -2122,6 +2610,8 @@ PolyImpl<NativeVector> DCRTPolyImpl<VecType>::ScaleAndRound(
     }
   }
 
+#endif
+
   // Setting the root of unity to ONE as the calculation is expensive
   // It is assumed that no polynomial multiplications in evaluation
   // representation are performed after this
@@ -2133,42 +2623,60 @@ PolyImpl<NativeVector> DCRTPolyImpl<VecType>::ScaleAndRound(
 }
 
 #if defined(HAVE_INT128) && NATIVEINT == 64
-template <typename VecType>
-DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::ApproxScaleAndRound(
-    const shared_ptr<DCRTPolyImpl::Params> paramsP,
+// out_j <- sum_{i<sizeQ} x_i * w_j[i] + x_{sizeQ+j} * w_j[sizeQ] mod p_j for
+// the towers x of a polynomial in the basis {Q,P} and w_j =
+// tPSHatInvModsDivsModp[j]: the common part of the scale and round
+// operations of BFVrns multiplication
+static void ScaleAndRoundTowers(
+    const std::vector<NativePoly> &x, std::vector<NativePoly> *out,
     const std::vector<std::vector<NativeInteger>> &tPSHatInvModsDivsModp,
-    const std::vector<DoubleNativeInt> &modpBarretMu) const {
-  DCRTPolyType ans(paramsP, m_format, true);
+    const std::vector<DoubleNativeInt> &modpBarretMu) {
+  usint ringDim = x[0].GetLength();
+  usint sizeP = out->size();
+  usint sizeQ = x.size() - sizeP;
 
-  usint ringDim = GetRingDimension();
-  size_t sizeQP = m_vectors.size();
-  size_t sizeP = ans.m_vectors.size();
-  size_t sizeQ = sizeQP - sizeP;
-
-#pragma omp parallel for
-  for (usint ri = 0; ri < ringDim; ri++) {
-    for (usint j = 0; j < sizeP; j++) {
-      DoubleNativeInt curValue = 0;
-
-      const NativeInteger &pj = paramsP->GetParams()[j]->GetModulus();
-      const std::vector<NativeInteger> &tPSHatInvModsDivsModpj =
-          tPSHatInvModsDivsModp[j];
+  std::vector<const uint64_t *> in(sizeQ);
+  for (usint i = 0; i < sizeQ; i++) {
+    in[i] = TowerData(x[i]);
+  }
+  std::vector<uint64_t *> outData(sizeP);
+  std::vector<uint64_t> moduliP(sizeP);
+  for (usint j = 0; j < sizeP; j++) {
+    outData[j] = TowerData((*out)[j]);
+    moduliP[j] = (*out)[j].GetModulus().ConvertToInt();
+  }
+  std::vector<uint64_t> weights =
+      ToWeights(tPSHatInvModsDivsModp, sizeQ, sizeP, true);
 
-      for (usint i = 0; i < sizeQ; i++) {
-        const NativeInteger &xi = m_vectors[i][ri];
-        curValue +=
-            Mul128(xi.ConvertToInt(), tPSHatInvModsDivsModpj[i].ConvertToInt());
-      }
+  ModGemmArgs args;
+  args.length = ringDim;
+  args.numIn = sizeQ;
+  args.numOut = sizeP;
+  args.in = in.data();
+  args.weights = weights.data();
+  args.out = outData.data();
+  args.outModuli = moduliP.data();
+  args.outBarrettMu = modpBarretMu.data();
+  ModGemm::Multiply(args);
 
-      const NativeInteger &xi = m_vectors[sizeQ + j][ri];
-      curValue += Mul128(xi.ConvertToInt(),
-                         tPSHatInvModsDivsModpj[sizeQ].ConvertToInt());
-
-      ans.m_vectors[j][ri] =
-          BarrettUint128ModUint64(curValue, pj.ConvertToInt(), modpBarretMu[j]);
-    }
+#pragma omp parallel for
+  for (usint j = 0; j < sizeP; j++) {
+    const NativeInteger &w = tPSHatInvModsDivsModp[j][sizeQ];
+    NativeVectorKernels::ModMulScalarAdd(
+        TowerData(x[sizeQ + j]), w.ConvertToInt(),
+        w.PrepModMulConst((*out)[j].GetModulus()).ConvertToInt(), outData[j],
+        outData[j], ringDim, moduliP[j]);
   }
+}
 
+template <typename VecType>
+DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::ApproxScaleAndRound(
+    const shared_ptr<DCRTPolyImpl::Params> paramsP,
+    const std::vector<std::vector<NativeInteger>> &tPSHatInvModsDivsModp,
+    const std::vector<DoubleNativeInt> &modpBarretMu) const {
+  DCRTPolyType ans(paramsP, m_format, true);
+  ScaleAndRoundTowers(m_vectors, &ans.m_vectors, tPSHatInvModsDivsModp,
+                      modpBarretMu);
   return ans;
 }
 #else
@@ -2227,40 +2735,26 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::ScaleAndRound(
   size_t sizeP = ans.m_vectors.size();
   size_t sizeQ = sizeQP - sizeP;
 
-#pragma omp parallel for
-  for (usint ri = 0; ri < ringDim; ri++) {
-    double nu = 0.5;
-
-    for (usint i = 0; i < sizeQ; i++) {
-      const NativeInteger &xi = m_vectors[i][ri];
-      nu += tPSHatInvModsDivsFrac[i] * xi.ConvertToInt();
-    }
-
-    NativeInteger alpha = static_cast<uint64_t>(nu);
-
-    for (usint j = 0; j < sizeP; j++) {
-      DoubleNativeInt curValue = 0;
-
-      const NativeInteger &pj = paramsP->GetParams()[j]->GetModulus();
-      const std::vector<NativeInteger> &tPSHatInvModsDivsModpj =
-          tPSHatInvModsDivsModp[j];
-
-      for (usint i = 0; i < sizeQ; i++) {
-        const NativeInteger &xi = m_vectors[i][ri];
-        curValue +=
-            Mul128(xi.ConvertToInt(), tPSHatInvModsDivsModpj[i].ConvertToInt());
-      }
-
-      const NativeInteger &xi = m_vectors[sizeQ + j][ri];
-      curValue += Mul128(xi.ConvertToInt(),
-                         tPSHatInvModsDivsModpj[sizeQ].ConvertToInt());
+  ScaleAndRoundTowers(m_vectors, &ans.m_vectors, tPSHatInvModsDivsModp,
+                      modpBarretMu);
 
-      const NativeInteger &curNativeValue =
-          NativeInteger(BarrettUint128ModUint64(curValue, pj.ConvertToInt(),
-                                                modpBarretMu[j]));
+  // alpha = Round(sum_i x_i * beta_i), added to every tower
+  std::vector<const uint64_t *> in(sizeQ);
+  for (usint i = 0; i < sizeQ; i++) {
+    in[i] = TowerData(m_vectors[i]);
+  }
+  std::vector<double> nu(ringDim);
+  RoundingSums(in, tPSHatInvModsDivsFrac, ringDim, nu.data());
+  std::vector<uint64_t> alpha(ringDim);
+  for (usint ri = 0; ri < ringDim; ri++) {
+    alpha[ri] = static_cast<uint64_t>(nu[ri]);
+  }
 
-      ans.m_vectors[j][ri] = curNativeValue.ModAddFast(alpha, pj);
-    }
+#pragma omp parallel for
+  for (usint j = 0; j < sizeP; j++) {
+    uint64_t *out = TowerData(ans.m_vectors[j]);
+    NativeVectorKernels::ModAdd(out, alpha.data(), out, ringDim,
+                                ans.m_vectors[j].GetModulus().ConvertToInt());
   }
 
   return ans;
@@ -2410,47 +2904,50 @@ void DCRTPolyImpl<VecType>::FastBaseConvqToBskMontgomery(
 
   // ----------------------- step 0 -----------------------
 
-  // first we twist xi by mtilde*(q/qi)^-1 mod qi
-  NativeInteger *ximtildeQHatModqi = new NativeInteger[n * numQ];
+  // first we twist xi by mtilde*(q/qi)^-1 mod qi, then convert to Bsk and
+  // to mtilde = 2^16, which is one more output modulus of the product
+  std::vector<const uint64_t *> in(numQ);
   for (uint32_t i = 0; i < numQ; i++) {
-    const NativeInteger &currentmtildeQHatInvModq = mtildeQHatInvModq[i];
-    const NativeInteger &currentmtildeQHatInvModqPrecon =
-        mtildeQHatInvModqPrecon[i];
-
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      ximtildeQHatModqi[i * n + k] = m_vectors[i][k].ModMulFastConst(
-          currentmtildeQHatInvModq, moduliQ[i], currentmtildeQHatInvModqPrecon);
-    }
+    in[i] = TowerData(m_vectors[i]);
   }
+  std::vector<uint64_t> moduliQWords = ToWords(moduliQ);
+  std::vector<uint64_t> scale = ToWords(mtildeQHatInvModq);
+  std::vector<uint64_t> scalePrecon = ToWords(mtildeQHatInvModqPrecon);
 
-  // mod Bsk
-  for (uint32_t j = 0; j < numBsk; j++) {
-    PolyType newvec(m_params->GetParams()[j], m_format, true);
-    m_vectors[numQ + j] = std::move(newvec);
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      DoubleNativeInt result = 0;
-      for (uint32_t i = 0; i < numQ; i++) {
-        const NativeInteger &QHatModbskij = QHatModbsk[i][j];
-        result += Mul128(ximtildeQHatModqi[i * n + k].ConvertToInt(),
-                         QHatModbskij.ConvertToInt());
-      }
-
-      m_vectors[numQ + j][k] = BarrettUint128ModUint64(
-          result, moduliBsk[j].ConvertToInt(), modbskBarrettMu[j]);
+  std::vector<uint64_t> weights((numBsk + 1) * numQ);
+  for (uint32_t i = 0; i < numQ; i++) {
+    for (uint32_t j = 0; j < numBsk; j++) {
+      weights[i * (numBsk + 1) + j] = QHatModbsk[i][j].ConvertToInt();
     }
+    weights[i * (numBsk + 1) + numBsk] = QHatModmtilde[i];
   }
 
-  // mod mtilde = 2^16
-  std::vector<uint16_t> result_mtilde(n);
-#pragma omp parallel for
-  for (uint32_t k = 0; k < n; k++) {
-    result_mtilde[k] = 0;
-    for (uint32_t i = 0; i < numQ; i++)
-      result_mtilde[k] +=
-          ximtildeQHatModqi[i * n + k].ConvertToInt() * QHatModmtilde[i];
-  }
+  std::vector<uint64_t> mtildeValues(n);
+  std::vector<uint64_t *> out(numBsk + 1);
+  std::vector<uint64_t> moduliOut = ToWords(moduliBsk);
+  std::vector<DoubleNativeInt> barrettMuOut(modbskBarrettMu.begin(),
+                                            modbskBarrettMu.begin() + numBsk);
+  for (uint32_t j = 0; j < numBsk; j++) {
+    m_vectors[numQ + j] = PolyType(m_params->GetParams()[j], m_format, true);
+    out[j] = TowerData(m_vectors[numQ + j]);
+  }
+  out[numBsk] = mtildeValues.data();
+  moduliOut.push_back(uint64_t(1) << 16);
+  barrettMuOut.push_back(DoubleNativeInt(1) << 112);
+
+  ModGemmArgs args;
+  args.length = n;
+  args.numIn = numQ;
+  args.numOut = numBsk + 1;
+  args.in = in.data();
+  args.inModuli = moduliQWords.data();
+  args.scale = scale.data();
+  args.scalePrecon = scalePrecon.data();
+  args.weights = weights.data();
+  args.out = out.data();
+  args.outModuli = moduliOut.data();
+  args.outBarrettMu = barrettMuOut.data();
+  ModGemm::Multiply(args);
 
   // now we have input in Basis (q U Bsk U mtilde)
   // next we perform Small Motgomery Reduction mod q
@@ -2460,9 +2957,11 @@ void DCRTPolyImpl<VecType>::FastBaseConvqToBskMontgomery(
   uint64_t mtilde = (uint64_t)1 << 16;
   uint64_t mtilde_half = mtilde >> 1;
 
+  std::vector<uint16_t> result_mtilde(n);
 #pragma omp parallel for
   for (uint32_t k = 0; k < n; k++) {
-    result_mtilde[k] *= negQInvModmtilde;
+    result_mtilde[k] =
+        static_cast<uint16_t>(mtildeValues[k] * negQInvModmtilde);
   }
 
   for (uint32_t i = 0; i < numBsk; i++) {
@@ -2500,8 +2999,6 @@ void DCRTPolyImpl<VecType>::FastBaseConvqToBskMontgomery(
 
   m_format = Format::EVALUATION;
 
-  delete[] ximtildeQHatModqi;
-  ximtildeQHatModqi = nullptr;
 }
 #else
 template <typename VecType>
@@ -2665,34 +3162,36 @@ void DCRTPolyImpl<VecType>::FastRNSFloorq(
 
   uint32_t n = GetLength();
 
-  // Twist xi by t*(q/qi)^-1 mod qi
-  NativeInteger *txiqiDivqModqi = new NativeInteger[n * numBsk];
-
+  // Twist xi by t*(q/qi)^-1 mod qi and convert to Bsk
+  std::vector<const uint64_t *> in(numQ);
   for (uint32_t i = 0; i < numQ; i++) {
-    const NativeInteger &currenttqDivqiModqi = tQHatInvModq[i];
-    const NativeInteger &currenttqDivqiModqiPrecon = tQHatInvModqPrecon[i];
-
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      // multiply by t*(q/qi)^-1 mod qi
-      m_vectors[i][k].ModMulFastConstEq(currenttqDivqiModqi, moduliQ[i],
-                                        currenttqDivqiModqiPrecon);
-    }
+    in[i] = TowerData(m_vectors[i]);
   }
+  std::vector<uint64_t> moduliQWords = ToWords(moduliQ);
+  std::vector<uint64_t> scale = ToWords(tQHatInvModq);
+  std::vector<uint64_t> scalePrecon = ToWords(tQHatInvModqPrecon);
+  std::vector<uint64_t> weights = ToWeights(qInvModbsk, numQ, numBsk);
 
+  std::vector<uint64_t> txiqiDivqModqi(n * numBsk);
+  std::vector<uint64_t *> out(numBsk);
   for (uint32_t j = 0; j < numBsk; j++) {
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      DoubleNativeInt aq = 0;
-      for (uint32_t i = 0; i < numQ; i++) {
-        const NativeInteger &InvqiModBjValue = qInvModbsk[i][j];
-        NativeInteger &xi = m_vectors[i][k];
-        aq += Mul128(xi.ConvertToInt(), InvqiModBjValue.ConvertToInt());
-      }
-      txiqiDivqModqi[j * n + k] = BarrettUint128ModUint64(
-          aq, moduliBsk[j].ConvertToInt(), modbskBarrettMu[j]);
-    }
-  }
+    out[j] = &txiqiDivqModqi[j * n];
+  }
+  std::vector<uint64_t> moduliBskWords = ToWords(moduliBsk);
+
+  ModGemmArgs args;
+  args.length = n;
+  args.numIn = numQ;
+  args.numOut = numBsk;
+  args.in = in.data();
+  args.inModuli = moduliQWords.data();
+  args.scale = scale.data();
+  args.scalePrecon = scalePrecon.data();
+  args.weights = weights.data();
+  args.out = out.data();
+  args.outModuli = moduliBskWords.data();
+  args.outBarrettMu = modbskBarrettMu.data();
+  ModGemm::Multiply(args);
 
   // now we have FastBaseConv( |t*ct|q, q, Bsk ) in txiqiDivqModqi
 
@@ -2704,12 +3203,10 @@ void DCRTPolyImpl<VecType>::FastRNSFloorq(
       // Not worthy to use lazy reduction here
       m_vectors[i + numQ][k].ModMulFastConstEq(
           currenttDivqModBski, moduliBsk[i], currenttDivqModBskiPrecon);
-      m_vectors[i + numQ][k].ModSubFastEq(txiqiDivqModqi[i * n + k],
-                                          moduliBsk[i]);
+      m_vectors[i + numQ][k].ModSubFastEq(
+          NativeInteger(txiqiDivqModqi[i * n + k]), moduliBsk[i]);
     }
   }
-  delete[] txiqiDivqModqi;
-  txiqiDivqModqi = nullptr;
 }
 #else
 template <typename VecType>
@@ -2808,44 +3305,56 @@ void DCRTPolyImpl<VecType>::FastBaseConvSK(
 
   uint32_t n = GetLength();
 
-  for (uint32_t i = 0; i < sizeBsk - 1; i++) {  // exclude msk residue
-    const NativeInteger &currentBDivBiModBi = BHatInvModb[i];
-    const NativeInteger &currentBDivBiModBiPrecon = BHatInvModbPrecon[i];
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      m_vectors[sizeQ + i][k].ModMulFastConstEq(
-          currentBDivBiModBi, moduliBsk[i], currentBDivBiModBiPrecon);
-    }
+  // [x_i * (B/B_i)^{-1}]_{B_i} converted to q and to msk, which is one more
+  // output modulus of the product
+  uint32_t sizeB = sizeBsk - 1;  // exclude msk residue
+  std::vector<const uint64_t *> in(sizeB);
+  for (uint32_t i = 0; i < sizeB; i++) {
+    in[i] = TowerData(m_vectors[sizeQ + i]);
   }
+  std::vector<uint64_t> moduliBWords = ToWords(moduliBsk);
+  std::vector<uint64_t> scale = ToWords(BHatInvModb);
+  std::vector<uint64_t> scalePrecon = ToWords(BHatInvModbPrecon);
 
-  for (uint32_t j = 0; j < sizeQ; j++) {
-#pragma omp parallel for
-    for (uint32_t k = 0; k < n; k++) {
-      DoubleNativeInt result = 0;
-      for (uint32_t i = 0; i < sizeBsk - 1; i++) {  // exclude msk residue
-        const NativeInteger &currentBDivBiModqj = BHatModq[i][j];
-        const NativeInteger &xi = m_vectors[sizeQ + i][k];
-        result += Mul128(xi.ConvertToInt(), currentBDivBiModqj.ConvertToInt());
-      }
-      m_vectors[j][k] = BarrettUint128ModUint64(
-          result, moduliQ[j].ConvertToInt(), modqBarrettMu[j]);
+  std::vector<uint64_t> weights(sizeB * (sizeQ + 1));
+  for (uint32_t i = 0; i < sizeB; i++) {
+    for (uint32_t j = 0; j < sizeQ; j++) {
+      weights[i * (sizeQ + 1) + j] = BHatModq[i][j].ConvertToInt();
     }
+    weights[i * (sizeQ + 1) + sizeQ] = BHatModmsk[i].ConvertToInt();
   }
 
-  // calculate alphaskx
-  // FastBaseConv(x, B, msk)
+  // calculate alphaskx = FastBaseConv(x, B, msk) along with the q residues
+  std::vector<uint64_t> alphaskxValues(n);
+  std::vector<uint64_t *> out(sizeQ + 1);
+  for (uint32_t j = 0; j < sizeQ; j++) {
+    out[j] = TowerData(m_vectors[j]);
+  }
+  out[sizeQ] = alphaskxValues.data();
+  std::vector<uint64_t> moduliOut = ToWords(moduliQ);
+  moduliOut.push_back(moduliBsk[sizeBsk - 1].ConvertToInt());
+  std::vector<DoubleNativeInt> barrettMuOut(modqBarrettMu.begin(),
+                                            modqBarrettMu.begin() + sizeQ);
+  barrettMuOut.push_back(modbskBarrettMu[sizeBsk - 1]);
+
+  ModGemmArgs args;
+  args.length = n;
+  args.numIn = sizeB;
+  args.numOut = sizeQ + 1;
+  args.in = in.data();
+  args.inModuli = moduliBWords.data();
+  args.scale = scale.data();
+  args.scalePrecon = scalePrecon.data();
+  args.weights = weights.data();
+  args.out = out.data();
+  args.outModuli = moduliOut.data();
+  args.outBarrettMu = barrettMuOut.data();
+  ModGemm::Multiply(args);
+
   NativeInteger *alphaskxVector = new NativeInteger[n];
 #pragma omp parallel for
   for (uint32_t k = 0; k < n; k++) {
-    DoubleNativeInt result = 0;
-    for (uint32_t i = 0; i < sizeBsk - 1; i++) {
-      const NativeInteger &currentBDivBiModmsk = BHatModmsk[i];
-      result += Mul128(m_vectors[sizeQ + i][k].ConvertToInt(),
-                       currentBDivBiModmsk.ConvertToInt());
-    }
-    alphaskxVector[k] =
-        BarrettUint128ModUint64(result, moduliBsk[sizeBsk - 1].ConvertToInt(),
-                                modbskBarrettMu[sizeBsk - 1]);
+    alphaskxVector[k] = alphaskxValues[k];
   }
 
   // subtract xsk
@@ -3014,9 +3523,104 @@ void DCRTPolyImpl<VecType>::FastBaseConvSK(
 }
 #endif
 
+template <typename VecType>
+std::atomic<bool> &DCRTPolyImpl<VecType>::LazyFormatFlag() {
+  static std::atomic<bool> lazy(false);
+  return lazy;
+}
+
+// performed and elided tower transforms
+template <typename VecType>
+std::atomic<uint64_t> *DCRTPolyImpl<VecType>::FormatSwitchCounters() {
+  static std::atomic<uint64_t> counters[2] = {{0}, {0}};
+  return counters;
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::SetLazyFormat(bool lazy) {
+  LazyFormatFlag().store(lazy, std::memory_order_relaxed);
+}
+
+template <typename VecType>
+bool DCRTPolyImpl<VecType>::IsLazyFormat() {
+  return LazyFormatFlag().load(std::memory_order_relaxed);
+}
+
+template <typename VecType>
+typename DCRTPolyImpl<VecType>::FormatSwitchCounts
+DCRTPolyImpl<VecType>::GetFormatSwitchCounts() {
+  FormatSwitchCounts counts;
+  counts.performed = FormatSwitchCounters()[0].load();
+  counts.elided = FormatSwitchCounters()[1].load();
+  return counts;
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::ResetFormatSwitchCounts() {
+  FormatSwitchCounters()[0] = 0;
+  FormatSwitchCounters()[1] = 0;
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::CountFormatSwitches(uint64_t performed,
+                                                uint64_t elided) {
+  if (!IsLazyFormat()) return;
+  if (performed) FormatSwitchCounters()[0] += performed;
+  if (elided) FormatSwitchCounters()[1] += elided;
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::SetFormat(const Format format) {
+  if (m_format != format) {
+    SwitchFormat();
+  } else {
+    DiscardFormatSwitch();
+  }
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::DeferFormat(const Format format) {
+  if (!IsLazyFormat()) {
+    SetFormat(format);
+  } else if (m_format == format) {
+    DiscardFormatSwitch();
+  } else {
+    m_formatDeferred = true;
+  }
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::ResolveFormat() {
+  if (m_formatDeferred) SwitchFormat();
+}
+
 /*Switch format calls IlVector2n's switchformat*/
 template <typename VecType>
 void DCRTPolyImpl<VecType>::SwitchFormat() {
+  m_formatDeferred = false;
+  if (m_format == Format::COEFFICIENT) {
+    m_format = Format::EVALUATION;
+  } else {
+    m_format = Format::COEFFICIENT;
+  }
+
+  std::vector<PolyType *> towers(m_vectors.size());
+  for (usint i = 0; i < m_vectors.size(); i++) {
+    towers[i] = &m_vectors[i];
+  }
+  PolyType::SwitchFormat(towers);
+  CountFormatSwitches(m_vectors.size(), 0);
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::SwitchFormatPruned(usint stride, usint degree) {
+  if (!NativeNTTEngine::IsValidPruning(GetRingDimension(), stride, degree)) {
+    PALISADE_THROW(math_error,
+                   "pruned transforms need a power-of-two stride dividing "
+                   "the ring dimension n and a degree bound in [1, n]");
+  }
+
+  m_formatDeferred = false;
   if (m_format == Format::COEFFICIENT) {
     m_format = Format::EVALUATION;
   } else {
@@ -3025,8 +3629,28 @@ void DCRTPolyImpl<VecType>::SwitchFormat() {
 
 #pragma omp parallel for
   for (usint i = 0; i < m_vectors.size(); i++) {
-    m_vectors[i].SwitchFormat();
+    m_vectors[i].SwitchFormatPruned(stride, degree);
+  }
+  CountFormatSwitches(m_vectors.size(), 0);
+}
+
+template <typename VecType>
+void DCRTPolyImpl<VecType>::SwitchFormat(
+    const std::vector<DCRTPolyImpl *> &elements) {
+  std::vector<PolyType *> towers;
+  for (DCRTPolyImpl *element : elements) {
+    element->m_formatDeferred = false;
+    if (element->m_format == Format::COEFFICIENT) {
+      element->m_format = Format::EVALUATION;
+    } else {
+      element->m_format = Format::COEFFICIENT;
+    }
+    for (auto &tower : element->m_vectors) {
+      towers.push_back(&tower);
+    }
   }
+  PolyType::SwitchFormat(towers);
+  CountFormatSwitches(towers.size(), 0);
 }
 
 #ifdef OUT
@@ -50,6 +50,25 @@ std::string type_name() {
 
 namespace lbcrypto {
 
+namespace {
+
+// element += sum_j a[j] * b[j]; native vectors have a fused kernel for this
+template <typename VecType>
+void VectorModMulAdd(VecType *element, const std::vector<const VecType *> &a,
+                     const std::vector<const VecType *> &b) {
+  for (usint j = 0; j < a.size(); j++) {
+    element->ModAddEq(a[j]->ModMul(*b[j]));
+  }
+}
+
+inline void VectorModMulAdd(NativeVector *element,
+                            const std::vector<const NativeVector *> &a,
+                            const std::vector<const NativeVector *> &b) {
+  element->ModMulAddEq(a, b);
+}
+
+}  // namespace
+
 template <typename VecType>
 PolyImpl<VecType>::PolyImpl()
     : m_values(nullptr), m_format(Format::EVALUATION) {}
@@ -597,6 +616,37 @@ PolyImpl<VecType> PolyImpl<VecType>::Times(const PolyImpl &element) const {
 
 }
 
+template <typename VecType>
+PolyImpl<VecType> PolyImpl<VecType>::NegacyclicMultiply(
+    const PolyImpl &element) const {
+  if (m_format != Format::COEFFICIENT)
+    PALISADE_THROW(not_implemented_error,
+                   "NegacyclicMultiply for PolyImpl is supported only in "
+                   "Format::COEFFICIENT format.\n");
+
+  if (!(*this->m_params == *element.m_params))
+    PALISADE_THROW(type_error,
+                   "NegacyclicMultiply called on PolyImpl's with different "
+                   "params.");
+
+  PolyImpl tmp = *this;
+  bool transformed = (element.m_format == Format::EVALUATION);
+  if (!NegacyclicMultiplyWithPlan(m_params->GetNTTPlan().get(),
+                                  &(*tmp.m_values), *element.m_values,
+                                  transformed)) {
+    tmp.SwitchFormat();
+    if (transformed) {
+      tmp.m_values->ModMulEq(*element.m_values);
+    } else {
+      PolyImpl other = element;
+      other.SwitchFormat();
+      tmp.m_values->ModMulEq(*other.m_values);
+    }
+    tmp.SwitchFormat();
+  }
+  return tmp;
+}
+
 // TODO: check if the parms tests here should be done in regular op as well as
 // op=? or in neither place?
 
@@ -661,6 +711,45 @@ const PolyImpl<VecType> &PolyImpl<VecType>::operator*=(
   return *this;
 }
 
+template <typename VecType>
+const PolyImpl<VecType> &PolyImpl<VecType>::ModMulAddEq(const PolyImpl &a,
+                                                        const PolyImpl &b) {
+  return ModMulAddEq(std::vector<const PolyImpl *>(1, &a),
+                     std::vector<const PolyImpl *>(1, &b));
+}
+
+template <typename VecType>
+const PolyImpl<VecType> &PolyImpl<VecType>::ModMulAddEq(
+    const std::vector<const PolyImpl *> &a,
+    const std::vector<const PolyImpl *> &b) {
+  if (a.size() != b.size())
+    PALISADE_THROW(math_error,
+                   "ModMulAddEq called with different numbers of operands.");
+
+  std::vector<const VecType *> aValues(a.size()), bValues(b.size());
+  for (usint j = 0; j < a.size(); j++) {
+    if (a[j]->m_format != Format::EVALUATION ||
+        b[j]->m_format != Format::EVALUATION)
+      PALISADE_THROW(not_implemented_error,
+                     "ModMulAddEq for PolyImpl is supported only in "
+                     "Format::EVALUATION format.\n");
+    if (!(*this->m_params == *a[j]->m_params) ||
+        !(*this->m_params == *b[j]->m_params))
+      PALISADE_THROW(type_error,
+                     "ModMulAddEq called on PolyImpl's with different params.");
+    aValues[j] = &(*a[j]->m_values);
+    bValues[j] = &(*b[j]->m_values);
+  }
+
+  if (m_values == nullptr) {
+    // act as tho it's 0
+    m_values = make_unique<VecType>(m_params->GetRingDimension(),
+                                    m_params->GetModulus());
+  }
+  VectorModMulAdd(&(*m_values), aValues, bValues);
+  return *this;
+}
+
 template <typename VecType>
 void PolyImpl<VecType>::AddILElementOne() {
   Integer tempValue;
@@ -674,75 +763,35 @@ void PolyImpl<VecType>::AddILElementOne() {
 template <typename VecType>
 PolyImpl<VecType> PolyImpl<VecType>::AutomorphismTransform(
     const usint &k) const {
-  PolyImpl result(*this);
-
   usint m = this->m_params->GetCyclotomicOrder();
   usint n = this->m_params->GetRingDimension();
 
   if (this->m_format == Format::EVALUATION) {
-    if (!m_params->OrderIsPowerOfTwo()) {
-      // Add a test based on the inverse totient hash table
-      // if (i % 2 == 0)
-      //  PALISADE_THROW(math_error, "automorphism index should be
-      // odd\n");
-
-      const auto &modulus = this->m_params->GetModulus();
-
-      // All automorphism operations are performed for k coprime to m, which are
-      // generated using GetTotientList(m)
-      std::vector<usint> totientList = GetTotientList(m);
-
-      // Temporary vector of size m is introduced
-      // This step can be eliminated by using a hash table that looks up the
-      // ring index (between 0 and n - 1) based on the totient index (between 0
-      // and m - 1)
-      VecType expanded(m, modulus);
-      for (usint i = 0; i < n; i++) {
-        expanded.operator[](totientList.operator[](i)) =
-            m_values->operator[](i);
-      }
-
-      for (usint i = 0; i < n; i++) {
-        // determines which power of primitive root unity we should switch to
-        usint idx = totientList.operator[](i) * k % m;
-        result.m_values->operator[](i) = expanded.operator[](idx);
-      }
-    } else {  // power of two cyclotomics
-      if (k % 2 == 0) {
-        PALISADE_THROW(math_error, "automorphism index should be odd\n");
-      }
-      usint logm = std::round(log2(m));
-      usint logn = std::round(log2(n));
-      for (usint j = 1; j < m; j += 2) {
-        usint idx = (j * k) - (((j * k) >> logm) << logm);
-        usint jrev = ReverseBits(j / 2, logn);
-        usint idxrev = ReverseBits(idx / 2, logn);
-        result.m_values->operator[](jrev) = GetValues().operator[](idxrev);
-      }
-    }
-  } else {
-    // automorphism in Format::COEFFICIENT representation
-    if (!m_params->OrderIsPowerOfTwo()) {
-      PALISADE_THROW(
-          not_implemented_error,
-          "Automorphism in Format::COEFFICIENT representation is not currently "
-          "supported for non-power-of-two polynomials");
-    } else {  // power of two cyclotomics
-      if (k % 2 == 0) {
-        PALISADE_THROW(math_error, "automorphism index should be odd\n");
-      }
+    // the slot permutation is shared by all elements of cyclotomic order m
+    return AutomorphismTransform(k, GetAutomorphismPermutation(m, k));
+  }
 
-      for (usint j = 1; j < n; j++) {
-        usint temp = j * k;
-        usint newIndex = temp % n;
+  // automorphism in Format::COEFFICIENT representation
+  if (!m_params->OrderIsPowerOfTwo()) {
+    PALISADE_THROW(
+        not_implemented_error,
+        "Automorphism in Format::COEFFICIENT representation is not currently "
+        "supported for non-power-of-two polynomials");
+  }
+  if (k % 2 == 0) {
+    PALISADE_THROW(math_error, "automorphism index should be odd\n");
+  }
 
-        if ((temp / n) % 2 == 1) {
-          result.m_values->operator[](newIndex) =
-              m_params->GetModulus() - m_values->operator[](j);
-        } else {
-          result.m_values->operator[](newIndex) = m_values->operator[](j);
-        }
-      }
+  PolyImpl result(*this);
+  for (usint j = 1; j < n; j++) {
+    usint temp = j * k;
+    usint newIndex = temp % n;
+
+    if ((temp / n) % 2 == 1) {
+      result.m_values->operator[](newIndex) =
+          m_params->GetModulus() - m_values->operator[](j);
+    } else {
+      result.m_values->operator[](newIndex) = m_values->operator[](j);
     }
   }
   return result;
@@ -751,22 +800,48 @@ PolyImpl<VecType> PolyImpl<VecType>::AutomorphismTransform(
 template <typename VecType>
 PolyImpl<VecType> PolyImpl<VecType>::AutomorphismTransform(
     usint k, const std::vector<usint> &precomp) const {
-  PolyImpl result(*this);
-  if ((this->m_format == Format::EVALUATION)  && (m_params->OrderIsPowerOfTwo())) {
-      if (k % 2 == 0) {
-        PALISADE_THROW(math_error, "automorphism index should be odd\n");
-      }
-      usint n = this->m_params->GetRingDimension();
+  if (this->m_format != Format::EVALUATION) {
+    PALISADE_THROW(not_implemented_error,
+                   "Precomputed automorphism is implemented only in the "
+                   "EVALUATION representation");
+  }
+  if (m_params->OrderIsPowerOfTwo() && k % 2 == 0) {
+    PALISADE_THROW(math_error, "automorphism index should be odd\n");
+  }
 
-      for (usint j = 0; j < n; j++) {
-        (*result.m_values)[j] = (*m_values)[precomp[j]];
-      }
+  usint n = this->m_params->GetRingDimension();
+  PolyImpl result(m_params, m_format, true);
+  for (usint j = 0; j < n; j++) {
+    (*result.m_values)[j] = (*m_values)[precomp[j]];
+  }
+  return result;
+}
 
-  } else {
-      PALISADE_THROW(
-          not_implemented_error,
-          "Precomputed automorphism is implemented only for power-of-two polynomials in the EVALUATION representation");
-    }
+template <typename VecType>
+PolyImpl<VecType> PolyImpl<VecType>::AutomorphismTransformSum(
+    usint k, const std::vector<usint> &precomp, const PolyImpl &addend) const {
+  if (this->m_format != Format::EVALUATION ||
+      addend.m_format != Format::EVALUATION) {
+    PALISADE_THROW(not_implemented_error,
+                   "Precomputed automorphism is implemented only in the "
+                   "EVALUATION representation");
+  }
+  if (m_params->OrderIsPowerOfTwo() && k % 2 == 0) {
+    PALISADE_THROW(math_error, "automorphism index should be odd\n");
+  }
+  if (m_params->GetModulus() != addend.m_params->GetModulus() ||
+      GetLength() != addend.GetLength()) {
+    PALISADE_THROW(math_error, "Polys must have the same modulus and length");
+  }
+
+  usint n = this->m_params->GetRingDimension();
+  const Integer &modulus = m_params->GetModulus();
+  PolyImpl result(m_params, m_format, true);
+  for (usint j = 0; j < n; j++) {
+    usint idx = precomp[j];
+    (*result.m_values)[j] =
+        (*m_values)[idx].ModAddFast((*addend.m_values)[idx], modulus);
+  }
   return result;
 }
 
@@ -818,6 +893,14 @@ void PolyImpl<VecType>::SwitchModulus(const Integer &modulus,
   }
 }
 
+template <typename VecType>
+void PolyImpl<VecType>::SwitchModulus(const std::shared_ptr<Params> &params) {
+  if (m_values && params->GetModulus() != m_params->GetModulus()) {
+    m_values->SwitchModulus(params->GetModulus());
+  }
+  m_params = params;
+}
+
 template <typename VecType>
 void PolyImpl<VecType>::SwitchFormat() {
   DEBUG_FLAG(false);
@@ -836,23 +919,107 @@ void PolyImpl<VecType>::SwitchFormat() {
 
     DEBUG("transform to Format::EVALUATION m_values was" << *m_values);
 
-    ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverseInPlace(
-        m_params->GetRootOfUnity(), m_params->GetCyclotomicOrder(),
-        &(*m_values));
+    if (!ForwardTransformWithPlan(m_params->GetNTTPlan().get(),
+                                  &(*m_values))) {
+      ChineseRemainderTransformFTT<VecType>::
+          ForwardTransformToBitReverseInPlace(m_params->GetRootOfUnity(),
+                                              m_params->GetCyclotomicOrder(),
+                                              &(*m_values));
+    }
     DEBUG("m_values now in Format::COEFFICIENT " << *m_values);
 
   } else {
     m_format = Format::COEFFICIENT;
     DEBUG("transform to Format::COEFFICIENT m_values was" << *m_values);
 
-    ChineseRemainderTransformFTT<VecType>::
-        InverseTransformFromBitReverseInPlace(m_params->GetRootOfUnity(),
-                                              m_params->GetCyclotomicOrder(),
-                                              &(*m_values));
+    if (!InverseTransformWithPlan(m_params->GetNTTPlan().get(),
+                                  &(*m_values))) {
+      ChineseRemainderTransformFTT<VecType>::
+          InverseTransformFromBitReverseInPlace(m_params->GetRootOfUnity(),
+                                                m_params->GetCyclotomicOrder(),
+                                                &(*m_values));
+    }
     DEBUG("m_values now in Format::EVALUATION " << *m_values);
   }
 }
 
+template <typename VecType>
+void PolyImpl<VecType>::SwitchFormatPruned(usint stride, usint degree) {
+  if (m_values == nullptr) {
+    std::string errMsg = "Poly switch format to empty values";
+    PALISADE_THROW(not_available_error, errMsg);
+  }
+
+  if (m_params->OrderIsPowerOfTwo() == false) {
+    ArbitrarySwitchFormat();
+    return;
+  }
+
+  if (m_format == Format::COEFFICIENT) {
+    m_format = Format::EVALUATION;
+    if (!ForwardTransformPrunedWithPlan(m_params->GetNTTPlan().get(), stride,
+                                        degree, &(*m_values))) {
+      ChineseRemainderTransformFTT<VecType>::
+          ForwardTransformToBitReversePrunedInPlace(
+              m_params->GetRootOfUnity(), m_params->GetCyclotomicOrder(),
+              stride, degree, &(*m_values));
+    }
+  } else {
+    m_format = Format::COEFFICIENT;
+    if (!InverseTransformPrunedWithPlan(m_params->GetNTTPlan().get(), stride,
+                                        degree, &(*m_values))) {
+      ChineseRemainderTransformFTT<VecType>::
+          InverseTransformFromBitReversePrunedInPlace(
+              m_params->GetRootOfUnity(), m_params->GetCyclotomicOrder(),
+              stride, degree, &(*m_values));
+    }
+  }
+}
+
+template <typename VecType>
+void PolyImpl<VecType>::SwitchFormat(const std::vector<PolyImpl *> &elements) {
+  std::vector<PolyImpl *> forward, inverse;
+  std::vector<VecType *> forwardValues, inverseValues;
+  std::vector<const NativeNTTPlan *> forwardPlans, inversePlans;
+  for (PolyImpl *element : elements) {
+    if (element->m_values == nullptr) {
+      std::string errMsg = "Poly switch format to empty values";
+      PALISADE_THROW(not_available_error, errMsg);
+    }
+    if (element->m_format == Format::COEFFICIENT) {
+      forward.push_back(element);
+      forwardValues.push_back(&(*element->m_values));
+      forwardPlans.push_back(element->m_params->GetNTTPlan().get());
+    } else {
+      inverse.push_back(element);
+      inverseValues.push_back(&(*element->m_values));
+      inversePlans.push_back(element->m_params->GetNTTPlan().get());
+    }
+  }
+
+  if (ForwardTransformWithPlans(forwardPlans, forwardValues)) {
+    for (PolyImpl *element : forward) {
+      element->m_format = Format::EVALUATION;
+    }
+  } else {
+#pragma omp parallel for
+    for (usint i = 0; i < forward.size(); i++) {
+      forward[i]->SwitchFormat();
+    }
+  }
+
+  if (InverseTransformWithPlans(inversePlans, inverseValues)) {
+    for (PolyImpl *element : inverse) {
+      element->m_format = Format::COEFFICIENT;
+    }
+  } else {
+#pragma omp parallel for
+    for (usint i = 0; i < inverse.size(); i++) {
+      inverse[i]->SwitchFormat();
+    }
+  }
+}
+
 template <typename VecType>
 void PolyImpl<VecType>::ArbitrarySwitchFormat() {
   DEBUG_FLAG(false);
@@ -37,6 +37,7 @@ template class BinaryUniformGeneratorImpl<M2Vector>;
 template class TernaryUniformGeneratorImpl<M2Vector>;
 template class DiscreteUniformGeneratorImpl<M2Vector>;
 template class ChineseRemainderTransformFTT<M2Vector>;
+template class ArbNTTPlan<M2Vector>;
 template class ChineseRemainderTransformArb<M2Vector>;
 
 template M2Integer RootOfUnity<M2Integer>(usint m, const M2Integer &modulo);
@@ -93,3 +94,5 @@ GADGET_FOR_TYPE(M2Vector)
 
 CEREAL_CLASS_VERSION(M2Integer, M2Integer::SerializedVersion());
 CEREAL_CLASS_VERSION(M2Vector, M2Vector::SerializedVersion());
+CEREAL_CLASS_VERSION(lbcrypto::ArbNTTPlan<M2Vector>,
+                     lbcrypto::ArbNTTPlan<M2Vector>::SerializedVersion());
@@ -39,6 +39,7 @@ template class BinaryUniformGeneratorImpl<M4Vector>;
 template class TernaryUniformGeneratorImpl<M4Vector>;
 template class DiscreteUniformGeneratorImpl<M4Vector>;
 template class ChineseRemainderTransformFTT<M4Vector>;
+template class ArbNTTPlan<M4Vector>;
 template class ChineseRemainderTransformArb<M4Vector>;
 
 template M4Integer RootOfUnity<M4Integer>(usint m, const M4Integer &modulo);
@@ -88,3 +89,5 @@ GADGET_FOR_TYPE(M4Vector)
 
 CEREAL_CLASS_VERSION(M4Integer, M4Integer::SerializedVersion());
 CEREAL_CLASS_VERSION(M4Vector, M4Vector::SerializedVersion());
+CEREAL_CLASS_VERSION(lbcrypto::ArbNTTPlan<M4Vector>,
+                     lbcrypto::ArbNTTPlan<M4Vector>::SerializedVersion());
@@ -41,6 +41,7 @@ template class BinaryUniformGeneratorImpl<M6Vector>;
 template class TernaryUniformGeneratorImpl<M6Vector>;
 template class DiscreteUniformGeneratorImpl<M6Vector>;
 template class ChineseRemainderTransformFTT<M6Vector>;
+template class ArbNTTPlan<M6Vector>;
 template class ChineseRemainderTransformArb<M6Vector>;
 
 template M6Integer RootOfUnity<M6Integer>(usint m, const M6Integer &modulo);
@@ -90,5 +91,7 @@ GADGET_FOR_TYPE(M6Vector)
 
 CEREAL_CLASS_VERSION(M6Integer, M6Integer::SerializedVersion());
 CEREAL_CLASS_VERSION(M6Vector, M6Vector::SerializedVersion());
+CEREAL_CLASS_VERSION(lbcrypto::ArbNTTPlan<M6Vector>,
+                     lbcrypto::ArbNTTPlan<M6Vector>::SerializedVersion());
 
 #endif
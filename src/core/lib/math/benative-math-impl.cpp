@@ -39,6 +39,7 @@ template class BinaryUniformGeneratorImpl<NativeVector>;
 template class TernaryUniformGeneratorImpl<NativeVector>;
 template class DiscreteUniformGeneratorImpl<NativeVector>;
 template class ChineseRemainderTransformFTT<NativeVector>;
+template class ArbNTTPlan<NativeVector>;
 template class ChineseRemainderTransformArb<NativeVector>;
 
 template NativeInteger RootOfUnity<NativeInteger>(usint m,
@@ -99,3 +100,5 @@ GADGET_FOR_TYPE(NativeVector)
 
 CEREAL_CLASS_VERSION(NativeInteger, NativeInteger::SerializedVersion());
 CEREAL_CLASS_VERSION(NativeVector, NativeVector::SerializedVersion());
+CEREAL_CLASS_VERSION(lbcrypto::ArbNTTPlan<NativeVector>,
+                     lbcrypto::ArbNTTPlan<NativeVector>::SerializedVersion());
@@ -24,6 +24,7 @@
 
 #include "math/backend.h"
 #include "math/bigintnat/mubintvecnat.h"
+#include "math/nativevectorkernels.h"
 #include "math/nbtheory.h"
 #include "utils/debug.h"
 #include "utils/serializable.h"
@@ -34,6 +35,22 @@
 
 namespace bigintnat {
 
+namespace {
+
+// the uint64_t storage of a vector of 64-bit native integers, which the
+// element-wise kernels of NativeVectorKernels work on
+template <class Container>
+inline uint64_t *RawData(Container &data) {
+  return reinterpret_cast<uint64_t *>(data.data());
+}
+
+template <class Container>
+inline const uint64_t *RawData(const Container &data) {
+  return reinterpret_cast<const uint64_t *>(data.data());
+}
+
+}  // namespace
+
 // CONSTRUCTORS
 
 template <class IntegerType>
@@ -202,6 +219,10 @@ void NativeVector<IntegerType>::SwitchModulus(const IntegerType &newModulus) {
     intel::hexl::EltwiseCmpAdd(
         op1, op1, m_data.size(), intel::hexl::CMPINT::NLE,
         oldModulusByTwo.ConvertToInt(), diff.ConvertToInt());
+#elif NATIVEINT == 64
+    lbcrypto::NativeVectorKernels::SwitchModulus(
+        RawData(m_data), RawData(m_data), m_data.size(),
+        oldModulus.ConvertToInt(), newModulus.ConvertToInt());
 #else
     for (usint i = 0; i < this->m_data.size(); i++) {
       IntegerType n = this->m_data[i];
@@ -217,6 +238,10 @@ void NativeVector<IntegerType>::SwitchModulus(const IntegerType &newModulus) {
         op1, op1, m_data.size(), newModulus.ConvertToInt(),
         intel::hexl::CMPINT::NLE, oldModulusByTwo.ConvertToInt(),
         diff.ConvertToInt() % newModulus.ConvertToInt());
+#elif NATIVEINT == 64
+    lbcrypto::NativeVectorKernels::SwitchModulus(
+        RawData(m_data), RawData(m_data), m_data.size(),
+        oldModulus.ConvertToInt(), newModulus.ConvertToInt());
 #else
     for (usint i = 0; i < this->m_data.size(); i++) {
       IntegerType n = this->m_data[i];
@@ -278,12 +303,18 @@ NativeVector<IntegerType> NativeVector<IntegerType>::ModAdd(
   IntegerType modulus = this->m_modulus;
   IntegerType bLocal = b;
   NativeVector ans(*this);
-  if (bLocal > m_modulus) {
+  if (bLocal >= m_modulus) {
     bLocal.ModEq(modulus);
   }
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModAddScalar(
+      RawData(m_data), bLocal.ConvertToInt(), RawData(ans.m_data),
+      m_data.size(), modulus.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     ans.m_data[i].ModAddFastEq(bLocal, modulus);
   }
+#endif
   return ans;
 }
 
@@ -292,12 +323,18 @@ const NativeVector<IntegerType> &NativeVector<IntegerType>::ModAddEq(
     const IntegerType &b) {
   IntegerType modulus = this->m_modulus;
   IntegerType bLocal = b;
-  if (bLocal > m_modulus) {
+  if (bLocal >= m_modulus) {
     bLocal.ModEq(modulus);
   }
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModAddScalar(
+      RawData(m_data), bLocal.ConvertToInt(), RawData(m_data), m_data.size(),
+      modulus.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     this->m_data[i].ModAddFastEq(bLocal, modulus);
   }
+#endif
   return *this;
 }
 
@@ -339,9 +376,15 @@ NativeVector<IntegerType> NativeVector<IntegerType>::ModAdd(
   }
   NativeVector ans(*this);
   IntegerType modulus = this->m_modulus;
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModAdd(RawData(m_data), RawData(b.m_data),
+                                        RawData(ans.m_data), m_data.size(),
+                                        modulus.ConvertToInt());
+#else
   for (usint i = 0; i < ans.m_data.size(); i++) {
     ans.m_data[i].ModAddFastEq(b[i], modulus);
   }
+#endif
   return ans;
 }
 
@@ -355,9 +398,15 @@ const NativeVector<IntegerType> &NativeVector<IntegerType>::ModAddEq(
         "ModAddEq called on NativeVector's with different parameters.");
   }
   IntegerType modulus = this->m_modulus;
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModAdd(RawData(m_data), RawData(b.m_data),
+                                        RawData(m_data), m_data.size(),
+                                        modulus.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     this->m_data[i].ModAddFastEq(b[i], modulus);
   }
+#endif
   return *this;
 }
 
@@ -365,18 +414,30 @@ template <class IntegerType>
 NativeVector<IntegerType> NativeVector<IntegerType>::ModSub(
     const IntegerType &b) const {
   NativeVector ans(*this);
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModSubScalar(
+      RawData(m_data), b.Mod(m_modulus).ConvertToInt(), RawData(ans.m_data),
+      m_data.size(), m_modulus.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     ans.m_data[i].ModSubEq(b, this->m_modulus);
   }
+#endif
   return ans;
 }
 
 template <class IntegerType>
 const NativeVector<IntegerType> &NativeVector<IntegerType>::ModSubEq(
     const IntegerType &b) {
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModSubScalar(
+      RawData(m_data), b.Mod(m_modulus).ConvertToInt(), RawData(m_data),
+      m_data.size(), m_modulus.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     this->m_data[i].ModSubEq(b, this->m_modulus);
   }
+#endif
   return *this;
 }
 
@@ -390,9 +451,15 @@ NativeVector<IntegerType> NativeVector<IntegerType>::ModSub(
         "ModSub called on NativeVector's with different parameters.");
   }
   NativeVector ans(*this);
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModSub(RawData(m_data), RawData(b.m_data),
+                                        RawData(ans.m_data), m_data.size(),
+                                        m_modulus.ConvertToInt());
+#else
   for (usint i = 0; i < ans.m_data.size(); i++) {
     ans.m_data[i].ModSubFastEq(b.m_data[i], this->m_modulus);
   }
+#endif
   return ans;
 }
 
@@ -405,9 +472,36 @@ const NativeVector<IntegerType> &NativeVector<IntegerType>::ModSubEq(
         lbcrypto::math_error,
         "ModSubEq called on NativeVector's with different parameters.");
   }
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModSub(RawData(m_data), RawData(b.m_data),
+                                        RawData(m_data), m_data.size(),
+                                        m_modulus.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     this->m_data[i].ModSubFastEq(b.m_data[i], this->m_modulus);
   }
+#endif
+  return *this;
+}
+
+template <class IntegerType>
+NativeVector<IntegerType> NativeVector<IntegerType>::ModNegate() const {
+  NativeVector ans(*this);
+  ans.ModNegateEq();
+  return ans;
+}
+
+template <class IntegerType>
+const NativeVector<IntegerType> &NativeVector<IntegerType>::ModNegateEq() {
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModNegate(RawData(m_data), RawData(m_data),
+                                           m_data.size(),
+                                           m_modulus.ConvertToInt());
+#else
+  for (usint i = 0; i < this->m_data.size(); i++) {
+    this->m_data[i] = IntegerType(0).ModSubFast(this->m_data[i], m_modulus);
+  }
+#endif
   return *this;
 }
 
@@ -421,9 +515,15 @@ NativeVector<IntegerType> NativeVector<IntegerType>::ModMul(
     bLocal.ModEq(modulus);
   }
   IntegerType bPrec = bLocal.PrepModMulConst(modulus);
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModMulScalar(
+      RawData(m_data), bLocal.ConvertToInt(), bPrec.ConvertToInt(),
+      RawData(ans.m_data), m_data.size(), modulus.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     ans.m_data[i].ModMulFastConstEq(bLocal, modulus, bPrec);
   }
+#endif
   return ans;
 }
 
@@ -436,9 +536,15 @@ const NativeVector<IntegerType> &NativeVector<IntegerType>::ModMulEq(
     bLocal.ModEq(modulus);
   }
   IntegerType bPrec = bLocal.PrepModMulConst(modulus);
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModMulScalar(
+      RawData(m_data), bLocal.ConvertToInt(), bPrec.ConvertToInt(),
+      RawData(m_data), m_data.size(), modulus.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     this->m_data[i].ModMulFastConstEq(bLocal, modulus, bPrec);
   }
+#endif
   return *this;
 }
 
@@ -463,9 +569,15 @@ NativeVector<IntegerType> NativeVector<IntegerType>::ModMul(
 
   IntegerType modulus = this->m_modulus;
   IntegerType mu = modulus.ComputeMu();
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModMul(
+      RawData(m_data), RawData(b.m_data), RawData(ans.m_data), m_data.size(),
+      modulus.ConvertToInt(), mu.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     ans.m_data[i].ModMulFastEq(b[i], modulus, mu);
   }
+#endif
   return ans;
 }
 
@@ -489,9 +601,66 @@ const NativeVector<IntegerType> &NativeVector<IntegerType>::ModMulEq(
 
   IntegerType modulus = this->m_modulus;
   IntegerType mu = modulus.ComputeMu();
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModMul(
+      RawData(m_data), RawData(b.m_data), RawData(m_data), m_data.size(),
+      modulus.ConvertToInt(), mu.ConvertToInt());
+#else
   for (usint i = 0; i < this->m_data.size(); i++) {
     this->m_data[i].ModMulFastEq(b[i], modulus, mu);
   }
+#endif
+  return *this;
+}
+
+template <class IntegerType>
+const NativeVector<IntegerType> &NativeVector<IntegerType>::ModMulAddEq(
+    const NativeVector &a, const NativeVector &b) {
+  return ModMulAddEq(std::vector<const NativeVector *>(1, &a),
+                     std::vector<const NativeVector *>(1, &b));
+}
+
+template <class IntegerType>
+const NativeVector<IntegerType> &NativeVector<IntegerType>::ModMulAddEq(
+    const std::vector<const NativeVector *> &a,
+    const std::vector<const NativeVector *> &b) {
+  if (a.size() != b.size()) {
+    PALISADE_THROW(lbcrypto::math_error,
+                   "ModMulAddEq called with different numbers of operands.");
+  }
+  for (usint j = 0; j < a.size(); j++) {
+    if (a[j]->m_data.size() != this->m_data.size() ||
+        b[j]->m_data.size() != this->m_data.size() ||
+        a[j]->m_modulus != this->m_modulus ||
+        b[j]->m_modulus != this->m_modulus) {
+      PALISADE_THROW(
+          lbcrypto::math_error,
+          "ModMulAddEq called on NativeVector's with different parameters.");
+    }
+  }
+  if (a.empty() || this->m_data.empty()) {
+    return *this;
+  }
+
+#if NATIVEINT == 64
+  std::vector<const uint64_t *> aData(a.size()), bData(b.size());
+  for (usint j = 0; j < a.size(); j++) {
+    aData[j] = RawData(a[j]->m_data);
+    bData[j] = RawData(b[j]->m_data);
+  }
+  lbcrypto::NativeVectorKernels::ModMulAdd(
+      aData.data(), bData.data(), a.size(), RawData(m_data), m_data.size(),
+      this->m_modulus.ConvertToInt());
+#else
+  IntegerType modulus = this->m_modulus;
+  IntegerType mu = modulus.ComputeMu();
+  for (usint j = 0; j < a.size(); j++) {
+    for (usint i = 0; i < this->m_data.size(); i++) {
+      this->m_data[i].ModAddFastEq(
+          a[j]->m_data[i].ModMulFast(b[j]->m_data[i], modulus, mu), modulus);
+    }
+  }
+#endif
   return *this;
 }
 
@@ -540,6 +709,11 @@ const NativeVector<IntegerType> &NativeVector<IntegerType>::ModInverseEq() {
 
 template <class IntegerType>
 const NativeVector<IntegerType> &NativeVector<IntegerType>::ModByTwoEq() {
+#if NATIVEINT == 64
+  lbcrypto::NativeVectorKernels::ModByTwo(RawData(m_data), RawData(m_data),
+                                          m_data.size(),
+                                          m_modulus.ConvertToInt());
+#else
   IntegerType halfQ(this->GetModulus() >> 1);
   for (size_t i = 0; i < this->GetLength(); i++) {
     if (this->operator[](i) > halfQ) {
@@ -556,6 +730,7 @@ const NativeVector<IntegerType> &NativeVector<IntegerType>::ModByTwoEq() {
       }
     }
   }
+#endif
   return *this;
 }
 
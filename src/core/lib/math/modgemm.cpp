@@ -0,0 +1,241 @@
+// @file modgemm.cpp Modular matrix products for RNS base conversion.
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "math/modgemm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "math/nativesimd.h"
+#include "utils/utilities.h"
+
+namespace lbcrypto {
+
+#if defined(HAVE_INT128) && NATIVEINT == 64
+
+namespace {
+
+using nativesimd::MulShoupLazy;
+using nativesimd::ReduceOnce;
+
+std::atomic<ModGemmKernel> currentKernel(&ModGemm::TiledKernel);
+
+#if defined(PALISADE_SIMD_X86) && defined(WITH_NATIVE_IFMA)
+
+using nativesimd::IsSmallModulus;
+
+// The IFMA path of TiledKernel(): with scaled inputs, 50-bit moduli and
+// weights below 2^52, the low and the high 52 bits of the products are summed
+// separately in 64 bits (which holds up to 2^12 terms), so the products take
+// two IFMA instructions instead of the 128-bit multiplication.
+bool UseIFMA(const ModGemmArgs &args) {
+  if (SIMDControls::GetEngine() != SIMD_AVX512IFMA || args.scale == nullptr ||
+      args.numIn > 4096) {
+    return false;
+  }
+  for (usint i = 0; i < args.numIn; i++) {
+    if (!IsSmallModulus(args.inModuli[i])) return false;
+  }
+  for (usint j = 0; j < args.numOut; j++) {
+    if (!IsSmallModulus(args.outModuli[j])) return false;
+  }
+  const uint64_t bound = uint64_t(1) << 52;
+  const uint64_t *weightsEnd = args.weights + size_t(args.numIn) * args.numOut;
+  return std::all_of(args.weights, weightsEnd,
+                     [bound](uint64_t w) { return w < bound; });
+}
+
+// GCC reports the self-initialized value behind _mm512_undefined_epi32() used
+// by the AVX-512 intrinsics as possibly uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+PALISADE_TARGET_AVX512IFMA void ScaleIFMA(const uint64_t *x, uint64_t *y,
+                                          usint len, uint64_t w,
+                                          uint64_t wPrecon, uint64_t q) {
+  const __m512i vQ = _mm512_set1_epi64(q);
+  const __m512i vNegQ = _mm512_set1_epi64((uint64_t(1) << 52) - q);
+  const __m512i vW = _mm512_set1_epi64(w);
+  const __m512i vWPrecon = _mm512_set1_epi64(wPrecon >> 12);
+  usint k = 0;
+  for (; k + 8 <= len; k += 8) {
+    __m512i v = nativesimd::MulShoupLazyIFMA(_mm512_loadu_si512(x + k), vW,
+                                             vWPrecon, vNegQ);
+    _mm512_storeu_si512(y + k, nativesimd::ReduceOnceAVX512(v, vQ));
+  }
+  for (; k < len; k++) {
+    y[k] = ReduceOnce(MulShoupLazy(x[k], w, wPrecon, q), q);
+  }
+}
+
+PALISADE_TARGET_AVX512IFMA void AccumulateIFMA(const uint64_t *y, uint64_t w,
+                                               usint len, uint64_t *sumLo,
+                                               uint64_t *sumHi) {
+  const __m512i vW = _mm512_set1_epi64(w);
+  usint k = 0;
+  for (; k + 8 <= len; k += 8) {
+    __m512i v = _mm512_loadu_si512(y + k);
+    _mm512_storeu_si512(
+        sumLo + k, _mm512_madd52lo_epu64(_mm512_loadu_si512(sumLo + k), v, vW));
+    _mm512_storeu_si512(
+        sumHi + k, _mm512_madd52hi_epu64(_mm512_loadu_si512(sumHi + k), v, vW));
+  }
+  for (; k < len; k++) {
+    DoubleNativeInt prod = Mul128(y[k], w);
+    sumLo[k] += static_cast<uint64_t>(prod) & ((uint64_t(1) << 52) - 1);
+    sumHi[k] += static_cast<uint64_t>(prod >> 52);
+  }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#else
+
+bool UseIFMA(const ModGemmArgs &) { return false; }
+
+#endif
+
+}  // namespace
+
+const usint ModGemm::TILE_SIZE;
+
+ModGemmKernel ModGemm::GetKernel() {
+  return currentKernel.load(std::memory_order_relaxed);
+}
+
+void ModGemm::SetKernel(ModGemmKernel kernel) {
+  currentKernel.store(kernel != nullptr ? kernel : &ModGemm::TiledKernel,
+                      std::memory_order_relaxed);
+}
+
+void ModGemm::TiledKernel(const ModGemmArgs &args) {
+  const usint length = args.length;
+  const usint numIn = args.numIn;
+  const usint numOut = args.numOut;
+  const bool scaled = args.scale != nullptr;
+  const bool ifma = UseIFMA(args);
+  const usint numTiles = (length + TILE_SIZE - 1) / TILE_SIZE;
+
+#pragma omp parallel if (numTiles > 1)
+  {
+    std::vector<uint64_t> tile(scaled ? size_t(numIn) * TILE_SIZE : 0);
+    std::vector<const uint64_t *> rows(numIn);
+    std::vector<DoubleNativeInt> sum(ifma ? 0 : TILE_SIZE);
+    std::vector<uint64_t> sumLo(ifma ? TILE_SIZE : 0);
+    std::vector<uint64_t> sumHi(ifma ? TILE_SIZE : 0);
+#pragma omp for
+    for (usint t = 0; t < numTiles; t++) {
+      const usint k0 = t * TILE_SIZE;
+      const usint len = std::min(TILE_SIZE, length - k0);
+
+      for (usint i = 0; i < numIn; i++) {
+        const uint64_t *x = args.in[i] + k0;
+        if (scaled) {
+          const uint64_t qi = args.inModuli[i];
+          const uint64_t w = args.scale[i];
+          const uint64_t wPrecon = args.scalePrecon[i];
+          uint64_t *y = &tile[size_t(i) * TILE_SIZE];
+#if defined(PALISADE_SIMD_X86) && defined(WITH_NATIVE_IFMA)
+          if (ifma) {
+            ScaleIFMA(x, y, len, w, wPrecon, qi);
+            rows[i] = y;
+            continue;
+          }
+#endif
+          for (usint k = 0; k < len; k++) {
+            y[k] = ReduceOnce(MulShoupLazy(x[k], w, wPrecon, qi), qi);
+          }
+          rows[i] = y;
+        } else {
+          rows[i] = x;
+        }
+      }
+
+      for (usint j = 0; j < numOut; j++) {
+        const uint64_t pj = args.outModuli[j];
+        uint64_t *out = args.out[j] + k0;
+#if defined(PALISADE_SIMD_X86) && defined(WITH_NATIVE_IFMA)
+        if (ifma) {
+          std::fill(sumLo.begin(), sumLo.begin() + len, 0);
+          std::fill(sumHi.begin(), sumHi.begin() + len, 0);
+          for (usint i = 0; i < numIn; i++) {
+            AccumulateIFMA(rows[i], args.weights[size_t(i) * numOut + j], len,
+                           sumLo.data(), sumHi.data());
+          }
+          for (usint k = 0; k < len; k++) {
+            DoubleNativeInt total =
+                (static_cast<DoubleNativeInt>(sumHi[k]) << 52) + sumLo[k];
+            out[k] = BarrettUint128ModUint64(total, pj, args.outBarrettMu[j]);
+          }
+          continue;
+        }
+#endif
+        std::fill(sum.begin(), sum.begin() + len, 0);
+        for (usint i = 0; i < numIn; i++) {
+          const uint64_t w = args.weights[size_t(i) * numOut + j];
+          const uint64_t *y = rows[i];
+          for (usint k = 0; k < len; k++) {
+            sum[k] += Mul128(y[k], w);
+          }
+        }
+        for (usint k = 0; k < len; k++) {
+          out[k] = BarrettUint128ModUint64(sum[k], pj, args.outBarrettMu[j]);
+        }
+      }
+    }
+  }
+}
+
+void ModGemm::ReferenceKernel(const ModGemmArgs &args) {
+  const bool scaled = args.scale != nullptr;
+
+#pragma omp parallel for
+  for (usint k = 0; k < args.length; k++) {
+    std::vector<DoubleNativeInt> sum(args.numOut);
+    for (usint i = 0; i < args.numIn; i++) {
+      uint64_t y = args.in[i][k];
+      if (scaled) {
+        y = ReduceOnce(MulShoupLazy(y, args.scale[i], args.scalePrecon[i],
+                                    args.inModuli[i]),
+                       args.inModuli[i]);
+      }
+      for (usint j = 0; j < args.numOut; j++) {
+        sum[j] += Mul128(y, args.weights[size_t(i) * args.numOut + j]);
+      }
+    }
+    for (usint j = 0; j < args.numOut; j++) {
+      args.out[j][k] = BarrettUint128ModUint64(sum[j], args.outModuli[j],
+                                               args.outBarrettMu[j]);
+    }
+  }
+}
+
+#endif
+
+}  // namespace lbcrypto
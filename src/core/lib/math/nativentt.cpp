@@ -0,0 +1,1256 @@
+// @file nativentt.cpp Vectorized number theoretic transforms on 64-bit native vectors
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "math/nativentt.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "math/nativesimd.h"
+
+namespace lbcrypto {
+
+namespace {
+
+using namespace nativesimd;
+
+// Cooley-Tukey butterfly: inputs and outputs in [0,4q)
+inline void ForwardButterfly(uint64_t *x, uint64_t *y, uint64_t w,
+                             uint64_t wPrecon, uint64_t q, uint64_t twoQ) {
+  uint64_t lo = ReduceOnce(*x, twoQ);
+  uint64_t t = MulShoupLazy(*y, w, wPrecon, q);
+  *x = lo + t;
+  *y = lo - t + twoQ;
+}
+
+// Gentleman-Sande butterfly: inputs and outputs in [0,2q)
+inline void InverseButterfly(uint64_t *x, uint64_t *y, uint64_t w,
+                             uint64_t wPrecon, uint64_t q, uint64_t twoQ) {
+  uint64_t lo = *x, hi = *y;
+  *x = ReduceOnce(lo + hi, twoQ);
+  *y = MulShoupLazy(lo - hi + twoQ, w, wPrecon, q);
+}
+
+// a twiddle factor with its Shoup precomputation
+struct Twiddle {
+  uint64_t value;
+  uint64_t precon;
+};
+
+// x * y mod q for x, y in [0,q), using the two-word Barrett ratio
+inline uint64_t MulModBarrett(uint64_t x, uint64_t y, uint64_t q,
+                              const BarrettRatio &r) {
+  return ReduceWide(x * y, MulHi64(x, y), q, r);
+}
+
+// A kernel provides the vectorizable pieces of the transforms:
+//  - ForwardRow/InverseRow apply the butterfly with one twiddle factor to the
+//    count pairs (x[j], y[j]);
+//  - ForwardRow4/InverseRow4 run two consecutive stages (radix 4) on the
+//    count quadruples (x0[j], x1[j], x2[j], x3[j]); in the forward direction
+//    the first stage pairs x0 with x2 and x1 with x3 (twiddle w) and the
+//    second x0 with x1 (twiddle wLo) and x2 with x3 (twiddle wHi), in the
+//    inverse direction the order is reversed;
+//  - Reduce maps the forward output from [0,4q) to [0,q);
+//  - Scale multiplies the inverse output by n^{-1} and maps it to [0,q).
+// The stage loops below are shared by all kernels; rows shorter than the
+// kernel's vector width are done with the scalar butterflies.
+
+struct PortableKernel {
+  static const usint WIDTH = 1;
+
+  static void ForwardRow(uint64_t *x, uint64_t *y, usint count, uint64_t w,
+                         uint64_t wPrecon, uint64_t q) {
+    const uint64_t twoQ = q << 1;
+    for (usint j = 0; j < count; ++j) {
+      ForwardButterfly(x + j, y + j, w, wPrecon, q, twoQ);
+    }
+  }
+
+  static void InverseRow(uint64_t *x, uint64_t *y, usint count, uint64_t w,
+                         uint64_t wPrecon, uint64_t q) {
+    const uint64_t twoQ = q << 1;
+    for (usint j = 0; j < count; ++j) {
+      InverseButterfly(x + j, y + j, w, wPrecon, q, twoQ);
+    }
+  }
+
+  static void ForwardRow4(uint64_t *x0, uint64_t *x1, uint64_t *x2,
+                          uint64_t *x3, usint count, Twiddle w, Twiddle wLo,
+                          Twiddle wHi, uint64_t q) {
+    const uint64_t twoQ = q << 1;
+    for (usint j = 0; j < count; ++j) {
+      ForwardButterfly(x0 + j, x2 + j, w.value, w.precon, q, twoQ);
+      ForwardButterfly(x1 + j, x3 + j, w.value, w.precon, q, twoQ);
+      ForwardButterfly(x0 + j, x1 + j, wLo.value, wLo.precon, q, twoQ);
+      ForwardButterfly(x2 + j, x3 + j, wHi.value, wHi.precon, q, twoQ);
+    }
+  }
+
+  static void InverseRow4(uint64_t *x0, uint64_t *x1, uint64_t *x2,
+                          uint64_t *x3, usint count, Twiddle w, Twiddle wLo,
+                          Twiddle wHi, uint64_t q) {
+    const uint64_t twoQ = q << 1;
+    for (usint j = 0; j < count; ++j) {
+      InverseButterfly(x0 + j, x1 + j, wLo.value, wLo.precon, q, twoQ);
+      InverseButterfly(x2 + j, x3 + j, wHi.value, wHi.precon, q, twoQ);
+      InverseButterfly(x0 + j, x2 + j, w.value, w.precon, q, twoQ);
+      InverseButterfly(x1 + j, x3 + j, w.value, w.precon, q, twoQ);
+    }
+  }
+
+  static void Reduce(uint64_t *a, usint count, uint64_t q) {
+    const uint64_t twoQ = q << 1;
+    for (usint i = 0; i < count; ++i) {
+      a[i] = ReduceOnce(ReduceOnce(a[i], twoQ), q);
+    }
+  }
+
+  static void Scale(uint64_t *a, usint count, uint64_t nInv,
+                    uint64_t nInvPrecon, uint64_t q) {
+    for (usint i = 0; i < count; ++i) {
+      a[i] = ReduceOnce(MulShoupLazy(a[i], nInv, nInvPrecon, q), q);
+    }
+  }
+};
+
+#ifdef PALISADE_SIMD_X86
+
+PALISADE_TARGET_AVX2 inline void ForwardButterflyAVX2(__m256i *x, __m256i *y,
+                                                      __m256i w,
+                                                      __m256i wPrecon,
+                                                      __m256i q,
+                                                      __m256i twoQ) {
+  __m256i lo = ReduceOnceAVX2(*x, twoQ);
+  __m256i prod = MulShoupLazyAVX2(*y, w, wPrecon, q);
+  *x = _mm256_add_epi64(lo, prod);
+  *y = _mm256_add_epi64(_mm256_sub_epi64(lo, prod), twoQ);
+}
+
+PALISADE_TARGET_AVX2 inline void InverseButterflyAVX2(__m256i *x, __m256i *y,
+                                                      __m256i w,
+                                                      __m256i wPrecon,
+                                                      __m256i q,
+                                                      __m256i twoQ) {
+  __m256i lo = *x, hi = *y;
+  *x = ReduceOnceAVX2(_mm256_add_epi64(lo, hi), twoQ);
+  *y = MulShoupLazyAVX2(_mm256_add_epi64(_mm256_sub_epi64(lo, hi), twoQ), w,
+                        wPrecon, q);
+}
+
+struct AVX2Kernel {
+  static const usint WIDTH = 4;
+
+  PALISADE_TARGET_AVX2 static void ForwardRow(uint64_t *x, uint64_t *y,
+                                              usint count, uint64_t w,
+                                              uint64_t wPrecon, uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vTwoQ = _mm256_set1_epi64x(q << 1);
+    const __m256i vW = _mm256_set1_epi64x(w);
+    const __m256i vWPrecon = _mm256_set1_epi64x(wPrecon);
+    usint j = 0;
+    for (; j + 4 <= count; j += 4) {
+      __m256i lo = LoadAVX2(x + j), hi = LoadAVX2(y + j);
+      ForwardButterflyAVX2(&lo, &hi, vW, vWPrecon, vQ, vTwoQ);
+      StoreAVX2(x + j, lo);
+      StoreAVX2(y + j, hi);
+    }
+    PortableKernel::ForwardRow(x + j, y + j, count - j, w, wPrecon, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void InverseRow(uint64_t *x, uint64_t *y,
+                                              usint count, uint64_t w,
+                                              uint64_t wPrecon, uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vTwoQ = _mm256_set1_epi64x(q << 1);
+    const __m256i vW = _mm256_set1_epi64x(w);
+    const __m256i vWPrecon = _mm256_set1_epi64x(wPrecon);
+    usint j = 0;
+    for (; j + 4 <= count; j += 4) {
+      __m256i lo = LoadAVX2(x + j), hi = LoadAVX2(y + j);
+      InverseButterflyAVX2(&lo, &hi, vW, vWPrecon, vQ, vTwoQ);
+      StoreAVX2(x + j, lo);
+      StoreAVX2(y + j, hi);
+    }
+    PortableKernel::InverseRow(x + j, y + j, count - j, w, wPrecon, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void ForwardRow4(uint64_t *x0, uint64_t *x1,
+                                               uint64_t *x2, uint64_t *x3,
+                                               usint count, Twiddle w,
+                                               Twiddle wLo, Twiddle wHi,
+                                               uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vTwoQ = _mm256_set1_epi64x(q << 1);
+    const __m256i vW = _mm256_set1_epi64x(w.value);
+    const __m256i vWPrecon = _mm256_set1_epi64x(w.precon);
+    const __m256i vWLo = _mm256_set1_epi64x(wLo.value);
+    const __m256i vWLoPrecon = _mm256_set1_epi64x(wLo.precon);
+    const __m256i vWHi = _mm256_set1_epi64x(wHi.value);
+    const __m256i vWHiPrecon = _mm256_set1_epi64x(wHi.precon);
+    usint j = 0;
+    for (; j + 4 <= count; j += 4) {
+      __m256i v0 = LoadAVX2(x0 + j), v1 = LoadAVX2(x1 + j);
+      __m256i v2 = LoadAVX2(x2 + j), v3 = LoadAVX2(x3 + j);
+      ForwardButterflyAVX2(&v0, &v2, vW, vWPrecon, vQ, vTwoQ);
+      ForwardButterflyAVX2(&v1, &v3, vW, vWPrecon, vQ, vTwoQ);
+      ForwardButterflyAVX2(&v0, &v1, vWLo, vWLoPrecon, vQ, vTwoQ);
+      ForwardButterflyAVX2(&v2, &v3, vWHi, vWHiPrecon, vQ, vTwoQ);
+      StoreAVX2(x0 + j, v0);
+      StoreAVX2(x1 + j, v1);
+      StoreAVX2(x2 + j, v2);
+      StoreAVX2(x3 + j, v3);
+    }
+    PortableKernel::ForwardRow4(x0 + j, x1 + j, x2 + j, x3 + j, count - j, w,
+                                wLo, wHi, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void InverseRow4(uint64_t *x0, uint64_t *x1,
+                                               uint64_t *x2, uint64_t *x3,
+                                               usint count, Twiddle w,
+                                               Twiddle wLo, Twiddle wHi,
+                                               uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vTwoQ = _mm256_set1_epi64x(q << 1);
+    const __m256i vW = _mm256_set1_epi64x(w.value);
+    const __m256i vWPrecon = _mm256_set1_epi64x(w.precon);
+    const __m256i vWLo = _mm256_set1_epi64x(wLo.value);
+    const __m256i vWLoPrecon = _mm256_set1_epi64x(wLo.precon);
+    const __m256i vWHi = _mm256_set1_epi64x(wHi.value);
+    const __m256i vWHiPrecon = _mm256_set1_epi64x(wHi.precon);
+    usint j = 0;
+    for (; j + 4 <= count; j += 4) {
+      __m256i v0 = LoadAVX2(x0 + j), v1 = LoadAVX2(x1 + j);
+      __m256i v2 = LoadAVX2(x2 + j), v3 = LoadAVX2(x3 + j);
+      InverseButterflyAVX2(&v0, &v1, vWLo, vWLoPrecon, vQ, vTwoQ);
+      InverseButterflyAVX2(&v2, &v3, vWHi, vWHiPrecon, vQ, vTwoQ);
+      InverseButterflyAVX2(&v0, &v2, vW, vWPrecon, vQ, vTwoQ);
+      InverseButterflyAVX2(&v1, &v3, vW, vWPrecon, vQ, vTwoQ);
+      StoreAVX2(x0 + j, v0);
+      StoreAVX2(x1 + j, v1);
+      StoreAVX2(x2 + j, v2);
+      StoreAVX2(x3 + j, v3);
+    }
+    PortableKernel::InverseRow4(x0 + j, x1 + j, x2 + j, x3 + j, count - j, w,
+                                wLo, wHi, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void Reduce(uint64_t *a, usint count,
+                                          uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vTwoQ = _mm256_set1_epi64x(q << 1);
+    usint i = 0;
+    for (; i + 4 <= count; i += 4) {
+      StoreAVX2(a + i,
+                ReduceOnceAVX2(ReduceOnceAVX2(LoadAVX2(a + i), vTwoQ), vQ));
+    }
+    PortableKernel::Reduce(a + i, count - i, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void Scale(uint64_t *a, usint count,
+                                         uint64_t nInv, uint64_t nInvPrecon,
+                                         uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vNInv = _mm256_set1_epi64x(nInv);
+    const __m256i vNInvPrecon = _mm256_set1_epi64x(nInvPrecon);
+    usint i = 0;
+    for (; i + 4 <= count; i += 4) {
+      StoreAVX2(a + i, ReduceOnceAVX2(MulShoupLazyAVX2(LoadAVX2(a + i), vNInv,
+                                                       vNInvPrecon, vQ),
+                                      vQ));
+    }
+    PortableKernel::Scale(a + i, count - i, nInv, nInvPrecon, q);
+  }
+};
+
+// The double-precision variant of the AVX2 kernel for q < 2^50 (see
+// MulShoupLazyFMA()): the coefficients stay integers, only the products are
+// taken in double precision
+
+PALISADE_TARGET_AVX2 inline void ForwardButterflyFMA(__m256i *x, __m256i *y,
+                                                     __m256d w, __m256d wRatio,
+                                                     __m256d q, __m256d twoQ,
+                                                     __m256i twoQInt) {
+  __m256i lo = ReduceOnceAVX2(*x, twoQInt);
+  __m256i prod =
+      ToIntAVX2(MulShoupLazyFMA(ToDoubleAVX2(*y), w, wRatio, twoQ, q));
+  *x = _mm256_add_epi64(lo, prod);
+  *y = _mm256_add_epi64(_mm256_sub_epi64(lo, prod), twoQInt);
+}
+
+PALISADE_TARGET_AVX2 inline void InverseButterflyFMA(__m256i *x, __m256i *y,
+                                                     __m256d w, __m256d wRatio,
+                                                     __m256d q, __m256d twoQ,
+                                                     __m256i twoQInt) {
+  __m256i lo = *x, hi = *y;
+  *x = ReduceOnceAVX2(_mm256_add_epi64(lo, hi), twoQInt);
+  __m256i diff = _mm256_add_epi64(_mm256_sub_epi64(lo, hi), twoQInt);
+  *y = ToIntAVX2(MulShoupLazyFMA(ToDoubleAVX2(diff), w, wRatio, twoQ, q));
+}
+
+PALISADE_TARGET_AVX2 inline __m256d RatioFMA(uint64_t wPrecon) {
+  return _mm256_set1_pd(static_cast<double>(wPrecon) * SHOUP_TO_RATIO);
+}
+
+struct AVX2FMAKernel : public AVX2Kernel {
+  PALISADE_TARGET_AVX2 static void ForwardRow(uint64_t *x, uint64_t *y,
+                                              usint count, uint64_t w,
+                                              uint64_t wPrecon, uint64_t q) {
+    const __m256d vQ = _mm256_set1_pd(static_cast<double>(q));
+    const __m256d vTwoQ = _mm256_set1_pd(static_cast<double>(q << 1));
+    const __m256i vTwoQInt = _mm256_set1_epi64x(q << 1);
+    const __m256d vW = _mm256_set1_pd(static_cast<double>(w));
+    const __m256d vWRatio = RatioFMA(wPrecon);
+    usint j = 0;
+    for (; j + 4 <= count; j += 4) {
+      __m256i lo = LoadAVX2(x + j), hi = LoadAVX2(y + j);
+      ForwardButterflyFMA(&lo, &hi, vW, vWRatio, vQ, vTwoQ, vTwoQInt);
+      StoreAVX2(x + j, lo);
+      StoreAVX2(y + j, hi);
+    }
+    PortableKernel::ForwardRow(x + j, y + j, count - j, w, wPrecon, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void InverseRow(uint64_t *x, uint64_t *y,
+                                              usint count, uint64_t w,
+                                              uint64_t wPrecon, uint64_t q) {
+    const __m256d vQ = _mm256_set1_pd(static_cast<double>(q));
+    const __m256d vTwoQ = _mm256_set1_pd(static_cast<double>(q << 1));
+    const __m256i vTwoQInt = _mm256_set1_epi64x(q << 1);
+    const __m256d vW = _mm256_set1_pd(static_cast<double>(w));
+    const __m256d vWRatio = RatioFMA(wPrecon);
+    usint j = 0;
+    for (; j + 4 <= count; j += 4) {
+      __m256i lo = LoadAVX2(x + j), hi = LoadAVX2(y + j);
+      InverseButterflyFMA(&lo, &hi, vW, vWRatio, vQ, vTwoQ, vTwoQInt);
+      StoreAVX2(x + j, lo);
+      StoreAVX2(y + j, hi);
+    }
+    PortableKernel::InverseRow(x + j, y + j, count - j, w, wPrecon, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void ForwardRow4(uint64_t *x0, uint64_t *x1,
+                                               uint64_t *x2, uint64_t *x3,
+                                               usint count, Twiddle w,
+                                               Twiddle wLo, Twiddle wHi,
+                                               uint64_t q) {
+    const __m256d vQ = _mm256_set1_pd(static_cast<double>(q));
+    const __m256d vTwoQ = _mm256_set1_pd(static_cast<double>(q << 1));
+    const __m256i vTwoQInt = _mm256_set1_epi64x(q << 1);
+    const __m256d vW = _mm256_set1_pd(static_cast<double>(w.value));
+    const __m256d vWRatio = RatioFMA(w.precon);
+    const __m256d vWLo = _mm256_set1_pd(static_cast<double>(wLo.value));
+    const __m256d vWLoRatio = RatioFMA(wLo.precon);
+    const __m256d vWHi = _mm256_set1_pd(static_cast<double>(wHi.value));
+    const __m256d vWHiRatio = RatioFMA(wHi.precon);
+    usint j = 0;
+    for (; j + 4 <= count; j += 4) {
+      __m256i v0 = LoadAVX2(x0 + j), v1 = LoadAVX2(x1 + j);
+      __m256i v2 = LoadAVX2(x2 + j), v3 = LoadAVX2(x3 + j);
+      ForwardButterflyFMA(&v0, &v2, vW, vWRatio, vQ, vTwoQ, vTwoQInt);
+      ForwardButterflyFMA(&v1, &v3, vW, vWRatio, vQ, vTwoQ, vTwoQInt);
+      ForwardButterflyFMA(&v0, &v1, vWLo, vWLoRatio, vQ, vTwoQ, vTwoQInt);
+      ForwardButterflyFMA(&v2, &v3, vWHi, vWHiRatio, vQ, vTwoQ, vTwoQInt);
+      StoreAVX2(x0 + j, v0);
+      StoreAVX2(x1 + j, v1);
+      StoreAVX2(x2 + j, v2);
+      StoreAVX2(x3 + j, v3);
+    }
+    PortableKernel::ForwardRow4(x0 + j, x1 + j, x2 + j, x3 + j, count - j, w,
+                                wLo, wHi, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void InverseRow4(uint64_t *x0, uint64_t *x1,
+                                               uint64_t *x2, uint64_t *x3,
+                                               usint count, Twiddle w,
+                                               Twiddle wLo, Twiddle wHi,
+                                               uint64_t q) {
+    const __m256d vQ = _mm256_set1_pd(static_cast<double>(q));
+    const __m256d vTwoQ = _mm256_set1_pd(static_cast<double>(q << 1));
+    const __m256i vTwoQInt = _mm256_set1_epi64x(q << 1);
+    const __m256d vW = _mm256_set1_pd(static_cast<double>(w.value));
+    const __m256d vWRatio = RatioFMA(w.precon);
+    const __m256d vWLo = _mm256_set1_pd(static_cast<double>(wLo.value));
+    const __m256d vWLoRatio = RatioFMA(wLo.precon);
+    const __m256d vWHi = _mm256_set1_pd(static_cast<double>(wHi.value));
+    const __m256d vWHiRatio = RatioFMA(wHi.precon);
+    usint j = 0;
+    for (; j + 4 <= count; j += 4) {
+      __m256i v0 = LoadAVX2(x0 + j), v1 = LoadAVX2(x1 + j);
+      __m256i v2 = LoadAVX2(x2 + j), v3 = LoadAVX2(x3 + j);
+      InverseButterflyFMA(&v0, &v1, vWLo, vWLoRatio, vQ, vTwoQ, vTwoQInt);
+      InverseButterflyFMA(&v2, &v3, vWHi, vWHiRatio, vQ, vTwoQ, vTwoQInt);
+      InverseButterflyFMA(&v0, &v2, vW, vWRatio, vQ, vTwoQ, vTwoQInt);
+      InverseButterflyFMA(&v1, &v3, vW, vWRatio, vQ, vTwoQ, vTwoQInt);
+      StoreAVX2(x0 + j, v0);
+      StoreAVX2(x1 + j, v1);
+      StoreAVX2(x2 + j, v2);
+      StoreAVX2(x3 + j, v3);
+    }
+    PortableKernel::InverseRow4(x0 + j, x1 + j, x2 + j, x3 + j, count - j, w,
+                                wLo, wHi, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void Scale(uint64_t *a, usint count,
+                                         uint64_t nInv, uint64_t nInvPrecon,
+                                         uint64_t q) {
+    const __m256d vQ = _mm256_set1_pd(static_cast<double>(q));
+    const __m256d vTwoQ = _mm256_set1_pd(static_cast<double>(q << 1));
+    const __m256i vQInt = _mm256_set1_epi64x(q);
+    const __m256d vNInv = _mm256_set1_pd(static_cast<double>(nInv));
+    const __m256d vNInvRatio = RatioFMA(nInvPrecon);
+    usint i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m256d v = ToDoubleAVX2(LoadAVX2(a + i));
+      v = MulShoupLazyFMA(v, vNInv, vNInvRatio, vTwoQ, vQ);
+      StoreAVX2(a + i, ReduceOnceAVX2(ToIntAVX2(v), vQInt));
+    }
+    PortableKernel::Scale(a + i, count - i, nInv, nInvPrecon, q);
+  }
+};
+
+// GCC reports the self-initialized value behind _mm512_undefined_epi32() used
+// by the AVX-512 intrinsics as possibly uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+PALISADE_TARGET_AVX512 inline void ForwardButterflyAVX512(
+    __m512i *x, __m512i *y, __m512i w, __m512i wPrecon, __m512i q,
+    __m512i twoQ) {
+  __m512i lo = ReduceOnceAVX512(*x, twoQ);
+  __m512i prod = MulShoupLazyAVX512(*y, w, wPrecon, q);
+  *x = _mm512_add_epi64(lo, prod);
+  *y = _mm512_add_epi64(_mm512_sub_epi64(lo, prod), twoQ);
+}
+
+PALISADE_TARGET_AVX512 inline void InverseButterflyAVX512(
+    __m512i *x, __m512i *y, __m512i w, __m512i wPrecon, __m512i q,
+    __m512i twoQ) {
+  __m512i lo = *x, hi = *y;
+  *x = ReduceOnceAVX512(_mm512_add_epi64(lo, hi), twoQ);
+  *y = MulShoupLazyAVX512(_mm512_add_epi64(_mm512_sub_epi64(lo, hi), twoQ),
+                          w, wPrecon, q);
+}
+
+struct AVX512Kernel {
+  static const usint WIDTH = 8;
+
+  PALISADE_TARGET_AVX512 static void ForwardRow(uint64_t *x, uint64_t *y,
+                                                usint count, uint64_t w,
+                                                uint64_t wPrecon,
+                                                uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vW = _mm512_set1_epi64(w);
+    const __m512i vWPrecon = _mm512_set1_epi64(wPrecon);
+    usint j = 0;
+    for (; j + 8 <= count; j += 8) {
+      __m512i lo = _mm512_loadu_si512(x + j), hi = _mm512_loadu_si512(y + j);
+      ForwardButterflyAVX512(&lo, &hi, vW, vWPrecon, vQ, vTwoQ);
+      _mm512_storeu_si512(x + j, lo);
+      _mm512_storeu_si512(y + j, hi);
+    }
+    PortableKernel::ForwardRow(x + j, y + j, count - j, w, wPrecon, q);
+  }
+
+  PALISADE_TARGET_AVX512 static void InverseRow(uint64_t *x, uint64_t *y,
+                                                usint count, uint64_t w,
+                                                uint64_t wPrecon,
+                                                uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vW = _mm512_set1_epi64(w);
+    const __m512i vWPrecon = _mm512_set1_epi64(wPrecon);
+    usint j = 0;
+    for (; j + 8 <= count; j += 8) {
+      __m512i lo = _mm512_loadu_si512(x + j), hi = _mm512_loadu_si512(y + j);
+      InverseButterflyAVX512(&lo, &hi, vW, vWPrecon, vQ, vTwoQ);
+      _mm512_storeu_si512(x + j, lo);
+      _mm512_storeu_si512(y + j, hi);
+    }
+    PortableKernel::InverseRow(x + j, y + j, count - j, w, wPrecon, q);
+  }
+
+  PALISADE_TARGET_AVX512 static void ForwardRow4(uint64_t *x0, uint64_t *x1,
+                                                 uint64_t *x2, uint64_t *x3,
+                                                 usint count, Twiddle w,
+                                                 Twiddle wLo, Twiddle wHi,
+                                                 uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vW = _mm512_set1_epi64(w.value);
+    const __m512i vWPrecon = _mm512_set1_epi64(w.precon);
+    const __m512i vWLo = _mm512_set1_epi64(wLo.value);
+    const __m512i vWLoPrecon = _mm512_set1_epi64(wLo.precon);
+    const __m512i vWHi = _mm512_set1_epi64(wHi.value);
+    const __m512i vWHiPrecon = _mm512_set1_epi64(wHi.precon);
+    usint j = 0;
+    for (; j + 8 <= count; j += 8) {
+      __m512i v0 = _mm512_loadu_si512(x0 + j), v1 = _mm512_loadu_si512(x1 + j);
+      __m512i v2 = _mm512_loadu_si512(x2 + j), v3 = _mm512_loadu_si512(x3 + j);
+      ForwardButterflyAVX512(&v0, &v2, vW, vWPrecon, vQ, vTwoQ);
+      ForwardButterflyAVX512(&v1, &v3, vW, vWPrecon, vQ, vTwoQ);
+      ForwardButterflyAVX512(&v0, &v1, vWLo, vWLoPrecon, vQ, vTwoQ);
+      ForwardButterflyAVX512(&v2, &v3, vWHi, vWHiPrecon, vQ, vTwoQ);
+      _mm512_storeu_si512(x0 + j, v0);
+      _mm512_storeu_si512(x1 + j, v1);
+      _mm512_storeu_si512(x2 + j, v2);
+      _mm512_storeu_si512(x3 + j, v3);
+    }
+    PortableKernel::ForwardRow4(x0 + j, x1 + j, x2 + j, x3 + j, count - j, w,
+                                wLo, wHi, q);
+  }
+
+  PALISADE_TARGET_AVX512 static void InverseRow4(uint64_t *x0, uint64_t *x1,
+                                                 uint64_t *x2, uint64_t *x3,
+                                                 usint count, Twiddle w,
+                                                 Twiddle wLo, Twiddle wHi,
+                                                 uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vW = _mm512_set1_epi64(w.value);
+    const __m512i vWPrecon = _mm512_set1_epi64(w.precon);
+    const __m512i vWLo = _mm512_set1_epi64(wLo.value);
+    const __m512i vWLoPrecon = _mm512_set1_epi64(wLo.precon);
+    const __m512i vWHi = _mm512_set1_epi64(wHi.value);
+    const __m512i vWHiPrecon = _mm512_set1_epi64(wHi.precon);
+    usint j = 0;
+    for (; j + 8 <= count; j += 8) {
+      __m512i v0 = _mm512_loadu_si512(x0 + j), v1 = _mm512_loadu_si512(x1 + j);
+      __m512i v2 = _mm512_loadu_si512(x2 + j), v3 = _mm512_loadu_si512(x3 + j);
+      InverseButterflyAVX512(&v0, &v1, vWLo, vWLoPrecon, vQ, vTwoQ);
+      InverseButterflyAVX512(&v2, &v3, vWHi, vWHiPrecon, vQ, vTwoQ);
+      InverseButterflyAVX512(&v0, &v2, vW, vWPrecon, vQ, vTwoQ);
+      InverseButterflyAVX512(&v1, &v3, vW, vWPrecon, vQ, vTwoQ);
+      _mm512_storeu_si512(x0 + j, v0);
+      _mm512_storeu_si512(x1 + j, v1);
+      _mm512_storeu_si512(x2 + j, v2);
+      _mm512_storeu_si512(x3 + j, v3);
+    }
+    PortableKernel::InverseRow4(x0 + j, x1 + j, x2 + j, x3 + j, count - j, w,
+                                wLo, wHi, q);
+  }
+
+  PALISADE_TARGET_AVX512 static void Reduce(uint64_t *a, usint count,
+                                            uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    usint i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m512i v = _mm512_loadu_si512(a + i);
+      v = ReduceOnceAVX512(ReduceOnceAVX512(v, vTwoQ), vQ);
+      _mm512_storeu_si512(a + i, v);
+    }
+    PortableKernel::Reduce(a + i, count - i, q);
+  }
+
+  PALISADE_TARGET_AVX512 static void Scale(uint64_t *a, usint count,
+                                           uint64_t nInv, uint64_t nInvPrecon,
+                                           uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vNInv = _mm512_set1_epi64(nInv);
+    const __m512i vNInvPrecon = _mm512_set1_epi64(nInvPrecon);
+    usint i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m512i v = _mm512_loadu_si512(a + i);
+      v = ReduceOnceAVX512(MulShoupLazyAVX512(v, vNInv, vNInvPrecon, vQ), vQ);
+      _mm512_storeu_si512(a + i, v);
+    }
+    PortableKernel::Scale(a + i, count - i, nInv, nInvPrecon, q);
+  }
+};
+
+#ifdef WITH_NATIVE_IFMA
+
+// The IFMA variant of the AVX-512 kernel for q < 2^50: the butterflies take
+// the 52-bit Shoup precomputations (see MulShoupLazyIFMA())
+
+PALISADE_TARGET_AVX512IFMA inline void ForwardButterflyIFMA(
+    __m512i *x, __m512i *y, __m512i w, __m512i wPrecon52, __m512i negQ,
+    __m512i twoQ) {
+  __m512i lo = ReduceOnceAVX512(*x, twoQ);
+  __m512i prod = MulShoupLazyIFMA(*y, w, wPrecon52, negQ);
+  *x = _mm512_add_epi64(lo, prod);
+  *y = _mm512_add_epi64(_mm512_sub_epi64(lo, prod), twoQ);
+}
+
+PALISADE_TARGET_AVX512IFMA inline void InverseButterflyIFMA(
+    __m512i *x, __m512i *y, __m512i w, __m512i wPrecon52, __m512i negQ,
+    __m512i twoQ) {
+  __m512i lo = *x, hi = *y;
+  *x = ReduceOnceAVX512(_mm512_add_epi64(lo, hi), twoQ);
+  *y = MulShoupLazyIFMA(_mm512_add_epi64(_mm512_sub_epi64(lo, hi), twoQ), w,
+                        wPrecon52, negQ);
+}
+
+struct IFMAKernel : public AVX512Kernel {
+  PALISADE_TARGET_AVX512IFMA static void ForwardRow(uint64_t *x, uint64_t *y,
+                                                    usint count, uint64_t w,
+                                                    uint64_t wPrecon,
+                                                    uint64_t q) {
+    const __m512i vNegQ = _mm512_set1_epi64((uint64_t(1) << 52) - q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vW = _mm512_set1_epi64(w);
+    const __m512i vWPrecon = _mm512_set1_epi64(wPrecon >> 12);
+    usint j = 0;
+    for (; j + 8 <= count; j += 8) {
+      __m512i lo = _mm512_loadu_si512(x + j), hi = _mm512_loadu_si512(y + j);
+      ForwardButterflyIFMA(&lo, &hi, vW, vWPrecon, vNegQ, vTwoQ);
+      _mm512_storeu_si512(x + j, lo);
+      _mm512_storeu_si512(y + j, hi);
+    }
+    PortableKernel::ForwardRow(x + j, y + j, count - j, w, wPrecon, q);
+  }
+
+  PALISADE_TARGET_AVX512IFMA static void InverseRow(uint64_t *x, uint64_t *y,
+                                                    usint count, uint64_t w,
+                                                    uint64_t wPrecon,
+                                                    uint64_t q) {
+    const __m512i vNegQ = _mm512_set1_epi64((uint64_t(1) << 52) - q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vW = _mm512_set1_epi64(w);
+    const __m512i vWPrecon = _mm512_set1_epi64(wPrecon >> 12);
+    usint j = 0;
+    for (; j + 8 <= count; j += 8) {
+      __m512i lo = _mm512_loadu_si512(x + j), hi = _mm512_loadu_si512(y + j);
+      InverseButterflyIFMA(&lo, &hi, vW, vWPrecon, vNegQ, vTwoQ);
+      _mm512_storeu_si512(x + j, lo);
+      _mm512_storeu_si512(y + j, hi);
+    }
+    PortableKernel::InverseRow(x + j, y + j, count - j, w, wPrecon, q);
+  }
+
+  PALISADE_TARGET_AVX512IFMA static void ForwardRow4(
+      uint64_t *x0, uint64_t *x1, uint64_t *x2, uint64_t *x3, usint count,
+      Twiddle w, Twiddle wLo, Twiddle wHi, uint64_t q) {
+    const __m512i vNegQ = _mm512_set1_epi64((uint64_t(1) << 52) - q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vW = _mm512_set1_epi64(w.value);
+    const __m512i vWPrecon = _mm512_set1_epi64(w.precon >> 12);
+    const __m512i vWLo = _mm512_set1_epi64(wLo.value);
+    const __m512i vWLoPrecon = _mm512_set1_epi64(wLo.precon >> 12);
+    const __m512i vWHi = _mm512_set1_epi64(wHi.value);
+    const __m512i vWHiPrecon = _mm512_set1_epi64(wHi.precon >> 12);
+    usint j = 0;
+    for (; j + 8 <= count; j += 8) {
+      __m512i v0 = _mm512_loadu_si512(x0 + j), v1 = _mm512_loadu_si512(x1 + j);
+      __m512i v2 = _mm512_loadu_si512(x2 + j), v3 = _mm512_loadu_si512(x3 + j);
+      ForwardButterflyIFMA(&v0, &v2, vW, vWPrecon, vNegQ, vTwoQ);
+      ForwardButterflyIFMA(&v1, &v3, vW, vWPrecon, vNegQ, vTwoQ);
+      ForwardButterflyIFMA(&v0, &v1, vWLo, vWLoPrecon, vNegQ, vTwoQ);
+      ForwardButterflyIFMA(&v2, &v3, vWHi, vWHiPrecon, vNegQ, vTwoQ);
+      _mm512_storeu_si512(x0 + j, v0);
+      _mm512_storeu_si512(x1 + j, v1);
+      _mm512_storeu_si512(x2 + j, v2);
+      _mm512_storeu_si512(x3 + j, v3);
+    }
+    PortableKernel::ForwardRow4(x0 + j, x1 + j, x2 + j, x3 + j, count - j, w,
+                                wLo, wHi, q);
+  }
+
+  PALISADE_TARGET_AVX512IFMA static void InverseRow4(
+      uint64_t *x0, uint64_t *x1, uint64_t *x2, uint64_t *x3, usint count,
+      Twiddle w, Twiddle wLo, Twiddle wHi, uint64_t q) {
+    const __m512i vNegQ = _mm512_set1_epi64((uint64_t(1) << 52) - q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vW = _mm512_set1_epi64(w.value);
+    const __m512i vWPrecon = _mm512_set1_epi64(w.precon >> 12);
+    const __m512i vWLo = _mm512_set1_epi64(wLo.value);
+    const __m512i vWLoPrecon = _mm512_set1_epi64(wLo.precon >> 12);
+    const __m512i vWHi = _mm512_set1_epi64(wHi.value);
+    const __m512i vWHiPrecon = _mm512_set1_epi64(wHi.precon >> 12);
+    usint j = 0;
+    for (; j + 8 <= count; j += 8) {
+      __m512i v0 = _mm512_loadu_si512(x0 + j), v1 = _mm512_loadu_si512(x1 + j);
+      __m512i v2 = _mm512_loadu_si512(x2 + j), v3 = _mm512_loadu_si512(x3 + j);
+      InverseButterflyIFMA(&v0, &v1, vWLo, vWLoPrecon, vNegQ, vTwoQ);
+      InverseButterflyIFMA(&v2, &v3, vWHi, vWHiPrecon, vNegQ, vTwoQ);
+      InverseButterflyIFMA(&v0, &v2, vW, vWPrecon, vNegQ, vTwoQ);
+      InverseButterflyIFMA(&v1, &v3, vW, vWPrecon, vNegQ, vTwoQ);
+      _mm512_storeu_si512(x0 + j, v0);
+      _mm512_storeu_si512(x1 + j, v1);
+      _mm512_storeu_si512(x2 + j, v2);
+      _mm512_storeu_si512(x3 + j, v3);
+    }
+    PortableKernel::InverseRow4(x0 + j, x1 + j, x2 + j, x3 + j, count - j, w,
+                                wLo, wHi, q);
+  }
+
+  PALISADE_TARGET_AVX512IFMA static void Scale(uint64_t *a, usint count,
+                                               uint64_t nInv,
+                                               uint64_t nInvPrecon,
+                                               uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vNegQ = _mm512_set1_epi64((uint64_t(1) << 52) - q);
+    const __m512i vNInv = _mm512_set1_epi64(nInv);
+    const __m512i vNInvPrecon = _mm512_set1_epi64(nInvPrecon >> 12);
+    usint i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m512i v = _mm512_loadu_si512(a + i);
+      v = ReduceOnceAVX512(MulShoupLazyIFMA(v, vNInv, vNInvPrecon, vNegQ), vQ);
+      _mm512_storeu_si512(a + i, v);
+    }
+    PortableKernel::Scale(a + i, count - i, nInv, nInvPrecon, q);
+  }
+};
+
+#endif  // WITH_NATIVE_IFMA
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // PALISADE_SIMD_X86
+
+// Stage loops. A block of length len at position b of a transform split into
+// B blocks sees the twiddle factor w[(B + b) * m + i] for its i-th group at
+// local stage m, so the whole transform is the block with B = 1, b = 0; the
+// scaling factor s = B + b is passed in directly. The forward loop runs the
+// stages down to butterfly span tLast, the inverse loop the stages from span
+// tFirst on; a full transform uses 1 for both.
+
+template <class Kernel>
+void ForwardStages(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                   usint len, usint s, usint tLast, uint64_t *a) {
+  const uint64_t twoQ = q << 1;
+  for (usint m = 1, t = len >> 1; t >= tLast && m < len; m <<= 1, t >>= 1) {
+    const uint64_t *wStage = w + s * m;
+    const uint64_t *wPreconStage = wPrecon + s * m;
+    if (t >= Kernel::WIDTH) {
+      for (usint i = 0; i < m; ++i) {
+        uint64_t *x = a + 2 * i * t;
+        Kernel::ForwardRow(x, x + t, t, wStage[i], wPreconStage[i], q);
+      }
+    } else {
+      for (usint i = 0; i < m; ++i) {
+        uint64_t *x = a + 2 * i * t;
+        for (usint j = 0; j < t; ++j) {
+          ForwardButterfly(x + j, x + t + j, wStage[i], wPreconStage[i], q,
+                           twoQ);
+        }
+      }
+    }
+  }
+}
+
+template <class Kernel>
+void InverseStages(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                   usint len, usint s, usint tFirst, uint64_t *a) {
+  const uint64_t twoQ = q << 1;
+  for (usint m = len / (2 * tFirst), t = tFirst; m >= 1; m >>= 1, t <<= 1) {
+    const uint64_t *wStage = w + s * m;
+    const uint64_t *wPreconStage = wPrecon + s * m;
+    if (t >= Kernel::WIDTH) {
+      for (usint i = 0; i < m; ++i) {
+        uint64_t *x = a + 2 * i * t;
+        Kernel::InverseRow(x, x + t, t, wStage[i], wPreconStage[i], q);
+      }
+    } else {
+      for (usint i = 0; i < m; ++i) {
+        uint64_t *x = a + 2 * i * t;
+        for (usint j = 0; j < t; ++j) {
+          InverseButterfly(x + j, x + t + j, wStage[i], wPreconStage[i], q,
+                           twoQ);
+        }
+      }
+    }
+  }
+}
+
+// the butterflies of offsets [begin, end) in every group of the stage with m
+// groups of a transform of size n
+template <class Kernel>
+void ForwardStageSlice(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                       usint n, usint m, usint begin, usint end, uint64_t *a) {
+  usint t = n / (2 * m);
+  for (usint i = 0; i < m; ++i) {
+    uint64_t *x = a + 2 * i * t;
+    Kernel::ForwardRow(x + begin, x + t + begin, end - begin, w[m + i],
+                       wPrecon[m + i], q);
+  }
+}
+
+template <class Kernel>
+void InverseStageSlice(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                       usint n, usint m, usint begin, usint end, uint64_t *a) {
+  usint t = n / (2 * m);
+  for (usint i = 0; i < m; ++i) {
+    uint64_t *x = a + 2 * i * t;
+    Kernel::InverseRow(x + begin, x + t + begin, end - begin, w[m + i],
+                       wPrecon[m + i], q);
+  }
+}
+
+
+// NTT_AUTO until overridden with NativeNTTEngine::SetAlgorithm()
+std::atomic<int> currentAlgorithm(NTT_AUTO);
+
+// the number of cache blocks the transform of size n is split into by the
+// blocked algorithm, or 1 if the radix-2 loop is used
+usint NumberOfCacheBlocks(usint n) {
+  const usint blockSize = NativeNTTEngine::CACHE_BLOCK_SIZE;
+  switch (currentAlgorithm.load(std::memory_order_relaxed)) {
+    case NTT_RADIX2:
+      return 1;
+    case NTT_BLOCKED:
+      return n >= 2 * blockSize ? n / blockSize : 1;
+    default:
+      return n >= NativeNTTEngine::BLOCKED_THRESHOLD ? n / blockSize : 1;
+  }
+}
+
+// The first log2(numBlocks) stages, merged pairwise: the stages with m and 2m
+// groups touch the coefficients x, x + h, x + t and x + t + h of group i of
+// the first one, with t = n/(2m) and h = t/2.
+template <class Kernel>
+void ForwardOuterStages(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                        usint n, usint numBlocks, uint64_t *a) {
+  usint m = 1;
+  for (; 4 * m <= numBlocks; m <<= 2) {
+    usint t = n / (2 * m), h = t >> 1;
+    for (usint i = 0; i < m; ++i) {
+      uint64_t *x = a + 2 * i * t;
+      Twiddle wMid = {w[m + i], wPrecon[m + i]};
+      Twiddle wLo = {w[2 * (m + i)], wPrecon[2 * (m + i)]};
+      Twiddle wHi = {w[2 * (m + i) + 1], wPrecon[2 * (m + i) + 1]};
+      Kernel::ForwardRow4(x, x + h, x + t, x + t + h, h, wMid, wLo, wHi, q);
+    }
+  }
+  if (m < numBlocks) {
+    ForwardStageSlice<Kernel>(w, wPrecon, q, n, m, 0, n / (2 * m), a);
+  }
+}
+
+// The last log2(numBlocks) stages, merged pairwise: the stages with m and m/2
+// groups touch the coefficients x, x + t, x + 2t and x + 3t of group i of the
+// second one, with t = n/(2m).
+template <class Kernel>
+void InverseOuterStages(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                        usint n, usint numBlocks, uint64_t *a) {
+  usint m = numBlocks >> 1;
+  for (; m >= 2; m >>= 2) {
+    usint t = n / (2 * m);
+    for (usint i = 0; i < (m >> 1); ++i) {
+      uint64_t *x = a + 4 * i * t;
+      Twiddle wMid = {w[(m >> 1) + i], wPrecon[(m >> 1) + i]};
+      Twiddle wLo = {w[m + 2 * i], wPrecon[m + 2 * i]};
+      Twiddle wHi = {w[m + 2 * i + 1], wPrecon[m + 2 * i + 1]};
+      Kernel::InverseRow4(x, x + t, x + 2 * t, x + 3 * t, t, wMid, wLo, wHi,
+                          q);
+    }
+  }
+  if (m == 1) {
+    InverseStageSlice<Kernel>(w, wPrecon, q, n, 1, 0, n >> 1, a);
+  }
+}
+
+template <class Kernel>
+void Forward(const uint64_t *w, const uint64_t *wPrecon, uint64_t q, usint n,
+             uint64_t *a) {
+  usint numBlocks = NumberOfCacheBlocks(n);
+  if (numBlocks > 1) {
+    usint len = n / numBlocks;
+    ForwardOuterStages<Kernel>(w, wPrecon, q, n, numBlocks, a);
+    for (usint b = 0; b < numBlocks; ++b) {
+      ForwardStages<Kernel>(w, wPrecon, q, len, numBlocks + b, 1,
+                            a + b * len);
+      Kernel::Reduce(a + b * len, len, q);
+    }
+    return;
+  }
+  ForwardStages<Kernel>(w, wPrecon, q, n, 1, 1, a);
+  Kernel::Reduce(a, n, q);
+}
+
+template <class Kernel>
+void Inverse(const uint64_t *w, const uint64_t *wPrecon, uint64_t nInv,
+             uint64_t nInvPrecon, uint64_t q, usint n, uint64_t *a) {
+  usint numBlocks = NumberOfCacheBlocks(n);
+  if (numBlocks > 1) {
+    usint len = n / numBlocks;
+    for (usint b = 0; b < numBlocks; ++b) {
+      InverseStages<Kernel>(w, wPrecon, q, len, numBlocks + b, 1,
+                            a + b * len);
+    }
+    InverseOuterStages<Kernel>(w, wPrecon, q, n, numBlocks, a);
+  } else {
+    InverseStages<Kernel>(w, wPrecon, q, n, 1, 1, a);
+  }
+  Kernel::Scale(a, n, nInv, nInvPrecon, q);
+}
+
+template <class Kernel>
+void ForwardBlock(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                  usint n, usint numBlocks, usint block, uint64_t *a) {
+  usint len = n / numBlocks;
+  uint64_t *blockStart = a + block * len;
+  ForwardStages<Kernel>(w, wPrecon, q, len, numBlocks + block, 1,
+                        blockStart);
+  Kernel::Reduce(blockStart, len, q);
+}
+
+template <class Kernel>
+void InverseBlock(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                  usint n, usint numBlocks, usint block, uint64_t *a) {
+  usint len = n / numBlocks;
+  InverseStages<Kernel>(w, wPrecon, q, len, numBlocks + block, 1,
+                        a + block * len);
+}
+
+// The last forward stage, the pointwise product and the first inverse stage
+// of block s (see ForwardStages()), fused so that every pair of coefficients
+// is loaded and stored once. b holds the other operand either after the same
+// forward stages as a or, if bTransformed, fully transformed and in [0,q).
+void MultiplyPairs(const uint64_t *w, const uint64_t *wPrecon,
+                   const uint64_t *wInv, const uint64_t *wInvPrecon,
+                   uint64_t q, const BarrettRatio &ratio, usint len, usint s,
+                   bool bTransformed, const uint64_t *b, uint64_t *a) {
+  const uint64_t twoQ = q << 1;
+  const usint m = len >> 1;
+  for (usint i = 0; i < m; ++i) {
+    uint64_t a0 = a[2 * i], a1 = a[2 * i + 1];
+    ForwardButterfly(&a0, &a1, w[s * m + i], wPrecon[s * m + i], q, twoQ);
+    uint64_t b0 = b[2 * i], b1 = b[2 * i + 1];
+    if (!bTransformed) {
+      ForwardButterfly(&b0, &b1, w[s * m + i], wPrecon[s * m + i], q, twoQ);
+      b0 = ReduceOnce(ReduceOnce(b0, twoQ), q);
+      b1 = ReduceOnce(ReduceOnce(b1, twoQ), q);
+    }
+    a0 = MulModBarrett(ReduceOnce(ReduceOnce(a0, twoQ), q), b0, q, ratio);
+    a1 = MulModBarrett(ReduceOnce(ReduceOnce(a1, twoQ), q), b1, q, ratio);
+    InverseButterfly(&a0, &a1, wInv[s * m + i], wInvPrecon[s * m + i], q,
+                     twoQ);
+    a[2 * i] = a0;
+    a[2 * i + 1] = a1;
+  }
+}
+
+// Forward transform of a (and b), product, and inverse transform, block by
+// block: with the blocked algorithm each cache block goes through its
+// forward stages, the product and its inverse stages before the next one is
+// touched.
+template <class Kernel>
+void FusedMultiply(const uint64_t *w, const uint64_t *wPrecon,
+                   const uint64_t *wInv, const uint64_t *wInvPrecon,
+                   uint64_t nInv, uint64_t nInvPrecon, uint64_t q, usint n,
+                   bool bTransformed, const uint64_t *other, uint64_t *a) {
+  const BarrettRatio ratio = ComputeBarrettRatio(q);
+  // the forward stages of the other operand run on a per-thread copy
+  static thread_local std::vector<uint64_t> scratch;
+  uint64_t *bCopy = nullptr;
+  if (!bTransformed) {
+    scratch.assign(other, other + n);
+    bCopy = scratch.data();
+  }
+  const uint64_t *b = bTransformed ? other : bCopy;
+
+  usint numBlocks = NumberOfCacheBlocks(n);
+  usint len = n / numBlocks;
+  if (numBlocks > 1) {
+    ForwardOuterStages<Kernel>(w, wPrecon, q, n, numBlocks, a);
+    if (!bTransformed) {
+      ForwardOuterStages<Kernel>(w, wPrecon, q, n, numBlocks, bCopy);
+    }
+  }
+  for (usint k = 0; k < numBlocks; ++k) {
+    usint s = numBlocks + k;
+    uint64_t *aBlock = a + k * len;
+    ForwardStages<Kernel>(w, wPrecon, q, len, s, 2, aBlock);
+    if (!bTransformed) {
+      ForwardStages<Kernel>(w, wPrecon, q, len, s, 2, bCopy + k * len);
+    }
+    MultiplyPairs(w, wPrecon, wInv, wInvPrecon, q, ratio, len, s,
+                  bTransformed, b + k * len, aBlock);
+    InverseStages<Kernel>(wInv, wInvPrecon, q, len, s, 2, aBlock);
+  }
+  if (numBlocks > 1) {
+    InverseOuterStages<Kernel>(wInv, wInvPrecon, q, n, numBlocks, a);
+  }
+  Kernel::Scale(a, n, nInv, nInvPrecon, q);
+}
+
+template <class Kernel>
+void Scale(uint64_t nInv, uint64_t nInvPrecon, uint64_t q, usint begin,
+           usint end, uint64_t *a) {
+  Kernel::Scale(a + begin, end - begin, nInv, nInvPrecon, q);
+}
+
+// the size D of the blocks the pruned transforms work on: the smallest power
+// of two that is at least stride and degree
+usint PrunedBlockSize(usint stride, usint degree) {
+  usint size = stride;
+  while (size < degree) {
+    size <<= 1;
+  }
+  return size;
+}
+
+// Pruned forward transform (see
+// NativeNTTEngine::ForwardTransformToBitReversePrunedInPlace()). After the
+// copy stages, each of the B = n/D blocks starts with the same values, and
+// its butterflies with span >= stride only touch multiples of stride, so
+// they run as the stages of a block of length D/stride (see ForwardStages())
+// on a compacted copy.
+template <class Kernel>
+void ForwardPruned(const uint64_t *w, const uint64_t *wPrecon, uint64_t q,
+                   usint n, usint stride, usint degree, uint64_t *a) {
+  const usint size = PrunedBlockSize(stride, degree);
+  const usint len = size / stride;
+  const usint numBlocks = n / size;
+  static thread_local std::vector<uint64_t> scratch;
+  scratch.resize(2 * len);
+  uint64_t *input = scratch.data();
+  uint64_t *block = input + len;
+  // the block may be longer than the pattern when degree is not a power of 2
+  for (usint k = 0; k < len; ++k) {
+    input[k] = (k * stride < degree) ? a[k * stride] : 0;
+  }
+  for (usint b = 0; b < numBlocks; ++b) {
+    std::copy(input, input + len, block);
+    ForwardStages<Kernel>(w, wPrecon, q, len, numBlocks + b, 1, block);
+    Kernel::Reduce(block, len, q);
+    uint64_t *out = a + b * size;
+    for (usint k = 0; k < len; ++k) {
+      std::fill(out + k * stride, out + (k + 1) * stride, block[k]);
+    }
+  }
+}
+
+// Pruned inverse transform (see
+// NativeNTTEngine::InverseTransformFromBitReversePrunedInPlace()), the
+// forward steps in reverse order.
+template <class Kernel>
+void InversePruned(const uint64_t *w, const uint64_t *wPrecon, uint64_t nInv,
+                   uint64_t nInvPrecon, uint64_t q, usint n, usint stride,
+                   usint degree, uint64_t *a) {
+  const usint size = PrunedBlockSize(stride, degree);
+  const usint len = size / stride;
+  const usint numBlocks = n / size;
+  const uint64_t twoQ = q << 1;
+  static thread_local std::vector<uint64_t> scratch;
+  scratch.assign(2 * len, 0);
+  uint64_t *sum = scratch.data();
+  uint64_t *block = sum + len;
+  for (usint b = 0; b < numBlocks; ++b) {
+    const uint64_t *in = a + b * size;
+    for (usint k = 0; k < len; ++k) {
+      uint64_t value = 0;
+      for (usint r = 0; r < stride; ++r) {
+        value = ReduceOnce(value + in[k * stride + r], q);
+      }
+      block[k] = value;
+    }
+    InverseStages<Kernel>(w, wPrecon, q, len, numBlocks + b, 1, block);
+    for (usint k = 0; k < len; ++k) {
+      sum[k] = ReduceOnce(sum[k] + block[k], twoQ);
+    }
+  }
+  Kernel::Scale(sum, len, nInv, nInvPrecon, q);
+  std::fill(a, a + n, 0);
+  for (usint k = 0; k * stride < degree; ++k) {
+    a[k * stride] = sum[k];
+  }
+}
+
+}  // namespace
+
+NTTAlgorithm NativeNTTEngine::GetAlgorithm() {
+  return static_cast<NTTAlgorithm>(
+      currentAlgorithm.load(std::memory_order_relaxed));
+}
+
+void NativeNTTEngine::SetAlgorithm(NTTAlgorithm algorithm) {
+  currentAlgorithm.store(algorithm, std::memory_order_relaxed);
+}
+
+// Expands to a switch that calls FUNC<Kernel>(ARGS...) with the kernel of the
+// given engine; moduli below SMALL_MODULUS_BOUND run on the 52-bit variants
+#if defined(PALISADE_SIMD_X86) && defined(WITH_NATIVE_IFMA)
+#define NATIVENTT_DISPATCH_IFMA(MODULUS, FUNC, ...) \
+  case SIMD_AVX512IFMA:                             \
+    if (IsSmallModulus(MODULUS)) {                  \
+      FUNC<IFMAKernel>(__VA_ARGS__);                \
+    } else {                                        \
+      FUNC<AVX512Kernel>(__VA_ARGS__);              \
+    }                                               \
+    break;
+#else
+#define NATIVENTT_DISPATCH_IFMA(MODULUS, FUNC, ...)
+#endif
+
+#ifdef PALISADE_SIMD_X86
+#define NATIVENTT_DISPATCH(ENGINE, MODULUS, FUNC, ...)  \
+  switch (ENGINE) {                                     \
+    NATIVENTT_DISPATCH_IFMA(MODULUS, FUNC, __VA_ARGS__) \
+    case SIMD_AVX512:                                   \
+      FUNC<AVX512Kernel>(__VA_ARGS__);                  \
+      break;                                            \
+    case SIMD_AVX2:                                     \
+      if (IsSmallModulus(MODULUS)) {                    \
+        FUNC<AVX2FMAKernel>(__VA_ARGS__);               \
+      } else {                                          \
+        FUNC<AVX2Kernel>(__VA_ARGS__);                  \
+      }                                                 \
+      break;                                            \
+    default:                                            \
+      FUNC<PortableKernel>(__VA_ARGS__);                \
+      break;                                            \
+  }
+#else
+#define NATIVENTT_DISPATCH(ENGINE, MODULUS, FUNC, ...) \
+  FUNC<PortableKernel>(__VA_ARGS__);
+#endif
+
+void NativeNTTEngine::ForwardTransformToBitReverseInPlace(
+    const uint64_t *rootOfUnityTable, const uint64_t *preconRootOfUnityTable,
+    uint64_t modulus, usint n, uint64_t *element) {
+  ForwardTransformToBitReverseInPlace(SIMDControls::GetEngine(),
+                                      rootOfUnityTable, preconRootOfUnityTable,
+                                      modulus, n, element);
+}
+
+void NativeNTTEngine::InverseTransformFromBitReverseInPlace(
+    const uint64_t *rootOfUnityInverseTable,
+    const uint64_t *preconRootOfUnityInverseTable, uint64_t cycloOrderInv,
+    uint64_t preconCycloOrderInv, uint64_t modulus, usint n,
+    uint64_t *element) {
+  InverseTransformFromBitReverseInPlace(
+      SIMDControls::GetEngine(), rootOfUnityInverseTable,
+      preconRootOfUnityInverseTable, cycloOrderInv, preconCycloOrderInv,
+      modulus, n, element);
+}
+
+void NativeNTTEngine::ForwardTransformToBitReverseInPlace(
+    SIMDEngine engine, const uint64_t *rootOfUnityTable,
+    const uint64_t *preconRootOfUnityTable, uint64_t modulus, usint n,
+    uint64_t *element) {
+  NATIVENTT_DISPATCH(engine, modulus, Forward, rootOfUnityTable, preconRootOfUnityTable,
+                     modulus, n, element)
+}
+
+void NativeNTTEngine::InverseTransformFromBitReverseInPlace(
+    SIMDEngine engine, const uint64_t *rootOfUnityInverseTable,
+    const uint64_t *preconRootOfUnityInverseTable, uint64_t cycloOrderInv,
+    uint64_t preconCycloOrderInv, uint64_t modulus, usint n,
+    uint64_t *element) {
+  NATIVENTT_DISPATCH(engine, modulus, Inverse, rootOfUnityInverseTable,
+                     preconRootOfUnityInverseTable, cycloOrderInv,
+                     preconCycloOrderInv, modulus, n, element)
+}
+
+void NativeNTTEngine::NegacyclicMultiply(
+    const uint64_t *rootOfUnityTable, const uint64_t *preconRootOfUnityTable,
+    const uint64_t *rootOfUnityInverseTable,
+    const uint64_t *preconRootOfUnityInverseTable, uint64_t cycloOrderInv,
+    uint64_t preconCycloOrderInv, uint64_t modulus, usint n,
+    bool otherTransformed, const uint64_t *other, uint64_t *element) {
+  NATIVENTT_DISPATCH(SIMDControls::GetEngine(), modulus, FusedMultiply,
+                     rootOfUnityTable, preconRootOfUnityTable,
+                     rootOfUnityInverseTable, preconRootOfUnityInverseTable,
+                     cycloOrderInv, preconCycloOrderInv, modulus, n,
+                     otherTransformed, other, element)
+}
+
+void NativeNTTEngine::ForwardTransformToBitReversePrunedInPlace(
+    const uint64_t *rootOfUnityTable, const uint64_t *preconRootOfUnityTable,
+    uint64_t modulus, usint n, usint stride, usint degree,
+    uint64_t *element) {
+  // nothing to prune: the compacted copy would only add overhead
+  if (stride == 1 && PrunedBlockSize(stride, degree) == n) {
+    std::fill(element + degree, element + n, 0);
+    ForwardTransformToBitReverseInPlace(rootOfUnityTable,
+                                        preconRootOfUnityTable, modulus, n,
+                                        element);
+    return;
+  }
+  NATIVENTT_DISPATCH(SIMDControls::GetEngine(), modulus, ForwardPruned,
+                     rootOfUnityTable, preconRootOfUnityTable, modulus, n,
+                     stride, degree, element)
+}
+
+void NativeNTTEngine::InverseTransformFromBitReversePrunedInPlace(
+    const uint64_t *rootOfUnityInverseTable,
+    const uint64_t *preconRootOfUnityInverseTable, uint64_t cycloOrderInv,
+    uint64_t preconCycloOrderInv, uint64_t modulus, usint n, usint stride,
+    usint degree, uint64_t *element) {
+  if (stride == 1 && PrunedBlockSize(stride, degree) == n) {
+    InverseTransformFromBitReverseInPlace(
+        rootOfUnityInverseTable, preconRootOfUnityInverseTable, cycloOrderInv,
+        preconCycloOrderInv, modulus, n, element);
+    std::fill(element + degree, element + n, 0);
+    return;
+  }
+  NATIVENTT_DISPATCH(SIMDControls::GetEngine(), modulus, InversePruned,
+                     rootOfUnityInverseTable, preconRootOfUnityInverseTable,
+                     cycloOrderInv, preconCycloOrderInv, modulus, n, stride,
+                     degree, element)
+}
+
+void NativeNTTEngine::ForwardTransformStageSlice(
+    const uint64_t *rootOfUnityTable, const uint64_t *preconRootOfUnityTable,
+    uint64_t modulus, usint n, usint m, usint begin, usint end,
+    uint64_t *element) {
+  NATIVENTT_DISPATCH(SIMDControls::GetEngine(), modulus, ForwardStageSlice,
+                     rootOfUnityTable, preconRootOfUnityTable, modulus, n, m,
+                     begin, end, element)
+}
+
+void NativeNTTEngine::ForwardTransformBlock(
+    const uint64_t *rootOfUnityTable, const uint64_t *preconRootOfUnityTable,
+    uint64_t modulus, usint n, usint numBlocks, usint block,
+    uint64_t *element) {
+  NATIVENTT_DISPATCH(SIMDControls::GetEngine(), modulus, ForwardBlock, rootOfUnityTable,
+                     preconRootOfUnityTable, modulus, n, numBlocks, block,
+                     element)
+}
+
+void NativeNTTEngine::InverseTransformBlock(
+    const uint64_t *rootOfUnityInverseTable,
+    const uint64_t *preconRootOfUnityInverseTable, uint64_t modulus, usint n,
+    usint numBlocks, usint block, uint64_t *element) {
+  NATIVENTT_DISPATCH(SIMDControls::GetEngine(), modulus, InverseBlock,
+                     rootOfUnityInverseTable, preconRootOfUnityInverseTable,
+                     modulus, n, numBlocks, block, element)
+}
+
+void NativeNTTEngine::InverseTransformStageSlice(
+    const uint64_t *rootOfUnityInverseTable,
+    const uint64_t *preconRootOfUnityInverseTable, uint64_t modulus, usint n,
+    usint m, usint begin, usint end, uint64_t *element) {
+  NATIVENTT_DISPATCH(SIMDControls::GetEngine(), modulus, InverseStageSlice,
+                     rootOfUnityInverseTable, preconRootOfUnityInverseTable,
+                     modulus, n, m, begin, end, element)
+}
+
+void NativeNTTEngine::InverseTransformScale(uint64_t cycloOrderInv,
+                                            uint64_t preconCycloOrderInv,
+                                            uint64_t modulus, usint begin,
+                                            usint end, uint64_t *element) {
+  NATIVENTT_DISPATCH(SIMDControls::GetEngine(), modulus, Scale, cycloOrderInv,
+                     preconCycloOrderInv, modulus, begin, end, element)
+}
+
+}  // namespace lbcrypto
@@ -0,0 +1,873 @@
+// @file nativevectorkernels.cpp Vectorized element-wise arithmetic on 64-bit native vectors
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "math/nativevectorkernels.h"
+
+#include <algorithm>
+
+#include "math/nativesimd.h"
+
+namespace lbcrypto {
+
+namespace {
+
+using namespace nativesimd;
+
+inline usint BitLength(uint64_t x) {
+  usint bits = 0;
+  for (; x != 0; x >>= 1) {
+    ++bits;
+  }
+  return bits;
+}
+
+// Shift amounts of the generalized Barrett reduction of
+// NativeInteger::ModMulFast() for an n-bit modulus (alpha = n + 3,
+// beta = -2): the product is shifted right by n - 2 bits, multiplied by
+// mu = floor(2^(2n+3) / q) and shifted right by n + 5 bits. The second
+// shift of the 128-bit value (hi:lo) is (lo >> (n + 5)) | (hi << (59 - n))
+// for n < 59 and hi >> (n - 59) otherwise.
+struct BarrettShifts {
+  explicit BarrettShifts(uint64_t q) {
+    usint n = BitLength(q);
+    productShift = n - 2;
+    wide = n >= 59;
+    quotientShiftLo = wide ? n - 59 : n + 5;
+    quotientShiftHi = wide ? 0 : 59 - n;
+  }
+  usint productShift;
+  bool wide;
+  usint quotientShiftLo;
+  usint quotientShiftHi;
+};
+
+// A kernel provides the element-wise operations on count consecutive values;
+// for the operations with a scalar and a vector operand, the template
+// parameter SCALAR selects whether b points to one value or to count values.
+// MulAccumulate adds the 128-bit products a[i] * b[i] to the accumulators
+// (hi[i]:lo[i]) and ReduceAccumulator reduces accumulators with hi[i] < q.
+// The vectorized kernels hand the last count % WIDTH values over to the
+// portable one.
+
+struct PortableKernel {
+  template <bool SCALAR>
+  static void Add(const uint64_t *a, const uint64_t *b, uint64_t *r,
+                  usint count, uint64_t q) {
+    for (usint i = 0; i < count; ++i) {
+      r[i] = ReduceOnce(a[i] + b[SCALAR ? 0 : i], q);
+    }
+  }
+
+  template <bool SCALAR>
+  static void Sub(const uint64_t *a, const uint64_t *b, uint64_t *r,
+                  usint count, uint64_t q) {
+    for (usint i = 0; i < count; ++i) {
+      r[i] = ReduceOnce(a[i] + q - b[SCALAR ? 0 : i], q);
+    }
+  }
+
+  static void Negate(const uint64_t *a, uint64_t *r, usint count,
+                     uint64_t q) {
+    for (usint i = 0; i < count; ++i) {
+      r[i] = ReduceOnce(q - a[i], q);
+    }
+  }
+
+  static void Mul(const uint64_t *a, const uint64_t *b, uint64_t *r,
+                  usint count, uint64_t q, uint64_t mu,
+                  const BarrettShifts &s) {
+    for (usint i = 0; i < count; ++i) {
+      uint64_t lo = a[i] * b[i], hi = MulHi64(a[i], b[i]);
+      uint64_t ql = s.productShift == 0 ? lo
+                                        : (lo >> s.productShift) |
+                                              (hi << (64 - s.productShift));
+      uint64_t tLo = ql * mu, tHi = MulHi64(ql, mu);
+      uint64_t quot = s.wide ? tHi >> s.quotientShiftLo
+                             : (tLo >> s.quotientShiftLo) |
+                                   (tHi << s.quotientShiftHi);
+      r[i] = ReduceOnce(lo - quot * q, q);
+    }
+  }
+
+  static void MulConst(const uint64_t *a, uint64_t b, uint64_t bPrecon,
+                       uint64_t *r, usint count, uint64_t q) {
+    for (usint i = 0; i < count; ++i) {
+      r[i] = ReduceOnce(MulShoupLazy(a[i], b, bPrecon, q), q);
+    }
+  }
+
+  static void Grow(const uint64_t *a, uint64_t *r, usint count,
+                   uint64_t halfQ, uint64_t diff) {
+    for (usint i = 0; i < count; ++i) {
+      r[i] = a[i] > halfQ ? a[i] + diff : a[i];
+    }
+  }
+
+  // a mod q is computed as the Shoup product a * 1 with the precomputation
+  // floor((2^64 - 1) / q), which is at most one off for inputs below 2^63
+  static void Shrink(const uint64_t *a, uint64_t *r, usint count,
+                     uint64_t halfQ, uint64_t diff, uint64_t q,
+                     uint64_t oneModQPrecon) {
+    for (usint i = 0; i < count; ++i) {
+      uint64_t x = ReduceOnce(MulShoupLazy(a[i], 1, oneModQPrecon, q), q);
+      r[i] = a[i] > halfQ ? ReduceOnce(x + q - diff, q) : x;
+    }
+  }
+
+  static void ByTwo(const uint64_t *a, uint64_t *r, usint count,
+                    uint64_t halfQ) {
+    for (usint i = 0; i < count; ++i) {
+      r[i] = (a[i] & 1) ^ static_cast<uint64_t>(a[i] > halfQ);
+    }
+  }
+
+  static void MulAccumulate(const uint64_t *a, const uint64_t *b,
+                            uint64_t *lo, uint64_t *hi, usint count) {
+    for (usint i = 0; i < count; ++i) {
+      uint64_t prodLo = a[i] * b[i];
+      uint64_t sum = lo[i] + prodLo;
+      hi[i] += MulHi64(a[i], b[i]) + (sum < prodLo);
+      lo[i] = sum;
+    }
+  }
+
+  static void ReduceAccumulator(const uint64_t *lo, const uint64_t *hi,
+                                uint64_t *r, usint count, uint64_t q,
+                                const BarrettRatio &ratio) {
+    for (usint i = 0; i < count; ++i) {
+      r[i] = ReduceWide(lo[i], hi[i], q, ratio);
+    }
+  }
+};
+
+#ifdef PALISADE_SIMD_X86
+
+// the shift count operands of the variable shifts
+PALISADE_TARGET_AVX2 inline __m128i ShiftCount(usint count) {
+  return _mm_cvtsi64_si128(static_cast<int64_t>(count));
+}
+
+// unsigned a < b; AVX2 only compares signed values
+PALISADE_TARGET_AVX2 inline __m256i LessThanAVX2(__m256i a, __m256i b) {
+  const __m256i signBit = _mm256_set1_epi64x(1ULL << 63);
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(b, signBit),
+                            _mm256_xor_si256(a, signBit));
+}
+
+// vectorized BarrettQuotient(); the masks of the carries are -1, so they are
+// subtracted
+PALISADE_TARGET_AVX2 inline __m256i BarrettQuotientAVX2(__m256i lo, __m256i hi,
+                                                        __m256i rHi,
+                                                        __m256i rLo) {
+  __m256i carry = MulHi64AVX2(lo, rLo);
+  __m256i mid = MulLo64AVX2(lo, rHi);
+  __m256i sum = _mm256_add_epi64(mid, carry);
+  __m256i upper =
+      _mm256_sub_epi64(MulHi64AVX2(lo, rHi), LessThanAVX2(sum, mid));
+  __m256i cross = MulLo64AVX2(hi, rLo);
+  __m256i sum2 = _mm256_add_epi64(sum, cross);
+  carry = _mm256_sub_epi64(MulHi64AVX2(hi, rLo), LessThanAVX2(sum2, cross));
+  return _mm256_add_epi64(_mm256_add_epi64(MulLo64AVX2(hi, rHi), upper),
+                          carry);
+}
+
+struct AVX2Kernel {
+  static const usint WIDTH = 4;
+
+  template <bool SCALAR>
+  PALISADE_TARGET_AVX2 static void Add(const uint64_t *a, const uint64_t *b,
+                                       uint64_t *r, usint count, uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vB = _mm256_set1_epi64x(b[0]);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i sum = _mm256_add_epi64(LoadAVX2(a + i),
+                                     SCALAR ? vB : LoadAVX2(b + i));
+      StoreAVX2(r + i, ReduceOnceAVX2(sum, vQ));
+    }
+    PortableKernel::Add<SCALAR>(a + i, SCALAR ? b : b + i, r + i, count - i,
+                                q);
+  }
+
+  template <bool SCALAR>
+  PALISADE_TARGET_AVX2 static void Sub(const uint64_t *a, const uint64_t *b,
+                                       uint64_t *r, usint count, uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vB = _mm256_set1_epi64x(b[0]);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i diff = _mm256_sub_epi64(_mm256_add_epi64(LoadAVX2(a + i), vQ),
+                                      SCALAR ? vB : LoadAVX2(b + i));
+      StoreAVX2(r + i, ReduceOnceAVX2(diff, vQ));
+    }
+    PortableKernel::Sub<SCALAR>(a + i, SCALAR ? b : b + i, r + i, count - i,
+                                q);
+  }
+
+  PALISADE_TARGET_AVX2 static void Negate(const uint64_t *a, uint64_t *r,
+                                          usint count, uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      StoreAVX2(r + i,
+                ReduceOnceAVX2(_mm256_sub_epi64(vQ, LoadAVX2(a + i)), vQ));
+    }
+    PortableKernel::Negate(a + i, r + i, count - i, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void Mul(const uint64_t *a, const uint64_t *b,
+                                       uint64_t *r, usint count, uint64_t q,
+                                       uint64_t mu, const BarrettShifts &s) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vMu = _mm256_set1_epi64x(mu);
+    // shift counts above 63 clear the values, so productShift = 0 works too
+    const __m128i prodLo = ShiftCount(s.productShift);
+    const __m128i prodHi = ShiftCount(64 - s.productShift);
+    const __m128i quotLo = ShiftCount(s.quotientShiftLo);
+    const __m128i quotHi = ShiftCount(s.quotientShiftHi);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i x = LoadAVX2(a + i), y = LoadAVX2(b + i);
+      __m256i lo = MulLo64AVX2(x, y), hi = MulHi64AVX2(x, y);
+      __m256i ql = _mm256_or_si256(_mm256_srl_epi64(lo, prodLo),
+                                   _mm256_sll_epi64(hi, prodHi));
+      __m256i tHi = MulHi64AVX2(ql, vMu);
+      __m256i quot;
+      if (s.wide) {
+        quot = _mm256_srl_epi64(tHi, quotLo);
+      } else {
+        quot = _mm256_or_si256(_mm256_srl_epi64(MulLo64AVX2(ql, vMu), quotLo),
+                               _mm256_sll_epi64(tHi, quotHi));
+      }
+      StoreAVX2(r + i, ReduceOnceAVX2(
+                           _mm256_sub_epi64(lo, MulLo64AVX2(quot, vQ)), vQ));
+    }
+    PortableKernel::Mul(a + i, b + i, r + i, count - i, q, mu, s);
+  }
+
+  PALISADE_TARGET_AVX2 static void MulConst(const uint64_t *a, uint64_t b,
+                                            uint64_t bPrecon, uint64_t *r,
+                                            usint count, uint64_t q) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vB = _mm256_set1_epi64x(b);
+    const __m256i vBPrecon = _mm256_set1_epi64x(bPrecon);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i prod = MulShoupLazyAVX2(LoadAVX2(a + i), vB, vBPrecon, vQ);
+      StoreAVX2(r + i, ReduceOnceAVX2(prod, vQ));
+    }
+    PortableKernel::MulConst(a + i, b, bPrecon, r + i, count - i, q);
+  }
+
+  PALISADE_TARGET_AVX2 static void Grow(const uint64_t *a, uint64_t *r,
+                                        usint count, uint64_t halfQ,
+                                        uint64_t diff) {
+    const __m256i vHalfQ = _mm256_set1_epi64x(halfQ);
+    const __m256i vDiff = _mm256_set1_epi64x(diff);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i x = LoadAVX2(a + i);
+      __m256i upper = _mm256_cmpgt_epi64(x, vHalfQ);
+      StoreAVX2(r + i, _mm256_add_epi64(x, _mm256_and_si256(upper, vDiff)));
+    }
+    PortableKernel::Grow(a + i, r + i, count - i, halfQ, diff);
+  }
+
+  PALISADE_TARGET_AVX2 static void Shrink(const uint64_t *a, uint64_t *r,
+                                          usint count, uint64_t halfQ,
+                                          uint64_t diff, uint64_t q,
+                                          uint64_t oneModQPrecon) {
+    const __m256i vHalfQ = _mm256_set1_epi64x(halfQ);
+    const __m256i vDiff = _mm256_set1_epi64x(diff);
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vOne = _mm256_set1_epi64x(1);
+    const __m256i vPrecon = _mm256_set1_epi64x(oneModQPrecon);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i v = LoadAVX2(a + i);
+      __m256i x = ReduceOnceAVX2(MulShoupLazyAVX2(v, vOne, vPrecon, vQ), vQ);
+      __m256i sub = _mm256_and_si256(_mm256_cmpgt_epi64(v, vHalfQ), vDiff);
+      x = _mm256_sub_epi64(_mm256_add_epi64(x, vQ), sub);
+      StoreAVX2(r + i, ReduceOnceAVX2(x, vQ));
+    }
+    PortableKernel::Shrink(a + i, r + i, count - i, halfQ, diff, q,
+                           oneModQPrecon);
+  }
+
+  PALISADE_TARGET_AVX2 static void ByTwo(const uint64_t *a, uint64_t *r,
+                                         usint count, uint64_t halfQ) {
+    const __m256i vHalfQ = _mm256_set1_epi64x(halfQ);
+    const __m256i vOne = _mm256_set1_epi64x(1);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i x = LoadAVX2(a + i);
+      __m256i upper = _mm256_cmpgt_epi64(x, vHalfQ);
+      StoreAVX2(r + i, _mm256_and_si256(_mm256_xor_si256(x, upper), vOne));
+    }
+    PortableKernel::ByTwo(a + i, r + i, count - i, halfQ);
+  }
+
+  PALISADE_TARGET_AVX2 static void MulAccumulate(const uint64_t *a,
+                                                 const uint64_t *b,
+                                                 uint64_t *lo, uint64_t *hi,
+                                                 usint count) {
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i x = LoadAVX2(a + i), y = LoadAVX2(b + i);
+      __m256i prodLo = MulLo64AVX2(x, y);
+      __m256i sum = _mm256_add_epi64(LoadAVX2(lo + i), prodLo);
+      __m256i carry = LessThanAVX2(sum, prodLo);
+      StoreAVX2(hi + i, _mm256_sub_epi64(_mm256_add_epi64(LoadAVX2(hi + i),
+                                                          MulHi64AVX2(x, y)),
+                                         carry));
+      StoreAVX2(lo + i, sum);
+    }
+    PortableKernel::MulAccumulate(a + i, b + i, lo + i, hi + i, count - i);
+  }
+
+  PALISADE_TARGET_AVX2 static void ReduceAccumulator(
+      const uint64_t *lo, const uint64_t *hi, uint64_t *r, usint count,
+      uint64_t q, const BarrettRatio &ratio) {
+    const __m256i vQ = _mm256_set1_epi64x(q);
+    const __m256i vTwoQ = _mm256_set1_epi64x(q << 1);
+    const __m256i vRHi = _mm256_set1_epi64x(ratio.hi);
+    const __m256i vRLo = _mm256_set1_epi64x(ratio.lo);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256i l = LoadAVX2(lo + i);
+      __m256i quot = BarrettQuotientAVX2(l, LoadAVX2(hi + i), vRHi, vRLo);
+      __m256i rem = _mm256_sub_epi64(l, MulLo64AVX2(quot, vQ));
+      StoreAVX2(r + i, ReduceOnceAVX2(ReduceOnceAVX2(rem, vTwoQ), vQ));
+    }
+    PortableKernel::ReduceAccumulator(lo + i, hi + i, r + i, count - i, q,
+                                      ratio);
+  }
+};
+
+// the double-precision variant of the AVX2 kernel for q < 2^50; the products
+// of reduced values are exact in two doubles (see MulModFMA())
+struct AVX2FMAKernel : public AVX2Kernel {
+  PALISADE_TARGET_AVX2 static void Mul(const uint64_t *a, const uint64_t *b,
+                                       uint64_t *r, usint count, uint64_t q,
+                                       uint64_t mu, const BarrettShifts &s) {
+    const __m256d vQ = _mm256_set1_pd(static_cast<double>(q));
+    const __m256d vQInv = _mm256_set1_pd(1.0 / static_cast<double>(q));
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256d x = ToDoubleAVX2(LoadAVX2(a + i));
+      __m256d y = ToDoubleAVX2(LoadAVX2(b + i));
+      StoreAVX2(r + i, ToIntAVX2(MulModFMA(x, y, vQ, vQInv)));
+    }
+    PortableKernel::Mul(a + i, b + i, r + i, count - i, q, mu, s);
+  }
+
+  PALISADE_TARGET_AVX2 static void MulConst(const uint64_t *a, uint64_t b,
+                                            uint64_t bPrecon, uint64_t *r,
+                                            usint count, uint64_t q) {
+    const __m256d vQ = _mm256_set1_pd(static_cast<double>(q));
+    const __m256d vTwoQ = _mm256_set1_pd(static_cast<double>(q << 1));
+    const __m256i vQInt = _mm256_set1_epi64x(q);
+    const __m256d vB = _mm256_set1_pd(static_cast<double>(b));
+    const __m256d vBRatio =
+        _mm256_set1_pd(static_cast<double>(bPrecon) * SHOUP_TO_RATIO);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m256d prod = MulShoupLazyFMA(ToDoubleAVX2(LoadAVX2(a + i)), vB,
+                                     vBRatio, vTwoQ, vQ);
+      StoreAVX2(r + i, ReduceOnceAVX2(ToIntAVX2(prod), vQInt));
+    }
+    PortableKernel::MulConst(a + i, b, bPrecon, r + i, count - i, q);
+  }
+};
+
+// GCC reports the self-initialized value behind _mm512_undefined_epi32() used
+// by the AVX-512 intrinsics as possibly uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+PALISADE_TARGET_AVX512 inline __m512i LoadAVX512(const uint64_t *p) {
+  return _mm512_loadu_si512(p);
+}
+
+PALISADE_TARGET_AVX512 inline void StoreAVX512(uint64_t *p, __m512i v) {
+  _mm512_storeu_si512(p, v);
+}
+
+// vectorized BarrettQuotient()
+PALISADE_TARGET_AVX512 inline __m512i BarrettQuotientAVX512(__m512i lo,
+                                                            __m512i hi,
+                                                            __m512i rHi,
+                                                            __m512i rLo) {
+  const __m512i one = _mm512_set1_epi64(1);
+  __m512i carry = MulHi64AVX512(lo, rLo);
+  __m512i mid = _mm512_mullo_epi64(lo, rHi);
+  __m512i sum = _mm512_add_epi64(mid, carry);
+  __m512i upper = MulHi64AVX512(lo, rHi);
+  upper = _mm512_mask_add_epi64(upper, _mm512_cmplt_epu64_mask(sum, mid),
+                                upper, one);
+  __m512i cross = _mm512_mullo_epi64(hi, rLo);
+  __m512i sum2 = _mm512_add_epi64(sum, cross);
+  carry = MulHi64AVX512(hi, rLo);
+  carry = _mm512_mask_add_epi64(carry, _mm512_cmplt_epu64_mask(sum2, cross),
+                                carry, one);
+  return _mm512_add_epi64(_mm512_add_epi64(_mm512_mullo_epi64(hi, rHi), upper),
+                          carry);
+}
+
+struct AVX512Kernel {
+  static const usint WIDTH = 8;
+
+  template <bool SCALAR>
+  PALISADE_TARGET_AVX512 static void Add(const uint64_t *a, const uint64_t *b,
+                                         uint64_t *r, usint count,
+                                         uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vB = _mm512_set1_epi64(b[0]);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i sum = _mm512_add_epi64(LoadAVX512(a + i),
+                                     SCALAR ? vB : LoadAVX512(b + i));
+      StoreAVX512(r + i, ReduceOnceAVX512(sum, vQ));
+    }
+    PortableKernel::Add<SCALAR>(a + i, SCALAR ? b : b + i, r + i, count - i,
+                                q);
+  }
+
+  template <bool SCALAR>
+  PALISADE_TARGET_AVX512 static void Sub(const uint64_t *a, const uint64_t *b,
+                                         uint64_t *r, usint count,
+                                         uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vB = _mm512_set1_epi64(b[0]);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i diff =
+          _mm512_sub_epi64(_mm512_add_epi64(LoadAVX512(a + i), vQ),
+                           SCALAR ? vB : LoadAVX512(b + i));
+      StoreAVX512(r + i, ReduceOnceAVX512(diff, vQ));
+    }
+    PortableKernel::Sub<SCALAR>(a + i, SCALAR ? b : b + i, r + i, count - i,
+                                q);
+  }
+
+  PALISADE_TARGET_AVX512 static void Negate(const uint64_t *a, uint64_t *r,
+                                            usint count, uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      StoreAVX512(r + i, ReduceOnceAVX512(
+                             _mm512_sub_epi64(vQ, LoadAVX512(a + i)), vQ));
+    }
+    PortableKernel::Negate(a + i, r + i, count - i, q);
+  }
+
+  PALISADE_TARGET_AVX512 static void Mul(const uint64_t *a, const uint64_t *b,
+                                         uint64_t *r, usint count, uint64_t q,
+                                         uint64_t mu, const BarrettShifts &s) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vMu = _mm512_set1_epi64(mu);
+    const __m128i prodLo = ShiftCount(s.productShift);
+    const __m128i prodHi = ShiftCount(64 - s.productShift);
+    const __m128i quotLo = ShiftCount(s.quotientShiftLo);
+    const __m128i quotHi = ShiftCount(s.quotientShiftHi);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i x = LoadAVX512(a + i), y = LoadAVX512(b + i);
+      __m512i lo = _mm512_mullo_epi64(x, y), hi = MulHi64AVX512(x, y);
+      __m512i ql = _mm512_or_si512(_mm512_srl_epi64(lo, prodLo),
+                                   _mm512_sll_epi64(hi, prodHi));
+      __m512i tHi = MulHi64AVX512(ql, vMu);
+      __m512i quot;
+      if (s.wide) {
+        quot = _mm512_srl_epi64(tHi, quotLo);
+      } else {
+        quot = _mm512_or_si512(
+            _mm512_srl_epi64(_mm512_mullo_epi64(ql, vMu), quotLo),
+            _mm512_sll_epi64(tHi, quotHi));
+      }
+      StoreAVX512(r + i,
+                  ReduceOnceAVX512(
+                      _mm512_sub_epi64(lo, _mm512_mullo_epi64(quot, vQ)), vQ));
+    }
+    PortableKernel::Mul(a + i, b + i, r + i, count - i, q, mu, s);
+  }
+
+  PALISADE_TARGET_AVX512 static void MulConst(const uint64_t *a, uint64_t b,
+                                              uint64_t bPrecon, uint64_t *r,
+                                              usint count, uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vB = _mm512_set1_epi64(b);
+    const __m512i vBPrecon = _mm512_set1_epi64(bPrecon);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i prod = MulShoupLazyAVX512(LoadAVX512(a + i), vB, vBPrecon, vQ);
+      StoreAVX512(r + i, ReduceOnceAVX512(prod, vQ));
+    }
+    PortableKernel::MulConst(a + i, b, bPrecon, r + i, count - i, q);
+  }
+
+  PALISADE_TARGET_AVX512 static void Grow(const uint64_t *a, uint64_t *r,
+                                          usint count, uint64_t halfQ,
+                                          uint64_t diff) {
+    const __m512i vHalfQ = _mm512_set1_epi64(halfQ);
+    const __m512i vDiff = _mm512_set1_epi64(diff);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i x = LoadAVX512(a + i);
+      __mmask8 upper = _mm512_cmpgt_epu64_mask(x, vHalfQ);
+      StoreAVX512(r + i, _mm512_mask_add_epi64(x, upper, x, vDiff));
+    }
+    PortableKernel::Grow(a + i, r + i, count - i, halfQ, diff);
+  }
+
+  PALISADE_TARGET_AVX512 static void Shrink(const uint64_t *a, uint64_t *r,
+                                            usint count, uint64_t halfQ,
+                                            uint64_t diff, uint64_t q,
+                                            uint64_t oneModQPrecon) {
+    const __m512i vHalfQ = _mm512_set1_epi64(halfQ);
+    const __m512i vDiff = _mm512_set1_epi64(diff);
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vOne = _mm512_set1_epi64(1);
+    const __m512i vPrecon = _mm512_set1_epi64(oneModQPrecon);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i v = LoadAVX512(a + i);
+      __m512i x =
+          ReduceOnceAVX512(MulShoupLazyAVX512(v, vOne, vPrecon, vQ), vQ);
+      __mmask8 upper = _mm512_cmpgt_epu64_mask(v, vHalfQ);
+      __m512i y = ReduceOnceAVX512(
+          _mm512_sub_epi64(_mm512_add_epi64(x, vQ), vDiff), vQ);
+      StoreAVX512(r + i, _mm512_mask_mov_epi64(x, upper, y));
+    }
+    PortableKernel::Shrink(a + i, r + i, count - i, halfQ, diff, q,
+                           oneModQPrecon);
+  }
+
+  PALISADE_TARGET_AVX512 static void ByTwo(const uint64_t *a, uint64_t *r,
+                                           usint count, uint64_t halfQ) {
+    const __m512i vHalfQ = _mm512_set1_epi64(halfQ);
+    const __m512i vOne = _mm512_set1_epi64(1);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i x = _mm512_and_si512(LoadAVX512(a + i), vOne);
+      __mmask8 upper = _mm512_cmpgt_epu64_mask(LoadAVX512(a + i), vHalfQ);
+      StoreAVX512(r + i, _mm512_mask_xor_epi64(x, upper, x, vOne));
+    }
+    PortableKernel::ByTwo(a + i, r + i, count - i, halfQ);
+  }
+
+  PALISADE_TARGET_AVX512 static void MulAccumulate(const uint64_t *a,
+                                                   const uint64_t *b,
+                                                   uint64_t *lo, uint64_t *hi,
+                                                   usint count) {
+    const __m512i vOne = _mm512_set1_epi64(1);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i x = LoadAVX512(a + i), y = LoadAVX512(b + i);
+      __m512i prodLo = _mm512_mullo_epi64(x, y);
+      __m512i sum = _mm512_add_epi64(LoadAVX512(lo + i), prodLo);
+      __m512i h = _mm512_add_epi64(LoadAVX512(hi + i), MulHi64AVX512(x, y));
+      h = _mm512_mask_add_epi64(h, _mm512_cmplt_epu64_mask(sum, prodLo), h,
+                                vOne);
+      StoreAVX512(hi + i, h);
+      StoreAVX512(lo + i, sum);
+    }
+    PortableKernel::MulAccumulate(a + i, b + i, lo + i, hi + i, count - i);
+  }
+
+  PALISADE_TARGET_AVX512 static void ReduceAccumulator(
+      const uint64_t *lo, const uint64_t *hi, uint64_t *r, usint count,
+      uint64_t q, const BarrettRatio &ratio) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vTwoQ = _mm512_set1_epi64(q << 1);
+    const __m512i vRHi = _mm512_set1_epi64(ratio.hi);
+    const __m512i vRLo = _mm512_set1_epi64(ratio.lo);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i l = LoadAVX512(lo + i);
+      __m512i quot = BarrettQuotientAVX512(l, LoadAVX512(hi + i), vRHi, vRLo);
+      __m512i rem = _mm512_sub_epi64(l, _mm512_mullo_epi64(quot, vQ));
+      StoreAVX512(r + i, ReduceOnceAVX512(ReduceOnceAVX512(rem, vTwoQ), vQ));
+    }
+    PortableKernel::ReduceAccumulator(lo + i, hi + i, r + i, count - i, q,
+                                      ratio);
+  }
+};
+
+#ifdef WITH_NATIVE_IFMA
+
+// the IFMA variant of the AVX-512 kernel for q < 2^50
+struct IFMAKernel : public AVX512Kernel {
+  PALISADE_TARGET_AVX512IFMA static void Mul(const uint64_t *a,
+                                             const uint64_t *b, uint64_t *r,
+                                             usint count, uint64_t q,
+                                             uint64_t mu,
+                                             const BarrettShifts &s) {
+    const BarrettIFMA barrett = ComputeBarrettIFMA(q);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      StoreAVX512(r + i,
+                  MulModIFMA(LoadAVX512(a + i), LoadAVX512(b + i), barrett));
+    }
+    PortableKernel::Mul(a + i, b + i, r + i, count - i, q, mu, s);
+  }
+
+  PALISADE_TARGET_AVX512IFMA static void MulConst(const uint64_t *a,
+                                                  uint64_t b, uint64_t bPrecon,
+                                                  uint64_t *r, usint count,
+                                                  uint64_t q) {
+    const __m512i vQ = _mm512_set1_epi64(q);
+    const __m512i vNegQ = _mm512_set1_epi64((uint64_t(1) << 52) - q);
+    const __m512i vB = _mm512_set1_epi64(b);
+    const __m512i vBPrecon = _mm512_set1_epi64(bPrecon >> 12);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i prod = MulShoupLazyIFMA(LoadAVX512(a + i), vB, vBPrecon, vNegQ);
+      StoreAVX512(r + i, ReduceOnceAVX512(prod, vQ));
+    }
+    PortableKernel::MulConst(a + i, b, bPrecon, r + i, count - i, q);
+  }
+
+  // the 104-bit product lo52 + hi52 * 2^52 is split into 64-bit words
+  PALISADE_TARGET_AVX512IFMA static void MulAccumulate(const uint64_t *a,
+                                                       const uint64_t *b,
+                                                       uint64_t *lo,
+                                                       uint64_t *hi,
+                                                       usint count) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i vOne = _mm512_set1_epi64(1);
+    usint i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      __m512i x = LoadAVX512(a + i), y = LoadAVX512(b + i);
+      __m512i prodHi52 = _mm512_madd52hi_epu64(zero, x, y);
+      __m512i prodLo = _mm512_or_si512(_mm512_madd52lo_epu64(zero, x, y),
+                                       _mm512_slli_epi64(prodHi52, 52));
+      __m512i sum = _mm512_add_epi64(LoadAVX512(lo + i), prodLo);
+      __m512i h = _mm512_add_epi64(LoadAVX512(hi + i),
+                                   _mm512_srli_epi64(prodHi52, 12));
+      h = _mm512_mask_add_epi64(h, _mm512_cmplt_epu64_mask(sum, prodLo), h,
+                                vOne);
+      StoreAVX512(hi + i, h);
+      StoreAVX512(lo + i, sum);
+    }
+    PortableKernel::MulAccumulate(a + i, b + i, lo + i, hi + i, count - i);
+  }
+};
+
+#endif  // WITH_NATIVE_IFMA
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // PALISADE_SIMD_X86
+
+}  // namespace
+
+// calls Kernel::FUNC for the kernel of the currently selected engine
+#ifdef PALISADE_SIMD_X86
+#define NATIVEVECTOR_DISPATCH(FUNC, ...)          \
+  switch (SIMDControls::GetEngine()) {            \
+    case SIMD_AVX512IFMA:                         \
+    case SIMD_AVX512:                             \
+      AVX512Kernel::FUNC(__VA_ARGS__);            \
+      break;                                      \
+    case SIMD_AVX2:                               \
+      AVX2Kernel::FUNC(__VA_ARGS__);              \
+      break;                                      \
+    default:                                      \
+      PortableKernel::FUNC(__VA_ARGS__);          \
+      break;                                      \
+  }
+
+// the same for the multiplications of values reduced modulo MODULUS, which
+// run on the 52-bit variants of the kernels for small moduli
+#ifdef WITH_NATIVE_IFMA
+#define NATIVEVECTOR_DISPATCH_IFMA(MODULUS, FUNC, ...) \
+  case SIMD_AVX512IFMA:                                \
+    if (IsSmallModulus(MODULUS)) {                     \
+      IFMAKernel::FUNC(__VA_ARGS__);                   \
+      break;                                           \
+    }                                                  \
+    AVX512Kernel::FUNC(__VA_ARGS__);                   \
+    break;
+#else
+#define NATIVEVECTOR_DISPATCH_IFMA(MODULUS, FUNC, ...)
+#endif
+#define NATIVEVECTOR_DISPATCH_MUL(MODULUS, FUNC, ...)      \
+  switch (SIMDControls::GetEngine()) {                     \
+    NATIVEVECTOR_DISPATCH_IFMA(MODULUS, FUNC, __VA_ARGS__) \
+    case SIMD_AVX512:                                      \
+      AVX512Kernel::FUNC(__VA_ARGS__);                     \
+      break;                                               \
+    case SIMD_AVX2:                                        \
+      if (IsSmallModulus(MODULUS)) {                       \
+        AVX2FMAKernel::FUNC(__VA_ARGS__);                  \
+        break;                                             \
+      }                                                    \
+      AVX2Kernel::FUNC(__VA_ARGS__);                       \
+      break;                                               \
+    default:                                               \
+      PortableKernel::FUNC(__VA_ARGS__);                   \
+      break;                                               \
+  }
+#else
+#define NATIVEVECTOR_DISPATCH(FUNC, ...) PortableKernel::FUNC(__VA_ARGS__);
+#define NATIVEVECTOR_DISPATCH_MUL(MODULUS, FUNC, ...) \
+  PortableKernel::FUNC(__VA_ARGS__);
+#endif
+
+void NativeVectorKernels::ModAdd(const uint64_t *a, const uint64_t *b,
+                                 uint64_t *result, usint n, uint64_t modulus) {
+  NATIVEVECTOR_DISPATCH(Add<false>, a, b, result, n, modulus)
+}
+
+void NativeVectorKernels::ModAddScalar(const uint64_t *a, uint64_t b,
+                                       uint64_t *result, usint n,
+                                       uint64_t modulus) {
+  NATIVEVECTOR_DISPATCH(Add<true>, a, &b, result, n, modulus)
+}
+
+void NativeVectorKernels::ModSub(const uint64_t *a, const uint64_t *b,
+                                 uint64_t *result, usint n, uint64_t modulus) {
+  NATIVEVECTOR_DISPATCH(Sub<false>, a, b, result, n, modulus)
+}
+
+void NativeVectorKernels::ModSubScalar(const uint64_t *a, uint64_t b,
+                                       uint64_t *result, usint n,
+                                       uint64_t modulus) {
+  NATIVEVECTOR_DISPATCH(Sub<true>, a, &b, result, n, modulus)
+}
+
+void NativeVectorKernels::ModNegate(const uint64_t *a, uint64_t *result,
+                                    usint n, uint64_t modulus) {
+  NATIVEVECTOR_DISPATCH(Negate, a, result, n, modulus)
+}
+
+void NativeVectorKernels::ModMul(const uint64_t *a, const uint64_t *b,
+                                 uint64_t *result, usint n, uint64_t modulus,
+                                 uint64_t mu) {
+  if (modulus < 4) {
+    // the Barrett shifts need at least a 2-bit modulus
+    for (usint i = 0; i < n; ++i) {
+      result[i] = (a[i] * b[i]) % modulus;
+    }
+    return;
+  }
+  BarrettShifts shifts(modulus);
+  NATIVEVECTOR_DISPATCH_MUL(modulus, Mul, a, b, result, n, modulus, mu,
+                            shifts)
+}
+
+void NativeVectorKernels::ModMulScalar(const uint64_t *a, uint64_t b,
+                                       uint64_t bPrecon, uint64_t *result,
+                                       usint n, uint64_t modulus) {
+  NATIVEVECTOR_DISPATCH_MUL(modulus, MulConst, a, b, bPrecon, result, n,
+                            modulus)
+}
+
+void NativeVectorKernels::SwitchModulus(const uint64_t *a, uint64_t *result,
+                                        usint n, uint64_t oldModulus,
+                                        uint64_t newModulus) {
+  const uint64_t halfQ = oldModulus >> 1;
+  if (newModulus > oldModulus) {
+    NATIVEVECTOR_DISPATCH(Grow, a, result, n, halfQ, newModulus - oldModulus)
+  } else {
+    const uint64_t diff = (oldModulus - newModulus) % newModulus;
+    const uint64_t oneModQPrecon = ~uint64_t(0) / newModulus;
+    NATIVEVECTOR_DISPATCH(Shrink, a, result, n, halfQ, diff, newModulus,
+                          oneModQPrecon)
+  }
+}
+
+void NativeVectorKernels::SwitchModulusAndScale(const uint64_t *a,
+                                                uint64_t *result, usint n,
+                                                uint64_t oldModulus,
+                                                uint64_t newModulus, uint64_t b,
+                                                uint64_t bPrecon) {
+  const usint BLOCK = 256;
+  for (usint begin = 0; begin < n; begin += BLOCK) {
+    const usint count = (n - begin < BLOCK) ? n - begin : BLOCK;
+    SwitchModulus(a + begin, result + begin, count, oldModulus, newModulus);
+    NATIVEVECTOR_DISPATCH_MUL(newModulus, MulConst, result + begin, b, bPrecon,
+                              result + begin, count, newModulus)
+  }
+}
+
+void NativeVectorKernels::ModMulScalarAdd(const uint64_t *a, uint64_t b,
+                                          uint64_t bPrecon, const uint64_t *c,
+                                          uint64_t *result, usint n,
+                                          uint64_t modulus) {
+  const usint BLOCK = 256;
+  uint64_t product[BLOCK];
+  for (usint begin = 0; begin < n; begin += BLOCK) {
+    const usint count = (n - begin < BLOCK) ? n - begin : BLOCK;
+    NATIVEVECTOR_DISPATCH_MUL(modulus, MulConst, a + begin, b, bPrecon,
+                              product, count, modulus)
+    NATIVEVECTOR_DISPATCH(Add<false>, product, c + begin, result + begin,
+                          count, modulus)
+  }
+}
+
+void NativeVectorKernels::ModMulAdd(const uint64_t *const *a,
+                                    const uint64_t *const *b, usint k,
+                                    uint64_t *result, usint n,
+                                    uint64_t modulus) {
+  if (k == 0) {
+    return;
+  }
+  const BarrettRatio ratio = ComputeBarrettRatio(modulus);
+  // the accumulators stay below q * 2^64 for up to 2^64 / q - 1 products of
+  // reduced values on top of a reduced value
+  const uint64_t maxTerms = ~uint64_t(0) / modulus - 1;
+  const usint termsPerReduction =
+      maxTerms < k ? static_cast<usint>(maxTerms) : k;
+  // blocks of accumulators that stay in the L1 cache
+  const usint BLOCK = 256;
+  uint64_t lo[BLOCK], hi[BLOCK];
+  for (usint begin = 0; begin < n; begin += BLOCK) {
+    const usint count = (n - begin < BLOCK) ? n - begin : BLOCK;
+    std::copy(result + begin, result + begin + count, lo);
+    std::fill(hi, hi + count, 0);
+    for (usint j = 0; j < k; ++j) {
+      if (j > 0 && j % termsPerReduction == 0) {
+        NATIVEVECTOR_DISPATCH(ReduceAccumulator, lo, hi, lo, count, modulus,
+                              ratio)
+        std::fill(hi, hi + count, 0);
+      }
+      NATIVEVECTOR_DISPATCH_MUL(modulus, MulAccumulate, a[j] + begin,
+                                b[j] + begin, lo, hi, count)
+    }
+    NATIVEVECTOR_DISPATCH(ReduceAccumulator, lo, hi, result + begin, count,
+                          modulus, ratio)
+  }
+}
+
+void NativeVectorKernels::ModByTwo(const uint64_t *a, uint64_t *result,
+                                   usint n, uint64_t modulus) {
+  NATIVEVECTOR_DISPATCH(ByTwo, a, result, n, modulus >> 1)
+}
+
+}  // namespace lbcrypto
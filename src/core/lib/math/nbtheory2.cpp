@@ -27,12 +27,17 @@
 #include <time.h>
 #include <chrono>
 #include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <utility>
 
 #include "math/distributiongenerator.h"
 #include "math/nbtheory.h"
 
 #include "utils/debug.h"
+#include "utils/utilities.h"
 
 namespace lbcrypto {
 
@@ -304,4 +309,65 @@ void PrecomputeAutoMap(uint32_t n, uint32_t k, std::vector<uint32_t> *precomp) {
   }
 }
 
+const std::vector<uint32_t> &GetAutomorphismPermutation(uint32_t m,
+                                                        uint32_t k) {
+  typedef std::pair<uint32_t, uint32_t> PermutationKey;
+  static std::map<PermutationKey, std::unique_ptr<std::vector<uint32_t>>>
+      registry;
+  static std::mutex registryMutex;
+  // Rotations look up their permutation on every call, often from OpenMP
+  // loops, so each thread keeps the permutations it has seen and only takes
+  // the lock on its first lookup of a key. Registry entries are never
+  // removed, so the cached pointers stay valid.
+  static thread_local std::map<PermutationKey, const std::vector<uint32_t> *>
+      seen;
+
+  k %= m;
+  PermutationKey key(m, k);
+  auto seenIt = seen.find(key);
+  if (seenIt != seen.end()) {
+    return *seenIt->second;
+  }
+
+  std::lock_guard<std::mutex> lock(registryMutex);
+  auto it = registry.find(key);
+  if (it != registry.end()) {
+    seen[key] = it->second.get();
+    return *it->second;
+  }
+
+  std::unique_ptr<std::vector<uint32_t>> perm(new std::vector<uint32_t>());
+  if (IsPowerOfTwo(m)) {
+    if (k % 2 == 0) {
+      PALISADE_THROW(math_error, "automorphism index should be odd\n");
+    }
+    uint32_t n = m >> 1;
+    perm->resize(n);
+    PrecomputeAutoMap(n, k, perm.get());
+  } else {
+    // slots are indexed by the totatives of m; k maps the slot of totative t
+    // to the slot of t * k mod m
+    std::vector<usint> totientList = GetTotientList(usint(m));
+    std::vector<uint32_t> slotOf(m, m);
+    for (uint32_t i = 0; i < totientList.size(); i++) {
+      slotOf[totientList[i]] = i;
+    }
+    perm->resize(totientList.size());
+    for (uint32_t i = 0; i < totientList.size(); i++) {
+      uint32_t slot = slotOf[uint64_t(totientList[i]) * k % m];
+      if (slot == m) {
+        PALISADE_THROW(math_error,
+                       "automorphism index should be coprime to the "
+                       "cyclotomic order\n");
+      }
+      (*perm)[i] = slot;
+    }
+  }
+
+  const std::vector<uint32_t> &result = *perm;
+  registry[key] = std::move(perm);
+  seen[key] = &result;
+  return result;
+}
+
 }  // namespace lbcrypto
@@ -0,0 +1,386 @@
+// @file nttplan.cpp Immutable per-modulus precomputations for the native NTT.
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "math/nttplan.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "math/nativentt.h"
+#include "math/transfrm.h"
+#include "utils/parallel.h"
+
+namespace lbcrypto {
+
+namespace {
+
+// Blocks smaller than this (in coefficients) are not worth the extra
+// synchronization of splitting a transform.
+const usint MIN_NTT_BLOCK_SIZE = 2048;
+
+// Number of blocks each of numTransforms transforms of size n is split into,
+// so that every available thread gets at least one block.
+usint NumberOfNTTBlocks(size_t numTransforms, usint n) {
+#if defined(PARALLEL) && !defined(WITH_INTEL_HEXL)
+  if (omp_in_parallel()) {
+    return 1;
+  }
+  size_t threads = omp_get_max_threads();
+  usint blocks = 1;
+  while (blocks * numTransforms < threads &&
+         n / (2 * blocks) >= MIN_NTT_BLOCK_SIZE) {
+    blocks <<= 1;
+  }
+  return blocks;
+#else
+  // without OpenMP there is nothing to split for; with Intel HEXL, each
+  // transform is done by the library as a whole
+  return 1;
+#endif
+}
+
+}  // namespace
+
+NativeNTTPlan::NativeNTTPlan(const NativeInteger &rootOfUnity,
+                             usint cycloOrder, const NativeInteger &modulus)
+    : m_rootOfUnity(rootOfUnity),
+      m_modulus(modulus),
+      m_cycloOrder(cycloOrder),
+      m_tables(nullptr),
+      m_cycloOrderInv(0),
+      m_preconCycloOrderInv(0) {
+  if (!IsPowerOfTwo(cycloOrder)) {
+    PALISADE_THROW(math_error, "CyclotomicOrder is not a power of two");
+  }
+
+#if NATIVEINT == 64
+  if (modulus.GetMSB() > NativeNTTEngine::MAX_MODULUS_BITS) {
+    return;
+  }
+
+  usint n = cycloOrder >> 1;
+  usint msb = GetMSB64(n - 1);
+  const size_t alignWords = 64 / sizeof(uint64_t);
+  m_storage.reset(new uint64_t[4 * n + alignWords]);
+  uint64_t *tables = m_storage.get();
+  size_t misalignment =
+      (reinterpret_cast<uintptr_t>(tables) / sizeof(uint64_t)) % alignWords;
+  if (misalignment != 0) {
+    tables += alignWords - misalignment;
+  }
+
+  uint64_t *rootTable = tables;
+  uint64_t *preconRootTable = tables + n;
+  uint64_t *rootInverseTable = tables + 2 * n;
+  uint64_t *preconRootInverseTable = tables + 3 * n;
+
+  NativeInteger mu = modulus.ComputeMu();
+  NativeInteger rootOfUnityInverse = rootOfUnity.ModInverse(modulus);
+  NativeInteger x(1), xinv(1);
+  for (usint i = 0; i < n; i++) {
+    usint iinv = ReverseBits(i, msb);
+    rootTable[iinv] = x.ConvertToInt();
+    preconRootTable[iinv] = x.PrepModMulConst(modulus).ConvertToInt();
+    rootInverseTable[iinv] = xinv.ConvertToInt();
+    preconRootInverseTable[iinv] = xinv.PrepModMulConst(modulus).ConvertToInt();
+    x.ModMulEq(rootOfUnity, modulus, mu);
+    xinv.ModMulEq(rootOfUnityInverse, modulus, mu);
+  }
+
+  NativeInteger cycloOrderInv = NativeInteger(n).ModInverse(modulus);
+  m_cycloOrderInv = cycloOrderInv.ConvertToInt();
+  m_preconCycloOrderInv = cycloOrderInv.PrepModMulConst(modulus).ConvertToInt();
+  m_tables = tables;
+
+#ifdef WITH_INTEL_HEXL
+  m_intelNtt.reset(new intel::hexl::NTT(n, modulus.ConvertToInt(),
+                                        rootOfUnity.ConvertToInt()));
+#endif
+#endif
+}
+
+std::shared_ptr<const NativeNTTPlan> NativeNTTPlan::Get(
+    const NativeInteger &rootOfUnity, usint cycloOrder,
+    const NativeInteger &modulus) {
+  if (rootOfUnity == NativeInteger(0) || rootOfUnity == NativeInteger(1) ||
+      cycloOrder < 2 || !IsPowerOfTwo(cycloOrder) ||
+      rootOfUnity >= modulus ||
+      modulus.Mod(NativeInteger(cycloOrder)) != NativeInteger(1)) {
+    return nullptr;
+  }
+
+  // Parameters for the same modulus share one plan. The registry is only
+  // consulted when parameters are built, so a plain mutex is fine here.
+  typedef std::tuple<NativeInteger, NativeInteger, usint> PlanKey;
+  static std::map<PlanKey, std::shared_ptr<const NativeNTTPlan>> registry;
+  static std::mutex registryMutex;
+
+  PlanKey key(modulus, rootOfUnity, cycloOrder);
+  std::lock_guard<std::mutex> lock(registryMutex);
+  auto it = registry.find(key);
+  if (it != registry.end()) {
+    return it->second;
+  }
+  std::shared_ptr<const NativeNTTPlan> plan;
+  try {
+    plan = std::make_shared<const NativeNTTPlan>(rootOfUnity, cycloOrder,
+                                                 modulus);
+  } catch (const math_error &) {
+    // e.g., a composite modulus where the root of unity is not invertible;
+    // such parameters keep using the generic transform, which reports the
+    // error if they are ever used for an NTT
+    return nullptr;
+  }
+  registry[key] = plan;
+  return plan;
+}
+
+void NativeNTTPlan::ForwardTransformToBitReverseInPlace(
+    NativeVector *element) const {
+  if (m_tables == nullptr) {
+    ChineseRemainderTransformFTT<NativeVector>::
+        ForwardTransformToBitReverseInPlace(m_rootOfUnity, m_cycloOrder,
+                                            element);
+    return;
+  }
+
+  auto *data = reinterpret_cast<uint64_t *>(&(*element)[0]);
+#ifdef WITH_INTEL_HEXL
+  m_intelNtt->ComputeForward(data, data, 1, 1);
+#else
+  usint n = GetRingDimension();
+  NativeNTTEngine::ForwardTransformToBitReverseInPlace(
+      m_tables, m_tables + n, m_modulus.ConvertToInt(), n, data);
+#endif
+}
+
+void NativeNTTPlan::InverseTransformFromBitReverseInPlace(
+    NativeVector *element) const {
+  if (m_tables == nullptr) {
+    ChineseRemainderTransformFTT<NativeVector>::
+        InverseTransformFromBitReverseInPlace(m_rootOfUnity, m_cycloOrder,
+                                              element);
+    return;
+  }
+
+  auto *data = reinterpret_cast<uint64_t *>(&(*element)[0]);
+#ifdef WITH_INTEL_HEXL
+  m_intelNtt->ComputeInverse(data, data, 1, 1);
+#else
+  usint n = GetRingDimension();
+  NativeNTTEngine::InverseTransformFromBitReverseInPlace(
+      m_tables + 2 * n, m_tables + 3 * n, m_cycloOrderInv,
+      m_preconCycloOrderInv, m_modulus.ConvertToInt(), n, data);
+#endif
+}
+
+// HEXL has no pruned transforms, but its outputs match those of the native
+// kernels, which are used instead
+void NativeNTTPlan::ForwardTransformToBitReversePrunedInPlace(
+    usint stride, usint degree, NativeVector *element) const {
+  usint n = GetRingDimension();
+  if (m_tables == nullptr ||
+      !NativeNTTEngine::IsValidPruning(n, stride, degree)) {
+    // the fallback also reports invalid arguments
+    ChineseRemainderTransformFTT<NativeVector>::
+        ForwardTransformToBitReversePrunedInPlace(m_rootOfUnity, m_cycloOrder,
+                                                  stride, degree, element);
+    return;
+  }
+  NativeNTTEngine::ForwardTransformToBitReversePrunedInPlace(
+      m_tables, m_tables + n, m_modulus.ConvertToInt(), n, stride, degree,
+      reinterpret_cast<uint64_t *>(&(*element)[0]));
+}
+
+void NativeNTTPlan::InverseTransformFromBitReversePrunedInPlace(
+    usint stride, usint degree, NativeVector *element) const {
+  usint n = GetRingDimension();
+  if (m_tables == nullptr ||
+      !NativeNTTEngine::IsValidPruning(n, stride, degree)) {
+    ChineseRemainderTransformFTT<NativeVector>::
+        InverseTransformFromBitReversePrunedInPlace(
+            m_rootOfUnity, m_cycloOrder, stride, degree, element);
+    return;
+  }
+  NativeNTTEngine::InverseTransformFromBitReversePrunedInPlace(
+      m_tables + 2 * n, m_tables + 3 * n, m_cycloOrderInv,
+      m_preconCycloOrderInv, m_modulus.ConvertToInt(), n, stride, degree,
+      reinterpret_cast<uint64_t *>(&(*element)[0]));
+}
+
+void NativeNTTPlan::NegacyclicMultiplyInPlace(NativeVector *element,
+                                              const NativeVector &other,
+                                              bool otherTransformed) const {
+#ifndef WITH_INTEL_HEXL
+  if (m_tables != nullptr) {
+    usint n = GetRingDimension();
+    NativeNTTEngine::NegacyclicMultiply(
+        m_tables, m_tables + n, m_tables + 2 * n, m_tables + 3 * n,
+        m_cycloOrderInv, m_preconCycloOrderInv, m_modulus.ConvertToInt(), n,
+        otherTransformed, reinterpret_cast<const uint64_t *>(&other[0]),
+        reinterpret_cast<uint64_t *>(&(*element)[0]));
+    return;
+  }
+#endif
+
+  ForwardTransformToBitReverseInPlace(element);
+  if (otherTransformed) {
+    element->ModMulEq(other);
+  } else {
+    NativeVector otherTransform(other);
+    ForwardTransformToBitReverseInPlace(&otherTransform);
+    element->ModMulEq(otherTransform);
+  }
+  InverseTransformFromBitReverseInPlace(element);
+}
+
+bool NativeNTTPlan::IsBatchable(
+    const std::vector<const NativeNTTPlan *> &plans,
+    const std::vector<NativeVector *> &elements) {
+  if (plans.size() != elements.size()) {
+    PALISADE_THROW(math_error, "number of plans and vectors do not match");
+  }
+  for (size_t k = 0; k < plans.size(); k++) {
+    if (plans[k] == nullptr || plans[k]->m_tables == nullptr ||
+        !plans[k]->IsCompatible(*elements[k]) ||
+        plans[k]->GetRingDimension() != plans[0]->GetRingDimension()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NativeNTTPlan::ForwardTransformBatch(
+    const std::vector<const NativeNTTPlan *> &plans,
+    const std::vector<NativeVector *> &elements) {
+  if (!IsBatchable(plans, elements)) {
+    return false;
+  }
+  if (elements.empty()) {
+    return true;
+  }
+
+  const size_t numTransforms = elements.size();
+  const usint n = plans[0]->GetRingDimension();
+  const usint numBlocks = NumberOfNTTBlocks(numTransforms, n);
+  if (numBlocks == 1) {
+#pragma omp parallel for
+    for (size_t k = 0; k < numTransforms; k++) {
+      plans[k]->ForwardTransformToBitReverseInPlace(elements[k]);
+    }
+    return true;
+  }
+
+  // the first log2(numBlocks) stages are split into numBlocks slices per
+  // transform, then each block finishes independently
+  const size_t numTasks = numTransforms * numBlocks;
+#pragma omp parallel
+  {
+    for (usint m = 1; m < numBlocks; m <<= 1) {
+      usint sliceSize = n / (2 * m * numBlocks);
+#pragma omp for
+      for (size_t task = 0; task < numTasks; task++) {
+        const NativeNTTPlan *plan = plans[task / numBlocks];
+        usint slice = task % numBlocks;
+        NativeNTTEngine::ForwardTransformStageSlice(
+            plan->m_tables, plan->m_tables + n, plan->m_modulus.ConvertToInt(),
+            n, m, slice * sliceSize, (slice + 1) * sliceSize,
+            reinterpret_cast<uint64_t *>(&(*elements[task / numBlocks])[0]));
+      }
+    }
+#pragma omp for
+    for (size_t task = 0; task < numTasks; task++) {
+      const NativeNTTPlan *plan = plans[task / numBlocks];
+      NativeNTTEngine::ForwardTransformBlock(
+          plan->m_tables, plan->m_tables + n, plan->m_modulus.ConvertToInt(), n,
+          numBlocks, task % numBlocks,
+          reinterpret_cast<uint64_t *>(&(*elements[task / numBlocks])[0]));
+    }
+  }
+  return true;
+}
+
+bool NativeNTTPlan::InverseTransformBatch(
+    const std::vector<const NativeNTTPlan *> &plans,
+    const std::vector<NativeVector *> &elements) {
+  if (!IsBatchable(plans, elements)) {
+    return false;
+  }
+  if (elements.empty()) {
+    return true;
+  }
+
+  const size_t numTransforms = elements.size();
+  const usint n = plans[0]->GetRingDimension();
+  const usint numBlocks = NumberOfNTTBlocks(numTransforms, n);
+  if (numBlocks == 1) {
+#pragma omp parallel for
+    for (size_t k = 0; k < numTransforms; k++) {
+      plans[k]->InverseTransformFromBitReverseInPlace(elements[k]);
+    }
+    return true;
+  }
+
+  // mirror image of ForwardTransformBatch(): independent blocks first, then
+  // the last log2(numBlocks) stages and the scaling by n^{-1} in slices
+  const size_t numTasks = numTransforms * numBlocks;
+#pragma omp parallel
+  {
+#pragma omp for
+    for (size_t task = 0; task < numTasks; task++) {
+      const NativeNTTPlan *plan = plans[task / numBlocks];
+      NativeNTTEngine::InverseTransformBlock(
+          plan->m_tables + 2 * n, plan->m_tables + 3 * n,
+          plan->m_modulus.ConvertToInt(), n, numBlocks, task % numBlocks,
+          reinterpret_cast<uint64_t *>(&(*elements[task / numBlocks])[0]));
+    }
+    for (usint m = numBlocks >> 1; m >= 1; m >>= 1) {
+      usint sliceSize = n / (2 * m * numBlocks);
+#pragma omp for
+      for (size_t task = 0; task < numTasks; task++) {
+        const NativeNTTPlan *plan = plans[task / numBlocks];
+        usint slice = task % numBlocks;
+        NativeNTTEngine::InverseTransformStageSlice(
+            plan->m_tables + 2 * n, plan->m_tables + 3 * n,
+            plan->m_modulus.ConvertToInt(), n, m, slice * sliceSize,
+            (slice + 1) * sliceSize,
+            reinterpret_cast<uint64_t *>(&(*elements[task / numBlocks])[0]));
+      }
+    }
+    usint blockSize = n / numBlocks;
+#pragma omp for
+    for (size_t task = 0; task < numTasks; task++) {
+      const NativeNTTPlan *plan = plans[task / numBlocks];
+      usint block = task % numBlocks;
+      NativeNTTEngine::InverseTransformScale(
+          plan->m_cycloOrderInv, plan->m_preconCycloOrderInv,
+          plan->m_modulus.ConvertToInt(), block * blockSize,
+          (block + 1) * blockSize,
+          reinterpret_cast<uint64_t *>(&(*elements[task / numBlocks])[0]));
+    }
+  }
+  return true;
+}
+
+}  // namespace lbcrypto
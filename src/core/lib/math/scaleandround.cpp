@@ -0,0 +1,162 @@
+// @file scaleandround.cpp Kernels of the RNS scaling and rounding by t/Q.
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "math/scaleandround.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "math/backend.h"
+#include "math/nativesimd.h"
+#include "math/nbtheory.h"
+
+namespace lbcrypto {
+
+namespace {
+
+using nativesimd::MulShoupLazy;
+using nativesimd::ReduceOnce;
+
+// x < 2^52 as a double, exactly: the bits of 2^52 + x minus 2^52; unlike
+// the conversion instruction, this vectorizes without AVX-512
+inline double ToDouble52(uint64_t x) {
+  uint64_t bits = x | 0x4330000000000000ULL;
+  double d;
+  std::memcpy(&d, &bits, sizeof(d));
+  return d - 4503599627370496.0;
+}
+
+// [x * w]_t if REDUCE, x * w otherwise
+template <bool REDUCE>
+inline uint64_t MulModt(uint64_t x, uint64_t w, uint64_t wPrecon, uint64_t t) {
+  return REDUCE ? ReduceOnce(MulShoupLazy(x, w, wPrecon, t), t) : x * w;
+}
+
+// The kernel of one regime: whether t is a power of two, whether the residues
+// are split and whether the products are reduced mod t. The floating-point
+// operations are done in the same order as in the one-coefficient-at-a-time
+// formulation, so the results do not depend on the blocking.
+template <bool POWER_OF_TWO_T, bool SPLIT, bool REDUCE>
+void ScaleAndRoundRegime(const ScaleAndRoundArgs &args) {
+  const usint BLOCK = ScaleAndRoundKernels::BLOCK_SIZE;
+  const usint length = args.length;
+  const usint numBlocks = (length + BLOCK - 1) / BLOCK;
+  const uint64_t t = args.t;
+  const double td = static_cast<double>(t);
+  const double tInv = 1. / td;
+
+#pragma omp parallel for if (numBlocks > 1)
+  for (usint b = 0; b < numBlocks; b++) {
+    const usint k0 = b * BLOCK;
+    const usint len = std::min(BLOCK, length - k0);
+    double floatSum[BLOCK];
+    uint64_t intSum[BLOCK];
+    for (usint k = 0; k < len; k++) {
+      floatSum[k] = POWER_OF_TWO_T ? 0.5 : 0.0;
+      intSum[k] = 0;
+    }
+
+    for (usint i = 0; i < args.numIn; i++) {
+      const uint64_t *x = args.in[i] + k0;
+      const double f = args.frac[i];
+      const uint64_t w = args.modt[i];
+      const uint64_t wPrecon = args.modtPrecon[i];
+      if (SPLIT) {
+        const usint shift = args.splitShift;
+        const double fB = args.fracB[i];
+        const uint64_t wB = args.modtB[i];
+        const uint64_t wBPrecon = args.modtBPrecon[i];
+        for (usint k = 0; k < len; k++) {
+          uint64_t hi = x[k] >> shift;
+          uint64_t lo = x[k] - (hi << shift);
+          floatSum[k] += ToDouble52(lo) * f;
+          floatSum[k] += ToDouble52(hi) * fB;
+          intSum[k] += MulModt<REDUCE>(lo, w, wPrecon, t);
+          intSum[k] += MulModt<REDUCE>(hi, wB, wBPrecon, t);
+        }
+      } else {
+        for (usint k = 0; k < len; k++) {
+          floatSum[k] += ToDouble52(x[k]) * f;
+          intSum[k] += MulModt<REDUCE>(x[k], w, wPrecon, t);
+        }
+      }
+    }
+
+    uint64_t *out = args.out + k0;
+    if (POWER_OF_TWO_T) {
+      const uint64_t tMinus1 = t - 1;
+      for (usint k = 0; k < len; k++) {
+        out[k] = (intSum[k] + static_cast<uint64_t>(floatSum[k])) & tMinus1;
+      }
+    } else {
+      // the quotient by t is found with doubles, then the rounding; a
+      // remainder in [t - 1/2, t) rounds up to t, which is 0 mod t
+      for (usint k = 0; k < len; k++) {
+        double sum = floatSum[k] + static_cast<double>(intSum[k]);
+        uint64_t quot = static_cast<uint64_t>(sum * tInv);
+        sum -= td * quot;
+        out[k] = ReduceOnce(static_cast<uint64_t>(sum + 0.5), t);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+const usint ScaleAndRoundKernels::BLOCK_SIZE;
+
+bool ScaleAndRoundKernels::SplitsResidues(usint qMSB, usint numIn) {
+  // x_i < q_i and the floating-point error of sum x_i * frac[i] is at most
+  // numIn * 2^qMSB * 2^-53, which is below 1/4 for qMSB + log(numIn) < 52;
+  // otherwise the halves of x_i keep it below 1/4 for up to 2^11 moduli
+  return qMSB + GetMSB64(numIn) >= 52;
+}
+
+ScaleAndRoundKernel ScaleAndRoundKernels::SelectKernel(usint qMSB,
+                                                       usint numIn,
+                                                       uint64_t t) {
+  const bool powerOfTwo = (t & (t - 1)) == 0;
+  const usint tMSB = GetMSB64(t);
+  const usint sizeQMSB = GetMSB64(numIn);
+  const bool split = SplitsResidues(qMSB, numIn);
+  // the bit length of the summed products without reductions mod t; for a
+  // power-of-two t they may use 63 bits (62 if split, as there are two
+  // products per residue), otherwise the sum has to be exact as a double
+  const usint productMSB = (split ? qMSB >> 1 : qMSB) + tMSB + sizeQMSB;
+  const bool reduce =
+      powerOfTwo ? productMSB >= (split ? 62U : 63U) : productMSB >= 52;
+
+  static const ScaleAndRoundKernel kernels[2][2][2] = {
+      {{&ScaleAndRoundRegime<false, false, false>,
+        &ScaleAndRoundRegime<false, false, true>},
+       {&ScaleAndRoundRegime<false, true, false>,
+        &ScaleAndRoundRegime<false, true, true>}},
+      {{&ScaleAndRoundRegime<true, false, false>,
+        &ScaleAndRoundRegime<true, false, true>},
+       {&ScaleAndRoundRegime<true, true, false>,
+        &ScaleAndRoundRegime<true, true, true>}}};
+  return kernels[powerOfTwo][split][reduce];
+}
+
+}  // namespace lbcrypto
@@ -23,6 +23,7 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "math/transfrm.h"
+#include "math/nativentt.h"
 #include "utils/defines.h"
 
 #ifdef WITH_INTEL_HEXL
@@ -31,6 +32,135 @@
 
 namespace lbcrypto {
 
+// The precomputed (Shoup) variants of the transforms below hand 64-bit native
+// vectors over to the vectorized NativeNTTEngine kernels. The generic
+// templates return false so that all other vector types, and moduli too large
+// for the lazy-reduction kernels, take the portable loops.
+template <typename VecType>
+inline bool NativeForwardTransformToBitReverseInPlace(
+    const VecType &rootOfUnityTable, const NativeVector &preconRootOfUnityTable,
+    VecType *element) {
+  return false;
+}
+
+template <typename VecType>
+inline bool NativeInverseTransformFromBitReverseInPlace(
+    const VecType &rootOfUnityInverseTable,
+    const NativeVector &preconRootOfUnityInverseTable,
+    const typename VecType::Integer &cycloOrderInv,
+    const NativeInteger &preconCycloOrderInv, VecType *element) {
+  return false;
+}
+
+template <typename VecType>
+inline bool NativeForwardTransformToBitReversePrunedInPlace(
+    const VecType &rootOfUnityTable, const NativeVector &preconRootOfUnityTable,
+    usint stride, usint degree, VecType *element) {
+  return false;
+}
+
+template <typename VecType>
+inline bool NativeInverseTransformFromBitReversePrunedInPlace(
+    const VecType &rootOfUnityInverseTable,
+    const NativeVector &preconRootOfUnityInverseTable,
+    const typename VecType::Integer &cycloOrderInv,
+    const NativeInteger &preconCycloOrderInv, usint stride, usint degree,
+    VecType *element) {
+  return false;
+}
+
+// checks the zero structure passed to the pruned transforms of size n
+inline void CheckPruning(usint n, usint stride, usint degree) {
+  if (!NativeNTTEngine::IsValidPruning(n, stride, degree)) {
+    PALISADE_THROW(math_error,
+                   "pruned transforms need a power-of-two stride dividing "
+                   "the ring dimension n and a degree bound in [1, n]");
+  }
+}
+
+// sets the coefficients outside of the zero structure of a pruned transform
+// to zero, so that the full transforms can stand in for the pruned ones
+template <typename VecType>
+inline void ZeroUnpruned(usint stride, usint degree, VecType *element) {
+  typename VecType::Integer zero(0);
+  for (usint i = 0; i < element->GetLength(); i++) {
+    if (i % stride != 0 || i >= degree) {
+      (*element)[i] = zero;
+    }
+  }
+}
+
+#if NATIVEINT == 64
+inline bool NativeForwardTransformToBitReverseInPlace(
+    const NativeVector &rootOfUnityTable, const NativeVector &preconRootOfUnityTable,
+    NativeVector *element) {
+  usint n = element->GetLength();
+  const NativeInteger &modulus = element->GetModulus();
+  if (n == 0 || modulus.GetMSB() > NativeNTTEngine::MAX_MODULUS_BITS) {
+    return false;
+  }
+  NativeNTTEngine::ForwardTransformToBitReverseInPlace(
+      reinterpret_cast<const uint64_t *>(&rootOfUnityTable[0]),
+      reinterpret_cast<const uint64_t *>(&preconRootOfUnityTable[0]),
+      modulus.ConvertToInt(), n, reinterpret_cast<uint64_t *>(&(*element)[0]));
+  return true;
+}
+
+inline bool NativeInverseTransformFromBitReverseInPlace(
+    const NativeVector &rootOfUnityInverseTable,
+    const NativeVector &preconRootOfUnityInverseTable,
+    const NativeInteger &cycloOrderInv,
+    const NativeInteger &preconCycloOrderInv, NativeVector *element) {
+  usint n = element->GetLength();
+  const NativeInteger &modulus = element->GetModulus();
+  if (n == 0 || modulus.GetMSB() > NativeNTTEngine::MAX_MODULUS_BITS) {
+    return false;
+  }
+  NativeNTTEngine::InverseTransformFromBitReverseInPlace(
+      reinterpret_cast<const uint64_t *>(&rootOfUnityInverseTable[0]),
+      reinterpret_cast<const uint64_t *>(&preconRootOfUnityInverseTable[0]),
+      cycloOrderInv.ConvertToInt(), preconCycloOrderInv.ConvertToInt(),
+      modulus.ConvertToInt(), n, reinterpret_cast<uint64_t *>(&(*element)[0]));
+  return true;
+}
+
+inline bool NativeForwardTransformToBitReversePrunedInPlace(
+    const NativeVector &rootOfUnityTable, const NativeVector &preconRootOfUnityTable,
+    usint stride, usint degree, NativeVector *element) {
+  usint n = element->GetLength();
+  const NativeInteger &modulus = element->GetModulus();
+  if (n == 0 || modulus.GetMSB() > NativeNTTEngine::MAX_MODULUS_BITS) {
+    return false;
+  }
+  NativeNTTEngine::ForwardTransformToBitReversePrunedInPlace(
+      reinterpret_cast<const uint64_t *>(&rootOfUnityTable[0]),
+      reinterpret_cast<const uint64_t *>(&preconRootOfUnityTable[0]),
+      modulus.ConvertToInt(), n, stride, degree,
+      reinterpret_cast<uint64_t *>(&(*element)[0]));
+  return true;
+}
+
+inline bool NativeInverseTransformFromBitReversePrunedInPlace(
+    const NativeVector &rootOfUnityInverseTable,
+    const NativeVector &preconRootOfUnityInverseTable,
+    const NativeInteger &cycloOrderInv,
+    const NativeInteger &preconCycloOrderInv, usint stride, usint degree,
+    NativeVector *element) {
+  usint n = element->GetLength();
+  const NativeInteger &modulus = element->GetModulus();
+  if (n == 0 || modulus.GetMSB() > NativeNTTEngine::MAX_MODULUS_BITS) {
+    return false;
+  }
+  NativeNTTEngine::InverseTransformFromBitReversePrunedInPlace(
+      reinterpret_cast<const uint64_t *>(&rootOfUnityInverseTable[0]),
+      reinterpret_cast<const uint64_t *>(&preconRootOfUnityInverseTable[0]),
+      cycloOrderInv.ConvertToInt(), preconCycloOrderInv.ConvertToInt(),
+      modulus.ConvertToInt(), n, stride, degree,
+      reinterpret_cast<uint64_t *>(&(*element)[0]));
+  return true;
+}
+#endif
+
 template <typename VecType>
 std::map<typename VecType::Integer, VecType>
     ChineseRemainderTransformFTT<VecType>::m_cycloOrderInverseTableByModulus;
@@ -64,18 +194,6 @@ template <typename VecType>
 std::mutex ChineseRemainderTransformFTT<VecType>::m_mtxIntelNTT;
 #endif
 
-template <typename VecType>
-std::map<typename VecType::Integer, VecType>
-    ChineseRemainderTransformArb<VecType>::m_cyclotomicPolyMap;
-
-template <typename VecType>
-std::map<typename VecType::Integer, VecType>
-    ChineseRemainderTransformArb<VecType>::m_cyclotomicPolyReverseNTTMap;
-
-template <typename VecType>
-std::map<typename VecType::Integer, VecType>
-    ChineseRemainderTransformArb<VecType>::m_cyclotomicPolyNTTMap;
-
 template <typename VecType>
 std::map<ModulusRoot<typename VecType::Integer>, VecType>
     BluesteinFFT<VecType>::m_rootOfUnityTableByModulusRoot;
@@ -97,23 +215,12 @@ std::map<typename VecType::Integer, ModulusRoot<typename VecType::Integer>>
     BluesteinFFT<VecType>::m_defaultNTTModulusRoot;
 
 template <typename VecType>
-std::map<typename VecType::Integer, VecType>
-    ChineseRemainderTransformArb<VecType>::m_rootOfUnityDivisionTableByModulus;
-
-template <typename VecType>
-std::map<typename VecType::Integer, VecType> ChineseRemainderTransformArb<
-    VecType>::m_rootOfUnityDivisionInverseTableByModulus;
+std::map<std::pair<usint, ModulusRootPair<typename VecType::Integer>>,
+         std::shared_ptr<const ArbNTTPlan<VecType>>>
+    ArbNTTPlan<VecType>::m_plans;
 
 template <typename VecType>
-std::map<typename VecType::Integer, typename VecType::Integer>
-    ChineseRemainderTransformArb<VecType>::m_DivisionNTTModulus;
-
-template <typename VecType>
-std::map<typename VecType::Integer, typename VecType::Integer>
-    ChineseRemainderTransformArb<VecType>::m_DivisionNTTRootOfUnity;
-
-template <typename VecType>
-std::map<usint, usint> ChineseRemainderTransformArb<VecType>::m_nttDivisionDim;
+std::mutex ArbNTTPlan<VecType>::m_plansMutex;
 
 template <typename VecType>
 void NumberTheoreticTransform<VecType>::ForwardTransformIterative(
@@ -298,6 +405,11 @@ template <typename VecType>
 void NumberTheoreticTransform<VecType>::ForwardTransformToBitReverseInPlace(
     const VecType &rootOfUnityTable, const NativeVector &preconRootOfUnityTable,
     VecType *element) {
+  if (NativeForwardTransformToBitReverseInPlace(
+          rootOfUnityTable, preconRootOfUnityTable, element)) {
+    return;
+  }
+
   usint n = element->GetLength();
   IntType modulus = element->GetModulus();
 
@@ -359,6 +471,11 @@ void NumberTheoreticTransform<VecType>::ForwardTransformToBitReverse(
     (*result)[i] = element[i];
   }
 
+  if (NativeForwardTransformToBitReverseInPlace(
+          rootOfUnityTable, preconRootOfUnityTable, result)) {
+    return;
+  }
+
   uint32_t indexOmega, indexHi;
   NativeInteger preconOmega;
   IntType omega, omegaFactor, loVal, hiVal, zero(0);
@@ -482,6 +599,12 @@ void NumberTheoreticTransform<VecType>::InverseTransformFromBitReverseInPlace(
     const NativeVector &preconRootOfUnityInverseTable,
     const IntType &cycloOrderInv, const NativeInteger &preconCycloOrderInv,
     VecType *element) {
+  if (NativeInverseTransformFromBitReverseInPlace(
+          rootOfUnityInverseTable, preconRootOfUnityInverseTable, cycloOrderInv,
+          preconCycloOrderInv, element)) {
+    return;
+  }
+
   usint n = element->GetLength();
 
   IntType modulus = element->GetModulus();
@@ -559,6 +682,41 @@ void NumberTheoreticTransform<VecType>::InverseTransformFromBitReverse(
   return;
 }
 
+template <typename VecType>
+void NumberTheoreticTransform<VecType>::
+    ForwardTransformToBitReversePrunedInPlace(
+        const VecType &rootOfUnityTable,
+        const NativeVector &preconRootOfUnityTable, usint stride, usint degree,
+        VecType *element) {
+  CheckPruning(element->GetLength(), stride, degree);
+  if (NativeForwardTransformToBitReversePrunedInPlace(
+          rootOfUnityTable, preconRootOfUnityTable, stride, degree, element)) {
+    return;
+  }
+  ZeroUnpruned(stride, degree, element);
+  ForwardTransformToBitReverseInPlace(rootOfUnityTable, preconRootOfUnityTable,
+                                      element);
+}
+
+template <typename VecType>
+void NumberTheoreticTransform<VecType>::
+    InverseTransformFromBitReversePrunedInPlace(
+        const VecType &rootOfUnityInverseTable,
+        const NativeVector &preconRootOfUnityInverseTable,
+        const IntType &cycloOrderInv, const NativeInteger &preconCycloOrderInv,
+        usint stride, usint degree, VecType *element) {
+  CheckPruning(element->GetLength(), stride, degree);
+  if (NativeInverseTransformFromBitReversePrunedInPlace(
+          rootOfUnityInverseTable, preconRootOfUnityInverseTable, cycloOrderInv,
+          preconCycloOrderInv, stride, degree, element)) {
+    return;
+  }
+  InverseTransformFromBitReverseInPlace(
+      rootOfUnityInverseTable, preconRootOfUnityInverseTable, cycloOrderInv,
+      preconCycloOrderInv, element);
+  ZeroUnpruned(stride, degree, element);
+}
+
 template <typename VecType>
 void ChineseRemainderTransformFTT<VecType>::ForwardTransformToBitReverseInPlace(
     const IntType &rootOfUnity, const usint CycloOrder, VecType *element) {
@@ -765,6 +923,94 @@ void ChineseRemainderTransformFTT<
   }
 }
 
+template <typename VecType>
+void ChineseRemainderTransformFTT<VecType>::
+    ForwardTransformToBitReversePrunedInPlace(const IntType &rootOfUnity,
+                                              const usint CycloOrder,
+                                              usint stride, usint degree,
+                                              VecType *element) {
+  if (rootOfUnity == IntType(1) || rootOfUnity == IntType(0)) {
+    return;
+  }
+
+  if (!IsPowerOfTwo(CycloOrder)) {
+    PALISADE_THROW(math_error, "CyclotomicOrder is not a power of two");
+  }
+
+  usint CycloOrderHf = (CycloOrder >> 1);
+  if (element->GetLength() != CycloOrderHf) {
+    PALISADE_THROW(math_error,
+                   "element size must be equal to CyclotomicOrder / 2");
+  }
+  CheckPruning(CycloOrderHf, stride, degree);
+
+  IntType modulus = element->GetModulus();
+
+  auto mapSearch = m_rootOfUnityReverseTableByModulus.find(modulus);
+  if (mapSearch == m_rootOfUnityReverseTableByModulus.end() ||
+      mapSearch->second.GetLength() != CycloOrderHf) {
+    PreCompute(rootOfUnity, CycloOrder, modulus);
+  }
+
+  if (typeid(IntType) == typeid(NativeInteger)) {
+    NumberTheoreticTransform<VecType>::
+        ForwardTransformToBitReversePrunedInPlace(
+            m_rootOfUnityReverseTableByModulus[modulus],
+            m_rootOfUnityPreconReverseTableByModulus[modulus], stride, degree,
+            element);
+  } else {
+    ZeroUnpruned(stride, degree, element);
+    NumberTheoreticTransform<VecType>::ForwardTransformToBitReverseInPlace(
+        m_rootOfUnityReverseTableByModulus[modulus], element);
+  }
+}
+
+template <typename VecType>
+void ChineseRemainderTransformFTT<VecType>::
+    InverseTransformFromBitReversePrunedInPlace(const IntType &rootOfUnity,
+                                                const usint CycloOrder,
+                                                usint stride, usint degree,
+                                                VecType *element) {
+  if (rootOfUnity == IntType(1) || rootOfUnity == IntType(0)) {
+    return;
+  }
+
+  if (!IsPowerOfTwo(CycloOrder)) {
+    PALISADE_THROW(math_error, "CyclotomicOrder is not a power of two");
+  }
+
+  usint CycloOrderHf = (CycloOrder >> 1);
+  if (element->GetLength() != CycloOrderHf) {
+    PALISADE_THROW(math_error,
+                   "element size must be equal to CyclotomicOrder / 2");
+  }
+  CheckPruning(CycloOrderHf, stride, degree);
+
+  IntType modulus = element->GetModulus();
+
+  auto mapSearch = m_rootOfUnityReverseTableByModulus.find(modulus);
+  if (mapSearch == m_rootOfUnityReverseTableByModulus.end() ||
+      mapSearch->second.GetLength() != CycloOrderHf) {
+    PreCompute(rootOfUnity, CycloOrder, modulus);
+  }
+
+  usint msb = GetMSB64(CycloOrderHf - 1);
+  if (typeid(IntType) == typeid(NativeInteger)) {
+    NumberTheoreticTransform<VecType>::
+        InverseTransformFromBitReversePrunedInPlace(
+            m_rootOfUnityInverseReverseTableByModulus[modulus],
+            m_rootOfUnityInversePreconReverseTableByModulus[modulus],
+            m_cycloOrderInverseTableByModulus[modulus][msb],
+            m_cycloOrderInversePreconTableByModulus[modulus][msb], stride,
+            degree, element);
+  } else {
+    NumberTheoreticTransform<VecType>::InverseTransformFromBitReverseInPlace(
+        m_rootOfUnityInverseReverseTableByModulus[modulus],
+        m_cycloOrderInverseTableByModulus[modulus][msb], element);
+    ZeroUnpruned(stride, degree, element);
+  }
+}
+
 template <typename VecType>
 void ChineseRemainderTransformFTT<VecType>::InverseTransformFromBitReverse(
     const VecType &element, const IntType &rootOfUnity, const usint CycloOrder,
@@ -1128,97 +1374,331 @@ void BluesteinFFT<VecType>::Reset() {
   m_defaultNTTModulusRoot.clear();
 }
 
+
+
+// the powers 1, root, ..., root^{size-1} modulo modulus
 template <typename VecType>
-void ChineseRemainderTransformArb<VecType>::SetCylotomicPolynomial(
-    const VecType &poly, const IntType &mod) {
-  m_cyclotomicPolyMap[mod] = poly;
+VecType RootPowersTable(const typename VecType::Integer &root, usint size,
+                        const typename VecType::Integer &modulus) {
+  VecType table(size, modulus);
+  typename VecType::Integer x(1);
+  for (usint i = 0; i < size; i++) {
+    table[i] = x;
+    x = x.ModMul(root, modulus);
+  }
+  return table;
 }
 
 template <typename VecType>
-void ChineseRemainderTransformArb<VecType>::PreCompute(const usint cyclotoOrder,
-                                                       const IntType &modulus) {
-  BluesteinFFT<VecType>::PreComputeDefaultNTTModulusRoot(cyclotoOrder, modulus);
+ArbNTTPlan<VecType>::ArbNTTPlan(usint cycloOrder, const IntType &modulus,
+                                const IntType &rootOfUnity,
+                                const IntType &nttModulus,
+                                const IntType &nttRootOfUnity)
+    : m_cycloOrder(cycloOrder),
+      m_modulus(modulus),
+      m_rootOfUnity(rootOfUnity),
+      m_nttModulus(nttModulus),
+      m_nttRootOfUnity(nttRootOfUnity),
+      m_divisionDim(0) {
+  if (cycloOrder < 2) {
+    PALISADE_THROW(math_error, "ArbNTTPlan requires a cyclotomic order >= 2");
+  }
+  m_nttDim = pow(2, ceil(log2(2 * cycloOrder - 1)));
+  const usint nttDimHf = m_nttDim >> 1;
+  m_nttRootTable =
+      RootPowersTable<VecType>(nttRootOfUnity, nttDimHf, nttModulus);
+  m_nttRootInverseTable = RootPowersTable<VecType>(
+      nttRootOfUnity.ModInverse(nttModulus), nttDimHf, nttModulus);
+
+  // Bluestein tables, as in BluesteinFFT::PreComputePowers() and
+  // BluesteinFFT::PreComputeRBTable()
+  const IntType rootInverse = rootOfUnity.ModInverse(modulus);
+  for (int direction = 0; direction < 2; direction++) {
+    const IntType &root = (direction == 0) ? rootOfUnity : rootInverse;
+    const IntType &rootInv = (direction == 0) ? rootInverse : rootOfUnity;
+
+    VecType powers(cycloOrder, modulus);
+    VecType b(2 * cycloOrder - 1, modulus);
+    powers[0] = 1;
+    b[cycloOrder - 1] = 1;
+    for (usint i = 1; i < cycloOrder; i++) {
+      IntType iSqr((uint64_t(i) * i) % (2 * cycloOrder));
+      powers[i] = root.ModExp(iSqr, modulus);
+      b[cycloOrder - 1 + i] = rootInv.ModExp(iSqr, modulus);
+      b[cycloOrder - 1 - i] = b[cycloOrder - 1 + i];
+    }
+
+    auto Rb = BluesteinFFT<VecType>::PadZeros(b, m_nttDim);
+    Rb.SetModulus(nttModulus);
+    VecType RB(m_nttDim);
+    NumberTheoreticTransform<VecType>::ForwardTransformIterative(
+        Rb, m_nttRootTable, &RB);
+
+    if (direction == 0) {
+      m_powers = std::move(powers);
+      m_RB = std::move(RB);
+    } else {
+      m_powersInverse = std::move(powers);
+      m_RBInverse = std::move(RB);
+    }
+  }
+
+  m_cycloOrderInverse = IntType(cycloOrder).ModInverse(modulus);
+  m_totientList = GetTotientList(cycloOrder);
+
+  // For prime m and twice a prime m, Reduce() needs no tables. Otherwise the
+  // quotient by Phi_m(X) is computed with NTTs of dimension m_divisionDim,
+  // using the inverse of the reversed Phi_m(X) modulo X^{m - phi(m)}.
+  const usint n = m_totientList.size();
+  if ((n + 1) == cycloOrder || (n + 1) * 2 == cycloOrder) {
+    return;
+  }
+  const usint power = cycloOrder - n;
+  m_divisionDim = 2 * std::pow(2, ceil(log2(power)));
+  const IntType divisionRoot =
+      nttRootOfUnity.ModExp(IntType(m_nttDim / m_divisionDim), nttModulus);
+  m_divisionRootTable =
+      RootPowersTable<VecType>(divisionRoot, m_divisionDim >> 1, nttModulus);
+  m_divisionRootInverseTable = RootPowersTable<VecType>(
+      divisionRoot.ModInverse(nttModulus), m_divisionDim >> 1, nttModulus);
+
+  const auto cycloPoly = GetCyclotomicPolynomial<VecType>(cycloOrder, modulus);
+
+  auto RevCPMPadded = BluesteinFFT<VecType>::PadZeros(
+      ChineseRemainderTransformArb<VecType>::InversePolyMod(cycloPoly, modulus,
+                                                            power),
+      m_divisionDim);
+  RevCPMPadded.SetModulus(nttModulus);
+  m_cyclotomicPolyReverseNTT = VecType(m_divisionDim);
+  NumberTheoreticTransform<VecType>::ForwardTransformIterative(
+      RevCPMPadded, m_divisionRootTable, &m_cyclotomicPolyReverseNTT);
+
+  VecType cycloPolyPadded(m_divisionDim, nttModulus);
+  for (usint i = 0; i < cycloPoly.GetLength(); i++) {
+    cycloPolyPadded[i] = cycloPoly[i];
+  }
+  m_cyclotomicPolyNTT = VecType(m_divisionDim);
+  NumberTheoreticTransform<VecType>::ForwardTransformIterative(
+      cycloPolyPadded, m_divisionRootTable, &m_cyclotomicPolyNTT);
 }
 
 template <typename VecType>
-void ChineseRemainderTransformArb<VecType>::SetPreComputedNTTModulus(
-    usint cyclotoOrder, const IntType &modulus, const IntType &nttModulus,
-    const IntType &nttRoot) {
-  const ModulusRoot<IntType> nttModulusRoot = {nttModulus, nttRoot};
-  BluesteinFFT<VecType>::PreComputeRootTableForNTT(cyclotoOrder,
-                                                   nttModulusRoot);
+std::shared_ptr<const ArbNTTPlan<VecType>> ArbNTTPlan<VecType>::Get(
+    usint cycloOrder, const IntType &modulus, const IntType &rootOfUnity,
+    const IntType &nttModulus, const IntType &nttRootOfUnity) {
+  const std::pair<usint, ModulusRootPair<IntType>> key = {
+      cycloOrder, {{modulus, rootOfUnity}, {nttModulus, nttRootOfUnity}}};
+  {
+    std::lock_guard<std::mutex> lock(m_plansMutex);
+    auto it = m_plans.find(key);
+    if (it != m_plans.end()) return it->second;
+  }
+
+  // the tables are built without holding the lock; if another thread built
+  // the same plan meanwhile, its plan is kept
+  auto built = std::make_shared<const ArbNTTPlan>(
+      cycloOrder, modulus, rootOfUnity, nttModulus, nttRootOfUnity);
+  std::lock_guard<std::mutex> lock(m_plansMutex);
+  auto &plan = m_plans[key];
+  if (plan == nullptr) plan = std::move(built);
+  return plan;
 }
 
 template <typename VecType>
-void ChineseRemainderTransformArb<VecType>::SetPreComputedNTTDivisionModulus(
-    usint cyclotoOrder, const IntType &modulus, const IntType &nttMod,
-    const IntType &nttRootBig) {
-  DEBUG_FLAG(false);
+void ArbNTTPlan<VecType>::Register(std::shared_ptr<const ArbNTTPlan> plan) {
+  if (plan == nullptr || plan->m_cycloOrder == 0) {
+    PALISADE_THROW(math_error, "cannot register an empty ArbNTTPlan");
+  }
+  const std::pair<usint, ModulusRootPair<IntType>> key = {
+      plan->m_cycloOrder,
+      {{plan->m_modulus, plan->m_rootOfUnity},
+       {plan->m_nttModulus, plan->m_nttRootOfUnity}}};
+  std::lock_guard<std::mutex> lock(m_plansMutex);
+  m_plans[key] = std::move(plan);
+}
 
-  usint n = GetTotient(cyclotoOrder);
-  DEBUG("GetTotient(" << cyclotoOrder << ")= " << n);
+template <typename VecType>
+void ArbNTTPlan<VecType>::Reset() {
+  std::lock_guard<std::mutex> lock(m_plansMutex);
+  m_plans.clear();
+}
 
-  usint power = cyclotoOrder - n;
-  m_nttDivisionDim[cyclotoOrder] = 2 * std::pow(2, ceil(log2(power)));
+template <typename VecType>
+bool ArbNTTPlan<VecType>::operator==(const ArbNTTPlan &other) const {
+  return m_cycloOrder == other.m_cycloOrder && m_modulus == other.m_modulus &&
+         m_rootOfUnity == other.m_rootOfUnity &&
+         m_nttModulus == other.m_nttModulus &&
+         m_nttRootOfUnity == other.m_nttRootOfUnity &&
+         m_nttDim == other.m_nttDim &&
+         m_nttRootTable == other.m_nttRootTable &&
+         m_nttRootInverseTable == other.m_nttRootInverseTable &&
+         m_powers == other.m_powers &&
+         m_powersInverse == other.m_powersInverse && m_RB == other.m_RB &&
+         m_RBInverse == other.m_RBInverse &&
+         m_cycloOrderInverse == other.m_cycloOrderInverse &&
+         m_totientList == other.m_totientList &&
+         m_divisionDim == other.m_divisionDim &&
+         m_divisionRootTable == other.m_divisionRootTable &&
+         m_divisionRootInverseTable == other.m_divisionRootInverseTable &&
+         m_cyclotomicPolyNTT == other.m_cyclotomicPolyNTT &&
+         m_cyclotomicPolyReverseNTT == other.m_cyclotomicPolyReverseNTT;
+}
 
-  usint nttDimBig = std::pow(2, ceil(log2(2 * cyclotoOrder - 1)));
+template <typename VecType>
+VecType ArbNTTPlan<VecType>::Bluestein(const VecType &element,
+                                       const VecType &powers,
+                                       const VecType &RB) const {
+  VecType x = element.ModMul(powers);
 
-  // Computes the root of unity for the division NTT based on the root of unity
-  // for regular NTT
-  IntType nttRoot = nttRootBig.ModExp(
-      IntType(nttDimBig / m_nttDivisionDim[cyclotoOrder]), nttMod);
+  auto Ra = BluesteinFFT<VecType>::PadZeros(x, m_nttDim);
+  Ra.SetModulus(m_nttModulus);
+  VecType RA(m_nttDim);
+  NumberTheoreticTransform<VecType>::ForwardTransformIterative(
+      Ra, m_nttRootTable, &RA);
 
-  m_DivisionNTTModulus[modulus] = nttMod;
-  m_DivisionNTTRootOfUnity[modulus] = nttRoot;
-  // part0 setting of rootTable and inverse rootTable
-  usint nttDim = m_nttDivisionDim[cyclotoOrder];
-  IntType root(nttRoot);
-  auto rootInv = root.ModInverse(nttMod);
+  auto RC = RA.ModMul(RB);
+  VecType Rc(m_nttDim);
+  NumberTheoreticTransform<VecType>::InverseTransformIterative(
+      RC, m_nttRootInverseTable, &Rc);
+  auto resizeRc = BluesteinFFT<VecType>::Resize(Rc, m_cycloOrder - 1,
+                                                2 * (m_cycloOrder - 1));
+  resizeRc.SetModulus(m_modulus);
+  resizeRc.ModEq(m_modulus);
+  return resizeRc.ModMul(powers);
+}
 
-  usint nttDimHf = (nttDim >> 1);
-  VecType rootTable(nttDimHf, nttMod);
-  VecType rootTableInverse(nttDimHf, nttMod);
+template <typename VecType>
+VecType ArbNTTPlan<VecType>::Reduce(const VecType &element) const {
+  const usint n = m_totientList.size();
+  VecType output(n, m_modulus);
+  IntType mu = m_modulus.ComputeMu();  // Precompute the Barrett mu parameter
+
+  if ((n + 1) == m_cycloOrder) {
+    // cycloOrder is prime: Reduce mod Phi_{n+1}(x)
+    // Reduction involves subtracting the coeff of x^n from all terms
+    auto coeff_n = element[n];
+    for (usint i = 0; i < n; i++) {
+      output[i] = element[i].ModSub(coeff_n, m_modulus, mu);
+    }
+  } else if ((n + 1) * 2 == m_cycloOrder) {
+    // cycloOrder is 2*prime: 2 Step reduction
+    // First reduce mod x^(n+1)+1 (=(x+1)*Phi_{2*(n+1)}(x))
+    // Subtract co-efficient of x^(i+n+1) from x^(i)
+    for (usint i = 0; i < n; i++) {
+      auto coeff_i = element[i];
+      auto coeff_ip = element[i + n + 1];
+      output[i] = coeff_i.ModSub(coeff_ip, m_modulus, mu);
+    }
+    auto coeff_n = element[n].ModSub(element[2 * n + 1], m_modulus, mu);
+    // Now reduce mod Phi_{2*(n+1)}(x)
+    // Similar to the prime case but with alternating signs
+    for (usint i = 0; i < n; i++) {
+      if (i % 2 == 0) {
+        output[i].ModSubEq(coeff_n, m_modulus, mu);
+      } else {
+        output[i].ModAddEq(coeff_n, m_modulus, mu);
+      }
+    }
+  } else {
+    // cycloOrder is arbitrary: compute the quotient by Phi_m(x) from the
+    // reversed high part of the element, then subtract quotient * Phi_m(x)
+    VecType aPadded2(m_divisionDim, m_nttModulus);
+    usint power = m_cycloOrder - n;
+    for (usint i = n; i < element.GetLength(); i++) {
+      aPadded2[power - (i - n) - 1] = element[i];
+    }
+    VecType A(m_divisionDim);
+    NumberTheoreticTransform<VecType>::ForwardTransformIterative(
+        aPadded2, m_divisionRootTable, &A);
+    auto AB = A * m_cyclotomicPolyReverseNTT;
+    VecType a(m_divisionDim);
+    NumberTheoreticTransform<VecType>::InverseTransformIterative(
+        AB, m_divisionRootInverseTable, &a);
+
+    VecType quotient(m_divisionDim, m_modulus);
+    for (usint i = 0; i < power; i++) {
+      quotient[i] = a[i];
+    }
+    quotient.ModEq(m_modulus);
+    quotient.SetModulus(m_nttModulus);
 
-  IntType x(1);
-  for (usint i = 0; i < nttDimHf; i++) {
-    rootTable[i] = x;
-    x = x.ModMul(root, nttMod);
-  }
+    VecType newQuotient(m_divisionDim);
+    NumberTheoreticTransform<VecType>::ForwardTransformIterative(
+        quotient, m_divisionRootTable, &newQuotient);
+    newQuotient *= m_cyclotomicPolyNTT;
 
-  x = 1;
-  for (usint i = 0; i < nttDimHf; i++) {
-    rootTableInverse[i] = x;
-    x = x.ModMul(rootInv, nttMod);
+    VecType newQuotient2(m_divisionDim);
+    NumberTheoreticTransform<VecType>::InverseTransformIterative(
+        newQuotient, m_divisionRootInverseTable, &newQuotient2);
+    newQuotient2.SetModulus(m_modulus);
+    newQuotient2.ModEq(m_modulus);
+
+    for (usint i = 0; i < n; i++) {
+      output[i] = element[i].ModSub(newQuotient2[m_cycloOrder - 1 - i],
+                                    m_modulus, mu);
+    }
   }
+  return output;
+}
 
-  m_rootOfUnityDivisionTableByModulus[nttMod] = rootTable;
-  m_rootOfUnityDivisionInverseTableByModulus[nttMod] = rootTableInverse;
+template <typename VecType>
+VecType ArbNTTPlan<VecType>::ForwardTransform(const VecType &element) const {
+  const usint n = m_totientList.size();
+  if (element.GetLength() != n || element.GetModulus() != m_modulus) {
+    PALISADE_THROW(math_error,
+                   "element size should be equal to phim, and its modulus to "
+                   "the modulus of the plan");
+  }
 
-  // end of part0
-  // part1
-  const auto &RevCPM =
-      InversePolyMod(m_cyclotomicPolyMap[modulus], modulus, power);
-  auto RevCPMPadded = BluesteinFFT<VecType>::PadZeros(RevCPM, nttDim);
-  RevCPMPadded.SetModulus(nttMod);
-  // end of part1
+  VecType inputToBluestein(m_cycloOrder, m_modulus);
+  for (usint i = 0; i < n; i++) {
+    inputToBluestein[i] = element[i];
+  }
+  auto outputBluestein = Bluestein(inputToBluestein, m_powers, m_RB);
 
-  VecType RA(nttDim);
-  NumberTheoreticTransform<VecType>::ForwardTransformIterative(RevCPMPadded,
-                                                               rootTable, &RA);
-  m_cyclotomicPolyReverseNTTMap[modulus] = RA;
+  VecType output(n, m_modulus);
+  for (usint i = 0; i < n; i++) {
+    output[i] = outputBluestein[m_totientList[i]];
+  }
+  return output;
+}
 
-  const auto &cycloPoly = m_cyclotomicPolyMap[modulus];
+template <typename VecType>
+VecType ArbNTTPlan<VecType>::InverseTransform(const VecType &element) const {
+  const usint n = m_totientList.size();
+  if (element.GetLength() != n || element.GetModulus() != m_modulus) {
+    PALISADE_THROW(math_error,
+                   "element size should be equal to phim, and its modulus to "
+                   "the modulus of the plan");
+  }
 
-  VecType QForwardTransform(nttDim, nttMod);
-  for (usint i = 0; i < cycloPoly.GetLength(); i++) {
-    QForwardTransform[i] = cycloPoly[i];
+  VecType inputToBluestein(m_cycloOrder, m_modulus);
+  for (usint i = 0; i < n; i++) {
+    inputToBluestein[m_totientList[i]] = element[i];
   }
+  auto outputBluestein =
+      Bluestein(inputToBluestein, m_powersInverse, m_RBInverse);
+  outputBluestein = outputBluestein * m_cycloOrderInverse;
+  return Reduce(outputBluestein);
+}
 
-  VecType QFwdResult(nttDim);
-  NumberTheoreticTransform<VecType>::ForwardTransformIterative(
-      QForwardTransform, rootTable, &QFwdResult);
+template <typename VecType>
+void ChineseRemainderTransformArb<VecType>::SetCylotomicPolynomial(
+    const VecType &poly, const IntType &mod) {}
+
+template <typename VecType>
+void ChineseRemainderTransformArb<VecType>::PreCompute(const usint cyclotoOrder,
+                                                       const IntType &modulus) {
+  BluesteinFFT<VecType>::PreComputeDefaultNTTModulusRoot(cyclotoOrder, modulus);
+}
 
-  m_cyclotomicPolyNTTMap[modulus] = QFwdResult;
+template <typename VecType>
+void ChineseRemainderTransformArb<VecType>::SetPreComputedNTTModulus(
+    usint cyclotoOrder, const IntType &modulus, const IntType &nttModulus,
+    const IntType &nttRoot) {
+  const ModulusRoot<IntType> nttModulusRoot = {nttModulus, nttRoot};
+  BluesteinFFT<VecType>::PreComputeRootTableForNTT(cyclotoOrder,
+                                                   nttModulusRoot);
 }
 
 template <typename VecType>
@@ -1266,39 +1746,9 @@ VecType ChineseRemainderTransformArb<VecType>::ForwardTransform(
   if (element.GetLength() != phim) {
     PALISADE_THROW(math_error, "element size should be equal to phim");
   }
-
-  const auto &modulus = element.GetModulus();
-  const ModulusRoot<IntType> modulusRoot = {modulus, root};
-
-  const ModulusRoot<IntType> nttModulusRoot = {nttModulus, nttRoot};
-  const ModulusRootPair<IntType> modulusRootPair = {modulusRoot,
-                                                    nttModulusRoot};
-
-#pragma omp critical
-  {
-    if (BluesteinFFT<VecType>::m_rootOfUnityTableByModulusRoot[nttModulusRoot]
-            .GetLength() == 0) {
-      BluesteinFFT<VecType>::PreComputeRootTableForNTT(cycloOrder,
-                                                       nttModulusRoot);
-    }
-
-    if (BluesteinFFT<VecType>::m_powersTableByModulusRoot[modulusRoot]
-            .GetLength() == 0) {
-      BluesteinFFT<VecType>::PreComputePowers(cycloOrder, modulusRoot);
-    }
-
-    if (BluesteinFFT<VecType>::m_RBTableByModulusRootPair[modulusRootPair]
-            .GetLength() == 0) {
-      BluesteinFFT<VecType>::PreComputeRBTable(cycloOrder, modulusRootPair);
-    }
-  }
-
-  VecType inputToBluestein = Pad(element, cycloOrder, true);
-  auto outputBluestein = BluesteinFFT<VecType>::ForwardTransform(
-      inputToBluestein, root, cycloOrder, nttModulusRoot);
-  VecType output = Drop(outputBluestein, cycloOrder, true, nttModulus, nttRoot);
-
-  return output;
+  return ArbNTTPlan<VecType>::Get(cycloOrder, element.GetModulus(), root,
+                                  nttModulus, nttRoot)
+      ->ForwardTransform(element);
 }
 
 template <typename VecType>
@@ -1309,180 +1759,14 @@ VecType ChineseRemainderTransformArb<VecType>::InverseTransform(
   if (element.GetLength() != phim) {
     PALISADE_THROW(math_error, "element size should be equal to phim");
   }
-
-  const auto &modulus = element.GetModulus();
-  auto rootInverse(root.ModInverse(modulus));
-  const ModulusRoot<IntType> modulusRootInverse = {modulus, rootInverse};
-
-  const ModulusRoot<IntType> nttModulusRoot = {nttModulus, nttRoot};
-  const ModulusRootPair<IntType> modulusRootPair = {modulusRootInverse,
-                                                    nttModulusRoot};
-
-#pragma omp critical
-  {
-    if (BluesteinFFT<VecType>::m_rootOfUnityTableByModulusRoot[nttModulusRoot]
-            .GetLength() == 0) {
-      BluesteinFFT<VecType>::PreComputeRootTableForNTT(cycloOrder,
-                                                       nttModulusRoot);
-    }
-
-    if (BluesteinFFT<VecType>::m_powersTableByModulusRoot[modulusRootInverse]
-            .GetLength() == 0) {
-      BluesteinFFT<VecType>::PreComputePowers(cycloOrder, modulusRootInverse);
-    }
-
-    if (BluesteinFFT<VecType>::m_RBTableByModulusRootPair[modulusRootPair]
-            .GetLength() == 0) {
-      BluesteinFFT<VecType>::PreComputeRBTable(cycloOrder, modulusRootPair);
-    }
-  }
-  VecType inputToBluestein = Pad(element, cycloOrder, false);
-  auto outputBluestein = BluesteinFFT<VecType>::ForwardTransform(
-      inputToBluestein, rootInverse, cycloOrder, nttModulusRoot);
-  auto cyclotomicInverse((IntType(cycloOrder)).ModInverse(modulus));
-  outputBluestein = outputBluestein * cyclotomicInverse;
-  VecType output =
-      Drop(outputBluestein, cycloOrder, false, nttModulus, nttRoot);
-  return output;
-}
-
-template <typename VecType>
-VecType ChineseRemainderTransformArb<VecType>::Pad(const VecType &element,
-                                                   const usint cycloOrder,
-                                                   bool forward) {
-  usint n = GetTotient(cycloOrder);
-
-  const auto &modulus = element.GetModulus();
-  VecType inputToBluestein(cycloOrder, modulus);
-
-  if (forward) {  // Forward transform padding
-    for (usint i = 0; i < n; i++) {
-      inputToBluestein[i] = element[i];
-    }
-  } else {  // Inverse transform padding
-    auto tList = GetTotientList(cycloOrder);
-    usint i = 0;
-    for (auto &coprime : tList) {
-      inputToBluestein[coprime] = element[i++];
-    }
-  }
-
-  return inputToBluestein;
-}
-
-template <typename VecType>
-VecType ChineseRemainderTransformArb<VecType>::Drop(const VecType &element,
-                                                    const usint cycloOrder,
-                                                    bool forward,
-                                                    const IntType &bigMod,
-                                                    const IntType &bigRoot) {
-  usint n = GetTotient(cycloOrder);
-
-  const auto &modulus = element.GetModulus();
-  VecType output(n, modulus);
-
-  if (forward) {  // Forward transform drop
-    auto tList = GetTotientList(cycloOrder);
-    for (usint i = 0; i < n; i++) {
-      output[i] = element[tList[i]];
-    }
-  } else {  // Inverse transform drop
-    if ((n + 1) == cycloOrder) {
-      IntType mu = modulus.ComputeMu();  // Precompute the Barrett mu parameter
-      // cycloOrder is prime: Reduce mod Phi_{n+1}(x)
-      // Reduction involves subtracting the coeff of x^n from all terms
-      auto coeff_n = element[n];
-      for (usint i = 0; i < n; i++) {
-        output[i] = element[i].ModSub(coeff_n, modulus, mu);
-      }
-    } else if ((n + 1) * 2 == cycloOrder) {
-      IntType mu = modulus.ComputeMu();  // Precompute the Barrett mu parameter
-      // cycloOrder is 2*prime: 2 Step reduction
-      // First reduce mod x^(n+1)+1 (=(x+1)*Phi_{2*(n+1)}(x))
-      // Subtract co-efficient of x^(i+n+1) from x^(i)
-      for (usint i = 0; i < n; i++) {
-        auto coeff_i = element[i];
-        auto coeff_ip = element[i + n + 1];
-        output[i] = coeff_i.ModSub(coeff_ip, modulus, mu);
-      }
-      auto coeff_n = element[n].ModSub(element[2 * n + 1], modulus, mu);
-      // Now reduce mod Phi_{2*(n+1)}(x)
-      // Similar to the prime case but with alternating signs
-      for (usint i = 0; i < n; i++) {
-        if (i % 2 == 0) {
-          output[i].ModSubEq(coeff_n, modulus, mu);
-        } else {
-          output[i].ModAddEq(coeff_n, modulus, mu);
-        }
-      }
-    } else {
-      // precompute root of unity tables for division NTT
-      if ((m_rootOfUnityDivisionTableByModulus[bigMod].GetLength() == 0) ||
-          (m_DivisionNTTModulus[modulus] != bigMod)) {
-        SetPreComputedNTTDivisionModulus(cycloOrder, modulus, bigMod, bigRoot);
-      }
-
-      // cycloOrder is arbitrary
-      // auto output = PolyMod(element, this->m_cyclotomicPolyMap[modulus],
-      // modulus);
-
-      const auto &nttMod = m_DivisionNTTModulus[modulus];
-      const auto &rootTable = m_rootOfUnityDivisionTableByModulus[nttMod];
-      VecType aPadded2(m_nttDivisionDim[cycloOrder], nttMod);
-      // perform mod operation
-      usint power = cycloOrder - n;
-      for (usint i = n; i < element.GetLength(); i++) {
-        aPadded2[power - (i - n) - 1] = element[i];
-      }
-      VecType A(m_nttDivisionDim[cycloOrder]);
-      NumberTheoreticTransform<VecType>::ForwardTransformIterative(
-          aPadded2, rootTable, &A);
-      auto AB = A * m_cyclotomicPolyReverseNTTMap[modulus];
-      const auto &rootTableInverse =
-          m_rootOfUnityDivisionInverseTableByModulus[nttMod];
-      VecType a(m_nttDivisionDim[cycloOrder]);
-      NumberTheoreticTransform<VecType>::InverseTransformIterative(
-          AB, rootTableInverse, &a);
-
-      VecType quotient(m_nttDivisionDim[cycloOrder], modulus);
-      for (usint i = 0; i < power; i++) {
-        quotient[i] = a[i];
-      }
-      quotient.ModEq(modulus);
-      quotient.SetModulus(nttMod);
-
-      VecType newQuotient(m_nttDivisionDim[cycloOrder]);
-      NumberTheoreticTransform<VecType>::ForwardTransformIterative(
-          quotient, rootTable, &newQuotient);
-      newQuotient *= m_cyclotomicPolyNTTMap[modulus];
-
-      VecType newQuotient2(m_nttDivisionDim[cycloOrder]);
-      NumberTheoreticTransform<VecType>::InverseTransformIterative(
-          newQuotient, rootTableInverse, &newQuotient2);
-      newQuotient2.SetModulus(modulus);
-      newQuotient2.ModEq(modulus);
-
-      IntType mu = modulus.ComputeMu();  // Precompute the Barrett mu parameter
-
-      for (usint i = 0; i < n; i++) {
-        output[i] =
-            element[i].ModSub(newQuotient2[cycloOrder - 1 - i], modulus, mu);
-      }
-    }
-  }
-  return output;
+  return ArbNTTPlan<VecType>::Get(cycloOrder, element.GetModulus(), root,
+                                  nttModulus, nttRoot)
+      ->InverseTransform(element);
 }
 
 template <typename VecType>
 void ChineseRemainderTransformArb<VecType>::Reset() {
-  m_cyclotomicPolyMap.clear();
-  m_cyclotomicPolyReverseNTTMap.clear();
-  m_cyclotomicPolyNTTMap.clear();
-  m_rootOfUnityDivisionTableByModulus.clear();
-  m_rootOfUnityDivisionInverseTableByModulus.clear();
-  m_DivisionNTTModulus.clear();
-  m_DivisionNTTRootOfUnity.clear();
-  m_nttDivisionDim.clear();
+  ArbNTTPlan<VecType>::Reset();
   BluesteinFFT<VecType>::Reset();
 }
 
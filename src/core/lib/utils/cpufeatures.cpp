@@ -0,0 +1,100 @@
+// @file cpufeatures.cpp Runtime selection of the vectorized native kernels
+// @author TPOC: contact@palisade-crypto.org
+//
+// @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+// All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution. THIS SOFTWARE IS
+// PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+// EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/cpufeatures.h"
+
+#include <atomic>
+#include <sstream>
+
+#include "config_core.h"
+#include "utils/exception.h"
+
+namespace lbcrypto {
+
+namespace {
+
+SIMDEngine DetectBestEngine() {
+#ifdef PALISADE_SIMD_X86
+  __builtin_cpu_init();
+#ifdef WITH_NATIVE_IFMA
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+      __builtin_cpu_supports("avx512ifma")) {
+    return SIMD_AVX512IFMA;
+  }
+#endif
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+    return SIMD_AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SIMD_AVX2;
+  }
+#endif
+  return SIMD_PORTABLE;
+}
+
+// SIMD_AUTO until the engine is first queried or set
+std::atomic<int> currentEngine(SIMD_AUTO);
+
+}  // namespace
+
+bool SIMDControls::IsSupported(SIMDEngine engine) {
+  switch (engine) {
+    case SIMD_AUTO:
+    case SIMD_PORTABLE:
+      return true;
+    case SIMD_AVX2:
+      return GetBestEngine() >= SIMD_AVX2;
+    case SIMD_AVX512:
+      return GetBestEngine() >= SIMD_AVX512;
+    case SIMD_AVX512IFMA:
+      return GetBestEngine() >= SIMD_AVX512IFMA;
+    default:
+      return false;
+  }
+}
+
+SIMDEngine SIMDControls::GetBestEngine() {
+  static const SIMDEngine best = DetectBestEngine();
+  return best;
+}
+
+SIMDEngine SIMDControls::GetEngine() {
+  int engine = currentEngine.load(std::memory_order_relaxed);
+  if (engine == SIMD_AUTO) {
+    engine = GetBestEngine();
+    currentEngine.store(engine, std::memory_order_relaxed);
+  }
+  return static_cast<SIMDEngine>(engine);
+}
+
+void SIMDControls::SetEngine(SIMDEngine engine) {
+  if (!IsSupported(engine)) {
+    std::stringstream s;
+    s << "SIMD engine " << engine << " is not supported on this platform";
+    PALISADE_THROW(config_error, s.str());
+  }
+  currentEngine.store(engine == SIMD_AUTO ? GetBestEngine() : engine,
+                      std::memory_order_relaxed);
+}
+
+}  // namespace lbcrypto
@@ -33,7 +33,11 @@
 #include "lattice/ilelement.h"
 #include "lattice/ilparams.h"
 #include "lattice/poly.h"
+#include "math/distrgen.h"
+#include "math/modgemm.h"
+#include "math/nbtheory.h"
 #include "testdefs.h"
+#include "utils/cpufeatures.h"
 #include "utils/debug.h"
 #include "utils/inttypes.h"
 #include "utils/utilities.h"
@@ -548,3 +552,301 @@ void modmul_vector(const string& msg) {
 TEST(UTBinVect, modmul_vector) {
   RUN_BIG_BACKENDS(modmul_vector, "modmul_vector")
 }
+
+// The element-wise NativeVector operations give the same results with every
+// SIMD engine as the corresponding NativeInteger operations; the lengths are
+// no multiples of the vector widths, so the scalar tails are covered too
+TEST(UTBinVect, native_vector_kernels) {
+  const usint n = 1029;
+  std::vector<NativeInteger> moduli = {NativeInteger(5), NativeInteger(65537),
+                                       NativeInteger(1) << 20};
+  for (usint bits : {30, 50, MAX_MODULUS_SIZE - 1}) {
+    moduli.push_back(FirstPrime<NativeInteger>(bits, 2048));
+  }
+  // the largest modulus of the 52-bit kernels
+  NativeInteger smallMax = PreviousPrime<NativeInteger>(
+      FirstPrime<NativeInteger>(50, 2048), 2048);
+  ASSERT_LT(smallMax, NativeInteger(1) << 50);
+  moduli.push_back(smallMax);
+  // the largest supported modulus size
+  moduli.push_back(PreviousPrime<NativeInteger>(
+      FirstPrime<NativeInteger>(MAX_MODULUS_SIZE, 2048), 2048));
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  for (const NativeInteger &q : moduli) {
+    dug.SetModulus(q);
+    NativeVector a = dug.GenerateVector(n);
+    NativeVector b = dug.GenerateVector(n);
+    NativeInteger c = dug.GenerateInteger();
+    NativeInteger half = q >> 1;
+    // every other modulus as the target of SwitchModulus
+    NativeInteger smaller = (q >> 3) + 1;
+    NativeInteger larger = moduli.back() == q ? q : moduli.back();
+
+    NativeVector sum(n, q), diff(n, q), prod(n, q), sumC(n, q), diffC(n, q),
+        prodC(n, q), neg(n, q), byTwo(n, q), down(n, smaller), up(n, larger);
+    for (usint i = 0; i < n; i++) {
+      sum[i] = a[i].ModAdd(b[i], q);
+      diff[i] = a[i].ModSub(b[i], q);
+      prod[i] = a[i];
+      prod[i].ModMulEq(b[i], q);
+      sumC[i] = a[i].ModAdd(c, q);
+      diffC[i] = a[i].ModSub(c, q);
+      prodC[i] = a[i];
+      prodC[i].ModMulEq(c, q);
+      neg[i] = NativeInteger(0).ModSub(a[i], q);
+      byTwo[i] = (a[i].ConvertToInt() & 1) ^ (a[i] > half ? 1 : 0);
+      down[i] = a[i] > half ? a[i].ModSub(q - smaller, smaller)
+                            : a[i].Mod(smaller);
+      up[i] = a[i] > half ? a[i] + (larger - q) : a[i];
+    }
+
+    for (SIMDEngine engine :
+         {SIMD_PORTABLE, SIMD_AVX2, SIMD_AVX512, SIMD_AVX512IFMA}) {
+      if (!SIMDControls::IsSupported(engine)) {
+        continue;
+      }
+      SIMDControls::SetEngine(engine);
+      std::stringstream msg;
+      msg << "engine " << engine << ", modulus " << q;
+
+      EXPECT_EQ(sum, a.ModAdd(b)) << msg.str();
+      EXPECT_EQ(diff, a.ModSub(b)) << msg.str();
+      EXPECT_EQ(prod, a.ModMul(b)) << msg.str();
+      EXPECT_EQ(sumC, a.ModAdd(c)) << msg.str();
+      EXPECT_EQ(diffC, a.ModSub(c)) << msg.str();
+      EXPECT_EQ(prodC, a.ModMul(c)) << msg.str();
+      EXPECT_EQ(neg, a.ModNegate()) << msg.str();
+      EXPECT_EQ(byTwo, a.ModByTwo()) << msg.str();
+
+      NativeVector x(a);
+      x.ModMulEq(b);
+      EXPECT_EQ(prod, x) << msg.str();
+      x.SwitchModulus(q);
+      EXPECT_EQ(prod, x) << msg.str();
+      x = a;
+      x.SwitchModulus(smaller);
+      EXPECT_EQ(down, x) << msg.str();
+      x = a;
+      x.SwitchModulus(larger);
+      EXPECT_EQ(up, x) << msg.str();
+    }
+    SIMDControls::SetEngine(SIMD_AUTO);
+  }
+}
+
+// The fused multiply-accumulate matches separate ModMul and ModAdd calls,
+// also with enough terms to reduce the 128-bit sums in between
+TEST(UTBinVect, native_vector_mul_add) {
+  const usint n = 1029;
+  const usint terms = 40;
+  std::vector<NativeInteger> moduli = {NativeInteger(5),
+                                       NativeInteger(1) << 20};
+  for (usint bits : {30, 50, MAX_MODULUS_SIZE - 1}) {
+    moduli.push_back(FirstPrime<NativeInteger>(bits, 2048));
+  }
+  moduli.push_back(PreviousPrime<NativeInteger>(
+      FirstPrime<NativeInteger>(MAX_MODULUS_SIZE, 2048), 2048));
+  moduli.push_back(PreviousPrime<NativeInteger>(
+      FirstPrime<NativeInteger>(51, 2048), 2048));
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  for (const NativeInteger &q : moduli) {
+    dug.SetModulus(q);
+    NativeVector c = dug.GenerateVector(n);
+    std::vector<NativeVector> as, bs;
+    std::vector<const NativeVector *> aPtrs, bPtrs;
+    NativeVector expected(c);
+    for (usint j = 0; j < terms; j++) {
+      as.push_back(dug.GenerateVector(n));
+      bs.push_back(dug.GenerateVector(n));
+      expected.ModAddEq(as.back().ModMul(bs.back()));
+    }
+    for (usint j = 0; j < terms; j++) {
+      aPtrs.push_back(&as[j]);
+      bPtrs.push_back(&bs[j]);
+    }
+
+    for (SIMDEngine engine :
+         {SIMD_PORTABLE, SIMD_AVX2, SIMD_AVX512, SIMD_AVX512IFMA}) {
+      if (!SIMDControls::IsSupported(engine)) {
+        continue;
+      }
+      SIMDControls::SetEngine(engine);
+      std::stringstream msg;
+      msg << "engine " << engine << ", modulus " << q;
+
+      NativeVector x(c);
+      x.ModMulAddEq(aPtrs, bPtrs);
+      EXPECT_EQ(expected, x) << msg.str();
+      x = c;
+      x.ModMulAddEq(as[0], bs[0]);
+      EXPECT_EQ(c.ModAdd(as[0].ModMul(bs[0])), x) << msg.str();
+    }
+    SIMDControls::SetEngine(SIMD_AUTO);
+  }
+
+  NativeVector x(n, moduli[0]), y(n + 1, moduli[0]);
+  EXPECT_THROW(x.ModMulAddEq(x, y), lbcrypto::math_error);
+}
+
+#if defined(HAVE_INT128) && NATIVEINT == 64
+static usint modGemmCalls = 0;
+
+static void CountingModGemmKernel(const ModGemmArgs &args) {
+  modGemmCalls++;
+  ModGemm::ReferenceKernel(args);
+}
+
+// checks both kernels on every engine against NativeInteger arithmetic, with
+// input moduli below 2^inBits, starting from the largest one, and the given
+// output moduli
+static void CheckModGemmKernels(
+    usint inBits, const std::vector<NativeInteger> &outputModuli) {
+  // not a multiple of the tile size
+  const usint n = 2 * ModGemm::TILE_SIZE + 17;
+  const usint numIn = 40;
+  const usint numOut = 3;
+  const BigInteger barrettBase128Bit("340282366920938463463374607431768211456");
+  const BigInteger twoPower64("18446744073709551616");
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  std::vector<NativeInteger> inModuli, scale;
+  std::vector<uint64_t> inModuliWords, scaleWords, scalePreconWords;
+  std::vector<NativeVector> in;
+  std::vector<const uint64_t *> inPtrs;
+  NativeInteger q = FirstPrime<NativeInteger>(inBits, 2048);
+  for (usint i = 0; i < numIn; i++) {
+    q = PreviousPrime<NativeInteger>(q, 2048);
+    dug.SetModulus(q);
+    in.push_back(dug.GenerateVector(n));
+    inModuli.push_back(q);
+    scale.push_back(dug.GenerateInteger());
+    inModuliWords.push_back(q.ConvertToInt());
+    scaleWords.push_back(scale.back().ConvertToInt());
+    scalePreconWords.push_back(
+        scale.back().PrepModMulConst(q).ConvertToInt());
+  }
+  for (usint i = 0; i < numIn; i++) {
+    inPtrs.push_back(reinterpret_cast<const uint64_t *>(&in[i][0]));
+  }
+
+  std::vector<uint64_t> outModuli, weights(numIn * numOut);
+  std::vector<DoubleNativeInt> outBarrettMu;
+  for (const NativeInteger &p : outputModuli) {
+    outModuli.push_back(p.ConvertToInt());
+    BigInteger mu = barrettBase128Bit / BigInteger(p);
+    uint64_t val[2];
+    val[0] = (mu % twoPower64).ConvertToInt();
+    val[1] = mu.RShift(64).ConvertToInt();
+    DoubleNativeInt muValue;
+    memcpy(&muValue, val, sizeof(DoubleNativeInt));
+    outBarrettMu.push_back(muValue);
+  }
+  for (usint i = 0; i < numIn; i++) {
+    for (usint j = 0; j < numOut; j++) {
+      dug.SetModulus(NativeInteger(outModuli[j]));
+      weights[i * numOut + j] = dug.GenerateInteger().ConvertToInt();
+    }
+  }
+
+  std::vector<NativeVector> expected, expectedScaled;
+  for (usint j = 0; j < numOut; j++) {
+    NativeInteger pj(outModuli[j]);
+    NativeVector sum(n, pj), sumScaled(n, pj);
+    for (usint i = 0; i < numIn; i++) {
+      NativeInteger w(weights[i * numOut + j]);
+      for (usint k = 0; k < n; k++) {
+        NativeInteger y = in[i][k].ModMul(scale[i], inModuli[i]);
+        sumScaled[k].ModAddEq(y.Mod(pj).ModMul(w, pj), pj);
+        sum[k].ModAddEq(in[i][k].Mod(pj).ModMul(w, pj), pj);
+      }
+    }
+    expected.push_back(sum);
+    expectedScaled.push_back(sumScaled);
+  }
+
+  for (SIMDEngine engine :
+       {SIMD_PORTABLE, SIMD_AVX2, SIMD_AVX512, SIMD_AVX512IFMA}) {
+    if (!SIMDControls::IsSupported(engine)) {
+      continue;
+    }
+    SIMDControls::SetEngine(engine);
+    for (ModGemmKernel kernel :
+         {&ModGemm::TiledKernel, &ModGemm::ReferenceKernel}) {
+      for (bool scaled : {false, true}) {
+        std::vector<std::vector<uint64_t>> out(numOut,
+                                               std::vector<uint64_t>(n));
+        std::vector<uint64_t *> outPtrs;
+        for (usint j = 0; j < numOut; j++) {
+          outPtrs.push_back(out[j].data());
+        }
+        ModGemmArgs args;
+        args.length = n;
+        args.numIn = numIn;
+        args.numOut = numOut;
+        args.in = inPtrs.data();
+        if (scaled) {
+          args.inModuli = inModuliWords.data();
+          args.scale = scaleWords.data();
+          args.scalePrecon = scalePreconWords.data();
+        }
+        args.weights = weights.data();
+        args.out = outPtrs.data();
+        args.outModuli = outModuli.data();
+        args.outBarrettMu = outBarrettMu.data();
+        kernel(args);
+
+        for (usint j = 0; j < numOut; j++) {
+          const NativeVector &ref = scaled ? expectedScaled[j] : expected[j];
+          for (usint k = 0; k < n; k++) {
+            ASSERT_EQ(ref[k].ConvertToInt(), out[j][k])
+                << "output " << j << ", coefficient " << k
+                << (scaled ? ", scaled" : "");
+          }
+        }
+      }
+    }
+  }
+  SIMDControls::SetEngine(SIMD_AUTO);
+}
+
+TEST(UTBinVect, mod_gemm) {
+  // 2^16, as for the mtilde residues of FastBaseConvqToBskMontgomery()
+  const NativeInteger mtilde = NativeInteger(1) << 16;
+  CheckModGemmKernels(
+      MAX_MODULUS_SIZE,
+      {FirstPrime<NativeInteger>(30, 2048),
+       FirstPrime<NativeInteger>(MAX_MODULUS_SIZE - 1, 2048), mtilde});
+  // the moduli of the 52-bit kernels, up to the largest one
+  NativeInteger smallMax = PreviousPrime<NativeInteger>(
+      FirstPrime<NativeInteger>(50, 2048), 2048);
+  ASSERT_LT(smallMax, NativeInteger(1) << 50);
+  CheckModGemmKernels(50, {FirstPrime<NativeInteger>(30, 2048), smallMax,
+                           mtilde});
+
+  EXPECT_EQ(&ModGemm::TiledKernel, ModGemm::GetKernel());
+  ModGemm::SetKernel(&CountingModGemmKernel);
+  EXPECT_EQ(&CountingModGemmKernel, ModGemm::GetKernel());
+  const usint n = 9;
+  std::vector<uint64_t> in(n, 5), out(n);
+  const uint64_t *inPtr = in.data();
+  uint64_t *outPtr = out.data();
+  const uint64_t weight = 3, modulus = 11;
+  const DoubleNativeInt barrettMu = ~DoubleNativeInt(0) / modulus;
+  ModGemmArgs args;
+  args.length = n;
+  args.numIn = 1;
+  args.numOut = 1;
+  args.in = &inPtr;
+  args.weights = &weight;
+  args.out = &outPtr;
+  args.outModuli = &modulus;
+  args.outBarrettMu = &barrettMu;
+  ModGemm::Multiply(args);
+  EXPECT_EQ(1U, modGemmCalls);
+  EXPECT_EQ(std::vector<uint64_t>(n, 4), out);
+  ModGemm::SetKernel(nullptr);
+  EXPECT_EQ(&ModGemm::TiledKernel, ModGemm::GetKernel());
+}
+#endif
@@ -26,6 +26,7 @@ library.
 */
 
 #include <iostream>
+#include <thread>
 #include <vector>
 #include "gtest/gtest.h"
 
@@ -641,6 +642,18 @@ void DCRT_mod_ops_on_two_elements(const string& msg) {
       }
     }
   }
+
+  {
+    Element op3(dug, ildcrtparams);
+    Element acc(op3);
+    acc.ModMulAddEq(op1, op2);
+    EXPECT_EQ(op3 + op1 * op2, acc) << msg << " Failure: DCRTPoly ModMulAddEq";
+
+    acc = op3;
+    acc.ModMulAddEq({&op1, &op2}, {&op2, &op3});
+    EXPECT_EQ(op3 + op1 * op2 + op2 * op3, acc)
+        << msg << " Failure: DCRTPoly inner product ModMulAddEq";
+  }
 }
 
 TEST(UTDCRTPoly, DCRT_mod_ops_on_two_elements) {
@@ -648,6 +661,535 @@ TEST(UTDCRTPoly, DCRT_mod_ops_on_two_elements) {
                     "DCRT DCRT_mod_ops_on_two_elements");
 }
 
+// the precomputations of ApproxSwitchCRTBasis() from the moduli q_i of Q to
+// the moduli p_j
+static void BaseConversionTables(const vector<NativeInteger>& moduliQ,
+                                 const vector<NativeInteger>& moduliP,
+                                 vector<NativeInteger>* QHatInvModq,
+                                 vector<NativeInteger>* QHatInvModqPrecon,
+                                 vector<vector<NativeInteger>>* QHatModp,
+                                 vector<DoubleNativeInt>* modpBarrettMu) {
+  usint sizeQ = moduliQ.size();
+  usint sizeP = moduliP.size();
+  BigInteger Q(1);
+  for (auto& qi : moduliQ) Q *= BigInteger(qi);
+  const BigInteger barrettBase128Bit("340282366920938463463374607431768211456");
+  const BigInteger twoPower64("18446744073709551616");
+  QHatInvModq->resize(sizeQ);
+  QHatInvModqPrecon->resize(sizeQ);
+  QHatModp->assign(sizeQ, vector<NativeInteger>(sizeP));
+  for (usint i = 0; i < sizeQ; i++) {
+    BigInteger QHati = Q / BigInteger(moduliQ[i]);
+    (*QHatInvModq)[i] = QHati.ModInverse(moduliQ[i]).ConvertToInt();
+    (*QHatInvModqPrecon)[i] = (*QHatInvModq)[i].PrepModMulConst(moduliQ[i]);
+    for (usint j = 0; j < sizeP; j++) {
+      (*QHatModp)[i][j] = QHati.Mod(moduliP[j]).ConvertToInt();
+    }
+  }
+  modpBarrettMu->resize(sizeP);
+  for (usint j = 0; j < sizeP; j++) {
+    BigInteger mu = barrettBase128Bit / BigInteger(moduliP[j]);
+    uint64_t val[2];
+    val[0] = (mu % twoPower64).ConvertToInt();
+    val[1] = mu.RShift(64).ConvertToInt();
+    memcpy(&(*modpBarrettMu)[j], val, sizeof(DoubleNativeInt));
+  }
+}
+
+TEST(UTDCRTPoly, DCRT_workspace) {
+  usint order = 64;
+  usint sizeQ = 3;
+  usint sizeP = 2;
+
+  auto paramsQP = GenerateDCRTParams<BigInteger>(order, sizeQ + sizeP, 55);
+  vector<NativeInteger> moduliQ, rootsQ, moduliP, rootsP;
+  for (usint i = 0; i < sizeQ + sizeP; i++) {
+    auto& moduli = (i < sizeQ) ? moduliQ : moduliP;
+    auto& roots = (i < sizeQ) ? rootsQ : rootsP;
+    moduli.push_back(paramsQP->GetParams()[i]->GetModulus());
+    roots.push_back(paramsQP->GetParams()[i]->GetRootOfUnity());
+  }
+  auto paramsQ = std::make_shared<ILDCRTParams<BigInteger>>(order, moduliQ,
+                                                            rootsQ);
+  auto paramsP = std::make_shared<ILDCRTParams<BigInteger>>(order, moduliP,
+                                                            rootsP);
+
+  vector<NativeInteger> QHatInvModq, QHatInvModqPrecon;
+  vector<vector<NativeInteger>> QHatModp;
+  vector<DoubleNativeInt> modpBarrettMu;
+  BaseConversionTables(moduliQ, moduliP, &QHatInvModq, &QHatInvModqPrecon,
+                       &QHatModp, &modpBarrettMu);
+  vector<NativeInteger> PHatInvModp, PHatInvModpPrecon;
+  vector<vector<NativeInteger>> PHatModq;
+  vector<DoubleNativeInt> modqBarrettMu;
+  BaseConversionTables(moduliP, moduliQ, &PHatInvModp, &PHatInvModpPrecon,
+                       &PHatModq, &modqBarrettMu);
+  BigInteger P(1);
+  for (auto& pj : moduliP) P *= BigInteger(pj);
+  vector<NativeInteger> PInvModq(sizeQ), PInvModqPrecon(sizeQ);
+  for (usint i = 0; i < sizeQ; i++) {
+    PInvModq[i] = P.ModInverse(moduliQ[i]).ConvertToInt();
+    PInvModqPrecon[i] = PInvModq[i].PrepModMulConst(moduliQ[i]);
+  }
+
+  DCRTPoly::DugType dug;
+  DCRTPoly::Workspace ws;
+  DCRTPoly switched, up, down;
+  for (int trial = 0; trial < 2; trial++) {
+    // the second trial reuses the towers of the results and the workspace
+    DCRTPoly x(dug, paramsQ, EVALUATION);
+    DCRTPoly xCoeff(x);
+    xCoeff.SetFormat(COEFFICIENT);
+
+    xCoeff.ApproxSwitchCRTBasis(paramsQ, paramsP, QHatInvModq,
+                                QHatInvModqPrecon, QHatModp, modpBarrettMu,
+                                &switched, &ws);
+    EXPECT_EQ(xCoeff.ApproxSwitchCRTBasis(paramsQ, paramsP, QHatInvModq,
+                                          QHatInvModqPrecon, QHatModp,
+                                          modpBarrettMu),
+              switched)
+        << "Failure: ApproxSwitchCRTBasis with a workspace";
+
+    x.ApproxModUp(paramsQ, paramsP, paramsQP, QHatInvModq, QHatInvModqPrecon,
+                  QHatModp, modpBarrettMu, &up, &ws);
+    DCRTPoly expectedUp(x);
+    expectedUp.ApproxModUp(paramsQ, paramsP, paramsQP, QHatInvModq,
+                           QHatInvModqPrecon, QHatModp, modpBarrettMu);
+    EXPECT_EQ(expectedUp, up) << "Failure: ApproxModUp with a workspace";
+    EXPECT_EQ(x.GetAllElements(),
+              vector<NativePoly>(up.GetAllElements().begin(),
+                                 up.GetAllElements().begin() + sizeQ))
+        << "Failure: ApproxModUp changed the towers of Q";
+    NativePoly upP(up.GetElementAtIndex(sizeQ));
+    upP.SetFormat(COEFFICIENT);
+    EXPECT_EQ(switched.GetElementAtIndex(0).GetValues(), upP.GetValues())
+        << "Failure: ApproxModUp towers of P";
+
+    // P * (x + alpha * Q) is 0 mod P, so scaling it down by P gives x
+    vector<NativeInteger> PModqp(sizeQ + sizeP);
+    for (usint i = 0; i < sizeQ + sizeP; i++) {
+      PModqp[i] = P.Mod(paramsQP->GetParams()[i]->GetModulus()).ConvertToInt();
+    }
+    DCRTPoly scaled = up.Times(PModqp);
+    scaled.ApproxModDown(paramsQ, paramsP, PInvModq, PInvModqPrecon,
+                         PHatInvModp, PHatInvModpPrecon, PHatModq,
+                         modqBarrettMu, vector<NativeInteger>(),
+                         vector<NativeInteger>(), 0, vector<NativeInteger>(),
+                         &down, &ws);
+    EXPECT_EQ(x, down) << "Failure: ApproxModDown with a workspace";
+
+    // dropping q_l from q_l * y gives y
+    NativeInteger ql = moduliQ[sizeQ - 1];
+    vector<NativeInteger> qlInvModq(sizeQ - 1), qlInvModqPrecon(sizeQ - 1);
+    vector<NativeInteger> zeros(sizeQ - 1);
+    for (usint i = 0; i < sizeQ - 1; i++) {
+      qlInvModq[i] = ql.ModInverse(moduliQ[i]);
+      qlInvModqPrecon[i] = qlInvModq[i].PrepModMulConst(moduliQ[i]);
+    }
+    DCRTPoly dropped = x.Times(BigInteger(ql));
+    dropped.DropLastElementAndScale(zeros, zeros, qlInvModq, qlInvModqPrecon,
+                                    &ws);
+    DCRTPoly expectedDropped(x);
+    expectedDropped.DropLastElement();
+    EXPECT_EQ(expectedDropped, dropped)
+        << "Failure: DropLastElementAndScale with a workspace";
+  }
+}
+
+TEST(UTDCRTPoly, DCRT_rescale) {
+  usint order = 64;
+  usint sizeQ = 4;
+  auto params = GenerateDCRTParams<BigInteger>(order, sizeQ, 50);
+  const NativeInteger& ql = params->GetParams()[sizeQ - 1]->GetModulus();
+  const NativeInteger t(65537);
+  const NativeInteger negtInvModq = ql - t.ModInverse(ql);
+
+  DCRTPoly::DugType dug;
+  vector<NativeInteger> scale(sizeQ - 1), scalePrecon(sizeQ - 1);
+  vector<NativeInteger> qlInvModq(sizeQ - 1), qlInvModqPrecon(sizeQ - 1);
+  vector<NativeInteger> tModqPrecon(sizeQ - 1);
+  for (usint i = 0; i < sizeQ - 1; i++) {
+    const NativeInteger& qi = params->GetParams()[i]->GetModulus();
+    scale[i] = qi - NativeInteger(1234567 + 1000 * i);
+    scalePrecon[i] = scale[i].PrepModMulConst(qi);
+    qlInvModq[i] = ql.ModInverse(qi);
+    qlInvModqPrecon[i] = qlInvModq[i].PrepModMulConst(qi);
+    tModqPrecon[i] = t.PrepModMulConst(qi);
+  }
+
+  for (Format format : {EVALUATION, COEFFICIENT}) {
+    DCRTPoly x(dug, params, format);
+    NativePoly last(x.GetElementAtIndex(sizeQ - 1));
+    last.SetFormat(COEFFICIENT);
+    NativePoly delta(last * negtInvModq);
+
+    // the unfused computations
+    DCRTPoly expectedScaled(x);
+    DCRTPoly expectedReduced(x);
+    expectedScaled.DropLastElement();
+    expectedReduced.DropLastElement();
+    for (usint i = 0; i < sizeQ - 1; i++) {
+      const auto& towerParams = params->GetParams()[i];
+      NativePoly extra(last);
+      extra.SwitchModulus(towerParams->GetModulus(),
+                          towerParams->GetRootOfUnity(), 0, 0);
+      extra *= scale[i];
+      extra.SetFormat(format);
+      expectedScaled.SetElementAtIndex(
+          i, x.GetElementAtIndex(i) * qlInvModq[i] + extra);
+
+      NativePoly deltaModqi(delta);
+      deltaModqi.SwitchModulus(towerParams->GetModulus(),
+                               towerParams->GetRootOfUnity(), 0, 0);
+      deltaModqi.SetFormat(format);
+      expectedReduced.SetElementAtIndex(
+          i, (x.GetElementAtIndex(i) + deltaModqi * t) * qlInvModq[i]);
+    }
+    expectedScaled.SetFormat(EVALUATION);
+
+    DCRTPoly scaled(x);
+    scaled.DropLastElementAndScale(scale, scalePrecon, qlInvModq,
+                                   qlInvModqPrecon);
+    EXPECT_EQ(expectedScaled.GetAllElements(), scaled.GetAllElements())
+        << "Failure: DropLastElementAndScale in format " << format;
+
+    DCRTPoly reduced(x);
+    reduced.ModReduce(t, tModqPrecon, negtInvModq,
+                      negtInvModq.PrepModMulConst(ql), qlInvModq,
+                      qlInvModqPrecon);
+    EXPECT_EQ(format, reduced.GetFormat());
+    EXPECT_EQ(expectedReduced.GetAllElements(), reduced.GetAllElements())
+        << "Failure: ModReduce in format " << format;
+  }
+}
+
+TEST(UTDCRTPoly, DCRT_lazy_format) {
+  usint order = 64;
+  usint sizeQ = 4;
+  auto params = GenerateDCRTParams<BigInteger>(order, sizeQ, 50);
+  DCRTPoly::DugType dug;
+  vector<NativeInteger> scale(sizeQ - 1), scalePrecon(sizeQ - 1);
+  vector<NativeInteger> qlInvModq(sizeQ - 1), qlInvModqPrecon(sizeQ - 1);
+  const NativeInteger& ql = params->GetParams()[sizeQ - 1]->GetModulus();
+  for (usint i = 0; i < sizeQ - 1; i++) {
+    const NativeInteger& qi = params->GetParams()[i]->GetModulus();
+    scale[i] = qi - NativeInteger(1234567 + 1000 * i);
+    scalePrecon[i] = scale[i].PrepModMulConst(qi);
+    qlInvModq[i] = ql.ModInverse(qi);
+    qlInvModqPrecon[i] = qlInvModq[i].PrepModMulConst(qi);
+  }
+
+  DCRTPoly a(dug, params, EVALUATION);
+  DCRTPoly b(dug, params, EVALUATION);
+
+  // the eager computations
+  DCRTPoly expectedSum(a);
+  expectedSum.SetFormat(COEFFICIENT);
+  DCRTPoly bCoef(b);
+  bCoef.SetFormat(COEFFICIENT);
+  expectedSum += bCoef;
+  expectedSum *= BigInteger(3);
+  DCRTPoly aCoef(a);
+  aCoef.SetFormat(COEFFICIENT);
+  DCRTPoly expectedScaled(aCoef);
+  expectedScaled.DropLastElementAndScale(scale, scalePrecon, qlInvModq,
+                                         qlInvModqPrecon);
+
+  // without lazy mode DeferFormat() switches right away and nothing is counted
+  DCRTPoly::ResetFormatSwitchCounts();
+  DCRTPoly w(a);
+  w.DeferFormat(COEFFICIENT);
+  EXPECT_EQ(COEFFICIENT, w.GetFormat());
+  EXPECT_EQ(aCoef, w) << "Failure: eager DeferFormat";
+  EXPECT_EQ(0U, DCRTPoly::GetFormatSwitchCounts().performed);
+
+  DCRTPoly::SetLazyFormat(true);
+  DCRTPoly::ResetFormatSwitchCounts();
+
+  // a switch that is undone is not performed
+  DCRTPoly x(a);
+  x.DeferFormat(COEFFICIENT);
+  EXPECT_EQ(EVALUATION, x.GetFormat());
+  EXPECT_EQ(COEFFICIENT, x.GetDeferredFormat());
+  x.SetFormat(EVALUATION);
+  EXPECT_EQ(EVALUATION, x.GetDeferredFormat());
+  EXPECT_EQ(0U, DCRTPoly::GetFormatSwitchCounts().performed);
+  EXPECT_EQ(sizeQ, DCRTPoly::GetFormatSwitchCounts().elided);
+  EXPECT_EQ(a, x) << "Failure: undone lazy switch";
+
+  // in-place additions and scalings commute with the deferred switches
+  DCRTPoly sum(a);
+  sum.DeferFormat(COEFFICIENT);
+  {
+    DCRTPoly y(b);
+    y.DeferFormat(COEFFICIENT);
+    sum += y;
+  }
+  sum *= BigInteger(3);
+  EXPECT_EQ(0U, DCRTPoly::GetFormatSwitchCounts().performed);
+  sum.ResolveFormat();
+  EXPECT_EQ(COEFFICIENT, sum.GetFormat());
+  EXPECT_EQ(expectedSum, sum) << "Failure: lazy addition";
+  EXPECT_EQ(sizeQ, DCRTPoly::GetFormatSwitchCounts().performed);
+
+  // towers that are dropped or overwritten are not transformed
+  DCRTPoly::ResetFormatSwitchCounts();
+  {
+    DCRTPoly z(b);
+    z.DeferFormat(COEFFICIENT);
+    z.DropLastElement();
+    z = a;
+    EXPECT_EQ(EVALUATION, z.GetDeferredFormat());
+  }
+  EXPECT_EQ(0U, DCRTPoly::GetFormatSwitchCounts().performed);
+  EXPECT_EQ(sizeQ, DCRTPoly::GetFormatSwitchCounts().elided);
+
+  // rescaling works on the towers in the format they are in
+  DCRTPoly scaled(a);
+  scaled.DeferFormat(COEFFICIENT);
+  scaled.DropLastElementAndScale(scale, scalePrecon, qlInvModq,
+                                 qlInvModqPrecon);
+  EXPECT_EQ(expectedScaled.GetAllElements(), scaled.GetAllElements())
+      << "Failure: lazy DropLastElementAndScale";
+
+  DCRTPoly::SetLazyFormat(false);
+}
+
+TEST(UTDCRTPoly, DCRT_tower_range) {
+  usint order = 64;
+  usint sizeQ = 4;
+  auto params = GenerateDCRTParams<BigInteger>(order, sizeQ, 50);
+  DCRTPoly::DugType dug;
+
+  DCRTPoly a(dug, params, EVALUATION);
+  DCRTPoly b(dug, params, EVALUATION);
+
+  // a view holds the same towers as a copy of them
+  DCRTPoly middle(a.Towers(1, 2));
+  DCRTPoly middleCopy = a.CloneTowers(1, 2);
+  EXPECT_EQ(middleCopy.GetAllElements(), middle.GetAllElements())
+      << "Failure: middle towers";
+  EXPECT_EQ(*middleCopy.GetParams(), *middle.GetParams())
+      << "Failure: middle tower params";
+
+  DCRTPoly prefix(a.Towers(0, sizeQ - 3));
+  DCRTPoly prefixCopy(a);
+  prefixCopy.DropLastElements(2);
+  EXPECT_EQ(prefixCopy, prefix) << "Failure: leading towers";
+
+  // arithmetic with a view of the leading towers of a larger polynomial
+  DCRTPoly expected(prefixCopy);
+  DCRTPoly bDropped(b);
+  bDropped.DropLastElements(2);
+  expected += bDropped;
+  DCRTPoly sum(prefix);
+  sum += b.Towers(0, sizeQ - 3);
+  EXPECT_EQ(expected, sum) << "Failure: += with a tower range";
+  EXPECT_EQ(expected, prefix + b.Towers(0, sizeQ - 3))
+      << "Failure: + with a tower range";
+
+  expected = prefixCopy * bDropped;
+  EXPECT_EQ(expected, prefix * b.Towers(0, sizeQ - 3))
+      << "Failure: * with a tower range";
+
+  EXPECT_THROW(sum -= b.Towers(0, sizeQ - 1), lbcrypto::math_error)
+      << "Failure: tower size mismatch";
+  EXPECT_THROW(a.Towers(2, sizeQ), lbcrypto::math_error)
+      << "Failure: tower range out of bounds";
+
+  // updating a range of towers in place
+  DCRTPoly c(a);
+  c.Towers(1, 2) += b.Towers(1, 2);
+  for (usint i = 0; i < sizeQ; i++) {
+    if (i == 1 || i == 2) {
+      EXPECT_EQ(a.GetElementAtIndex(i) + b.GetElementAtIndex(i),
+                c.GetElementAtIndex(i));
+    } else {
+      EXPECT_EQ(a.GetElementAtIndex(i), c.GetElementAtIndex(i));
+    }
+  }
+
+  // a view has the format of its polynomial; the format of the towers of a
+  // view is switched on a copy
+  DCRTPoly coef(a);
+  coef.SetFormat(COEFFICIENT);
+  EXPECT_EQ(COEFFICIENT, coef.Towers(1, 2).GetFormat());
+  DCRTPoly lower(a.Towers(0, 1));
+  lower.SetFormat(COEFFICIENT);
+  EXPECT_EQ(DCRTPoly(coef.Towers(0, 1)), lower)
+      << "Failure: format of a copy of a tower range";
+}
+
+TEST(UTDCRTPoly, DCRT_automorphism) {
+  usint order = 64;
+  usint sizeQ = 3;
+  auto params = GenerateDCRTParams<BigInteger>(order, sizeQ, 50);
+  DCRTPoly::DugType dug;
+
+  DCRTPoly a(dug, params, EVALUATION);
+  DCRTPoly b(dug, params, EVALUATION);
+
+  // permutations are computed once per cyclotomic order and index
+  const auto& perm = GetAutomorphismPermutation(order, 5);
+  EXPECT_EQ(&perm, &GetAutomorphismPermutation(order, 5 + order));
+  EXPECT_THROW(GetAutomorphismPermutation(order, 4), lbcrypto::math_error);
+  // other threads get the same shared permutation
+  const std::vector<uint32_t>* permOtherThread = nullptr;
+  std::thread other(
+      [&]() { permOtherThread = &GetAutomorphismPermutation(order, 5); });
+  other.join();
+  EXPECT_EQ(&perm, permOtherThread);
+
+  // non-power-of-two orders permute the slots of the totatives
+  const auto& permArb = GetAutomorphismPermutation(15, 2);
+  std::vector<usint> totients = GetTotientList(usint(15));
+  ASSERT_EQ(totients.size(), permArb.size());
+  for (usint i = 0; i < totients.size(); i++) {
+    EXPECT_EQ(totients[i] * 2 % 15, totients[permArb[i]]);
+  }
+  EXPECT_THROW(GetAutomorphismPermutation(15, 3), lbcrypto::math_error);
+
+  for (usint k : {3, 5, 63}) {
+    // the EVALUATION permutation agrees with the COEFFICIENT automorphism
+    DCRTPoly aCoef(a);
+    aCoef.SetFormat(COEFFICIENT);
+    DCRTPoly expected = aCoef.AutomorphismTransform(k);
+    expected.SetFormat(EVALUATION);
+    EXPECT_EQ(expected, a.AutomorphismTransform(k))
+        << "Failure: AutomorphismTransform k = " << k;
+
+    EXPECT_EQ((a + b).AutomorphismTransform(k),
+              a.AutomorphismTransformSum(k, b))
+        << "Failure: AutomorphismTransformSum k = " << k;
+
+    // the towers missing from the addend are zero
+    DCRTPoly b01(b.CloneTowers(0, 1));
+    DCRTPoly expectedSum(a.AutomorphismTransform(k));
+    DCRTPoly psiB(b.AutomorphismTransform(k));
+    for (usint i = 0; i < 2; i++) {
+      expectedSum.ElementAtIndex(i) += psiB.GetElementAtIndex(i);
+    }
+    EXPECT_EQ(expectedSum, a.AutomorphismTransformSumPrefix(k, b01))
+        << "Failure: AutomorphismTransformSumPrefix k = " << k;
+  }
+  // only the prefix variant accepts an addend with fewer towers
+  EXPECT_THROW(a.AutomorphismTransformSum(3, b.CloneTowers(0, 1)),
+               lbcrypto::math_error);
+  EXPECT_THROW(b.CloneTowers(0, 1).AutomorphismTransformSum(3, a),
+               lbcrypto::math_error);
+  EXPECT_THROW(b.CloneTowers(0, 1).AutomorphismTransformSumPrefix(3, a),
+               lbcrypto::math_error);
+}
+
+// ScaleAndRound of coefficient k for t not a power of two, one coefficient at
+// a time as before the kernels: the sum of the integer parts is added to the
+// fractional sum as a double and the quotient by t is found with doubles
+static uint64_t ScaleAndRoundNonPowerOfTwo(
+    const DCRTPoly& x, usint k, const NativeInteger& t,
+    const vector<NativeInteger>& modt, const vector<NativeInteger>& modtB,
+    const vector<double>& frac, const vector<double>& fracB) {
+  usint sizeQ = x.GetNumOfElements();
+  usint qMSB = x.GetElementAtIndex(0).GetModulus().GetMSB();
+  usint sizeQMSB = GetMSB64(sizeQ);
+  usint qMSBHf = qMSB >> 1;
+  bool split = qMSB + sizeQMSB >= 52;
+  bool reduce = (split ? qMSBHf : qMSB) + t.GetMSB() + sizeQMSB >= 52;
+
+  double floatSum = 0.0;
+  uint64_t intSum = 0;
+  for (usint i = 0; i < sizeQ; i++) {
+    NativeInteger lo = x.GetElementAtIndex(i)[k];
+    NativeInteger hi = split ? lo >> qMSBHf : NativeInteger(0);
+    lo -= hi << qMSBHf;
+    floatSum += static_cast<double>(lo.ConvertToInt()) * frac[i];
+    intSum += (reduce ? lo.ModMul(modt[i], t) : lo * modt[i]).ConvertToInt();
+    if (split) {
+      floatSum += static_cast<double>(hi.ConvertToInt()) * fracB[i];
+      intSum +=
+          (reduce ? hi.ModMul(modtB[i], t) : hi * modtB[i]).ConvertToInt();
+    }
+  }
+  double td = t.ConvertToInt();
+  floatSum += intSum;
+  uint64_t quot = static_cast<uint64_t>(floatSum * (1. / td));
+  floatSum -= td * quot;
+  // a remainder in [t - 1/2, t) rounds up to t
+  return static_cast<uint64_t>(floatSum + 0.5) % t.ConvertToInt();
+}
+
+TEST(UTDCRTPoly, DCRT_scale_and_round) {
+  usint order = 64;
+  usint sizeQ = 3;
+  DCRTPoly::DugType dug;
+
+  // every regime of ScaleAndRoundKernels: residues split or not, t a power
+  // of two or not, with and without reductions mod t
+  for (usint qBits : {30, 55}) {
+    auto params = GenerateDCRTParams<BigInteger>(order, sizeQ, qBits);
+    const BigInteger& Q = params->GetModulus();
+    usint qMSB = params->GetParams()[0]->GetModulus().GetMSB();
+    usint splitShift = qMSB >> 1;
+    for (uint64_t tValue : {uint64_t(1) << 16, uint64_t(65537),
+                            uint64_t(1) << 40, (uint64_t(1) << 40) + 15}) {
+      NativeInteger t(tValue);
+      BigInteger tBig(tValue);
+      vector<NativeInteger> modt(sizeQ), modtPrecon(sizeQ);
+      vector<NativeInteger> modtB(sizeQ), modtBPrecon(sizeQ);
+      vector<double> frac(sizeQ), fracB(sizeQ);
+      for (usint i = 0; i < sizeQ; i++) {
+        BigInteger qi(params->GetParams()[i]->GetModulus().ConvertToInt());
+        BigInteger tQHatInvModqi = Q.DividedBy(qi).ModInverse(qi) * tBig;
+        modt[i] = tQHatInvModqi.DividedBy(qi).Mod(tBig).ConvertToInt();
+        modtPrecon[i] = modt[i].PrepModMulConst(t);
+        frac[i] = static_cast<double>(tQHatInvModqi.Mod(qi).ConvertToInt()) /
+                  static_cast<double>(qi.ConvertToInt());
+        tQHatInvModqi.LShiftEq(splitShift);
+        modtB[i] = tQHatInvModqi.DividedBy(qi).Mod(tBig).ConvertToInt();
+        modtBPrecon[i] = modtB[i].PrepModMulConst(t);
+        fracB[i] = static_cast<double>(tQHatInvModqi.Mod(qi).ConvertToInt()) /
+                   static_cast<double>(qi.ConvertToInt());
+      }
+
+      DCRTPoly x(dug, params, COEFFICIENT);
+      NativePoly result =
+          x.ScaleAndRound(t, modt, modtPrecon, modtB, modtBPrecon, frac, fracB,
+                          ScaleAndRoundKernels::SelectKernel(qMSB, sizeQ, tValue));
+      EXPECT_EQ(result, x.ScaleAndRound(t, modt, modtPrecon, modtB,
+                                        modtBPrecon, frac, fracB))
+          << "Failure: ScaleAndRound kernel selection";
+
+      // for t not a power of two, the integer part (up to 2^50 here) is added
+      // to the fraction as a double, which keeps too few fractional bits to
+      // compare with the exact rounding
+      if ((tValue & (tValue - 1)) != 0) {
+        for (usint k = 0; k < x.GetRingDimension(); k++) {
+          EXPECT_EQ(ScaleAndRoundNonPowerOfTwo(x, k, t, modt, modtB, frac,
+                                               fracB),
+                    result[k].ConvertToInt())
+              << "Failure: ScaleAndRound for q_i of " << qBits
+              << " bits and t = " << tValue << " at " << k;
+        }
+        continue;
+      }
+
+      // round(t/Q * X) mod t, except for values whose fractional part is
+      // too close to 1/2 for the floating-point rounding
+      auto X = x.CRTInterpolate();
+      for (usint k = 0; k < x.GetRingDimension(); k++) {
+        BigInteger tX = X[k] * tBig;
+        BigInteger rem = tX.Mod(Q);
+        BigInteger twiceRem = rem << 1;
+        BigInteger distance = twiceRem > Q ? twiceRem - Q : Q - twiceRem;
+        if (distance < (Q >> 10)) continue;
+        BigInteger rounded = tX.DividedBy(Q) + (twiceRem > Q ? 1 : 0);
+        EXPECT_EQ(rounded.Mod(tBig).ConvertToInt(), result[k].ConvertToInt())
+            << "Failure: ScaleAndRound for q_i of " << qBits
+            << " bits and t = " << tValue << " at " << k;
+      }
+    }
+  }
+}
+
 // only need to try this with one
 void testDCRTPolyConstructorNegative(std::vector<NativePoly>& towers) {
   DCRTPoly expectException(towers);
@@ -37,8 +37,10 @@ IntPlainTextEncoding) work.
 #include "lattice/backend.h"
 #include "math/backend.h"
 #include "math/distrgen.h"
+#include "math/nativentt.h"
 #include "math/nbtheory.h"
 #include "testdefs.h"
+#include "utils/cpufeatures.h"
 #include "utils/inttypes.h"
 #include "utils/utilities.h"
 
@@ -132,3 +134,389 @@ TEST(UTNTT, switch_format_simple_double_crt) {
   RUN_BIG_DCRTPOLYS(switch_format_simple_double_crt,
                     "switch_format_simple_double_crt")
 }
+
+// Every SIMD engine the CPU supports must produce the same (fully reduced)
+// transform as the generic multiprecision NTT, and must invert it exactly.
+TEST(UTNTT, native_engines_match_big_transform) {
+  usint m = 2048;
+  usint n = m / 2;
+
+  std::vector<NativeInteger> moduli;
+  for (usint bits : {30, 50, 59}) {
+    moduli.push_back(FirstPrime<NativeInteger>(bits, m));
+  }
+  // the largest modulus of the 52-bit kernels
+  NativeInteger smallMax =
+      PreviousPrime<NativeInteger>(FirstPrime<NativeInteger>(50, m), m);
+  ASSERT_LT(smallMax, NativeInteger(1) << 50);
+  moduli.push_back(smallMax);
+
+  for (const NativeInteger &q : moduli) {
+    usint bits = q.GetMSB();
+    NativeInteger root = RootOfUnity<NativeInteger>(m, q);
+
+    DiscreteUniformGeneratorImpl<NativeVector> dug;
+    dug.SetModulus(q);
+    NativeVector x = dug.GenerateVector(n);
+
+    BigInteger bigQ(q.ConvertToInt());
+    BigVector xBig(n, bigQ);
+    for (usint i = 0; i < n; i++) {
+      xBig[i] = BigInteger(x[i].ConvertToInt());
+    }
+    BigVector expected(n, bigQ);
+    ChineseRemainderTransformFTT<BigVector>::ForwardTransformToBitReverse(
+        xBig, BigInteger(root.ConvertToInt()), m, &expected);
+
+    for (SIMDEngine engine :
+         {SIMD_PORTABLE, SIMD_AVX2, SIMD_AVX512, SIMD_AVX512IFMA}) {
+      if (!SIMDControls::IsSupported(engine)) {
+        continue;
+      }
+      SIMDControls::SetEngine(engine);
+
+      NativeVector y(x);
+      ChineseRemainderTransformFTT<NativeVector>::
+          ForwardTransformToBitReverseInPlace(root, m, &y);
+      for (usint i = 0; i < n; i++) {
+        ASSERT_EQ(y[i].ConvertToInt(), expected[i].ConvertToInt())
+            << "engine " << engine << ", " << bits << "-bit modulus, index "
+            << i;
+      }
+
+      ChineseRemainderTransformFTT<NativeVector>::
+          InverseTransformFromBitReverseInPlace(root, m, &y);
+      EXPECT_EQ(x, y) << "engine " << engine << ", " << bits
+                      << "-bit modulus";
+    }
+    SIMDControls::SetEngine(SIMD_AUTO);
+  }
+}
+
+// Native parameters carry a shared NTT plan, and transforming with it gives
+// the same result as the map-based ChineseRemainderTransformFTT path.
+TEST(UTNTT, native_params_ntt_plan) {
+  usint m = 4096;
+  usint n = m / 2;
+
+  NativeInteger q = FirstPrime<NativeInteger>(50, m);
+  NativeInteger root = RootOfUnity<NativeInteger>(m, q);
+  auto params = std::make_shared<ILNativeParams>(m, q, root);
+  ILNativeParams paramsCopy(*params);
+
+  ASSERT_NE(params->GetNTTPlan(), nullptr);
+  EXPECT_EQ(params->GetNTTPlan(), paramsCopy.GetNTTPlan())
+      << "copies of the parameters must share the plan";
+  EXPECT_EQ(params->GetNTTPlan(),
+            std::make_shared<ILNativeParams>(m, q, root)->GetNTTPlan())
+      << "parameters for the same modulus must share the plan";
+  EXPECT_EQ(params->GetNTTPlan()->GetRingDimension(), n);
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  NativePoly x(dug, params, Format::COEFFICIENT);
+  NativeVector expected(x.GetValues());
+  ChineseRemainderTransformFTT<NativeVector>::
+      ForwardTransformToBitReverseInPlace(root, m, &expected);
+
+  NativePoly y(x);
+  y.SwitchFormat();
+  EXPECT_EQ(expected, y.GetValues());
+  y.SwitchFormat();
+  EXPECT_EQ(x, y);
+
+  auto arbParams = std::make_shared<ILNativeParams>(
+      22, FirstPrime<NativeInteger>(22, 22));
+  EXPECT_EQ(arbParams->GetNTTPlan(), nullptr)
+      << "only power-of-two cyclotomics have a plan";
+}
+
+// A transform split into blocks with the NativeNTTEngine building blocks
+// gives the same result as the whole transform.
+TEST(UTNTT, native_engine_blocked_transform) {
+  usint m = 8192;
+  usint n = m / 2;
+
+  NativeInteger q = FirstPrime<NativeInteger>(59, m);
+  NativeInteger root = RootOfUnity<NativeInteger>(m, q);
+  auto plan = NativeNTTPlan::Get(root, m, q);
+  ASSERT_NE(plan, nullptr);
+
+  // the plan tables are the ones the map-based transform uses
+  ChineseRemainderTransformFTT<NativeVector>::PreCompute(root, m, q);
+  const NativeVector &rootTable =
+      ChineseRemainderTransformFTT<NativeVector>::
+          m_rootOfUnityReverseTableByModulus[q];
+  const NativeVector &preconRootTable =
+      ChineseRemainderTransformFTT<NativeVector>::
+          m_rootOfUnityPreconReverseTableByModulus[q];
+  const NativeVector &rootInverseTable =
+      ChineseRemainderTransformFTT<NativeVector>::
+          m_rootOfUnityInverseReverseTableByModulus[q];
+  const NativeVector &preconRootInverseTable =
+      ChineseRemainderTransformFTT<NativeVector>::
+          m_rootOfUnityInversePreconReverseTableByModulus[q];
+  usint msb = GetMSB64(n - 1);
+  NativeInteger nInv =
+      ChineseRemainderTransformFTT<NativeVector>::
+          m_cycloOrderInverseTableByModulus[q][msb];
+  NativeInteger nInvPrecon =
+      ChineseRemainderTransformFTT<NativeVector>::
+          m_cycloOrderInversePreconTableByModulus[q][msb];
+
+  auto w = reinterpret_cast<const uint64_t *>(&rootTable[0]);
+  auto wPrecon = reinterpret_cast<const uint64_t *>(&preconRootTable[0]);
+  auto wInv = reinterpret_cast<const uint64_t *>(&rootInverseTable[0]);
+  auto wInvPrecon =
+      reinterpret_cast<const uint64_t *>(&preconRootInverseTable[0]);
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  dug.SetModulus(q);
+  NativeVector x = dug.GenerateVector(n);
+  NativeVector expected(x);
+  plan->ForwardTransformToBitReverseInPlace(&expected);
+
+  for (usint numBlocks = 2; numBlocks <= 32; numBlocks <<= 1) {
+    NativeVector y(x);
+    auto data = reinterpret_cast<uint64_t *>(&y[0]);
+    for (usint s = 1; s < numBlocks; s <<= 1) {
+      usint t = n / (2 * s);
+      NativeNTTEngine::ForwardTransformStageSlice(w, wPrecon, q.ConvertToInt(),
+                                                  n, s, 0, t / 2, data);
+      NativeNTTEngine::ForwardTransformStageSlice(w, wPrecon, q.ConvertToInt(),
+                                                  n, s, t / 2, t, data);
+    }
+    for (usint b = 0; b < numBlocks; b++) {
+      NativeNTTEngine::ForwardTransformBlock(w, wPrecon, q.ConvertToInt(), n,
+                                             numBlocks, b, data);
+    }
+    EXPECT_EQ(expected, y) << "forward transform in " << numBlocks
+                           << " blocks";
+
+    for (usint b = 0; b < numBlocks; b++) {
+      NativeNTTEngine::InverseTransformBlock(wInv, wInvPrecon,
+                                             q.ConvertToInt(), n, numBlocks, b,
+                                             data);
+    }
+    for (usint s = numBlocks >> 1; s >= 1; s >>= 1) {
+      usint t = n / (2 * s);
+      NativeNTTEngine::InverseTransformStageSlice(
+          wInv, wInvPrecon, q.ConvertToInt(), n, s, 0, t / 2, data);
+      NativeNTTEngine::InverseTransformStageSlice(
+          wInv, wInvPrecon, q.ConvertToInt(), n, s, t / 2, t, data);
+    }
+    NativeNTTEngine::InverseTransformScale(nInv.ConvertToInt(),
+                                           nInvPrecon.ConvertToInt(),
+                                           q.ConvertToInt(), 0, n, data);
+    EXPECT_EQ(x, y) << "inverse transform in " << numBlocks << " blocks";
+  }
+}
+
+// The blocked algorithm (radix-4 passes, then in-cache blocks) gives the same
+// result as the radix-2 one on every engine.
+TEST(UTNTT, native_engine_blocked_algorithm) {
+  for (usint m : {1 << 14, 1 << 16, 1 << 17}) {
+    usint n = m / 2;
+    std::vector<NativeInteger> moduli = {FirstPrime<NativeInteger>(59, m)};
+    if (m == 1 << 16) {
+      // the largest modulus of the 52-bit kernels
+      NativeInteger smallMax =
+          PreviousPrime<NativeInteger>(FirstPrime<NativeInteger>(50, m), m);
+      ASSERT_LT(smallMax, NativeInteger(1) << 50);
+      moduli.push_back(smallMax);
+    }
+
+    for (const NativeInteger &q : moduli) {
+      NativeInteger root = RootOfUnity<NativeInteger>(m, q);
+      auto plan = NativeNTTPlan::Get(root, m, q);
+      ASSERT_NE(plan, nullptr);
+
+      DiscreteUniformGeneratorImpl<NativeVector> dug;
+      dug.SetModulus(q);
+      NativeVector x = dug.GenerateVector(n);
+
+      for (SIMDEngine engine :
+           {SIMD_PORTABLE, SIMD_AVX2, SIMD_AVX512, SIMD_AVX512IFMA}) {
+        if (!SIMDControls::IsSupported(engine)) {
+          continue;
+        }
+        SIMDControls::SetEngine(engine);
+
+        NativeNTTEngine::SetAlgorithm(NTT_RADIX2);
+        NativeVector expected(x);
+        plan->ForwardTransformToBitReverseInPlace(&expected);
+
+        NativeNTTEngine::SetAlgorithm(NTT_BLOCKED);
+        NativeVector y(x);
+        plan->ForwardTransformToBitReverseInPlace(&y);
+        EXPECT_EQ(expected, y) << "engine " << engine << ", ring dimension "
+                               << n << ", modulus " << q;
+        plan->InverseTransformFromBitReverseInPlace(&y);
+        EXPECT_EQ(x, y) << "engine " << engine << ", ring dimension " << n
+                        << ", modulus " << q;
+      }
+    }
+    NativeNTTEngine::SetAlgorithm(NTT_AUTO);
+    SIMDControls::SetEngine(SIMD_AUTO);
+  }
+}
+
+// Switching the format of several DCRTPolys in one batch matches switching
+// them one tower at a time.
+TEST(UTNTT, dcrtpoly_batch_switch_format) {
+  usint m = 8192;
+  usint towers = 3;
+  auto params = std::make_shared<ILDCRTParams<BigInteger>>(m, towers, 50);
+
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  DCRTPoly a(dug, params, Format::COEFFICIENT);
+  DCRTPoly b(dug, params, Format::EVALUATION);
+
+  DCRTPoly aExpected(a), bExpected(b);
+  for (usint i = 0; i < towers; i++) {
+    aExpected.ElementAtIndex(i).SwitchFormat();
+    bExpected.ElementAtIndex(i).SwitchFormat();
+  }
+
+  DCRTPoly::SwitchFormat({&a, &b});
+  EXPECT_EQ(Format::EVALUATION, a.GetFormat());
+  EXPECT_EQ(Format::COEFFICIENT, b.GetFormat());
+  for (usint i = 0; i < towers; i++) {
+    EXPECT_EQ(aExpected.GetElementAtIndex(i), a.GetElementAtIndex(i));
+    EXPECT_EQ(bExpected.GetElementAtIndex(i), b.GetElementAtIndex(i));
+  }
+}
+
+// The fused negacyclic product matches transforming, multiplying and
+// transforming back, for both formats of the second operand.
+TEST(UTNTT, negacyclic_multiply) {
+  for (usint m : {16, 2048, 1 << 15}) {
+    NativeInteger q = FirstPrime<NativeInteger>(59, m);
+    NativeInteger root = RootOfUnity<NativeInteger>(m, q);
+    auto params = std::make_shared<ILNativeParams>(m, q, root);
+
+    DiscreteUniformGeneratorImpl<NativeVector> dug;
+    NativePoly a(dug, params, Format::COEFFICIENT);
+    NativePoly b(dug, params, Format::COEFFICIENT);
+
+    NativePoly aEval(a), bEval(b);
+    aEval.SwitchFormat();
+    bEval.SwitchFormat();
+    NativePoly expected = aEval * bEval;
+    expected.SwitchFormat();
+
+    NativePoly product = a.NegacyclicMultiply(b);
+    EXPECT_EQ(Format::COEFFICIENT, product.GetFormat());
+    EXPECT_EQ(expected, product) << "coefficient operand, order " << m;
+    EXPECT_EQ(expected, a.NegacyclicMultiply(bEval))
+        << "evaluation operand, order " << m;
+  }
+
+  // X * X^(n-1) = -1
+  usint m = 16;
+  auto params = std::make_shared<ILNativeParams>(m, 17, 3);
+  NativePoly x(params, Format::COEFFICIENT, true), y(x);
+  x[1] = 1;
+  y[m / 2 - 1] = 1;
+  NativePoly minusOne(params, Format::COEFFICIENT, true);
+  minusOne[0] = 16;
+  EXPECT_EQ(minusOne, x.NegacyclicMultiply(y));
+
+  auto dcrtParams = std::make_shared<ILDCRTParams<BigInteger>>(4096, 3, 50);
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  DCRTPoly c(dug, dcrtParams, Format::COEFFICIENT);
+  DCRTPoly d(dug, dcrtParams, Format::COEFFICIENT);
+  DCRTPoly product = c.NegacyclicMultiply(d);
+  c.SwitchFormat();
+  d.SwitchFormat();
+  DCRTPoly cd = c * d;
+  cd.SwitchFormat();
+  EXPECT_EQ(cd, product);
+}
+
+// Pruned transforms of polynomials that are zero except at multiples of a
+// stride below a degree bound agree with the full transforms, with every
+// engine and also for a big-integer polynomial (which uses the full
+// transforms internally)
+TEST(UTNTT, pruned_switch_format) {
+  for (usint m : {16, 2048}) {
+    NativeInteger q = FirstPrime<NativeInteger>(59, m);
+    NativeInteger root = RootOfUnity<NativeInteger>(m, q);
+    auto params = std::make_shared<ILNativeParams>(m, q, root);
+    usint n = m / 2;
+
+    DiscreteUniformGeneratorImpl<NativeVector> dug;
+    dug.SetModulus(q);
+    NativePoly random(dug, params, Format::EVALUATION);
+    for (usint stride : {1u, 2u, 4u, n}) {
+      for (usint degree : {1u, 3u, n / 2 + 1, n}) {
+        std::stringstream msg;
+        msg << "order " << m << ", stride " << stride << ", degree "
+            << degree;
+        NativePoly sparse(params, Format::COEFFICIENT, true);
+        NativePoly dense(dug, params, Format::COEFFICIENT);
+        for (usint i = 0; i < degree; i += stride) {
+          sparse[i] = dense[i];
+        }
+        NativePoly expected(sparse);
+        expected.SwitchFormat();
+        NativePoly coefficients(random);
+        coefficients.SwitchFormat();
+        for (usint i = 0; i < n; i++) {
+          if (i % stride != 0 || i >= degree) {
+            coefficients[i] = 0;
+          }
+        }
+
+        for (SIMDEngine engine :
+             {SIMD_PORTABLE, SIMD_AVX2, SIMD_AVX512, SIMD_AVX512IFMA}) {
+          if (!SIMDControls::IsSupported(engine)) {
+            continue;
+          }
+          SIMDControls::SetEngine(engine);
+          // the coefficients outside of the structure are ignored
+          NativePoly x(dense);
+          for (usint i = 0; i < degree; i += stride) {
+            x[i] = sparse[i];
+          }
+          NativePoly pruned(x);
+          pruned.SwitchFormatPruned(stride, degree);
+          EXPECT_EQ(expected, pruned) << msg.str();
+
+          NativeVector values(sparse.GetValues());
+          ChineseRemainderTransformFTT<NativeVector>::
+              ForwardTransformToBitReversePrunedInPlace(root, m, stride,
+                                                        degree, &values);
+          EXPECT_EQ(expected.GetValues(), values) << msg.str();
+
+          pruned = random;
+          pruned.SwitchFormatPruned(stride, degree);
+          EXPECT_EQ(coefficients, pruned) << msg.str();
+        }
+        SIMDControls::SetEngine(SIMD_AUTO);
+      }
+    }
+  }
+
+  BigInteger bigQ = FirstPrime<BigInteger>(60, 16);
+  auto bigParams = std::make_shared<ILParams>(
+      16, bigQ, RootOfUnity<BigInteger>(16, bigQ));
+  DiscreteUniformGeneratorImpl<BigVector> bigDug;
+  bigDug.SetModulus(bigParams->GetModulus());
+  Poly dense(bigDug, bigParams, Format::COEFFICIENT);
+  Poly sparse(bigParams, Format::COEFFICIENT, true);
+  for (usint i = 0; i < 8; i += 2) {
+    sparse[i] = dense[i];
+  }
+  Poly expected(sparse);
+  expected.SwitchFormat();
+  dense.SwitchFormatPruned(2, 8);
+  EXPECT_EQ(expected, dense);
+  dense.SwitchFormatPruned(2, 8);
+  EXPECT_EQ(sparse, dense);
+
+  auto dcrtParams = std::make_shared<ILDCRTParams<BigInteger>>(64, 3, 50);
+  DiscreteUniformGeneratorImpl<NativeVector> dug;
+  DCRTPoly c(dug, dcrtParams, Format::EVALUATION);
+  EXPECT_THROW(c.SwitchFormatPruned(3, 32), math_error);
+  EXPECT_THROW(c.SwitchFormatPruned(2, 33), math_error);
+}
@@ -290,6 +290,40 @@ void serialize_matrix_bigint(const string& msg) {
   DEBUGEXP(newmat);
 }
 
+template <typename V>
+void arb_ntt_plan_test(const string& msg) {
+  usint m = 1800;
+  typename V::Integer modulus(14401);
+  typename V::Integer root("972");
+  typename V::Integer nttModulus("1045889179649");
+  typename V::Integer nttRoot("864331722621");
+  ArbNTTPlan<V> plan(m, modulus, root, nttModulus, nttRoot);
+
+  V input(GetTotient(m), modulus);
+  for (usint i = 0; i < input.GetLength(); i++) {
+    input.at(i) = typename V::Integer(i);
+  }
+
+  stringstream s;
+  ArbNTTPlan<V> deser;
+
+  Serial::Serialize(plan, s, SerType::JSON);
+  Serial::Deserialize(deser, s, SerType::JSON);
+  EXPECT_EQ(plan, deser) << msg << " json ser/deser fails";
+
+  s.str("");
+  deser = ArbNTTPlan<V>();
+  Serial::Serialize(plan, s, SerType::BINARY);
+  Serial::Deserialize(deser, s, SerType::BINARY);
+  EXPECT_EQ(plan, deser) << msg << " binary ser/deser fails";
+  EXPECT_EQ(plan.ForwardTransform(input), deser.ForwardTransform(input))
+      << msg << " deserialized plan transforms differently";
+}
+
+TEST(UTSer, arb_ntt_plan) {
+  RUN_ALL_BACKENDS(arb_ntt_plan_test, "arb_ntt_plan")
+}
+
 TEST(UTSer, serialize_matrix_bigint) {
   RUN_ALL_BACKENDS(serialize_matrix_bigint, "serialize_matrix_bigint")
 }
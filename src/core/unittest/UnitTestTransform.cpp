@@ -343,6 +343,70 @@ void CRT_CHECK_small_ring_precomputed(const string& msg) {
   }
 }
 
+template <typename V>
+void CRT_arb_plan(const string& msg) {
+  usint m = 1800;
+  typename V::Integer modulus(14401);
+  typename V::Integer squareRootOfRoot("972");
+  typename V::Integer bigModulus("1045889179649");
+  typename V::Integer bigRoot("864331722621");
+  usint n = GetTotient(m);
+
+  V input(n, modulus);
+  PRNG gen(1);
+  std::uniform_int_distribution<> dis(0, 14400);
+  for (usint i = 0; i < n; i++) {
+    input.at(i) = typename V::Integer(dis(gen));
+  }
+
+  ArbNTTPlan<V>::Reset();
+  auto plan = ArbNTTPlan<V>::Get(m, modulus, squareRootOfRoot, bigModulus,
+                                 bigRoot);
+  EXPECT_EQ(plan, ArbNTTPlan<V>::Get(m, modulus, squareRootOfRoot, bigModulus,
+                                     bigRoot))
+      << msg << " plan is not shared";
+
+  auto output = ChineseRemainderTransformArb<V>::ForwardTransform(
+      input, squareRootOfRoot, bigModulus, bigRoot, m);
+  EXPECT_EQ(output, plan->ForwardTransform(input)) << msg;
+  EXPECT_EQ(input, plan->InverseTransform(output)) << msg;
+
+  // a plan built elsewhere replaces the shared one
+  auto copy = std::make_shared<const ArbNTTPlan<V>>(
+      m, modulus, squareRootOfRoot, bigModulus, bigRoot);
+  EXPECT_EQ(*plan, *copy) << msg;
+  ArbNTTPlan<V>::Register(copy);
+  EXPECT_EQ(copy, ArbNTTPlan<V>::Get(m, modulus, squareRootOfRoot, bigModulus,
+                                     bigRoot))
+      << msg << " registered plan is not used";
+  EXPECT_EQ(input, ChineseRemainderTransformArb<V>::InverseTransform(
+                       output, squareRootOfRoot, bigModulus, bigRoot, m))
+      << msg;
+
+  // the first transform of a polynomial builds the shared plan of its ring
+  ArbNTTPlan<V>::Reset();
+  auto params = std::make_shared<ILParamsImpl<typename V::Integer>>(
+      m, modulus, squareRootOfRoot, bigModulus, bigRoot);
+  PolyImpl<V> poly(params, COEFFICIENT);
+  poly.SetValues(input, COEFFICIENT);
+  poly.SwitchFormat();
+  EXPECT_EQ(output, poly.GetValues()) << msg;
+  EXPECT_EQ(*copy, *ArbNTTPlan<V>::Get(m, modulus, squareRootOfRoot,
+                                       bigModulus, bigRoot))
+      << msg;
+
+  EXPECT_THROW(ArbNTTPlan<V>::Register(std::make_shared<ArbNTTPlan<V>>()),
+               lbcrypto::math_error)
+      << msg;
+  V wrongModulus(n, bigModulus);
+  EXPECT_THROW(plan->ForwardTransform(wrongModulus), lbcrypto::math_error)
+      << msg;
+}
+
+TEST(UTTransform, CRT_arb_plan) {
+  RUN_ALL_BACKENDS(CRT_arb_plan, "CRT_arb_plan")
+}
+
 TEST(UTTransform, CRT_CHECK_small_ring_precomputed) {
   RUN_ALL_BACKENDS(CRT_CHECK_small_ring_precomputed,
                    "CRT_CHECK_small_ring_precomputed")
@@ -24,6 +24,7 @@
 #ifndef SRC_PKE_CRYPTOCONTEXT_H_
 #define SRC_PKE_CRYPTOCONTEXT_H_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -58,6 +59,83 @@ class CryptoContextImpl;
 template <typename Element>
 using CryptoContext = shared_ptr<CryptoContextImpl<Element>>;
 
+/**
+ * @brief LinearTransformImpl
+ *
+ * The plaintext diagonals of a square matrix, prepared by
+ * CryptoContextImpl::EvalLinearTransformPrecompute for the baby-step
+ * giant-step evaluation in CryptoContextImpl::EvalLinearTransform.
+ *
+ * Diagonal k = giantSteps[a] + babySteps[b] is stored at (a, b), already
+ * rotated by -giantSteps[a], encoded at the level of the input ciphertext and
+ * switched to EVALUATION format. Zero diagonals are stored as nullptr.
+ */
+template <typename Element>
+class LinearTransformImpl {
+ public:
+  LinearTransformImpl(std::vector<int32_t> babySteps,
+                      std::vector<int32_t> giantSteps,
+                      std::vector<std::vector<Plaintext>> diagonals,
+                      uint32_t level)
+      : m_babySteps(std::move(babySteps)),
+        m_giantSteps(std::move(giantSteps)),
+        m_diagonals(std::move(diagonals)),
+        m_level(level) {}
+
+  const std::vector<int32_t>& GetBabySteps() const { return m_babySteps; }
+
+  const std::vector<int32_t>& GetGiantSteps() const { return m_giantSteps; }
+
+  /**
+   * @return the diagonal giantSteps[giant] + babySteps[baby], or nullptr if
+   * it is zero
+   */
+  const Plaintext& GetDiagonal(size_t giant, size_t baby) const {
+    return m_diagonals[giant][baby];
+  }
+
+  /**
+   * @return the level of the ciphertexts the transform can be applied to
+   */
+  uint32_t GetLevel() const { return m_level; }
+
+  /**
+   * GetRotationIndices returns the indices that have to be passed to
+   * EvalAtIndexKeyGen before the transform is evaluated.
+   */
+  std::vector<int32_t> GetRotationIndices() const {
+    std::vector<int32_t> indices;
+    for (size_t b = 0; b < m_babySteps.size(); b++) {
+      if (m_babySteps[b] == 0) continue;
+      for (size_t a = 0; a < m_giantSteps.size(); a++) {
+        if (m_diagonals[a][b] != nullptr) {
+          indices.push_back(m_babySteps[b]);
+          break;
+        }
+      }
+    }
+    for (size_t a = 0; a < m_giantSteps.size(); a++) {
+      if (m_giantSteps[a] == 0) continue;
+      for (size_t b = 0; b < m_babySteps.size(); b++) {
+        if (m_diagonals[a][b] != nullptr) {
+          indices.push_back(m_giantSteps[a]);
+          break;
+        }
+      }
+    }
+    return indices;
+  }
+
+ private:
+  std::vector<int32_t> m_babySteps;
+  std::vector<int32_t> m_giantSteps;
+  std::vector<std::vector<Plaintext>> m_diagonals;
+  uint32_t m_level;
+};
+
+template <typename Element>
+using LinearTransform = shared_ptr<const LinearTransformImpl<Element>>;
+
 /**
  * @brief CryptoContextImpl
  *
@@ -2156,6 +2234,19 @@ class CryptoContextImpl : public Serializable {
   void EvalSumKeyGen(const LPPrivateKey<Element> privateKey,
                      const LPPublicKey<Element> publicKey = nullptr);
 
+  /**
+   * EvalSumRadixKeyGen generates the rotation keys used by EvalSum with a
+   * given radix, for batches up to the batch size of the encoding parameters.
+   * Each of the log_radix(batchSize) reduction steps needs radix - 1 keys.
+   * The keys are added to the EvalAtIndex key map of the private key.
+   *
+   * @param privateKey private key.
+   * @param radix the radix of the reduction, a power of two.
+   * @param publicKey public key (used in NTRU schemes).
+   */
+  void EvalSumRadixKeyGen(const LPPrivateKey<Element> privateKey, usint radix,
+                          const LPPublicKey<Element> publicKey = nullptr);
+
   shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalSumRowsKeyGen(
       const LPPrivateKey<Element> privateKey,
       const LPPublicKey<Element> publicKey = nullptr, usint rowSize = 0,
@@ -2186,6 +2277,21 @@ class CryptoContextImpl : public Serializable {
   Ciphertext<Element> EvalSum(ConstCiphertext<Element> ciphertext,
                               usint batchSize) const;
 
+  /**
+   * Sums all components of the batch in ceil(log_radix(batchSize)) steps.
+   * Each step adds radix - 1 rotations of the running sum, which share one
+   * digit decomposition (EvalAtIndexBatch) and, with Hybrid key switching,
+   * one KeySwitchDown. Keys have to be generated with EvalSumRadixKeyGen for
+   * the same radix.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param batchSize size of the batch, a power of two.
+   * @param radix the radix of the reduction, a power of two.
+   * @return resulting ciphertext
+   */
+  Ciphertext<Element> EvalSum(ConstCiphertext<Element> ciphertext,
+                              usint batchSize, usint radix) const;
+
   Ciphertext<Element> EvalSumRows(
       ConstCiphertext<Element> ciphertext, usint rowSize,
       const std::map<usint, LPEvalKey<Element>>& evalKeys,
@@ -2282,6 +2388,92 @@ class CryptoContextImpl : public Serializable {
     return rv;
   }
 
+  /**
+   * EvalAtIndexBatch rotates one ciphertext by several indices. The rotations
+   * share one digit decomposition (ModUp), and with Hybrid key switching the
+   * results are left in the extended basis QP (see EvalFastRotationExt), so
+   * that the caller can add them with EvalAdd/EvalAddInPlace and pay for a
+   * single KeySwitchDown (ModDown) on the sum. Ciphertexts in QP must not be
+   * used in any other operation. With BV and GHS the results are ordinary
+   * rotated ciphertexts, and KeySwitchDown just copies them.
+   *
+   * @param ciphertext the input ciphertext
+   * @param indices the rotation indices; rotation keys have to be generated
+   * with EvalAtIndexKeyGen for all nonzero indices
+   * @return the rotated ciphertexts, in the order of indices
+   */
+  std::vector<Ciphertext<Element>> EvalAtIndexBatch(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<int32_t>& indices) const {
+    if (ciphertext == nullptr || Mismatched(ciphertext->GetCryptoContext()))
+      PALISADE_THROW(config_error,
+                     "Information passed to EvalAtIndexBatch was not "
+                     "generated with this crypto context");
+
+    auto algo = GetEncryptionAlgorithm();
+    auto digits = algo->EvalFastRotationPrecompute(ciphertext);
+    usint m = GetCyclotomicOrder();
+
+    std::vector<Ciphertext<Element>> rotated;
+    rotated.reserve(indices.size());
+    for (int32_t index : indices)
+      rotated.push_back(
+          algo->EvalFastRotationExt(ciphertext, index, m, digits));
+    return rotated;
+  }
+
+  /**
+   * KeySwitchDown brings a result of EvalAtIndexBatch, or a sum of such
+   * results, back from the extended basis QP to Q.
+   *
+   * @param ciphertext the ciphertext in the extended basis
+   * @return the ciphertext in the basis Q
+   */
+  Ciphertext<Element> KeySwitchDown(ConstCiphertext<Element> ciphertext) const {
+    if (ciphertext == nullptr || Mismatched(ciphertext->GetCryptoContext()))
+      PALISADE_THROW(config_error,
+                     "Information passed to KeySwitchDown was not generated "
+                     "with this crypto context");
+
+    return GetEncryptionAlgorithm()->KeySwitchDown(ciphertext);
+  }
+
+  /**
+   * EvalLinearTransformPrecompute prepares the diagonals of a square matrix A
+   * for EvalLinearTransform. A acts on the ringDim/2 slots that EvalAtIndex
+   * rotates (on both rows of slots for Packed encoding), and diagonals[k]
+   * holds its k-th diagonal, i.e., diagonals[k][i] = A[i][(i + k) mod
+   * (ringDim/2)]. Diagonals close to ringDim/2 are treated as negative
+   * offsets, so banded matrices need few rotations.
+   *
+   * @param diagonals the Packed (BGVrns) or CKKSPacked (CKKS) diagonals; a
+   * nullptr entry stands for a zero diagonal
+   * @param level the level of the ciphertexts the transform will be applied
+   * to, after they have been rescaled to depth 1
+   * @return the precomputed transform; generate rotation keys for its
+   * GetRotationIndices() before evaluating it
+   */
+  LinearTransform<Element> EvalLinearTransformPrecompute(
+      const std::vector<Plaintext>& diagonals, uint32_t level = 0) const;
+
+  /**
+   * EvalLinearTransform multiplies the encrypted slot vector by the matrix
+   * precomputed in EvalLinearTransformPrecompute. The d nonzero diagonals are
+   * split into about sqrt(d) baby steps, which share one hoisted
+   * EvalFastRotationPrecompute, and about sqrt(d) giant steps, so roughly
+   * 2*sqrt(d) key switchings are done instead of d.
+   *
+   * The ciphertext is brought to depth 1 and to the level of the transform
+   * first; a ciphertext already past that level is rejected.
+   *
+   * @param ciphertext the input ciphertext
+   * @param transform the precomputed transform
+   * @return the encrypted matrix-vector product
+   */
+  Ciphertext<Element> EvalLinearTransform(
+      ConstCiphertext<Element> ciphertext,
+      const LinearTransform<Element> transform) const;
+
   /**
    * Merges multiple ciphertexts with encrypted results in slot 0 into a single
    * ciphertext The slot assignment is done based on the order of ciphertexts in
@@ -2340,6 +2532,38 @@ class CryptoContextImpl : public Serializable {
                                        ConstPlaintext plaintext,
                                        usint batchSize) const;
 
+  /**
+   * Evaluates inner product in batched encoding, summing the products with
+   * EvalSum of the given radix.
+   *
+   * @param ciphertext1 first vector.
+   * @param ciphertext2 second vector.
+   * @param batchSize size of the batch to be summed up
+   * @param radix the radix of the reduction, a power of two.
+   * @return resulting ciphertext
+   */
+  Ciphertext<Element> EvalInnerProduct(ConstCiphertext<Element> ciphertext1,
+                                       ConstCiphertext<Element> ciphertext2,
+                                       usint batchSize, usint radix) const {
+    return EvalSum(EvalMult(ciphertext1, ciphertext2), batchSize, radix);
+  }
+
+  /**
+   * Evaluates inner product in batched encoding, summing the products with
+   * EvalSum of the given radix.
+   *
+   * @param ciphertext1 first vector - ciphertext.
+   * @param plaintext second vector - plaintext.
+   * @param batchSize size of the batch to be summed up
+   * @param radix the radix of the reduction, a power of two.
+   * @return resulting ciphertext
+   */
+  Ciphertext<Element> EvalInnerProduct(ConstCiphertext<Element> ciphertext1,
+                                       ConstPlaintext plaintext,
+                                       usint batchSize, usint radix) const {
+    return EvalSum(EvalMult(ciphertext1, plaintext), batchSize, radix);
+  }
+
   /**
    * Method for polynomial evaluation for polynomials represented as power
    * series.
@@ -2364,6 +2588,126 @@ class CryptoContextImpl : public Serializable {
     return rv;
   }
 
+  /**
+   * Method for polynomial evaluation for polynomials represented in the
+   * Chebyshev basis on the interval [a, b].
+   *
+   * @param &cipherText input ciphertext
+   * @param &coefficients is the vector of coefficients of T_0, T_1, ...; the
+   * size of the vector is the degree of the polynomial + 1
+   * @param a lower bound of the interval
+   * @param b upper bound of the interval
+   * @return the result of polynomial evaluation.
+   */
+  virtual Ciphertext<Element> EvalChebyshevSeries(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double>& coefficients, double a, double b) const {
+    if (ciphertext == nullptr ||
+        this->Mismatched(ciphertext->GetCryptoContext()))
+      throw std::logic_error(
+          "Information passed to EvalChebyshevSeries was not generated with "
+          "this crypto context");
+
+    return std::static_pointer_cast<LPPublicKeyEncryptionScheme<Element>>(
+               this->GetEncryptionAlgorithm())
+        ->EvalChebyshevSeries(ciphertext, coefficients, a, b);
+  }
+
+  /**
+   * Evaluates the Chebyshev approximation of degree \p degree of a function
+   * on the interval [a, b]; the slots of the input are expected to lie in
+   * [a, b].
+   *
+   * @param func the function to approximate.
+   * @param ciphertext input ciphertext
+   * @param a lower bound of the interval
+   * @param b upper bound of the interval
+   * @param degree the degree of the approximation.
+   * @return the result of the approximation.
+   */
+  Ciphertext<Element> EvalChebyshevFunction(std::function<double(double)> func,
+                                            ConstCiphertext<Element> ciphertext,
+                                            double a, double b,
+                                            uint32_t degree) const {
+    auto coefficients =
+        LPLeveledSHEAlgorithmCKKS<Element>::EvalChebyshevCoefficients(
+            func, a, b, degree);
+    return EvalChebyshevSeries(ciphertext, coefficients, a, b);
+  }
+
+  /**
+   * Evaluates the logistic function 1 / (1 + exp(-x)) on [a, b] using a
+   * Chebyshev approximation of degree \p degree.
+   */
+  Ciphertext<Element> EvalLogistic(ConstCiphertext<Element> ciphertext,
+                                   double a, double b, uint32_t degree) const {
+    return EvalChebyshevFunction(
+        [](double x) { return 1 / (1 + std::exp(-x)); }, ciphertext, a, b,
+        degree);
+  }
+
+  /**
+   * Evaluates exp(x) on [a, b] using a Chebyshev approximation of degree
+   * \p degree.
+   */
+  Ciphertext<Element> EvalExp(ConstCiphertext<Element> ciphertext, double a,
+                              double b, uint32_t degree) const {
+    return EvalChebyshevFunction([](double x) { return std::exp(x); },
+                                 ciphertext, a, b, degree);
+  }
+
+  /**
+   * Evaluates the inverse 1 / x on [a, b] using a Chebyshev approximation of
+   * degree \p degree. The interval must not contain 0.
+   */
+  Ciphertext<Element> EvalDivide(ConstCiphertext<Element> ciphertext, double a,
+                                 double b, uint32_t degree) const {
+    if (a <= 0 && b >= 0)
+      PALISADE_THROW(math_error,
+                     "EvalDivide: The interval [a, b] must not contain 0.");
+    return EvalChebyshevFunction([](double x) { return 1 / x; }, ciphertext,
+                                 a, b, degree);
+  }
+
+  /**
+   * EvalBootstrapSetup precomputes the linear transforms and the modular
+   * reduction polynomial used by CKKS bootstrapping. The FHE feature has to be
+   * enabled.
+   *
+   * @param levelBudget the number of levels used by {CoeffToSlot,
+   * SlotToCoeff}.
+   */
+  void EvalBootstrapSetup(const std::vector<uint32_t>& levelBudget = {3, 3}) {
+    GetEncryptionAlgorithm()->EvalBootstrapSetup(GetCryptoParameters(),
+                                                 levelBudget);
+  }
+
+  /**
+   * EvalBootstrapKeyGen generates the rotation and conjugation keys used by
+   * EvalBootstrap and adds them to the automorphism keys of privateKey.
+   *
+   * @param privateKey private key.
+   */
+  void EvalBootstrapKeyGen(const LPPrivateKey<Element> privateKey);
+
+  /**
+   * EvalBootstrap refreshes a ciphertext that has run out of levels. The
+   * refreshed ciphertext is at level
+   * LPAlgorithmFHECKKS::GetBootstrapDepth(levelBudget, mode).
+   *
+   * @param ciphertext input ciphertext.
+   * @return the refreshed ciphertext.
+   */
+  Ciphertext<Element> EvalBootstrap(ConstCiphertext<Element> ciphertext) const {
+    if (ciphertext == nullptr || Mismatched(ciphertext->GetCryptoContext()))
+      PALISADE_THROW(config_error,
+                     "Information passed to EvalBootstrap was not generated "
+                     "with this crypto context");
+
+    const auto& evalKeys = GetEvalAutomorphismKeyMap(ciphertext->GetKeyTag());
+    return GetEncryptionAlgorithm()->EvalBootstrap(ciphertext, evalKeys);
+  }
+
   /**
    * KeySwitch - PALISADE KeySwitch method
    * @param keySwitchHint - reference to KeySwitchHint
@@ -3224,6 +3568,37 @@ class CryptoContextFactory {
       int maxDepth = 2, usint firstModSize = FIRSTMODSIZE,
       usint relinWindow = 0, MODE mode = OPTIMIZED);
 
+  /**
+   * Construct a PALISADE CryptoContextImpl for the CKKS Scheme with enough
+   * levels for bootstrapping. The modulus chain supports the levels consumed
+   * by bootstrapping plus levelsAfterBootstrap; HYBRID key switching is used.
+   * The FHE feature still has to be enabled before EvalBootstrapSetup.
+   *
+   * @param levelsAfterBootstrap the multiplicative depth available after
+   * bootstrapping
+   * @param scalingFactorBits the size of the scaling factor in bits
+   * @param batchSize the number of slots being used in the ciphertext
+   * @param stdLevel the standard security level we want the scheme to satisfy
+   * @param ringDim the ring dimension (if not specified selected automatically
+   * based on stdLevel)
+   * @param levelBudget the number of levels used by {CoeffToSlot,
+   * SlotToCoeff}; pass the same value to EvalBootstrapSetup
+   * @param rsTech rescaling technique to use (e.g., APPROXRESCALE or
+   * EXACTRESCALE)
+   * @param numLargeDigits the number of big digits to use in HYBRID key
+   * switching
+   * @param firstModSize the bit-length of the first modulus
+   * @param mode SPARSE (recommended for bootstrapping), OPTIMIZED or RLWE
+   * @return new context
+   */
+  static CryptoContext<Element> genCryptoContextCKKSWithBootstrap(
+      usint levelsAfterBootstrap, usint scalingFactorBits, usint batchSize,
+      SecurityLevel stdLevel = HEStd_128_classic, usint ringDim = 0,
+      const std::vector<uint32_t>& levelBudget = {3, 3},
+      enum RescalingTechnique rsTech = DEFAULTRSTECH,
+      uint32_t numLargeDigits = 0, usint firstModSize = FIRSTMODSIZE,
+      MODE mode = SPARSE);
+
   /**
    * construct a PALISADE CryptoContextImpl for the BGVrns Scheme
    * @param plaintextmodulus
@@ -1222,6 +1222,24 @@ class LPLeveledSHEAlgorithm {
     PALISADE_THROW(config_error, "EvalPoly is not supported for the scheme.");
   }
 
+  /**
+   * Method for polynomial evaluation for polynomials represented in the
+   * Chebyshev basis on the interval [a, b].
+   *
+   * @param &cipherText input ciphertext
+   * @param &coefficients is the vector of coefficients of T_0, T_1, ...; the
+   * size of the vector is the degree of the polynomial + 1
+   * @param a lower bound of the interval
+   * @param b upper bound of the interval
+   * @return the result of polynomial evaluation.
+   */
+  virtual Ciphertext<Element> EvalChebyshevSeries(
+      ConstCiphertext<Element> cipherText,
+      const std::vector<double> &coefficients, double a, double b) const {
+    PALISADE_THROW(config_error,
+                   "EvalChebyshevSeries is not supported for the scheme.");
+  }
+
   template <class Archive>
   void save(Archive &ar, std::uint32_t const version) const {}
 
@@ -1231,6 +1249,49 @@ class LPLeveledSHEAlgorithm {
   std::string SerializedObjectName() const { return "LeveledSHE"; }
 };
 
+/**
+ * @brief Abstract interface class for LBC FHE (bootstrapping) algorithms
+ * @tparam Element a ring element.
+ */
+template <class Element>
+class LPFHEAlgorithm {
+ public:
+  virtual ~LPFHEAlgorithm() {}
+
+  /**
+   * Precomputes the plaintext constants used by bootstrapping.
+   *
+   * @param cryptoParams the parameters of the crypto context.
+   * @param levelBudget the number of levels consumed by the two linear
+   * transforms of bootstrapping, {encoding, decoding}.
+   */
+  virtual void EvalBootstrapSetup(
+      const shared_ptr<LPCryptoParameters<Element>> cryptoParams,
+      const std::vector<uint32_t> &levelBudget) = 0;
+
+  /**
+   * Generates the automorphism keys needed by bootstrapping; must be called
+   * after EvalBootstrapSetup.
+   *
+   * @param privateKey private key.
+   * @return a map of automorphism keys indexed by automorphism index.
+   */
+  virtual shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalBootstrapKeyGen(
+      const LPPrivateKey<Element> privateKey) const = 0;
+
+  /**
+   * Refreshes the modulus of a ciphertext that has (almost) exhausted its
+   * levels.
+   *
+   * @param ciphertext the input ciphertext.
+   * @param evalKeys the automorphism keys generated by EvalBootstrapKeyGen.
+   * @return a ciphertext encrypting the same message with more levels.
+   */
+  virtual Ciphertext<Element> EvalBootstrap(
+      ConstCiphertext<Element> ciphertext,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const = 0;
+};
+
 /**
  * @brief Abstract interface class for LBC PRE algorithms
  * @tparam Element a ring element.
@@ -2288,6 +2349,39 @@ class LPSHEAlgorithm {
     PALISADE_THROW(not_implemented_error, errMsg);
   }
 
+  /**
+   * Virtual function for hoisted automorphisms that skip the final ModDown.
+   * The result stays in the extended basis QP and can only be added to other
+   * such results before KeySwitchDown is applied to the sum.
+   *
+   * @param ct the input ciphertext to perform the automorphism on
+   * @param index the index of the rotation
+   * @param m is the cyclotomic order
+   * @param digits the digit decomposition created by
+   * EvalFastRotationPrecompute at the precomputation step.
+   */
+  virtual Ciphertext<Element> EvalFastRotationExt(
+      ConstCiphertext<Element> cipherText, const usint index, const usint m,
+      const shared_ptr<vector<Element>> digits) const {
+    std::string errMsg =
+        "LPSHEAlgorithm::EvalFastRotationExt is not implemented for this "
+        "Scheme.";
+    PALISADE_THROW(not_implemented_error, errMsg);
+  }
+
+  /**
+   * Virtual function that brings a ciphertext produced by EvalFastRotationExt
+   * (or a sum of them) back from the extended basis QP to Q.
+   *
+   * @param ct the ciphertext in the extended basis
+   */
+  virtual Ciphertext<Element> KeySwitchDown(
+      ConstCiphertext<Element> cipherText) const {
+    std::string errMsg =
+        "LPSHEAlgorithm::KeySwitchDown is not implemented for this Scheme.";
+    PALISADE_THROW(not_implemented_error, errMsg);
+  }
+
   /**
    * Generates evaluation keys for a list of indices
    * Currently works only for power-of-two and cyclic-group cyclotomics
@@ -3239,6 +3333,8 @@ class LPPublicKeyEncryptionScheme {
     if (mask & LEVELEDSHE) Enable(LEVELEDSHE);
 
     if (mask & MULTIPARTY) Enable(MULTIPARTY);
+
+    if (mask & FHE) Enable(FHE);
   }
 
   virtual usint GetEnabled() const {
@@ -3249,6 +3345,7 @@ class LPPublicKeyEncryptionScheme {
     if (m_algorithmSHE != nullptr) flag |= SHE;
     if (m_algorithmLeveledSHE != nullptr) flag |= LEVELEDSHE;
     if (m_algorithmMultiparty != nullptr) flag |= MULTIPARTY;
+    if (m_algorithmFHE != nullptr) flag |= FHE;
 
     return flag;
   }
@@ -4040,6 +4137,32 @@ class LPPublicKeyEncryptionScheme {
                    "EvalFastRotation operation has not been enabled");
   }
 
+  virtual Ciphertext<Element> EvalFastRotationExt(
+      ConstCiphertext<Element> ciphertext, const usint index, const usint m,
+      const shared_ptr<vector<Element>> digits) const {
+    if (m_algorithmSHE) {
+      if (!ciphertext)
+        PALISADE_THROW(config_error, "Input ciphertext is nullptr");
+      auto ct =
+          m_algorithmSHE->EvalFastRotationExt(ciphertext, index, m, digits);
+      return ct;
+    }
+    PALISADE_THROW(config_error,
+                   "EvalFastRotationExt operation has not been enabled");
+  }
+
+  virtual Ciphertext<Element> KeySwitchDown(
+      ConstCiphertext<Element> ciphertext) const {
+    if (m_algorithmSHE) {
+      if (!ciphertext)
+        PALISADE_THROW(config_error, "Input ciphertext is nullptr");
+      auto ct = m_algorithmSHE->KeySwitchDown(ciphertext);
+      return ct;
+    }
+    PALISADE_THROW(config_error,
+                   "KeySwitchDown operation has not been enabled");
+  }
+
   virtual shared_ptr<std::map<usint, LPEvalKey<Element>>>
   EvalAutomorphismKeyGen(const LPPrivateKey<Element> privateKey,
                          const std::vector<usint> &indexList) const {
@@ -4320,7 +4443,35 @@ class LPPublicKeyEncryptionScheme {
   /////////////////////////////////////////
   // the functions below are wrappers for things in LPFHEAlgorithm (FHE)
   //
-  // TODO: Add Bootstrap and any other FHE methods
+
+  virtual void EvalBootstrapSetup(
+      const shared_ptr<LPCryptoParameters<Element>> cryptoParams,
+      const std::vector<uint32_t> &levelBudget) {
+    if (m_algorithmFHE) {
+      return m_algorithmFHE->EvalBootstrapSetup(cryptoParams, levelBudget);
+    }
+    PALISADE_THROW(config_error,
+                   "EvalBootstrapSetup operation has not been enabled");
+  }
+
+  virtual shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalBootstrapKeyGen(
+      const LPPrivateKey<Element> privateKey) const {
+    if (m_algorithmFHE) {
+      return m_algorithmFHE->EvalBootstrapKeyGen(privateKey);
+    }
+    PALISADE_THROW(config_error,
+                   "EvalBootstrapKeyGen operation has not been enabled");
+  }
+
+  virtual Ciphertext<Element> EvalBootstrap(
+      ConstCiphertext<Element> ciphertext,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const {
+    if (m_algorithmFHE) {
+      return m_algorithmFHE->EvalBootstrap(ciphertext, evalKeys);
+    }
+    PALISADE_THROW(config_error,
+                   "EvalBootstrap operation has not been enabled");
+  }
 
   /////////////////////////////////////////
   // the functions below are wrappers for things in LPSHEAlgorithm (SHE)
@@ -4407,6 +4558,31 @@ class LPPublicKeyEncryptionScheme {
     }
   }
 
+  /**
+   * Method for polynomial evaluation for polynomials represented in the
+   * Chebyshev basis on the interval [a, b].
+   *
+   * @param &cipherText input ciphertext
+   * @param &coefficients is the vector of coefficients of T_0, T_1, ...; the
+   * size of the vector is the degree of the polynomial + 1
+   * @param a lower bound of the interval
+   * @param b upper bound of the interval
+   * @return the result of polynomial evaluation.
+   */
+  Ciphertext<Element> EvalChebyshevSeries(
+      ConstCiphertext<Element> ciphertext,
+      const std::vector<double> &coefficients, double a, double b) const {
+    if (this->m_algorithmLeveledSHE) {
+      if (!ciphertext)
+        PALISADE_THROW(config_error, "Input ciphertext is nullptr");
+      return this->m_algorithmLeveledSHE->EvalChebyshevSeries(
+          ciphertext, coefficients, a, b);
+    } else {
+      PALISADE_THROW(config_error,
+                     "EvalChebyshevSeries operation has not been enabled");
+    }
+  }
+
   /*
    * This exposes CKKS's own ParamsGen through the
    * LPPublicKeyEncryptionSchemeCKKS API. See
@@ -4610,6 +4786,8 @@ class LPPublicKeyEncryptionScheme {
         << (s.m_algorithmLeveledSHE == 0
                 ? "none"
                 : typeid(*s.m_algorithmLeveledSHE).name());
+    out << ", FHE "
+        << (s.m_algorithmFHE == 0 ? "none" : typeid(*s.m_algorithmFHE).name());
     return out;
   }
 
@@ -4619,7 +4797,7 @@ class LPPublicKeyEncryptionScheme {
   std::shared_ptr<LPPREAlgorithm<Element>> m_algorithmPRE;
   std::shared_ptr<LPMultipartyAlgorithm<Element>> m_algorithmMultiparty;
   std::shared_ptr<LPSHEAlgorithm<Element>> m_algorithmSHE;
-  std::shared_ptr<LPLeveledSHEAlgorithm<Element>> m_algorithmLeveledSHE;
+  std::shared_ptr<LPLeveledSHEAlgorithm<Element>> m_algorithmLeveledSHE;  std::shared_ptr<LPFHEAlgorithm<Element>> m_algorithmFHE;
 };
 
 }  // namespace lbcrypto
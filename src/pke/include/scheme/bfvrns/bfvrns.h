@@ -294,6 +294,16 @@ class LPCryptoParametersBFVrns : public LPCryptoParametersRLWE<Element> {
     return m_tQHatInvModqBDivqModtPrecon;
   }
 
+  /**
+   * Gets the decryption ScaleAndRound kernel selected for the moduli q_i and
+   * the plaintext modulus t
+   *
+   * @return the selected kernel
+   */
+  ScaleAndRoundKernel GetScaleAndRoundKernel() const {
+    return m_scaleAndRoundKernel;
+  }
+
   /**
    * Gets the precomputed table of [\floor{Q/t}]_{q_i}
    *
@@ -476,6 +486,9 @@ class LPCryptoParametersBFVrns : public LPCryptoParametersRLWE<Element> {
   // Stores NTL precomputations for [\floor{t*{Q/q_i}^{-1}*B/q_i}]_t
   std::vector<NativeInteger> m_tQHatInvModqBDivqModtPrecon;
 
+  // Decryption ScaleAndRound kernel selected for q_i and t
+  ScaleAndRoundKernel m_scaleAndRoundKernel = nullptr;
+
   // Stores [\floor{Q/t}]_{q_i}
   std::vector<NativeInteger> m_QDivtModq;
 
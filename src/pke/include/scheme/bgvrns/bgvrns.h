@@ -972,8 +972,8 @@ class LPAlgorithmSHEBGVrns : public LPSHEAlgorithm<Element> {
 
   /**
    * Internal function for in-place homomorphic addition of ciphertexts.
-   * This method does not check whether input ciphertexts are
-   * at the same level.
+   * \p ciphertext2 may be at a lower level than \p ciphertext1, in which
+   * case only its towers at the level of \p ciphertext1 are added.
    *
    * @param ciphertext1 first input/output ciphertext.
    * @param ciphertext2 second input ciphertext.
@@ -1477,6 +1477,33 @@ class LPAlgorithmSHEBGVrns : public LPSHEAlgorithm<Element> {
       ConstCiphertext<Element> ciphertext, const usint index, const usint m,
       const shared_ptr<vector<Element>> precomp) const override;
 
+  /**
+   * EvalFastRotationExt is EvalFastRotation without the final ModDown: the
+   * rotated ciphertext, with its first component multiplied by P, is returned
+   * in the extended basis QP. Results that share the digit decomposition can
+   * be added together and brought back to Q with a single KeySwitchDown.
+   * Only Hybrid key switching works in QP; for BV and GHS this is
+   * EvalFastRotation.
+   *
+   * @param ciphertext the input ciphertext to perform the automorphism on
+   * @param index the index of the rotation
+   * @param m is the cyclotomic order
+   * @param precomp the digit decomposition created by
+   * EvalFastRotationPrecompute
+   */
+  Ciphertext<Element> EvalFastRotationExt(
+      ConstCiphertext<Element> ciphertext, const usint index, const usint m,
+      const shared_ptr<vector<Element>> precomp) const override;
+
+  /**
+   * KeySwitchDown applies ModDown to a ciphertext in the extended basis QP
+   * produced by EvalFastRotationExt. Ciphertexts already in Q are copied.
+   *
+   * @param ciphertext the ciphertext in the extended basis
+   */
+  Ciphertext<Element> KeySwitchDown(
+      ConstCiphertext<Element> ciphertext) const override;
+
  private:
   /**
    * EvalFastRotationPrecomputeBV implements the precomputation step of
@@ -28,6 +28,7 @@
 #ifndef LBCRYPTO_CRYPTO_CKKS_H
 #define LBCRYPTO_CRYPTO_CKKS_H
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -1481,6 +1482,33 @@ class LPAlgorithmSHECKKS : public LPSHEAlgorithm<Element> {
       ConstCiphertext<Element> ciphertext, const usint index, const usint m,
       const shared_ptr<vector<Element>> precomp) const override;
 
+  /**
+   * EvalFastRotationExt is EvalFastRotation without the final ModDown: the
+   * rotated ciphertext, with its first component multiplied by P, is returned
+   * in the extended basis QP. Results that share the digit decomposition can
+   * be added together and brought back to Q with a single KeySwitchDown.
+   * Only Hybrid key switching works in QP; for BV and GHS this is
+   * EvalFastRotation.
+   *
+   * @param ciphertext the input ciphertext to perform the automorphism on
+   * @param index the index of the rotation
+   * @param m is the cyclotomic order
+   * @param precomp the digit decomposition created by
+   * EvalFastRotationPrecompute
+   */
+  Ciphertext<Element> EvalFastRotationExt(
+      ConstCiphertext<Element> ciphertext, const usint index, const usint m,
+      const shared_ptr<vector<Element>> precomp) const override;
+
+  /**
+   * KeySwitchDown applies ModDown to a ciphertext in the extended basis QP
+   * produced by EvalFastRotationExt. Ciphertexts already in Q are copied.
+   *
+   * @param ciphertext the ciphertext in the extended basis
+   */
+  Ciphertext<Element> KeySwitchDown(
+      ConstCiphertext<Element> ciphertext) const override;
+
   /**
    * Function used in EXACTRESCALE to change the level of a ciphertext, while
    * at the same time adjusting the scaling factor of the target level.
@@ -2453,7 +2481,8 @@ class LPLeveledSHEAlgorithmCKKS : public LPLeveledSHEAlgorithm<Element> {
 
   /**
    * Method for polynomial evaluation for polynomials represented as power
-   * series.
+   * series. Uses the Paterson-Stockmeyer algorithm, i.e., O(sqrt(degree))
+   * ciphertext multiplications, and consumes ceil(log2(degree)) + 1 levels.
    *
    * @param &cipherText input ciphertext
    * @param &coefficients is the vector of coefficients in the polynomial; the
@@ -2468,6 +2497,64 @@ class LPLeveledSHEAlgorithmCKKS : public LPLeveledSHEAlgorithm<Element> {
     PALISADE_THROW(not_implemented_error, errMsg);
   }
 
+  /**
+   * Method for polynomial evaluation for polynomials represented in the
+   * Chebyshev basis on the interval [a, b]. Uses the Paterson-Stockmeyer
+   * algorithm over the Chebyshev polynomials and consumes
+   * ceil(log2(degree)) + 1 levels, plus one level for the linear change of
+   * variable when [a, b] is not [-1, 1].
+   *
+   * @param &cipherText input ciphertext
+   * @param &coefficients is the vector of coefficients of T_0, T_1, ...; the
+   * size of the vector is the degree of the polynomial + 1
+   * @param a lower bound of the interval
+   * @param b upper bound of the interval
+   * @return the result of polynomial evaluation.
+   */
+  Ciphertext<Element> EvalChebyshevSeries(
+      ConstCiphertext<Element> cipherText,
+      const std::vector<double> &coefficients, double a,
+      double b) const override {
+    std::string errMsg =
+        "LPLeveledSHEAlgorithmCKKS::EvalChebyshevSeries is only supported for "
+        "DCRTPoly.";
+    PALISADE_THROW(not_implemented_error, errMsg);
+  }
+
+  /**
+   * Returns the coefficients of the Chebyshev interpolant of func on [a, b],
+   * i.e., the interpolant at the degree + 1 Chebyshev nodes, to be used with
+   * EvalChebyshevSeries.
+   *
+   * @param func the function to approximate.
+   * @param a lower bound of the interval
+   * @param b upper bound of the interval
+   * @param degree the degree of the approximation.
+   * @return the coefficients of T_0, ..., T_degree.
+   */
+  static std::vector<double> EvalChebyshevCoefficients(
+      std::function<double(double)> func, double a, double b,
+      uint32_t degree) {
+    const uint32_t n = degree + 1;
+
+    std::vector<double> values(n);
+    for (uint32_t j = 0; j < n; j++) {
+      double x = std::cos(M_PI * (j + 0.5) / n);
+      values[j] = func((b - a) / 2 * x + (a + b) / 2);
+    }
+
+    std::vector<double> coefficients(n);
+    for (uint32_t k = 0; k < n; k++) {
+      double sum = 0;
+      for (uint32_t j = 0; j < n; j++)
+        sum += values[j] * std::cos(M_PI * k * (j + 0.5) / n);
+      coefficients[k] = 2 * sum / n;
+    }
+    coefficients[0] /= 2;
+
+    return coefficients;
+  }
+
   template <class Archive>
   void save(Archive &ar) const {
     ar(cereal::base_class<LPLeveledSHEAlgorithm<Element>>(this));
@@ -2481,6 +2568,198 @@ class LPLeveledSHEAlgorithmCKKS : public LPLeveledSHEAlgorithm<Element> {
   std::string SerializedObjectName() const { return "CKKSLeveledSHE"; }
 };
 
+/**
+ * @brief Concrete feature class for FHE (bootstrapping) operations in the
+ * CKKS scheme.
+ *
+ * Bootstrapping follows the approach of
+ *   - Cheon J.H., Han K., Kim A., Kim M., Song Y. (2018) Bootstrapping for
+ * Approximate Homomorphic Encryption. In: Nielsen J., Rijmen V. (eds) Advances
+ * in Cryptology – EUROCRYPT 2018. (https://eprint.iacr.org/2018/153.pdf)
+ *   - Han K., Ki D. (2020) Better Bootstrapping for Approximate Homomorphic
+ * Encryption. In: Jarecki S. (eds) Topics in Cryptology – CT-RSA 2020.
+ * (https://eprint.iacr.org/2019/688.pdf)
+ *
+ * A ciphertext is reduced to the first CRT modulus q0 and raised back to the
+ * full modulus chain (ModRaise), which adds an unknown multiple q0 * I of the
+ * first modulus to the plaintext polynomial. CoeffToSlot moves the
+ * coefficients into the slots by evaluating the special inverse FFT as a
+ * product of sparse matrices, EvalMod removes q0 * I by a scaled sine
+ * (Chebyshev interpolant followed by double-angle steps), and SlotToCoeff
+ * evaluates the special FFT to return to the original encoding. Each level
+ * of the linear transforms is evaluated with baby-step giant-step rotations,
+ * where the baby steps share one hoisted key switching precomputation.
+ *
+ * All N/2 slots are refreshed. Sparse ternary secrets (MODE SPARSE) keep the
+ * multiple I small and give the best precision.
+ *
+ * @tparam Element a ring element.
+ */
+template <class Element>
+class LPAlgorithmFHECKKS : public LPFHEAlgorithm<Element> {
+  using ParmType = typename Element::Params;
+
+ public:
+  /**
+   * Default constructor
+   */
+  LPAlgorithmFHECKKS() {}
+
+  virtual ~LPAlgorithmFHECKKS() {}
+
+  /**
+   * Precomputes the plaintext diagonals of CoeffToSlot and SlotToCoeff and
+   * the coefficients of the modular reduction polynomial.
+   *
+   * @param cryptoParams the parameters of the crypto context.
+   * @param levelBudget the number of levels used by {CoeffToSlot,
+   * SlotToCoeff}; each entry is between 1 and log2(N/2). More levels mean
+   * fewer rotations per level.
+   */
+  void EvalBootstrapSetup(
+      const shared_ptr<LPCryptoParameters<Element>> cryptoParams,
+      const std::vector<uint32_t> &levelBudget) override;
+
+  /**
+   * Generates the rotation keys of the linear transforms and the conjugation
+   * key.
+   *
+   * @param privateKey private key.
+   * @return a map of automorphism keys indexed by automorphism index.
+   */
+  shared_ptr<std::map<usint, LPEvalKey<Element>>> EvalBootstrapKeyGen(
+      const LPPrivateKey<Element> privateKey) const override;
+
+  /**
+   * Bootstraps a ciphertext. The real parts of the slots are refreshed and
+   * should be bounded by 1 in absolute value. The result is at level
+   * GetBootstrapDepth(levelBudget, mode).
+   *
+   * @param ciphertext the input ciphertext.
+   * @param evalKeys the automorphism keys generated by EvalBootstrapKeyGen.
+   * @return the refreshed ciphertext.
+   */
+  Ciphertext<Element> EvalBootstrap(
+      ConstCiphertext<Element> ciphertext,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const override;
+
+  /**
+   * Returns the number of levels consumed by bootstrapping.
+   *
+   * @param levelBudget the number of levels of {CoeffToSlot, SlotToCoeff}.
+   * @param mode the secret key distribution.
+   * @return the multiplicative depth of bootstrapping.
+   */
+  static uint32_t GetBootstrapDepth(const std::vector<uint32_t> &levelBudget,
+                                    MODE mode) {
+    uint32_t degree = GetEvalModCoefficients(mode).size() - 1;
+    return levelBudget[0] + levelBudget[1] +
+           static_cast<uint32_t>(std::ceil(std::log2(degree))) + 1 +
+           GetDoubleAngleIterations(mode);
+  }
+
+  /**
+   * Returns the bound K on the multiple of q0 that ModRaise adds to the
+   * scaled coefficients, i.e. |q0 * I| < K * q0.
+   *
+   * @param mode the secret key distribution.
+   */
+  static double GetEvalModBound(MODE mode) {
+    return (mode == SPARSE) ? 16.0 : 512.0;
+  }
+
+  /**
+   * Returns the number of double-angle steps r of EvalMod: the polynomial
+   * approximates cos(2 pi (K x - 1/4) / 2^r) and r squarings recover
+   * sin(2 pi K x).
+   *
+   * @param mode the secret key distribution.
+   */
+  static uint32_t GetDoubleAngleIterations(MODE mode) {
+    return static_cast<uint32_t>(std::log2(GetEvalModBound(mode))) - 1;
+  }
+
+  /**
+   * Returns the Chebyshev coefficients (on [-1, 1]) of the scaled cosine
+   * evaluated before the double-angle steps. The interpolant is truncated
+   * after its last coefficient above 1e-11.
+   *
+   * @param mode the secret key distribution.
+   */
+  static std::vector<double> GetEvalModCoefficients(MODE mode) {
+    const double K = GetEvalModBound(mode);
+    const double scale = std::pow(2.0, GetDoubleAngleIterations(mode));
+
+    std::vector<double> coefficients =
+        LPLeveledSHEAlgorithmCKKS<Element>::EvalChebyshevCoefficients(
+            [K, scale](double x) {
+              return std::cos(2 * M_PI * (K * x - 0.25) / scale);
+            },
+            -1, 1, 119);
+
+    uint32_t degree = coefficients.size() - 1;
+    while (degree > 1 && std::fabs(coefficients[degree]) <= 1e-11) degree--;
+    coefficients.resize(degree + 1);
+    for (auto &c : coefficients)
+      if (std::fabs(c) <= 1e-11) c = 0;
+
+    return coefficients;
+  }
+
+ private:
+  /**
+   * One level of CoeffToSlot or SlotToCoeff. The transform is
+   * sum_a Rot(giantSteps[a], sum_b diagonals[a][b] * Rot(babySteps[b], ct)),
+   * with the diagonals encoded in EVALUATION format at the level of the
+   * input ciphertext.
+   */
+  struct BootstrapStage {
+    std::vector<int32_t> babySteps;
+    std::vector<int32_t> giantSteps;
+    // nullptr marks a zero diagonal
+    std::vector<std::vector<shared_ptr<Element>>> diagonals;
+    uint32_t level = 0;
+  };
+
+  /**
+   * Builds the baby-step giant-step plan of a linear transform given by its
+   * nonzero diagonals and encodes the diagonals at the given level.
+   */
+  BootstrapStage MakeBootstrapStage(
+      const std::map<uint32_t, std::vector<std::complex<double>>> &matrix,
+      const shared_ptr<LPCryptoParametersCKKS<Element>> cryptoParams,
+      uint32_t level) const;
+
+  /**
+   * Applies one level of a linear transform and rescales the result.
+   */
+  Ciphertext<Element> EvalBootstrapStage(
+      ConstCiphertext<Element> ciphertext, const BootstrapStage &stage,
+      const std::map<usint, LPEvalKey<Element>> &evalKeys) const;
+
+  /**
+   * Evaluates the scaled sine sin(2 pi K x) on a ciphertext with real slots
+   * in [-1, 1].
+   */
+  Ciphertext<Element> EvalMod(ConstCiphertext<Element> ciphertext) const;
+
+  /**
+   * Multiplies by the imaginary unit, i.e., by the monomial X^(N/2).
+   */
+  Ciphertext<Element> MultByImaginaryUnit(
+      ConstCiphertext<Element> ciphertext) const;
+
+  std::vector<BootstrapStage> m_coeffToSlot;
+  std::vector<BootstrapStage> m_slotToCoeff;
+  std::vector<double> m_evalModCoefficients;
+  // X^(N/2) in EVALUATION format over the full modulus chain
+  Element m_imaginaryUnit;
+  // scaling factor of a ciphertext reduced to q0, as assumed by SlotToCoeff
+  double m_scalingFactorIn = 0;
+  uint32_t m_slots = 0;
+  uint32_t m_doubleAngleIterations = 0;
+};
+
 /**
  * @brief Main public key encryption scheme for the CKKS/CKKS implementation
  * @tparam Element a ring element.
@@ -157,6 +157,181 @@ DecryptResult CryptoContextImpl<DCRTPoly>::MultipartyDecryptFusion(
   return result;
 }
 
+template <>
+LinearTransform<DCRTPoly>
+CryptoContextImpl<DCRTPoly>::EvalLinearTransformPrecompute(
+    const std::vector<Plaintext>& diagonals, uint32_t level) const {
+  int32_t slots = GetRingDimension() >> 1;
+  if (diagonals.size() > static_cast<size_t>(slots))
+    PALISADE_THROW(config_error,
+                   "EvalLinearTransformPrecompute: there are more diagonals "
+                   "than slots");
+  if (level >= GetElementParams()->GetParams().size())
+    PALISADE_THROW(config_error,
+                   "EvalLinearTransformPrecompute: level " +
+                       std::to_string(level) + " exceeds the modulus chain");
+
+  // Offsets are centered in (-slots/2, slots/2] and split into baby and
+  // giant steps of about the same count.
+  std::vector<int32_t> offsets(diagonals.size());
+  int32_t minOffset = slots;
+  int32_t maxOffset = -slots;
+  for (size_t k = 0; k < diagonals.size(); k++) {
+    offsets[k] = (static_cast<int32_t>(k) > slots / 2)
+                     ? static_cast<int32_t>(k) - slots
+                     : static_cast<int32_t>(k);
+    if (diagonals[k] == nullptr) continue;
+    minOffset = std::min(minOffset, offsets[k]);
+    maxOffset = std::max(maxOffset, offsets[k]);
+  }
+  if (minOffset > maxOffset)
+    PALISADE_THROW(config_error,
+                   "EvalLinearTransformPrecompute: all diagonals are zero");
+
+  uint32_t span = maxOffset - minOffset + 1;
+  uint32_t g = 1;
+  while (g * g < span) g <<= 1;
+  uint32_t giants = (span + g - 1) / g;
+
+  std::vector<int32_t> babySteps(g);
+  for (uint32_t b = 0; b < g; b++) babySteps[b] = b;
+  std::vector<int32_t> giantSteps(giants);
+  for (uint32_t a = 0; a < giants; a++) giantSteps[a] = minOffset + a * g;
+  std::vector<std::vector<Plaintext>> encoded(giants,
+                                              std::vector<Plaintext>(g));
+
+  for (size_t k = 0; k < diagonals.size(); k++) {
+    const Plaintext& diagonal = diagonals[k];
+    if (diagonal == nullptr) continue;
+    uint32_t t = offsets[k] - minOffset;
+    uint32_t a = t / g;
+    int32_t giant = giantSteps[a];
+
+    // pre-rotate by the giant step so it can be applied after the sum
+    Plaintext pt;
+    if (diagonal->GetEncodingType() == CKKSPacked) {
+      std::vector<std::complex<double>> values =
+          diagonal->GetCKKSPackedValue();
+      values.resize(slots);
+      std::vector<std::complex<double>> rotated(slots);
+      for (int32_t p = 0; p < slots; p++)
+        rotated[p] = values[((p - giant) % slots + slots) % slots];
+      pt = MakeCKKSPackedPlaintext(rotated, 1, level);
+    } else if (diagonal->GetEncodingType() == Packed) {
+      // both rows of slots are rotated independently
+      std::vector<int64_t> values = diagonal->GetPackedValue();
+      values.resize(slots << 1);
+      std::vector<int64_t> rotated(slots << 1);
+      for (int32_t row = 0; row < (slots << 1); row += slots) {
+        for (int32_t p = 0; p < slots; p++)
+          rotated[row + p] =
+              values[row + ((p - giant) % slots + slots) % slots];
+      }
+      pt = MakePackedPlaintext(rotated);
+      if (level > 0) pt->GetElement<DCRTPoly>().DropLastElements(level);
+    } else {
+      PALISADE_THROW(type_error,
+                     "EvalLinearTransformPrecompute supports only Packed and "
+                     "CKKSPacked diagonals");
+    }
+    pt->GetElement<DCRTPoly>().SetFormat(Format::EVALUATION);
+    encoded[a][t % g] = pt;
+  }
+
+  return std::make_shared<LinearTransformImpl<DCRTPoly>>(
+      std::move(babySteps), std::move(giantSteps), std::move(encoded), level);
+}
+
+template <>
+Ciphertext<DCRTPoly> CryptoContextImpl<DCRTPoly>::EvalLinearTransform(
+    ConstCiphertext<DCRTPoly> ciphertext,
+    const LinearTransform<DCRTPoly> transform) const {
+  if (ciphertext == nullptr || Mismatched(ciphertext->GetCryptoContext()))
+    PALISADE_THROW(config_error,
+                   "Information passed to EvalLinearTransform was not "
+                   "generated with this crypto context");
+  if (transform == nullptr)
+    PALISADE_THROW(config_error, "EvalLinearTransform: transform is empty");
+
+  // Bring the input to depth 1 and to the level of the diagonals once, so
+  // that the products below neither rescale nor re-encode every rotated copy.
+  uint32_t level = transform->GetLevel();
+  Ciphertext<DCRTPoly> adjusted;
+  if (ciphertext->GetLevel() < level || ciphertext->GetDepth() > 1) {
+    auto algo = GetEncryptionAlgorithm();
+    if (ciphertext->GetEncodingType() == CKKSPacked) {
+      uint32_t towers = ciphertext->GetElements()[0].GetNumOfElements();
+      uint32_t drop =
+          (ciphertext->GetLevel() < level) ? level - ciphertext->GetLevel() : 0;
+      adjusted = algo->Compress(ciphertext, towers - drop);
+    } else {
+      const auto cryptoParamsBGVrns =
+          std::dynamic_pointer_cast<LPCryptoParametersBGVrns<DCRTPoly>>(
+              GetCryptoParameters());
+      adjusted = ciphertext->Clone();
+      if (cryptoParamsBGVrns != nullptr &&
+          cryptoParamsBGVrns->GetModSwitchMethod() == AUTO &&
+          adjusted->GetDepth() > 1)
+        algo->ModReduceInternalInPlace(adjusted);
+      if (adjusted->GetLevel() < level)
+        adjusted = algo->LevelReduceInternal(adjusted, nullptr,
+                                             level - adjusted->GetLevel());
+    }
+  }
+  ConstCiphertext<DCRTPoly> ct = (adjusted != nullptr) ? adjusted : ciphertext;
+  if (ct->GetLevel() != level)
+    PALISADE_THROW(math_error,
+                   "EvalLinearTransform: the ciphertext is at level " +
+                       std::to_string(ct->GetLevel()) +
+                       " but the transform was precomputed for level " +
+                       std::to_string(level) + ".");
+
+  const std::vector<int32_t>& babySteps = transform->GetBabySteps();
+  const std::vector<int32_t>& giantSteps = transform->GetGiantSteps();
+  usint m = GetCyclotomicOrder();
+
+  // all baby steps share one hoisted key switching precomputation
+  shared_ptr<vector<DCRTPoly>> digits;
+  std::vector<shared_ptr<const CiphertextImpl<DCRTPoly>>> babies(
+      babySteps.size());
+  for (size_t b = 0; b < babySteps.size(); b++) {
+    for (size_t a = 0; a < giantSteps.size(); a++) {
+      if (transform->GetDiagonal(a, b) == nullptr) continue;
+      if (babySteps[b] == 0) {
+        babies[b] = ct;
+      } else {
+        if (digits == nullptr) digits = EvalFastRotationPrecompute(ct);
+        babies[b] = EvalFastRotation(ct, babySteps[b], m, digits);
+      }
+      break;
+    }
+  }
+
+  Ciphertext<DCRTPoly> result;
+  for (size_t a = 0; a < giantSteps.size(); a++) {
+    Ciphertext<DCRTPoly> inner;
+    for (size_t b = 0; b < babySteps.size(); b++) {
+      const Plaintext& diagonal = transform->GetDiagonal(a, b);
+      if (diagonal == nullptr) continue;
+      auto product = EvalMult(babies[b], diagonal);
+      if (inner == nullptr)
+        inner = product;
+      else
+        EvalAddInPlace(inner, product);
+    }
+    if (inner == nullptr) continue;
+
+    if (giantSteps[a] != 0) inner = EvalAtIndex(inner, giantSteps[a]);
+
+    if (result == nullptr)
+      result = inner;
+    else
+      EvalAddInPlace(result, inner);
+  }
+
+  return result;
+}
+
 template class CryptoContextFactory<Poly>;
 template class CryptoContextImpl<Poly>;
 template class CryptoObject<Poly>;
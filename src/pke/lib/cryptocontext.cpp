@@ -111,6 +111,41 @@ void CryptoContextImpl<Element>::InsertEvalMultKey(
   GetAllEvalMultKeys()[vectorToInsert[0]->GetKeyTag()] = vectorToInsert;
 }
 
+/**
+ * Returns the rotation indices of each reduction step of EvalSum with the
+ * given radix: the step with stride s adds the rotations by s, 2s, ...,
+ * (radix - 1)s. For Packed encoding, a batch spanning both rows of slots
+ * is summed within the rows, and rowSwap is set to add the two rows with the
+ * automorphism m - 1 at the end, as in the radix-2 EvalSum.
+ */
+static std::vector<std::vector<int32_t>> EvalSumSteps(usint batchSize,
+                                                      usint radix, usint m,
+                                                      bool ckks,
+                                                      bool *rowSwap) {
+  if (radix < 2 || !IsPowerOfTwo(radix))
+    PALISADE_THROW(config_error,
+                   "EvalSum: the radix must be a power of two and at least 2");
+  if (batchSize == 0 || !IsPowerOfTwo(batchSize))
+    PALISADE_THROW(config_error,
+                   "EvalSum: the batch size must be a nonzero power of two");
+
+  usint window = batchSize;
+  *rowSwap = false;
+  if (!ckks && 2 * batchSize >= m) {
+    window >>= 1;
+    *rowSwap = true;
+  }
+
+  std::vector<std::vector<int32_t>> steps;
+  for (usint stride = 1; stride < window; stride *= radix) {
+    usint digits = std::min(radix, window / stride);
+    std::vector<int32_t> indices;
+    for (usint k = 1; k < digits; k++) indices.push_back(k * stride);
+    steps.push_back(indices);
+  }
+  return steps;
+}
+
 template <typename Element>
 void CryptoContextImpl<Element>::EvalSumKeyGen(
     const LPPrivateKey<Element> privateKey,
@@ -134,6 +169,54 @@ void CryptoContextImpl<Element>::EvalSumKeyGen(
   GetAllEvalSumKeys()[privateKey->GetKeyTag()] = evalKeys;
 }
 
+template <typename Element>
+void CryptoContextImpl<Element>::EvalSumRadixKeyGen(
+    const LPPrivateKey<Element> privateKey, usint radix,
+    const LPPublicKey<Element> publicKey) {
+  if (privateKey == nullptr || Mismatched(privateKey->GetCryptoContext())) {
+    PALISADE_THROW(config_error,
+                   "Private key passed to EvalSumRadixKeyGen were not "
+                   "generated with this crypto context");
+  }
+
+  if (publicKey != nullptr &&
+      privateKey->GetKeyTag() != publicKey->GetKeyTag()) {
+    PALISADE_THROW(
+        config_error,
+        "Public key passed to EvalSumRadixKeyGen does not match private key");
+  }
+
+  usint batchSize = GetEncodingParams()->GetBatchSize();
+  if (batchSize == 0)
+    PALISADE_THROW(config_error,
+                   "EvalSumRadixKeyGen: Packed encoding parameters 'batch "
+                   "size' is not set; Please check the EncodingParams passed "
+                   "to the crypto context.");
+
+  usint m = GetCyclotomicOrder();
+  bool rowSwap;
+  std::vector<int32_t> indexList;
+  for (const auto& step : EvalSumSteps(batchSize, radix, m,
+                                       getSchemeId() == "CKKS", &rowSwap))
+    indexList.insert(indexList.end(), step.begin(), step.end());
+
+  auto evalKeys = GetEncryptionAlgorithm()->EvalAtIndexKeyGen(
+      publicKey, privateKey, indexList);
+  if (rowSwap) {
+    auto swapKeys =
+        GetEncryptionAlgorithm()->EvalAutomorphismKeyGen(privateKey, {m - 1});
+    for (auto& key : *swapKeys) (*evalKeys)[key.first] = key.second;
+  }
+
+  // keep the rotation keys generated so far
+  auto& keyMap = evalAutomorphismKeyMap()[privateKey->GetKeyTag()];
+  if (keyMap == nullptr) {
+    keyMap = evalKeys;
+  } else {
+    for (auto& key : *evalKeys) (*keyMap)[key.first] = key.second;
+  }
+}
+
 template <typename Element>
 shared_ptr<std::map<usint, LPEvalKey<Element>>>
 CryptoContextImpl<Element>::EvalSumRowsKeyGen(
@@ -265,6 +348,26 @@ void CryptoContextImpl<Element>::EvalAtIndexKeyGen(
   evalAutomorphismKeyMap()[privateKey->GetKeyTag()] = evalKeys;
 }
 
+template <typename Element>
+void CryptoContextImpl<Element>::EvalBootstrapKeyGen(
+    const LPPrivateKey<Element> privateKey) {
+  if (privateKey == nullptr || Mismatched(privateKey->GetCryptoContext())) {
+    PALISADE_THROW(config_error,
+                   "Private key passed to EvalBootstrapKeyGen was not "
+                   "generated with this crypto context");
+  }
+
+  auto evalKeys = GetEncryptionAlgorithm()->EvalBootstrapKeyGen(privateKey);
+
+  // keep the rotation keys generated so far
+  auto& keyMap = evalAutomorphismKeyMap()[privateKey->GetKeyTag()];
+  if (keyMap == nullptr) {
+    keyMap = evalKeys;
+  } else {
+    for (auto& key : *evalKeys) (*keyMap)[key.first] = key.second;
+  }
+}
+
 template <typename Element>
 const std::map<usint, LPEvalKey<Element>>&
 CryptoContextImpl<Element>::GetEvalAutomorphismKeyMap(const string& keyID) {
@@ -338,6 +441,39 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalSum(
   return rv;
 }
 
+template <typename Element>
+Ciphertext<Element> CryptoContextImpl<Element>::EvalSum(
+    ConstCiphertext<Element> ciphertext, usint batchSize, usint radix) const {
+  if (ciphertext == nullptr || Mismatched(ciphertext->GetCryptoContext()))
+    PALISADE_THROW(config_error,
+                   "Information passed to EvalSum was not generated with this "
+                   "crypto context");
+
+  usint m = GetCyclotomicOrder();
+  bool rowSwap;
+  auto steps = EvalSumSteps(batchSize, radix, m, getSchemeId() == "CKKS",
+                            &rowSwap);
+
+  // the rotations of a step share one decomposition of the running sum,
+  // and their sum is brought back to Q with a single KeySwitchDown
+  Ciphertext<Element> result = ciphertext->Clone();
+  for (const auto& step : steps) {
+    auto rotated = EvalAtIndexBatch(result, step);
+    for (size_t i = 1; i < rotated.size(); i++)
+      EvalAddInPlace(rotated[0], rotated[i]);
+    result = EvalAdd(result, KeySwitchDown(rotated[0]));
+  }
+
+  if (rowSwap) {
+    auto evalKeys = CryptoContextImpl<Element>::GetEvalAutomorphismKeyMap(
+        ciphertext->GetKeyTag());
+    result = EvalAdd(result, GetEncryptionAlgorithm()->EvalAutomorphism(
+                                 result, m - 1, evalKeys));
+  }
+
+  return result;
+}
+
 template <typename Element>
 Ciphertext<Element> CryptoContextImpl<Element>::EvalSumRows(
     ConstCiphertext<Element> ciphertext, usint rowSize,
@@ -413,6 +549,23 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalMerge(
   return rv;
 }
 
+template <typename Element>
+LinearTransform<Element>
+CryptoContextImpl<Element>::EvalLinearTransformPrecompute(
+    const std::vector<Plaintext>& diagonals, uint32_t level) const {
+  PALISADE_THROW(not_implemented_error,
+                 "EvalLinearTransformPrecompute is only supported for "
+                 "DCRTPoly");
+}
+
+template <typename Element>
+Ciphertext<Element> CryptoContextImpl<Element>::EvalLinearTransform(
+    ConstCiphertext<Element> ciphertext,
+    const LinearTransform<Element> transform) const {
+  PALISADE_THROW(not_implemented_error,
+                 "EvalLinearTransform is only supported for DCRTPoly");
+}
+
 template <typename Element>
 Ciphertext<Element> CryptoContextImpl<Element>::EvalInnerProduct(
     ConstCiphertext<Element> ct1, ConstCiphertext<Element> ct2,
@@ -673,6 +673,25 @@ CryptoContext<T> CryptoContextFactory<T>::genCryptoContextCKKS(
   return cc;
 }
 
+template <typename T>
+CryptoContext<T> CryptoContextFactory<T>::genCryptoContextCKKSWithBootstrap(
+    usint levelsAfterBootstrap, usint scalingFactorBits, usint batchSize,
+    SecurityLevel stdLevel, usint ringDim,
+    const std::vector<uint32_t>& levelBudget, RescalingTechnique rsTech,
+    uint32_t numLargeDigits, usint firstModSize, MODE mode) {
+  if (levelBudget.size() != 2)
+    PALISADE_THROW(config_error,
+                   "The level budget should have two entries, for "
+                   "CoeffToSlot and SlotToCoeff.");
+
+  usint depth = levelsAfterBootstrap +
+                LPAlgorithmFHECKKS<T>::GetBootstrapDepth(levelBudget, mode);
+
+  return genCryptoContextCKKS(depth, scalingFactorBits, batchSize, stdLevel,
+                              ringDim, rsTech, HYBRID, numLargeDigits, 2,
+                              firstModSize, 0, mode);
+}
+
 template <>
 CryptoContext<DCRTPoly> CryptoContextFactory<DCRTPoly>::genCryptoContextNull(
     unsigned int m, const PlaintextModulus ptModulus) {
@@ -449,6 +449,9 @@ bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables() {
     }
   }
 
+  m_scaleAndRoundKernel = ScaleAndRoundKernels::SelectKernel(
+      qMSB, sizeQ, GetPlaintextModulus());
+
   // compute the CRT delta table [\floor{Q/t}]_{q_i}
   // used for encryption
 
@@ -955,7 +958,8 @@ DecryptResult LPAlgorithmBFVrns<DCRTPoly>::Decrypt(
   *plaintext =
       b.ScaleAndRound(t, tQHatInvModqDivqModt, tQHatInvModqDivqModtPrecon,
                       tQHatInvModqBDivqModt, tQHatInvModqBDivqModtPrecon,
-                      tQHatInvModqDivqFrac, tQHatInvModqBDivqFrac);
+                      tQHatInvModqDivqFrac, tQHatInvModqBDivqFrac,
+                      cryptoParamsBFVrns->GetScaleAndRoundKernel());
 
   // std::cout << "Decryption time (internal): " << TOC_US(t_total) << " us" <<
   // std::endl;
@@ -1575,7 +1579,8 @@ DecryptResult LPAlgorithmMultipartyBFVrns<DCRTPoly>::MultipartyDecryptFusion(
                                cryptoParams->GettQHatInvModqBDivqModt(),
                                cryptoParams->GettQHatInvModqBDivqModtPrecon(),
                                cryptoParams->GettQHatInvModqDivqFrac(),
-                               cryptoParams->GettQHatInvModqBDivqFrac());
+                               cryptoParams->GettQHatInvModqBDivqFrac(),
+                               cryptoParams->GetScaleAndRoundKernel());
 
   return DecryptResult(plaintext->GetLength());
 }
@@ -1142,26 +1142,27 @@ void LPAlgorithmSHEBGVrns<DCRTPoly>::KeySwitchBVInPlace(
   // to be switched to evaluation format
   cv[0].SetFormat(Format::EVALUATION);
 
-  DCRTPoly ct1;
-
   std::vector<DCRTPoly> digitsC2;
   if (cv.size() == 2) {
     // case of PRE or automorphism
     digitsC2 = cv[1].CRTDecompose(relinWindow);
-    cv[1] = digitsC2[0] * av[0];
+    cv[1] = DCRTPoly(cv[0].GetParams(), Format::EVALUATION, true);
   } else {
     // case of EvalMult
     digitsC2 = cv[2].CRTDecompose(relinWindow);
     cv[1].SetFormat(EVALUATION);
-    cv[1] += digitsC2[0] * av[0];
   }
 
-  cv[0] += digitsC2[0] * bv[0];
-
-  for (usint i = 1; i < digitsC2.size(); ++i) {
-    cv[0] += digitsC2[i] * bv[i];
-    cv[1] += digitsC2[i] * av[i];
+  // fused inner products of the digits with both key components
+  std::vector<const DCRTPoly*> digits(digitsC2.size());
+  std::vector<const DCRTPoly*> bKeys(digitsC2.size()), aKeys(digitsC2.size());
+  for (usint i = 0; i < digitsC2.size(); ++i) {
+    digits[i] = &digitsC2[i];
+    bKeys[i] = &bv[i];
+    aKeys[i] = &av[i];
   }
+  cv[0].ModMulAddEq(digits, bKeys);
+  cv[1].ModMulAddEq(digits, aKeys);
   cv.resize(2);
 }
 
@@ -1603,27 +1604,21 @@ void LPAlgorithmSHEBGVrns<DCRTPoly>::KeySwitchHybridInPlace(
   DCRTPoly cTilda0(paramsQlP, Format::EVALUATION, true);
   DCRTPoly cTilda1(paramsQlP, Format::EVALUATION, true);
 
-  for (uint32_t j = 0; j < numPartQl; j++) {
-    const DCRTPoly &cj = partsCtExt[j];
-    const DCRTPoly &bj = bv[j];
-    const DCRTPoly &aj = av[j];
-
-    for (usint i = 0; i < sizeQl; i++) {
-      const auto &cji = cj.GetElementAtIndex(i);
-      const auto &aji = aj.GetElementAtIndex(i);
-      const auto &bji = bj.GetElementAtIndex(i);
-
-      cTilda0.SetElementAtIndex(i, cTilda0.GetElementAtIndex(i) + cji * bji);
-      cTilda1.SetElementAtIndex(i, cTilda1.GetElementAtIndex(i) + cji * aji);
-    }
-    for (usint i = sizeQl, idx = sizeQ; i < sizeQlP; i++, idx++) {
-      const auto &cji = cj.GetElementAtIndex(i);
-      const auto &aji = aj.GetElementAtIndex(idx);
-      const auto &bji = bj.GetElementAtIndex(idx);
-
-      cTilda0.SetElementAtIndex(i, cTilda0.GetElementAtIndex(i) + cji * bji);
-      cTilda1.SetElementAtIndex(i, cTilda1.GetElementAtIndex(i) + cji * aji);
+  // fused inner products of the digits with both key components, tower by
+  // tower: the towers of P follow all sizeQ towers of Q in the keys
+  usint numPartsExt = partsCtExt.size();
+#pragma omp parallel for
+  for (usint i = 0; i < sizeQlP; i++) {
+    usint keyIdx = (i < sizeQl) ? i : i - sizeQl + sizeQ;
+    vector<const DCRTPoly::PolyType *> digits(numPartsExt);
+    vector<const DCRTPoly::PolyType *> bKeys(numPartsExt), aKeys(numPartsExt);
+    for (usint j = 0; j < numPartsExt; j++) {
+      digits[j] = &partsCtExt[j].GetElementAtIndex(i);
+      bKeys[j] = &bv[j].GetElementAtIndex(keyIdx);
+      aKeys[j] = &av[j].GetElementAtIndex(keyIdx);
     }
+    cTilda0.ElementAtIndex(i).ModMulAddEq(digits, bKeys);
+    cTilda1.ElementAtIndex(i).ModMulAddEq(digits, aKeys);
   }
 
   //cTilda0.SetFormat(Format::COEFFICIENT);
@@ -1956,9 +1951,15 @@ void LPAlgorithmSHEBGVrns<DCRTPoly>::EvalAddInPlace(
     Ciphertext<DCRTPoly>& ciphertext1,
     ConstCiphertext<DCRTPoly> ciphertext2) const {
 
-  auto ciphertext2_clone = ciphertext2->Clone();
-  AdjustLevelsEq(ciphertext1, ciphertext2_clone);
-  EvalAddCoreInPlace(ciphertext1, ciphertext2_clone);
+  usint lvl1 = ciphertext1->GetLevel();
+  usint lvl2 = ciphertext2->GetLevel();
+
+  if (lvl1 < lvl2) {
+    auto algo = ciphertext1->GetCryptoContext()->GetEncryptionAlgorithm();
+    ciphertext1 = algo->LevelReduceInternal(ciphertext1, nullptr, lvl2 - lvl1);
+  }
+
+  EvalAddCoreInPlace(ciphertext1, ciphertext2);
 }
 
 template <>
@@ -2957,6 +2958,157 @@ Ciphertext<DCRTPoly> LPAlgorithmSHEBGVrns<DCRTPoly>::EvalFastRotation(
   }
 }
 
+template <>
+Ciphertext<Poly> LPAlgorithmSHEBGVrns<Poly>::EvalFastRotationExt(
+    ConstCiphertext<Poly> ciphertext, const usint index, const usint m,
+    const shared_ptr<vector<Poly>> precomp) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHEBGVrns<NativePoly>::EvalFastRotationExt(
+    ConstCiphertext<NativePoly> ciphertext, const usint index, const usint m,
+    const shared_ptr<vector<NativePoly>> precomp) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHEBGVrns<DCRTPoly>::EvalFastRotationExt(
+    ConstCiphertext<DCRTPoly> ciphertext, const usint index, const usint m,
+    const shared_ptr<vector<DCRTPoly>> expandedCiphertext) const {
+  const auto cryptoParams =
+      std::static_pointer_cast<LPCryptoParametersBGVrns<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+
+  if (cryptoParams->GetKeySwitchTechnique() != HYBRID)
+    return EvalFastRotation(ciphertext, index, m, expandedCiphertext);
+
+  const std::vector<DCRTPoly> &cv = ciphertext->GetElements();
+  const shared_ptr<ParmType> paramsQlP = (*expandedCiphertext)[0].GetParams();
+
+  size_t sizeQl = cv[0].GetNumOfElements();
+  size_t sizeQlP = paramsQlP->GetParams().size();
+  size_t sizeQ = cryptoParams->GetElementParams()->GetParams().size();
+
+  DCRTPoly cTilda0(paramsQlP, Format::EVALUATION, true);
+  DCRTPoly cTilda1(paramsQlP, Format::EVALUATION, true);
+  const std::vector<NativeInteger> &PModq = cryptoParams->GetPModq();
+
+  // P * c vanishes modulo P, so ModDown maps it back to c exactly
+  if (index == 0) {
+    for (usint i = 0; i < sizeQl; i++) {
+      cTilda0.SetElementAtIndex(i, cv[0].GetElementAtIndex(i) * PModq[i]);
+      cTilda1.SetElementAtIndex(i, cv[1].GetElementAtIndex(i) * PModq[i]);
+    }
+  } else {
+    usint autoIndex = FindAutomorphismIndex2nComplex(index, m);
+
+    const auto &evalKeys =
+        ciphertext->GetCryptoContext()->GetEvalAutomorphismKeyMap(
+            ciphertext->GetKeyTag());
+    auto key = evalKeys.find(autoIndex);
+    if (key == evalKeys.end())
+      PALISADE_THROW(not_available_error,
+                     "EvalFastRotationExt: there is no rotation key for "
+                     "index " +
+                         std::to_string(static_cast<int32_t>(index)));
+
+    const std::vector<DCRTPoly> &bv = key->second->GetBVector();
+    const std::vector<DCRTPoly> &av = key->second->GetAVector();
+
+    const std::vector<usint> &map =
+        GetAutomorphismPermutation(paramsQlP->GetCyclotomicOrder(), autoIndex);
+
+    // tower by tower: psi(c0) * P followed by the fused inner products of the
+    // permuted digits with both key components (the towers of P follow all
+    // sizeQ towers of Q in the keys)
+    usint numPartsExt = expandedCiphertext->size();
+#pragma omp parallel for
+    for (usint i = 0; i < sizeQlP; i++) {
+      usint keyIdx = (i < sizeQl) ? i : i - sizeQl + sizeQ;
+      if (i < sizeQl) {
+        DCRTPoly::PolyType &c0 = cTilda0.ElementAtIndex(i);
+        c0 = cv[0].GetElementAtIndex(i).AutomorphismTransform(autoIndex, map);
+        c0 *= PModq[i];
+      }
+      vector<DCRTPoly::PolyType> psiDigits(numPartsExt);
+      vector<const DCRTPoly::PolyType *> digits(numPartsExt);
+      vector<const DCRTPoly::PolyType *> bKeys(numPartsExt), aKeys(numPartsExt);
+      for (usint j = 0; j < numPartsExt; j++) {
+        psiDigits[j] = (*expandedCiphertext)[j].GetElementAtIndex(i)
+                           .AutomorphismTransform(autoIndex, map);
+        digits[j] = &psiDigits[j];
+        bKeys[j] = &bv[j].GetElementAtIndex(keyIdx);
+        aKeys[j] = &av[j].GetElementAtIndex(keyIdx);
+      }
+      cTilda0.ElementAtIndex(i).ModMulAddEq(digits, bKeys);
+      cTilda1.ElementAtIndex(i).ModMulAddEq(digits, aKeys);
+    }
+  }
+
+  Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
+  result->SetElements({std::move(cTilda0), std::move(cTilda1)});
+  result->SetDepth(ciphertext->GetDepth());
+  result->SetLevel(ciphertext->GetLevel());
+  result->SetScalingFactor(ciphertext->GetScalingFactor());
+
+  return result;
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmSHEBGVrns<Poly>::KeySwitchDown(
+    ConstCiphertext<Poly> ciphertext) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHEBGVrns<NativePoly>::KeySwitchDown(
+    ConstCiphertext<NativePoly> ciphertext) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHEBGVrns<DCRTPoly>::KeySwitchDown(
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  const auto cryptoParams =
+      std::static_pointer_cast<LPCryptoParametersBGVrns<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+
+  const std::vector<DCRTPoly> &cv = ciphertext->GetElements();
+  const shared_ptr<ParmType> paramsQ = cryptoParams->GetElementParams();
+  size_t sizeQl = paramsQ->GetParams().size() - ciphertext->GetLevel();
+  if (cryptoParams->GetKeySwitchTechnique() != HYBRID ||
+      cv[0].GetNumOfElements() == sizeQl)
+    return ciphertext->Clone();
+
+  auto paramsQl = std::make_shared<ParmType>(*paramsQ);
+  for (uint32_t i = 0; i < ciphertext->GetLevel(); i++)
+    paramsQl->PopLastParam();
+  const shared_ptr<ParmType> paramsP = cryptoParams->GetParamsP();
+
+  // Get the plaintext modulus
+  const NativeInteger t(cryptoParams->GetPlaintextModulus());
+
+  std::vector<DCRTPoly> elements;
+  elements.reserve(cv.size());
+  for (const auto &c : cv) {
+    elements.push_back(c.ApproxModDown(
+        paramsQl, paramsP, cryptoParams->GetPInvModq(),
+        cryptoParams->GetPInvModqPrecon(), cryptoParams->GetPHatInvModp(),
+        cryptoParams->GetPHatInvModpPrecon(), cryptoParams->GetPHatModq(),
+        cryptoParams->GetModqBarrettMu(), cryptoParams->GettInvModp(),
+        cryptoParams->GettInvModpPrecon(), t, cryptoParams->GettModqPrecon()));
+  }
+
+  Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
+  result->SetElements(std::move(elements));
+  result->SetDepth(ciphertext->GetDepth());
+  result->SetLevel(ciphertext->GetLevel());
+  result->SetScalingFactor(ciphertext->GetScalingFactor());
+
+  return result;
+}
+
 template <>
 Ciphertext<Poly> LPLeveledSHEAlgorithmBGVrns<Poly>::ComposedEvalMult(
     ConstCiphertext<Poly> ciphertext1, ConstCiphertext<Poly> ciphertext2,
@@ -3591,9 +3743,15 @@ Ciphertext<DCRTPoly> LPLeveledSHEAlgorithmBGVrns<DCRTPoly>::LevelReduceInternal(
   result->SetDepth(ciphertext->GetDepth());
   result->SetLevel(ciphertext->GetLevel() + levels);
 
-  vector<DCRTPoly> copy(ciphertext->GetElements());
+  const vector<DCRTPoly> &cv = ciphertext->GetElements();
+  vector<DCRTPoly> copy;
+  copy.reserve(cv.size());
 
-  for (size_t i = 0; i < copy.size(); i++) copy[i].DropLastElements(levels);
+  // copy only the towers that remain after the level reduction
+  for (size_t i = 0; i < cv.size(); i++) {
+    usint sizeQl = cv[i].GetNumOfElements();
+    copy.emplace_back(cv[i].Towers(0, sizeQl - levels - 1));
+  }
 
   result->SetElements(std::move(copy));
 
@@ -112,14 +112,26 @@ Ciphertext<Element> LPAlgorithmSHEBGVrns<Element>::EvalAddCore(
   return result;
 }
 
+// the towers of b that correspond to those of a; only DCRTPoly ciphertexts
+// can be at different levels
+template <class Element>
+static const Element &TowersMatching(const Element &b, const Element &a) {
+  return b;
+}
+
+static DCRTPoly::ConstTowerRange TowersMatching(const DCRTPoly &b,
+                                                const DCRTPoly &a) {
+  return b.Towers(0, a.GetNumOfElements() - 1);
+}
+
 template <class Element>
 void LPAlgorithmSHEBGVrns<Element>::EvalAddCoreInPlace(
     Ciphertext<Element> &ciphertext1,
     ConstCiphertext<Element> ciphertext2) const {
-  if (ciphertext1->GetLevel() != ciphertext2->GetLevel()) {
+  if (ciphertext1->GetLevel() < ciphertext2->GetLevel()) {
     PALISADE_THROW(config_error,
-                   "EvalAddCore cannot add ciphertexts with different number "
-                   "of CRT components.");
+                   "EvalAddCore cannot add a ciphertext with fewer CRT "
+                   "components to another ciphertext.");
   }
 
   std::vector<Element> &cv1 = ciphertext1->GetElements();
@@ -129,13 +141,15 @@ void LPAlgorithmSHEBGVrns<Element>::EvalAddCoreInPlace(
   size_t c2Size = cv2.size();
   size_t cSmallSize = std::min(c1Size, c2Size);
 
+  // the leading towers of a ciphertext2 at a lower level are added in place
+  // instead of level reducing a clone of it
   for (size_t i = 0; i < cSmallSize; i++) {
-    cv1[i] += cv2[i];
+    cv1[i] += TowersMatching(cv2[i], cv1[0]);
   }
   if (c1Size < c2Size) {
     cv1.reserve(c2Size);
     for (size_t i = c1Size; i < c2Size; i++) {
-      cv1.emplace_back(cv2[i]);
+      cv1.emplace_back(TowersMatching(cv2[i], cv1[0]));
     }
   }
 
@@ -423,13 +437,9 @@ Ciphertext<Element> LPAlgorithmSHEBGVrns<Element>::EvalAutomorphism(
     PALISADE_THROW(config_error, errorMsg + CALLER_INFO);
   }
 
-  usint n = ciphertext->GetElements()[0].GetRingDimension();
-  std::vector<usint> map(n);
-  PrecomputeAutoMap(n, i, &map);
-
   Ciphertext<Element> permutedCiphertext = ciphertext->CloneEmpty();
-  permutedCiphertext->SetElements({std::move(c[0].AutomorphismTransform(i, map)),
-                                   std::move(c[1].AutomorphismTransform(i, map))});
+  permutedCiphertext->SetElements({c[0].AutomorphismTransform(i),
+                                   c[1].AutomorphismTransform(i)});
   permutedCiphertext->SetDepth(ciphertext->GetDepth());
   permutedCiphertext->SetLevel(ciphertext->GetLevel());
 
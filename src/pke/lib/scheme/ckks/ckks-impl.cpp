@@ -1305,28 +1305,21 @@ void LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchHybridInPlace(
   DCRTPoly cTilda0(paramsQlP, Format::EVALUATION, true);
   DCRTPoly cTilda1(paramsQlP, Format::EVALUATION, true);
 
-  for (uint32_t j = 0; j < numPartQl; j++) {
-    const DCRTPoly &cj = partsCtExt[j];
-    const DCRTPoly &bj = bv[j];
-    const DCRTPoly &aj = av[j];
-
-    for (usint i = 0; i < sizeQl; i++) {
-      const auto &cji = cj.GetElementAtIndex(i);
-      const auto &aji = aj.GetElementAtIndex(i);
-      const auto &bji = bj.GetElementAtIndex(i);
-
-      cTilda0.SetElementAtIndex(i, cTilda0.GetElementAtIndex(i) + cji * bji);
-      cTilda1.SetElementAtIndex(i, cTilda1.GetElementAtIndex(i) + cji * aji);
-    }
-
-    for (usint i = sizeQl, idx = sizeQ; i < sizeQlP; i++, idx++) {
-      const auto &cji = cj.GetElementAtIndex(i);
-      const auto &aji = aj.GetElementAtIndex(idx);
-      const auto &bji = bj.GetElementAtIndex(idx);
-
-      cTilda0.SetElementAtIndex(i, cTilda0.GetElementAtIndex(i) + cji * bji);
-      cTilda1.SetElementAtIndex(i, cTilda1.GetElementAtIndex(i) + cji * aji);
+  // fused inner products of the digits with both key components, tower by
+  // tower: the towers of P follow all sizeQ towers of Q in the keys
+  usint numPartsExt = partsCtExt.size();
+#pragma omp parallel for
+  for (usint i = 0; i < sizeQlP; i++) {
+    usint keyIdx = (i < sizeQl) ? i : i - sizeQl + sizeQ;
+    vector<const DCRTPoly::PolyType *> digits(numPartsExt);
+    vector<const DCRTPoly::PolyType *> bKeys(numPartsExt), aKeys(numPartsExt);
+    for (usint j = 0; j < numPartsExt; j++) {
+      digits[j] = &partsCtExt[j].GetElementAtIndex(i);
+      bKeys[j] = &bv[j].GetElementAtIndex(keyIdx);
+      aKeys[j] = &av[j].GetElementAtIndex(keyIdx);
     }
+    cTilda0.ElementAtIndex(i).ModMulAddEq(digits, bKeys);
+    cTilda1.ElementAtIndex(i).ModMulAddEq(digits, aKeys);
   }
 
   // cTilda0.SetFormat(Format::COEFFICIENT);
@@ -1652,19 +1645,23 @@ void LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchBVInPlace(
   if (cv.size() == 2) {
     // case of PRE or automorphism
     digitsC2 = cv[1].CRTDecompose(relinWindow);
-    cv[1] = (av[0] *= digitsC2[0]);
+    cv[1] = DCRTPoly(cv[0].GetParams(), Format::EVALUATION, true);
   } else {
     // case of EvalMult
     digitsC2 = cv[2].CRTDecompose(relinWindow);
     cv[1].SetFormat(Format::EVALUATION);
-    cv[1] += (av[0] *= digitsC2[0]);
   }
 
-  cv[0] += (bv[0] *= digitsC2[0]);
-  for (usint i = 1; i < digitsC2.size(); ++i) {
-    cv[0] += (bv[i] *= digitsC2[i]);
-    cv[1] += (av[i] *= digitsC2[i]);
+  // fused inner products of the digits with both key components
+  std::vector<const DCRTPoly *> digits(digitsC2.size());
+  std::vector<const DCRTPoly *> bKeys(digitsC2.size()), aKeys(digitsC2.size());
+  for (usint i = 0; i < digitsC2.size(); ++i) {
+    digits[i] = &digitsC2[i];
+    bKeys[i] = &bv[i];
+    aKeys[i] = &av[i];
   }
+  cv[0].ModMulAddEq(digits, bKeys);
+  cv[1].ModMulAddEq(digits, aKeys);
   cv.resize(2);
 }
 
@@ -1860,10 +1857,14 @@ Ciphertext<DCRTPoly> LPLeveledSHEAlgorithmCKKS<DCRTPoly>::LevelReduceInternal(
     const LPEvalKey<DCRTPoly> linearKeySwitchHint, size_t levels) const {
   Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
 
-  vector<DCRTPoly> cvLevelReduced(ciphertext->GetElements());
+  const vector<DCRTPoly> &cv = ciphertext->GetElements();
+  vector<DCRTPoly> cvLevelReduced;
+  cvLevelReduced.reserve(cv.size());
 
-  for (size_t i = 0; i < cvLevelReduced.size(); i++) {
-    cvLevelReduced[i].DropLastElements(levels);
+  // copy only the towers that remain after the level reduction
+  for (size_t i = 0; i < cv.size(); i++) {
+    usint sizeQl = cv[i].GetNumOfElements();
+    cvLevelReduced.emplace_back(cv[i].Towers(0, sizeQl - levels - 1));
   }
 
   result->SetElements(std::move(cvLevelReduced));
@@ -1904,105 +1905,179 @@ Ciphertext<DCRTPoly> LPLeveledSHEAlgorithmCKKS<DCRTPoly>::LevelReduce(
   return std::make_shared<CiphertextImpl<DCRTPoly>>(*ciphertext);
 }
 
-template <>
-Ciphertext<DCRTPoly> LPLeveledSHEAlgorithmCKKS<DCRTPoly>::EvalPoly(
-    ConstCiphertext<DCRTPoly> x,
-    const std::vector<double> &coefficients) const {
-  if (coefficients[coefficients.size() - 1] == 0)
-    PALISADE_THROW(
-        math_error,
-        "EvalPoly: The highest-order coefficient cannot be set to 0.");
+/**
+ * Evaluates sum_i coefficients[i] * B_i(x) with the Paterson-Stockmeyer
+ * algorithm, where B_i is the monomial x^i or, if chebyshev is set, the
+ * Chebyshev polynomial T_i(x). For k 2^m >= degree, the baby steps
+ * B_1, ..., B_k and the giant steps B_k, B_2k, ..., B_(k 2^(m-1)) are
+ * computed by squaring/doubling, and the polynomial is split recursively as
+ * q * B_(k 2^i) + r down to leaves of degree at most k, which only need
+ * scalar multiplications. This takes about k + 2^m + m ciphertext
+ * multiplications, and the result is at depth ceil(log2(degree)) + 1 above
+ * the input. The highest-order coefficient must be nonzero.
+ */
+static Ciphertext<DCRTPoly> EvalPolyPS(ConstCiphertext<DCRTPoly> x,
+                                       const std::vector<double> &coefficients,
+                                       bool chebyshev) {
+  size_t degree = coefficients.size() - 1;
 
-  std::vector<Ciphertext<DCRTPoly>> powers(coefficients.size() - 1);
-  std::vector<int32_t> indices(coefficients.size() - 1, 0);
-
-  // set the indices for the powers of x that need to be computed to 1
-  for (size_t i = coefficients.size() - 1; i > 0; i--) {
-    if (IsPowerOfTwo(i)) {
-      indices[i - 1] = 1;
-    } else {  // non-power of 2
-      if (coefficients[i] != 0) {
-        indices[i - 1] = 1;
-        int64_t powerOf2 = 1 << (int64_t)std::floor(std::log2(i));
-        int64_t rem = i % powerOf2;
-        if (indices[rem - 1] == 0) indices[rem - 1] = 1;
-        // while rem is not a power of 2, set indices required to compute rem to
-        // 1
-        while (!IsPowerOfTwo(rem)) {
-          powerOf2 = 1 << (int64_t)std::floor(std::log2(rem));
-          rem = rem % powerOf2;
-          if (indices[rem - 1] == 0) indices[rem - 1] = 1;
-        }
-      }
+  auto cc = x->GetCryptoContext();
+
+  // brings two ciphertexts to the same number of towers for APPROXRESCALE
+  auto align = [&cc](Ciphertext<DCRTPoly> &a, Ciphertext<DCRTPoly> &b) {
+    int levelDiff = a->GetElements()[0].GetNumOfElements() -
+                    b->GetElements()[0].GetNumOfElements();
+    for (int i = 0; i < levelDiff; i++) a = cc->LevelReduce(a, nullptr);
+    for (int i = 0; i < -levelDiff; i++) b = cc->LevelReduce(b, nullptr);
+  };
+  auto mult = [&cc, &align](Ciphertext<DCRTPoly> a, Ciphertext<DCRTPoly> b) {
+    align(a, b);
+    auto product = cc->EvalMult(a, b);
+    cc->ModReduceInPlace(product);
+    return product;
+  };
+  auto add = [&cc, &align](Ciphertext<DCRTPoly> a, Ciphertext<DCRTPoly> b) {
+    align(a, b);
+    return cc->EvalAdd(a, b);
+  };
+  auto addConstant = [&cc](Ciphertext<DCRTPoly> a, double constant) {
+    if (constant < 0) return cc->EvalSub(a, std::fabs(constant));
+    if (constant > 0) return cc->EvalAdd(a, constant);
+    return a;
+  };
+  // 2 a b - c, or 2 a^2 - 1 for the Chebyshev recurrences
+  auto doubleProduct = [&cc, &mult](Ciphertext<DCRTPoly> a,
+                                    Ciphertext<DCRTPoly> b) {
+    auto product = mult(a, b);
+    return cc->EvalAdd(product, product);
+  };
+
+  uint32_t logDegree =
+      static_cast<uint32_t>(std::ceil(std::log2(static_cast<double>(degree))));
+  uint32_t m = logDegree / 2;
+  size_t k = size_t(1) << (logDegree - m);
+
+  // baby steps B_1, ..., B_k, where B_j is at depth ceil(log2(j))
+  std::vector<Ciphertext<DCRTPoly>> baby(k + 1);
+  baby[1] = std::make_shared<CiphertextImpl<DCRTPoly>>(*x);
+  for (size_t j = 2; j <= k; j++) {
+    size_t power = size_t(1) << static_cast<size_t>(std::floor(std::log2(j)));
+    if (!chebyshev) {
+      baby[j] = (power == j) ? mult(baby[j / 2], baby[j / 2])
+                             : mult(baby[power], baby[j - power]);
+    } else if (power == j) {
+      baby[j] = cc->EvalSub(doubleProduct(baby[j / 2], baby[j / 2]), 1.0);
+    } else {
+      baby[j] = cc->EvalSub(doubleProduct(baby[power], baby[j - power]),
+                            baby[2 * power - j]);
     }
   }
 
-  powers[0] = Ciphertext<DCRTPoly>(new CiphertextImpl<DCRTPoly>(*x));
+  // giant steps B_(k 2^i) for i < m
+  std::vector<Ciphertext<DCRTPoly>> giant(m);
+  if (m > 0) giant[0] = baby[k];
+  for (uint32_t i = 1; i < m; i++) {
+    giant[i] = chebyshev
+                   ? cc->EvalSub(doubleProduct(giant[i - 1], giant[i - 1]), 1.0)
+                   : mult(giant[i - 1], giant[i - 1]);
+  }
 
-  auto cc = x->GetCryptoContext();
+  auto trim = [](std::vector<double> &c) {
+    while (c.size() > 1 && c.back() == 0) c.pop_back();
+  };
 
-  // computes all powers for x
-  for (size_t i = 2; i < coefficients.size(); i++) {
-    if (IsPowerOfTwo(i)) {
-      powers[i - 1] = cc->EvalMult(powers[i / 2 - 1], powers[i / 2 - 1]);
-      cc->ModReduceInPlace(powers[i - 1]);
-    } else {  // non-power of 2
-      if (indices[i - 1] == 1) {
-        int64_t powerOf2 = 1 << (int64_t)std::floor(std::log2(i));
-        int64_t rem = i % powerOf2;
-
-        int levelDiff =
-            powers[powerOf2 - 1]->GetElements()[0].GetNumOfElements() -
-            powers[rem - 1]->GetElements()[0].GetNumOfElements();
-        for (int idx = 0; idx < levelDiff; idx++) {
-          powers[rem - 1] = cc->LevelReduce(powers[rem - 1], nullptr);
-        }
+  // evaluates a polynomial of degree in [1, k 2^i]
+  std::function<Ciphertext<DCRTPoly>(std::vector<double>, uint32_t)> eval =
+      [&](std::vector<double> c, uint32_t i) -> Ciphertext<DCRTPoly> {
+    size_t n = (i > 0) ? k << (i - 1) : 0;
+    while (i > 0 && c.size() <= n + 1) {
+      i--;
+      n = (i > 0) ? k << (i - 1) : 0;
+    }
 
-        powers[i - 1] = cc->EvalMult(powers[powerOf2 - 1], powers[rem - 1]);
-        cc->ModReduceInPlace(powers[i - 1]);
+    if (i == 0) {
+      Ciphertext<DCRTPoly> result;
+      for (size_t j = c.size() - 1; j > 0; j--) {
+        if (c[j] == 0) continue;
+        auto term = cc->EvalMult(baby[j], c[j]);
+        result = (result == nullptr) ? term : add(result, term);
       }
+      cc->ModReduceInPlace(result);
+      return addConstant(result, c[0]);
     }
-  }
-
-  // gets the highest depth (lowest number of CRT limbs)
-  int64_t limbs =
-      powers[coefficients.size() - 2]->GetElements()[0].GetNumOfElements();
 
-  // brings all powers of x to the same level
-  for (size_t i = 1; i < coefficients.size() - 1; i++) {
-    if (indices[i - 1] == 1) {
-      int levelDiff =
-          limbs - powers[i - 1]->GetElements()[0].GetNumOfElements();
-      for (int idx = 0; idx < levelDiff; idx++) {
-        powers[i - 1] = cc->LevelReduce(powers[i - 1], nullptr);
+    // c = q * B_n + r with deg(q) <= n and deg(r) < n. For the Chebyshev
+    // basis, T_n T_j = (T_(n+j) + T_(n-j)) / 2.
+    std::vector<double> q(c.begin() + n, c.end());
+    std::vector<double> r(c.begin(), c.begin() + n);
+    if (chebyshev) {
+      for (size_t j = 1; j < q.size(); j++) {
+        q[j] *= 2;
+        r[n - j] -= q[j] / 2;
       }
     }
-  }
+    trim(q);
+    trim(r);
 
-  // perform scalar multiplication for the highest-order term
-  auto result = cc->EvalMult(powers[coefficients.size() - 2],
-                             coefficients[coefficients.size() - 1]);
-
-  // perform scalar multiplication for all other terms and sum them up
-  for (size_t i = 0; i < coefficients.size() - 2; i++) {
-    if (coefficients[i + 1] != 0) {
-      result =
-          cc->EvalAdd(result, cc->EvalMult(powers[i], coefficients[i + 1]));
+    Ciphertext<DCRTPoly> result;
+    if (q.size() > 1) {
+      result = mult(eval(q, i - 1), giant[i - 1]);
+    } else {
+      result = cc->EvalMult(giant[i - 1], q[0]);
+      cc->ModReduceInPlace(result);
     }
-  }
 
-  // Do rescaling after scalar multiplication
-  result = cc->ModReduce(result);
+    if (r.size() > 1) return add(result, eval(r, i - 1));
+    return addConstant(result, r[0]);
+  };
 
-  // adds the free term (at x^0)
-  if (coefficients[0] != 0) {
-    if (coefficients[0] < 0)
-      result = cc->EvalSub(result, std::fabs(coefficients[0]));
-    else
-      result = cc->EvalAdd(result, coefficients[0]);
-  }
+  return eval(coefficients, m);
+}
 
-  return result;
+template <>
+Ciphertext<DCRTPoly> LPLeveledSHEAlgorithmCKKS<DCRTPoly>::EvalPoly(
+    ConstCiphertext<DCRTPoly> x,
+    const std::vector<double> &coefficients) const {
+  if (coefficients.size() < 2)
+    PALISADE_THROW(math_error,
+                   "EvalPoly: The degree of the polynomial must be at least 1.");
+  if (coefficients[coefficients.size() - 1] == 0)
+    PALISADE_THROW(
+        math_error,
+        "EvalPoly: The highest-order coefficient cannot be set to 0.");
+
+  return EvalPolyPS(x, coefficients, false);
+}
+
+template <>
+Ciphertext<DCRTPoly> LPLeveledSHEAlgorithmCKKS<DCRTPoly>::EvalChebyshevSeries(
+    ConstCiphertext<DCRTPoly> x, const std::vector<double> &coefficients,
+    double a, double b) const {
+  if (!(a < b))
+    PALISADE_THROW(math_error,
+                   "EvalChebyshevSeries: The interval [a, b] must satisfy "
+                   "a < b.");
+
+  std::vector<double> c(coefficients);
+  while (c.size() > 1 && c.back() == 0) c.pop_back();
+  if (c.size() < 2)
+    PALISADE_THROW(math_error,
+                   "EvalChebyshevSeries: The degree of the series must be at "
+                   "least 1.");
+
+  if (a == -1 && b == 1) return EvalPolyPS(x, c, true);
+
+  // maps [a, b] to [-1, 1]
+  auto cc = x->GetCryptoContext();
+  auto y = cc->EvalMult(x, 2 / (b - a));
+  cc->ModReduceInPlace(y);
+  double shift = (a + b) / (b - a);
+  if (shift > 0)
+    y = cc->EvalSub(y, shift);
+  else if (shift < 0)
+    y = cc->EvalAdd(y, -shift);
+
+  return EvalPolyPS(y, c, true);
 }
 
 #if NATIVEINT == 128
@@ -2721,9 +2796,20 @@ template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalAddApprox(
     ConstCiphertext<DCRTPoly> ciphertext1,
     ConstCiphertext<DCRTPoly> ciphertext2) const {
-  auto ciphertext1_clone = ciphertext1->Clone();
-  EvalAddApproxInPlace(ciphertext1_clone, ciphertext2);
-  return ciphertext1_clone;
+  auto sizeQl1 = ciphertext1->GetElements()[0].GetNumOfElements();
+  auto sizeQl2 = ciphertext2->GetElements()[0].GetNumOfElements();
+
+  // level reducing while copying avoids cloning the towers that get dropped
+  Ciphertext<DCRTPoly> result;
+  if (sizeQl1 > sizeQl2) {
+    auto algo = ciphertext1->GetCryptoContext()->GetEncryptionAlgorithm();
+    result = algo->LevelReduceInternal(ciphertext1, nullptr, sizeQl1 - sizeQl2);
+  } else {
+    result = ciphertext1->Clone();
+  }
+
+  EvalAddApproxInPlace(result, ciphertext2);
+  return result;
 }
 
 template <>
@@ -3900,10 +3986,9 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationHybrid(
   // Find the automorphism index that corresponds to rotation index index.
   usint autoIndex = FindAutomorphismIndex2nComplex(index, m);
 
-  // Apply the automorphism to the first component of the ciphertext.
-  // DCRTPoly
-  // psiC0(ciphertext->GetElements()[0].AutomorphismTransform(autoIndex));
-  DCRTPoly psiC0(ciphertext->GetElements()[0]);
+  // The automorphism is applied to the first component of the ciphertext
+  // together with the key-switched part at the end.
+  const DCRTPoly &psiC0 = ciphertext->GetElements()[0];
 
   const auto cryptoParams =
       std::static_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
@@ -3911,8 +3996,8 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationHybrid(
 
   Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
 
-  std::vector<DCRTPoly> bv = evalKey->GetBVector();
-  std::vector<DCRTPoly> av = evalKey->GetAVector();
+  const std::vector<DCRTPoly> &bv = evalKey->GetBVector();
+  const std::vector<DCRTPoly> &av = evalKey->GetAVector();
 
   const shared_ptr<ParmType> paramsQl = psiC0.GetParams();
   const shared_ptr<ParmType> paramsP = cryptoParams->GetParamsP();
@@ -3926,8 +4011,7 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationHybrid(
   DCRTPoly cTilda1(paramsQlP, Format::EVALUATION, true);
 
   for (uint32_t j = 0; j < expandedCiphertext->size(); j++) {
-    // DCRTPoly cj((*expandedCiphertext)[j].AutomorphismTransform(autoIndex));
-    DCRTPoly cj((*expandedCiphertext)[j]);
+    const DCRTPoly &cj = (*expandedCiphertext)[j];
     const DCRTPoly &bj = bv[j];
     const DCRTPoly &aj = av[j];
 
@@ -3967,14 +4051,9 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationHybrid(
   // ct0.SetFormat(Format::EVALUATION);
   // ct1.SetFormat(Format::EVALUATION);
 
-  ct0 += psiC0;
-
-  usint n = cryptoParams->GetElementParams()->GetRingDimension();
-  std::vector<usint> map(n);
-  PrecomputeAutoMap(n, autoIndex, &map);
-
-  result->SetElements({ct0.AutomorphismTransform(autoIndex, map),
-                       ct1.AutomorphismTransform(autoIndex, map)});
+  // psi(ct0 + c0) is permuted while adding, without forming the sum
+  result->SetElements({ct0.AutomorphismTransformSum(autoIndex, psiC0),
+                       ct1.AutomorphismTransform(autoIndex)});
 
   result->SetDepth(ciphertext->GetDepth());
   result->SetLevel(ciphertext->GetLevel());
@@ -3991,10 +4070,9 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationGHS(
   // Find the automorphism index that corresponds to rotation index index.
   usint autoIndex = FindAutomorphismIndex2nComplex(index, m);
 
-  // Apply the automorphism to the first component of the ciphertext.
-  // DCRTPoly
-  // psiC0(ciphertext->GetElements()[0].AutomorphismTransform(autoIndex));
-  DCRTPoly psiC0(ciphertext->GetElements()[0]);
+  // The automorphism is applied to the first component of the ciphertext
+  // together with the key-switched part at the end.
+  const DCRTPoly &psiC0 = ciphertext->GetElements()[0];
 
   const auto cryptoParams =
       std::static_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
@@ -4002,8 +4080,8 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationGHS(
 
   Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
 
-  std::vector<DCRTPoly> bv = evalKey->GetBVector();
-  std::vector<DCRTPoly> av = evalKey->GetAVector();
+  const std::vector<DCRTPoly> &bv = evalKey->GetBVector();
+  const std::vector<DCRTPoly> &av = evalKey->GetAVector();
 
   // Applying the automorphism to the expanded ciphertext.
   // DCRTPoly
@@ -4062,14 +4140,9 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationGHS(
   // ct0.SetFormat(Format::EVALUATION);
   // ct1.SetFormat(Format::EVALUATION);
 
-  ct0 += psiC0;
-
-  usint n = cryptoParams->GetElementParams()->GetRingDimension();
-  std::vector<usint> map(n);
-  PrecomputeAutoMap(n, autoIndex, &map);
-
-  result->SetElements({ct0.AutomorphismTransform(autoIndex, map),
-                       ct1.AutomorphismTransform(autoIndex, map)});
+  // psi(ct0 + c0) is permuted while adding, without forming the sum
+  result->SetElements({ct0.AutomorphismTransformSum(autoIndex, psiC0),
+                       ct1.AutomorphismTransform(autoIndex)});
 
   result->SetDepth(ciphertext->GetDepth());
   result->SetLevel(ciphertext->GetLevel());
@@ -4098,70 +4171,42 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationBV(
 
   Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
   const std::vector<DCRTPoly> &cv = ciphertext->GetElements();
-
-  const auto cryptoParams =
-      std::static_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
-          evalKey->GetCryptoParameters());
+  const std::vector<DCRTPoly> &digitsQl = *digits;
 
   // Find the automorphism index that corresponds to rotation index index.
   usint autoIndex = FindAutomorphismIndex2nComplex(index, m);
 
   // Get the parts of the automorphism key
-  std::vector<DCRTPoly> bv = evalKey->GetBVector();
-  std::vector<DCRTPoly> av = evalKey->GetAVector();
-
-  // Drop the unnecessary moduli to get better performance.
-  auto sizeQl = cv[0].GetParams()->GetParams().size();
-  auto sizeQ = bv[0].GetParams()->GetParams().size();
-
-  size_t diffQl = sizeQ - sizeQl;
-  for (size_t k = 0; k < bv.size(); k++) {
-    av[k].DropLastElements(diffQl);
-    bv[k].DropLastElements(diffQl);
-  }
+  const std::vector<DCRTPoly> &bv = evalKey->GetBVector();
+  const std::vector<DCRTPoly> &av = evalKey->GetAVector();
 
-  // Create a copy of the input digit decomposition to avoid
-  // changing the input.
-  std::vector<DCRTPoly> digitsCopy(*digits);
+  // Only the key towers of the current level are used, which are read
+  // through views instead of copying the keys and dropping the rest.
+  usint sizeQl = cv[0].GetNumOfElements();
 
-  /* (2) Apply the automorphism on the digits and the first
-   * component of the input ciphertext p0.
-   * p'_0 = psi(p0)
-   * q'_k = psi(q_k), where q_k are the digits.
-   */
-  /*for (size_t i = 0; i < digitsCopy.size(); i++) {
-    digitsCopy[i] = digitsCopy[i].AutomorphismTransform(autoIndex);
-  }*/
-  // DCRTPoly p0Prime(cv[0].AutomorphismTransform(autoIndex));
-  DCRTPoly p0Prime(cv[0]);
-  DCRTPoly p1DoublePrime;
-
-  /* (3) Do key switching on intermediate ciphertext tmp = (p'_0, p'_1),
+  /* (2) The automorphism psi is applied after key switching, to
+   * p'_0 = p0 and q'_k = q_k, where q_k are the digits.
+   *
+   * (3) Do key switching on intermediate ciphertext tmp = (p'_0, p'_1),
    * where p'_1 = Sum_k( q'_k * D_k ), where D_k is the decomposition
    * constants.
    *
    * p''_0 = Sum_k( q'_k * A_k ), for all k.
    * p''_1 = Sum_k( q'_k * B_k ), for all k.
    */
-  p1DoublePrime = digitsCopy[0] * av[0];
-  auto p0DoublePrime = digitsCopy[0] * bv[0];
+  DCRTPoly p1DoublePrime = digitsQl[0] * av[0].Towers(0, sizeQl - 1);
+  DCRTPoly p0DoublePrime = digitsQl[0] * bv[0].Towers(0, sizeQl - 1);
 
-  for (usint i = 1; i < digitsCopy.size(); ++i) {
-    p0DoublePrime += digitsCopy[i] * bv[i];
-    p1DoublePrime += digitsCopy[i] * av[i];
+  for (usint i = 1; i < digitsQl.size(); ++i) {
+    p0DoublePrime += digitsQl[i] * bv[i].Towers(0, sizeQl - 1);
+    p1DoublePrime += digitsQl[i] * av[i].Towers(0, sizeQl - 1);
   }
 
-  /* Ciphertext c_out = (p'_0 + p''_0, p''_1) is the result of the
-   * automorphism.
+  /* Ciphertext c_out = psi(p'_0 + p''_0, p''_1) is the result of the
+   * automorphism; psi is applied while adding p'_0.
    */
-
-  usint n = cryptoParams->GetElementParams()->GetRingDimension();
-  std::vector<usint> map(n);
-  PrecomputeAutoMap(n, autoIndex, &map);
-
-  result->SetElements(
-      {(p0Prime + p0DoublePrime).AutomorphismTransform(autoIndex, map),
-       p1DoublePrime.AutomorphismTransform(autoIndex, map)});
+  result->SetElements({p0DoublePrime.AutomorphismTransformSum(autoIndex, cv[0]),
+                       p1DoublePrime.AutomorphismTransform(autoIndex)});
 
   result->SetDepth(ciphertext->GetDepth());
   result->SetLevel(ciphertext->GetLevel());
@@ -4217,6 +4262,151 @@ Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotation(
   }
 }
 
+template <>
+Ciphertext<Poly> LPAlgorithmSHECKKS<Poly>::EvalFastRotationExt(
+    ConstCiphertext<Poly> ciphertext, const usint index, const usint m,
+    const shared_ptr<vector<Poly>> digits) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHECKKS<NativePoly>::EvalFastRotationExt(
+    ConstCiphertext<NativePoly> ciphertext, const usint index, const usint m,
+    const shared_ptr<vector<NativePoly>> digits) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::EvalFastRotationExt(
+    ConstCiphertext<DCRTPoly> ciphertext, const usint index, const usint m,
+    const shared_ptr<vector<DCRTPoly>> expandedCiphertext) const {
+  const auto cryptoParams =
+      std::static_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+
+  if (cryptoParams->GetKeySwitchTechnique() != HYBRID)
+    return EvalFastRotation(ciphertext, index, m, expandedCiphertext);
+
+  const std::vector<DCRTPoly> &cv = ciphertext->GetElements();
+  const shared_ptr<ParmType> paramsQlP = (*expandedCiphertext)[0].GetParams();
+
+  size_t sizeQl = cv[0].GetNumOfElements();
+  size_t sizeQlP = paramsQlP->GetParams().size();
+  size_t sizeQ = cryptoParams->GetElementParams()->GetParams().size();
+
+  DCRTPoly cTilda0(paramsQlP, Format::EVALUATION, true);
+  DCRTPoly cTilda1(paramsQlP, Format::EVALUATION, true);
+  const std::vector<NativeInteger> &PModq = cryptoParams->GetPModq();
+
+  // P * c vanishes modulo P, so ModDown maps it back to c exactly
+  if (index == 0) {
+    for (usint i = 0; i < sizeQl; i++) {
+      cTilda0.SetElementAtIndex(i, cv[0].GetElementAtIndex(i) * PModq[i]);
+      cTilda1.SetElementAtIndex(i, cv[1].GetElementAtIndex(i) * PModq[i]);
+    }
+    Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
+    result->SetElements({std::move(cTilda0), std::move(cTilda1)});
+    result->SetDepth(ciphertext->GetDepth());
+    result->SetLevel(ciphertext->GetLevel());
+    result->SetScalingFactor(ciphertext->GetScalingFactor());
+    return result;
+  }
+
+  usint autoIndex = FindAutomorphismIndex2nComplex(index, m);
+
+  const auto &evalKeys =
+      ciphertext->GetCryptoContext()->GetEvalAutomorphismKeyMap(
+          ciphertext->GetKeyTag());
+  auto key = evalKeys.find(autoIndex);
+  if (key == evalKeys.end())
+    PALISADE_THROW(not_available_error,
+                   "EvalFastRotationExt: there is no rotation key for index " +
+                       std::to_string(static_cast<int32_t>(index)));
+
+  const std::vector<DCRTPoly> &bv = key->second->GetBVector();
+  const std::vector<DCRTPoly> &av = key->second->GetAVector();
+
+  // fused inner products of the digits with both key components, tower by
+  // tower: the towers of P follow all sizeQ towers of Q in the keys
+  usint numPartsExt = expandedCiphertext->size();
+#pragma omp parallel for
+  for (usint i = 0; i < sizeQlP; i++) {
+    usint keyIdx = (i < sizeQl) ? i : i - sizeQl + sizeQ;
+    vector<const DCRTPoly::PolyType *> digits(numPartsExt);
+    vector<const DCRTPoly::PolyType *> bKeys(numPartsExt), aKeys(numPartsExt);
+    for (usint j = 0; j < numPartsExt; j++) {
+      digits[j] = &(*expandedCiphertext)[j].GetElementAtIndex(i);
+      bKeys[j] = &bv[j].GetElementAtIndex(keyIdx);
+      aKeys[j] = &av[j].GetElementAtIndex(keyIdx);
+    }
+    cTilda0.ElementAtIndex(i).ModMulAddEq(digits, bKeys);
+    cTilda1.ElementAtIndex(i).ModMulAddEq(digits, aKeys);
+  }
+
+  // as in EvalFastRotationHybrid, the automorphism follows the key switching;
+  // psi(cTilda0 + P * c0) is permuted while adding, and P * c0 has no towers
+  // of P
+  Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
+  result->SetElements(
+      {cTilda0.AutomorphismTransformSumPrefix(autoIndex, cv[0].Times(PModq)),
+       cTilda1.AutomorphismTransform(autoIndex)});
+  result->SetDepth(ciphertext->GetDepth());
+  result->SetLevel(ciphertext->GetLevel());
+  result->SetScalingFactor(ciphertext->GetScalingFactor());
+
+  return result;
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmSHECKKS<Poly>::KeySwitchDown(
+    ConstCiphertext<Poly> ciphertext) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmSHECKKS<NativePoly>::KeySwitchDown(
+    ConstCiphertext<NativePoly> ciphertext) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmSHECKKS<DCRTPoly>::KeySwitchDown(
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  const auto cryptoParams =
+      std::static_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+
+  const std::vector<DCRTPoly> &cv = ciphertext->GetElements();
+  const shared_ptr<ParmType> paramsQ = cryptoParams->GetElementParams();
+  size_t sizeQl = paramsQ->GetParams().size() - ciphertext->GetLevel();
+  if (cryptoParams->GetKeySwitchTechnique() != HYBRID ||
+      cv[0].GetNumOfElements() == sizeQl)
+    return ciphertext->Clone();
+
+  auto paramsQl = std::make_shared<ParmType>(*paramsQ);
+  for (uint32_t i = 0; i < ciphertext->GetLevel(); i++)
+    paramsQl->PopLastParam();
+  const shared_ptr<ParmType> paramsP = cryptoParams->GetParamsP();
+
+  std::vector<DCRTPoly> elements;
+  elements.reserve(cv.size());
+  for (const auto &c : cv) {
+    elements.push_back(c.ApproxModDown(
+        paramsQl, paramsP, cryptoParams->GetPInvModq(),
+        cryptoParams->GetPInvModqPrecon(), cryptoParams->GetPHatInvModp(),
+        cryptoParams->GetPHatInvModpPrecon(), cryptoParams->GetPHatModq(),
+        cryptoParams->GetModqBarrettMu()));
+  }
+
+  Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
+  result->SetElements(std::move(elements));
+  result->SetDepth(ciphertext->GetDepth());
+  result->SetLevel(ciphertext->GetLevel());
+  result->SetScalingFactor(ciphertext->GetScalingFactor());
+
+  return result;
+}
+
 template <>
 LPEvalKey<DCRTPoly> LPAlgorithmPRECKKS<DCRTPoly>::ReKeyGenBV(
     const LPPublicKey<DCRTPoly> newPk,
@@ -4469,4 +4659,524 @@ Ciphertext<DCRTPoly> LPAlgorithmPRECKKS<DCRTPoly>::ReEncrypt(
   }
 }
 
+template <>
+void LPAlgorithmFHECKKS<Poly>::EvalBootstrapSetup(
+    const shared_ptr<LPCryptoParameters<Poly>> cryptoParams,
+    const std::vector<uint32_t> &levelBudget) {
+  NOPOLY
+}
+
+template <>
+void LPAlgorithmFHECKKS<NativePoly>::EvalBootstrapSetup(
+    const shared_ptr<LPCryptoParameters<NativePoly>> cryptoParams,
+    const std::vector<uint32_t> &levelBudget) {
+  NONATIVEPOLY
+}
+
+template <>
+shared_ptr<std::map<usint, LPEvalKey<Poly>>>
+LPAlgorithmFHECKKS<Poly>::EvalBootstrapKeyGen(
+    const LPPrivateKey<Poly> privateKey) const {
+  NOPOLY
+}
+
+template <>
+shared_ptr<std::map<usint, LPEvalKey<NativePoly>>>
+LPAlgorithmFHECKKS<NativePoly>::EvalBootstrapKeyGen(
+    const LPPrivateKey<NativePoly> privateKey) const {
+  NONATIVEPOLY
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmFHECKKS<Poly>::EvalBootstrap(
+    ConstCiphertext<Poly> ciphertext,
+    const std::map<usint, LPEvalKey<Poly>> &evalKeys) const {
+  NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmFHECKKS<NativePoly>::EvalBootstrap(
+    ConstCiphertext<NativePoly> ciphertext,
+    const std::map<usint, LPEvalKey<NativePoly>> &evalKeys) const {
+  NONATIVEPOLY
+}
+
+// Diagonals of one layer of the special FFT used by CKKS encoding (butterflies
+// of length len), without the bit reversal and, for the inverse, without the
+// division by 2. Diagonal k of a matrix A holds A[p][(p + k) mod slots].
+static std::map<uint32_t, std::vector<std::complex<double>>> FFTLayerDiagonals(
+    uint32_t slots, uint32_t len, bool inverse) {
+  uint32_t m = slots << 2;
+  uint32_t lenh = len >> 1;
+  uint32_t lenq = len << 2;
+
+  std::vector<std::complex<double>> roots(lenh);
+  for (uint32_t j = 0, rot = 1; j < lenh; j++, rot = (rot * 5) % m) {
+    double angle = 2 * M_PI * (rot % lenq) / lenq;
+    roots[j] = std::polar(1.0, inverse ? -angle : angle);
+  }
+
+  std::map<uint32_t, std::vector<std::complex<double>>> diagonals;
+  auto &main = diagonals[0];
+  auto &upper = diagonals[lenh];
+  auto &lower = diagonals[slots - lenh];
+  main.resize(slots);
+  upper.resize(slots);
+  lower.resize(slots);
+
+  for (uint32_t i = 0; i < slots; i += len) {
+    for (uint32_t j = 0; j < lenh; j++) {
+      uint32_t p = i + j;
+      uint32_t q = p + lenh;
+      // forward: x[p] + w x[q], x[p] - w x[q]
+      // inverse: x[p] + x[q], w (x[p] - x[q])
+      main[p] = 1.0;
+      upper[p] += inverse ? 1.0 : roots[j];
+      main[q] = -roots[j];
+      lower[q] += inverse ? roots[j] : 1.0;
+    }
+  }
+
+  return diagonals;
+}
+
+// Diagonals of the product a * b (b is applied first).
+static std::map<uint32_t, std::vector<std::complex<double>>> ComposeDiagonals(
+    const std::map<uint32_t, std::vector<std::complex<double>>> &a,
+    const std::map<uint32_t, std::vector<std::complex<double>>> &b,
+    uint32_t slots) {
+  std::map<uint32_t, std::vector<std::complex<double>>> result;
+  for (const auto &da : a) {
+    for (const auto &db : b) {
+      auto &dc = result[(da.first + db.first) % slots];
+      if (dc.empty()) dc.resize(slots);
+      for (uint32_t p = 0; p < slots; p++)
+        dc[p] += da.second[p] * db.second[(p + da.first) % slots];
+    }
+  }
+  return result;
+}
+
+template <>
+LPAlgorithmFHECKKS<DCRTPoly>::BootstrapStage
+LPAlgorithmFHECKKS<DCRTPoly>::MakeBootstrapStage(
+    const std::map<uint32_t, std::vector<std::complex<double>>> &matrix,
+    const shared_ptr<LPCryptoParametersCKKS<DCRTPoly>> cryptoParams,
+    uint32_t level) const {
+  int32_t slots = m_slots;
+
+  // Offsets are centered in (-slots/2, slots/2] and share a power-of-two
+  // stride; the multiples of the stride are split into baby and giant steps.
+  double maxEntry = 0;
+  int32_t stride = slots;
+  std::vector<int32_t> offsets;
+  for (const auto &d : matrix) {
+    int32_t k = d.first;
+    if (k > slots / 2) k -= slots;
+    offsets.push_back(k);
+    if (k != 0) stride = std::min(stride, k & -k);
+    for (const auto &x : d.second) maxEntry = std::max(maxEntry, std::abs(x));
+  }
+  if (stride == slots) stride = 1;
+
+  int32_t minMultiple = *std::min_element(offsets.begin(), offsets.end());
+  int32_t maxMultiple = *std::max_element(offsets.begin(), offsets.end());
+  minMultiple /= stride;
+  maxMultiple /= stride;
+  uint32_t span = maxMultiple - minMultiple + 1;
+  uint32_t g = 1;
+  while (g * g < span) g <<= 1;
+  uint32_t giants = (span + g - 1) / g;
+
+  BootstrapStage stage;
+  stage.level = level;
+  for (uint32_t b = 0; b < g; b++) stage.babySteps.push_back(b * stride);
+  for (uint32_t a = 0; a < giants; a++)
+    stage.giantSteps.push_back((minMultiple + static_cast<int32_t>(a * g)) *
+                               stride);
+  stage.diagonals.assign(giants, std::vector<shared_ptr<DCRTPoly>>(g));
+
+  auto elementParams = std::make_shared<ParmType>(
+      *cryptoParams->GetElementParams());
+  for (uint32_t i = 0; i < level; i++) elementParams->PopLastParam();
+  const auto &nativeParams = elementParams->GetParams();
+  double scale = cryptoParams->GetScalingFactorOfLevel(level);
+  double bound = std::pow(2.0, 63);
+
+  size_t idx = 0;
+  for (const auto &d : matrix) {
+    int32_t t = offsets[idx++] / stride - minMultiple;
+    uint32_t a = t / g;
+    uint32_t b = t % g;
+    int32_t giant = stage.giantSteps[a];
+
+    // pre-rotate by the giant step so it can be applied after the sum
+    std::vector<std::complex<double>> values(slots);
+    double maxDiagonal = 0;
+    for (int32_t p = 0; p < slots; p++) {
+      values[p] = d.second[((p - giant) % slots + slots) % slots];
+      maxDiagonal = std::max(maxDiagonal, std::abs(values[p]));
+    }
+    if (maxDiagonal <= 1e-10 * maxEntry) continue;
+
+    // Encode keeps only real parts, so the complex diagonal is mapped to its
+    // coefficients here directly.
+    DiscreteFourierTransform::FFTSpecialInv(values);
+    DCRTPoly diagonal(elementParams, Format::COEFFICIENT, true);
+    for (size_t i = 0; i < nativeParams.size(); i++) {
+      const NativeInteger &q = nativeParams[i]->GetModulus();
+      NativeVector vec(slots << 1, q);
+      for (int32_t p = 0; p < slots; p++) {
+        double parts[2] = {values[p].real() * scale, values[p].imag() * scale};
+        for (uint32_t h = 0; h < 2; h++) {
+          if (std::fabs(parts[h]) >= bound)
+            PALISADE_THROW(math_error,
+                           "EvalBootstrapSetup: a scaled diagonal does not "
+                           "fit into 64 bits. Try decreasing the scaling "
+                           "factor.");
+          int64_t c = std::llround(parts[h]);
+          NativeInteger v =
+              NativeInteger(static_cast<uint64_t>(c < 0 ? -c : c)).Mod(q);
+          vec[p + h * slots] = (c < 0 && v != 0) ? q - v : v;
+        }
+      }
+      NativePoly element(nativeParams[i], Format::COEFFICIENT, true);
+      element.SetValues(std::move(vec), Format::COEFFICIENT);
+      diagonal.SetElementAtIndex(i, std::move(element));
+    }
+    diagonal.SetFormat(Format::EVALUATION);
+    stage.diagonals[a][b] = std::make_shared<DCRTPoly>(std::move(diagonal));
+  }
+
+  return stage;
+}
+
+template <>
+void LPAlgorithmFHECKKS<DCRTPoly>::EvalBootstrapSetup(
+    const shared_ptr<LPCryptoParameters<DCRTPoly>> cryptoParams,
+    const std::vector<uint32_t> &levelBudget) {
+  const auto cryptoParamsCKKS =
+      std::static_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(cryptoParams);
+  const shared_ptr<ParmType> paramsQ = cryptoParamsCKKS->GetElementParams();
+  size_t sizeQ = paramsQ->GetParams().size();
+  uint32_t m = paramsQ->GetCyclotomicOrder();
+  uint32_t slots = m >> 2;
+  uint32_t logSlots = std::log2(slots);
+
+  if (levelBudget.size() != 2)
+    PALISADE_THROW(config_error,
+                   "EvalBootstrapSetup: the level budget should have two "
+                   "entries, for CoeffToSlot and SlotToCoeff.");
+  for (auto budget : levelBudget) {
+    if (budget == 0 || budget > logSlots)
+      PALISADE_THROW(config_error,
+                     "EvalBootstrapSetup: each level budget should be "
+                     "between 1 and log2(N/2) = " +
+                         std::to_string(logSlots) + ".");
+  }
+
+  MODE mode = cryptoParamsCKKS->GetMode();
+  uint32_t depth = GetBootstrapDepth(levelBudget, mode);
+  if (depth >= sizeQ)
+    PALISADE_THROW(config_error,
+                   "EvalBootstrapSetup: bootstrapping consumes " +
+                       std::to_string(depth) +
+                       " levels but the modulus chain only supports " +
+                       std::to_string(sizeQ - 1) + ".");
+
+  m_slots = slots;
+  m_evalModCoefficients = GetEvalModCoefficients(mode);
+  m_doubleAngleIterations = GetDoubleAngleIterations(mode);
+  m_scalingFactorIn = cryptoParamsCKKS->GetScalingFactorOfLevel(sizeQ - 1);
+  uint32_t levelEvalMod = depth - levelBudget[1];
+
+  double K = GetEvalModBound(mode);
+  double q0 = paramsQ->GetParams()[0]->GetModulus().ConvertToDouble();
+
+  // splits the FFT layers into levelBudget[i] groups and multiplies each
+  // group into one matrix, spreading the scalar evenly across the levels
+  auto makeStages = [&](const std::vector<uint32_t> &lengths, bool inverse,
+                        uint32_t budget, double scalar, uint32_t level) {
+    std::vector<BootstrapStage> stages;
+    double factor = std::pow(scalar, 1.0 / budget);
+    size_t layer = 0;
+    for (uint32_t j = 0; j < budget; j++) {
+      size_t count = lengths.size() / budget + (j < lengths.size() % budget);
+      auto matrix = FFTLayerDiagonals(slots, lengths[layer++], inverse);
+      for (size_t i = 1; i < count; i++)
+        matrix = ComposeDiagonals(
+            FFTLayerDiagonals(slots, lengths[layer++], inverse), matrix, slots);
+      for (auto &d : matrix)
+        for (auto &x : d.second) x *= factor;
+      stages.push_back(MakeBootstrapStage(matrix, cryptoParamsCKKS, level + j));
+    }
+    return stages;
+  };
+
+  std::vector<uint32_t> lengths;
+  for (uint32_t len = slots; len >= 2; len >>= 1) lengths.push_back(len);
+
+  // CoeffToSlot: the raised ciphertext is marked with the scaling factor of
+  // level 0, and the slots end up holding the coefficients (low half as the
+  // real parts, high half as the imaginary parts, in bit-reversed order)
+  // divided by 2 K q0.
+  m_coeffToSlot = makeStages(
+      lengths, true, levelBudget[0],
+      cryptoParamsCKKS->GetScalingFactorOfLevel(0) / (2 * K * q0 * slots), 0);
+
+  // SlotToCoeff: EvalMod outputs sin(2 pi m Delta / q0) ~ 2 pi m Delta / q0
+  std::reverse(lengths.begin(), lengths.end());
+  m_slotToCoeff =
+      makeStages(lengths, false, levelBudget[1],
+                 q0 / (2 * M_PI * m_scalingFactorIn), levelEvalMod);
+
+  m_imaginaryUnit = DCRTPoly(paramsQ, Format::COEFFICIENT, true);
+  for (size_t i = 0; i < sizeQ; i++) {
+    const auto &params = paramsQ->GetParams()[i];
+    NativeVector vec(m >> 1, params->GetModulus());
+    vec[slots] = NativeInteger(1);
+    NativePoly element(params, Format::COEFFICIENT, true);
+    element.SetValues(std::move(vec), Format::COEFFICIENT);
+    m_imaginaryUnit.SetElementAtIndex(i, std::move(element));
+  }
+  m_imaginaryUnit.SetFormat(Format::EVALUATION);
+}
+
+template <>
+shared_ptr<std::map<usint, LPEvalKey<DCRTPoly>>>
+LPAlgorithmFHECKKS<DCRTPoly>::EvalBootstrapKeyGen(
+    const LPPrivateKey<DCRTPoly> privateKey) const {
+  if (m_coeffToSlot.empty())
+    PALISADE_THROW(config_error,
+                   "EvalBootstrapSetup must be called before "
+                   "EvalBootstrapKeyGen.");
+
+  uint32_t m = m_slots << 2;
+  std::vector<usint> indices;
+  for (const auto *stages : {&m_coeffToSlot, &m_slotToCoeff}) {
+    for (const auto &stage : *stages) {
+      for (size_t a = 0; a < stage.giantSteps.size(); a++) {
+        bool used = false;
+        for (size_t b = 0; b < stage.babySteps.size(); b++) {
+          if (stage.diagonals[a][b] == nullptr) continue;
+          used = true;
+          if (stage.babySteps[b] != 0)
+            indices.push_back(
+                FindAutomorphismIndex2nComplex(stage.babySteps[b], m));
+        }
+        if (used && stage.giantSteps[a] != 0)
+          indices.push_back(
+              FindAutomorphismIndex2nComplex(stage.giantSteps[a], m));
+      }
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  auto algo = privateKey->GetCryptoContext()->GetEncryptionAlgorithm();
+  auto evalKeys = algo->EvalAutomorphismKeyGen(privateKey, indices);
+
+  // Conjugation is not exposed through EvalAutomorphism because CKKS
+  // plaintexts are real; bootstrapping needs it to split the complex slots
+  // produced by CoeffToSlot, so its key is generated here.
+  LPPrivateKey<DCRTPoly> privateKeyConjugate =
+      std::make_shared<LPPrivateKeyImpl<DCRTPoly>>(
+          privateKey->GetCryptoContext());
+  privateKeyConjugate->SetPrivateElement(
+      privateKey->GetPrivateElement().AutomorphismTransform(m - 1));
+  (*evalKeys)[m - 1] = algo->KeySwitchGen(privateKey, privateKeyConjugate);
+
+  return evalKeys;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmFHECKKS<DCRTPoly>::MultByImaginaryUnit(
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  const std::vector<DCRTPoly> &cv = ciphertext->GetElements();
+
+  DCRTPoly unit(m_imaginaryUnit);
+  unit.DropLastElements(unit.GetNumOfElements() - cv[0].GetNumOfElements());
+
+  std::vector<DCRTPoly> cvMult(cv.size());
+  for (size_t i = 0; i < cv.size(); i++) cvMult[i] = cv[i] * unit;
+
+  Ciphertext<DCRTPoly> result = ciphertext->CloneEmpty();
+  result->SetElements(std::move(cvMult));
+  result->SetDepth(ciphertext->GetDepth());
+  result->SetLevel(ciphertext->GetLevel());
+  result->SetScalingFactor(ciphertext->GetScalingFactor());
+
+  return result;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmFHECKKS<DCRTPoly>::EvalBootstrapStage(
+    ConstCiphertext<DCRTPoly> ciphertext, const BootstrapStage &stage,
+    const std::map<usint, LPEvalKey<DCRTPoly>> &evalKeys) const {
+  if (ciphertext->GetLevel() != stage.level || ciphertext->GetDepth() != 1)
+    PALISADE_THROW(math_error,
+                   "EvalBootstrap: the ciphertext is at level " +
+                       std::to_string(ciphertext->GetLevel()) +
+                       " but the linear transform was encoded for level " +
+                       std::to_string(stage.level) + ".");
+
+  const auto cryptoParams =
+      std::static_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+  auto algo = ciphertext->GetCryptoContext()->GetEncryptionAlgorithm();
+  uint32_t m = m_slots << 2;
+
+  // all baby steps share one hoisted key switching precomputation
+  auto digits = algo->EvalFastRotationPrecompute(ciphertext);
+  std::vector<Ciphertext<DCRTPoly>> babies(stage.babySteps.size());
+  for (size_t b = 0; b < stage.babySteps.size(); b++) {
+    for (size_t a = 0; a < stage.giantSteps.size(); a++) {
+      if (stage.diagonals[a][b] != nullptr) {
+        babies[b] = algo->EvalFastRotation(ciphertext, stage.babySteps[b], m,
+                                           digits);
+        break;
+      }
+    }
+  }
+
+  double scale = cryptoParams->GetScalingFactorOfLevel(stage.level);
+  Ciphertext<DCRTPoly> result;
+  for (size_t a = 0; a < stage.giantSteps.size(); a++) {
+    std::vector<DCRTPoly> sum;
+    for (size_t b = 0; b < stage.babySteps.size(); b++) {
+      const auto &diagonal = stage.diagonals[a][b];
+      if (diagonal == nullptr) continue;
+      const std::vector<DCRTPoly> &cv = babies[b]->GetElements();
+      if (sum.empty()) {
+        sum = {cv[0] * *diagonal, cv[1] * *diagonal};
+      } else {
+        sum[0] += cv[0] * *diagonal;
+        sum[1] += cv[1] * *diagonal;
+      }
+    }
+    if (sum.empty()) continue;
+
+    Ciphertext<DCRTPoly> inner = ciphertext->CloneEmpty();
+    inner->SetElements(std::move(sum));
+    inner->SetDepth(2);
+    inner->SetLevel(stage.level);
+    inner->SetScalingFactor(ciphertext->GetScalingFactor() * scale);
+    algo->ModReduceInternalInPlace(inner);
+
+    if (stage.giantSteps[a] != 0)
+      inner = algo->EvalAutomorphism(
+          inner, FindAutomorphismIndex2nComplex(stage.giantSteps[a], m),
+          evalKeys);
+
+    if (result == nullptr)
+      result = inner;
+    else
+      algo->EvalAddInPlace(result, inner);
+  }
+
+  return result;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmFHECKKS<DCRTPoly>::EvalMod(
+    ConstCiphertext<DCRTPoly> ciphertext) const {
+  auto cc = ciphertext->GetCryptoContext();
+
+  auto result =
+      cc->EvalChebyshevSeries(ciphertext, m_evalModCoefficients, -1, 1);
+
+  // double-angle formula cos(2x) = 2 cos(x)^2 - 1
+  for (uint32_t i = 0; i < m_doubleAngleIterations; i++) {
+    auto square = cc->EvalMult(result, result);
+    cc->ModReduceInPlace(square);
+    result = cc->EvalSub(cc->EvalAdd(square, square), 1.0);
+  }
+
+  return result;
+}
+
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmFHECKKS<DCRTPoly>::EvalBootstrap(
+    ConstCiphertext<DCRTPoly> ciphertext,
+    const std::map<usint, LPEvalKey<DCRTPoly>> &evalKeys) const {
+  if (m_coeffToSlot.empty())
+    PALISADE_THROW(config_error,
+                   "EvalBootstrapSetup must be called before EvalBootstrap.");
+  if (ciphertext->GetElements().size() != 2)
+    PALISADE_THROW(config_error,
+                   "EvalBootstrap expects a relinearized ciphertext.");
+  if (ciphertext->GetElements()[0].GetRingDimension() != (m_slots << 1))
+    PALISADE_THROW(config_error,
+                   "EvalBootstrap: the ring dimension does not match the one "
+                   "used in EvalBootstrapSetup.");
+
+  const auto cryptoParams =
+      std::static_pointer_cast<LPCryptoParametersCKKS<DCRTPoly>>(
+          ciphertext->GetCryptoParameters());
+  auto cc = ciphertext->GetCryptoContext();
+  auto algo = cc->GetEncryptionAlgorithm();
+
+  const shared_ptr<ParmType> paramsQ = cryptoParams->GetElementParams();
+  size_t sizeQ = paramsQ->GetParams().size();
+
+  // ModRaise: reduce to q0, then lift the centered coefficients to Q. The
+  // plaintext polynomial becomes Delta m + q0 I for a small integer
+  // polynomial I.
+  Ciphertext<DCRTPoly> result = algo->Compress(ciphertext, 1);
+  double scalingFactorIn = result->GetScalingFactor();
+  for (auto &c : result->GetElements()) {
+    c.SetFormat(Format::COEFFICIENT);
+    DCRTPoly raised(paramsQ, Format::COEFFICIENT, true);
+    for (size_t i = 0; i < sizeQ; i++) {
+      NativePoly element(c.GetElementAtIndex(0));
+      element.SwitchModulus(paramsQ->GetParams()[i]);
+      raised.SetElementAtIndex(i, std::move(element));
+    }
+    raised.SetFormat(Format::EVALUATION);
+    c = std::move(raised);
+  }
+  result->SetDepth(1);
+  result->SetLevel(0);
+  result->SetScalingFactor(cryptoParams->GetScalingFactorOfLevel(0));
+
+  for (const auto &stage : m_coeffToSlot)
+    result = EvalBootstrapStage(result, stage, evalKeys);
+
+  // separate the real and imaginary parts: (z + conj(z)) and i (conj(z) - z)
+  uint32_t m = m_slots << 2;
+  auto conjugationKey = evalKeys.find(m - 1);
+  if (conjugationKey == evalKeys.end())
+    PALISADE_THROW(config_error,
+                   "EvalBootstrap: the conjugation key was not found; call "
+                   "EvalBootstrapKeyGen first.");
+  auto conj = algo->KeySwitch(conjugationKey->second, result);
+  conj->SetElements({conj->GetElements()[0].AutomorphismTransform(m - 1),
+                     conj->GetElements()[1].AutomorphismTransform(m - 1)});
+  auto real = cc->EvalAdd(result, conj);
+  auto imag = MultByImaginaryUnit(cc->EvalSub(conj, result));
+
+  real = EvalMod(real);
+  imag = EvalMod(imag);
+  result = cc->EvalAdd(real, MultByImaginaryUnit(imag));
+
+  // bring the ciphertext to the level SlotToCoeff was encoded for
+  while (result->GetDepth() > 1) algo->ModReduceInternalInPlace(result);
+  uint32_t levelSlotToCoeff = m_slotToCoeff[0].level;
+  if (result->GetLevel() > levelSlotToCoeff)
+    PALISADE_THROW(math_error,
+                   "EvalBootstrap: EvalMod consumed more levels than "
+                   "expected.");
+  if (result->GetLevel() < levelSlotToCoeff)
+    result = algo->Compress(result, sizeQ - levelSlotToCoeff);
+
+  for (const auto &stage : m_slotToCoeff)
+    result = EvalBootstrapStage(result, stage, evalKeys);
+
+  // SlotToCoeff assumed the scaling factor of the last level
+  result->SetScalingFactor(result->GetScalingFactor() * scalingFactorIn /
+                           m_scalingFactorIn);
+
+  return result;
+}
+
 }  // namespace lbcrypto
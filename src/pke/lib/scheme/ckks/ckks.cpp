@@ -784,15 +784,11 @@ Ciphertext<Element> LPAlgorithmSHECKKS<Element>::EvalAutomorphism(
         not_available_error,
         "automorphism indices higher than 2*n are not allowed " + CALLER_INFO);
 
-  usint n = ciphertext->GetElements()[0].GetRingDimension();
-  std::vector<usint> map(n);
-  PrecomputeAutoMap(n, i, &map);
-
   Ciphertext<Element> permutedCiphertext = this->KeySwitch(fk, ciphertext);
 
   permutedCiphertext->SetElements(
-      {permutedCiphertext->GetElements()[0].AutomorphismTransform(i, map),
-       permutedCiphertext->GetElements()[1].AutomorphismTransform(i, map)});
+      {permutedCiphertext->GetElements()[0].AutomorphismTransform(i),
+       permutedCiphertext->GetElements()[1].AutomorphismTransform(i)});
 
   return permutedCiphertext;
 }
@@ -821,10 +817,8 @@ LPAlgorithmSHECKKS<Element>::EvalAutomorphismKeyGen(
             privateKey->GetCryptoContext()));
     // Element sPermuted = s.AutomorphismTransform(indexList[i]);
     usint index = NativeInteger(indexList[i]).ModInverse(2 * n).ConvertToInt();
-    std::vector<usint> map(n);
-    PrecomputeAutoMap(n, index, &map);
 
-    Element sPermuted = s.AutomorphismTransform(index, map);
+    Element sPermuted = s.AutomorphismTransform(index);
     privateKeyPermuted->SetPrivateElement(sPermuted);
 
     keysVector[i] = this->KeySwitchGen(privateKey, privateKeyPermuted);
@@ -1273,10 +1267,8 @@ LPAlgorithmMultipartyCKKS<Element>::MultiEvalAutomorphismKeyGen(
     for (usint i = 0; i < indexList.size(); i++) {
       usint index =
           NativeInteger(indexList[i]).ModInverse(2 * n).ConvertToInt();
-      std::vector<usint> map(n);
-      PrecomputeAutoMap(n, index, &map);
 
-      Element sPermuted = privateKeyElement.AutomorphismTransform(index, map);
+      Element sPermuted = privateKeyElement.AutomorphismTransform(index);
       tempPrivateKey->SetPrivateElement(sPermuted);
 
       (*evalKeys)[indexList[i]] = MultiKeySwitchGen(
@@ -1441,8 +1433,12 @@ void LPPublicKeyEncryptionSchemeCKKS<Element>::Enable(
             std::make_shared<LPAlgorithmMultipartyCKKS<Element>>();
       break;
     case FHE:
-      PALISADE_THROW(not_implemented_error,
-                     "FHE feature not supported for CKKS scheme");
+      if (this->m_algorithmEncryption == nullptr)
+        this->m_algorithmEncryption =
+            std::make_shared<LPAlgorithmCKKS<Element>>();
+      if (this->m_algorithmFHE == nullptr)
+        this->m_algorithmFHE = std::make_shared<LPAlgorithmFHECKKS<Element>>();
+      break;
     case ADVANCEDSHE:
       PALISADE_THROW(not_implemented_error,
                      "ADVANCEDSHE feature not supported for CKKS scheme");
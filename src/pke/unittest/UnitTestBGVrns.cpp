@@ -1006,6 +1006,188 @@ GENERATE_TEST_CASES_FUNC_GHS(UTBGVrns, UnitTest_EvalFastRotation, ORDER, PTM,
 GENERATE_TEST_CASES_FUNC_HYBRID(UTBGVrns, UnitTest_EvalFastRotation, ORDER, PTM,
                                 SIZEMODULI, NUMPRIME, RELIN, BATCH)
 
+/**
+ * Tests whether EvalAtIndexBatch and KeySwitchDown for BGVrns work properly.
+ */
+template <class Element>
+static void UnitTest_EvalAtIndexBatch(const CryptoContext<Element> cc,
+                                      const string& failmsg) {
+  uint32_t slots = cc->GetRingDimension() >> 1;
+
+  std::vector<int32_t> indices = {0, 1, 3, -2};
+  std::vector<int64_t> input(slots);
+  for (uint32_t i = 0; i < slots; i++) {
+    input[i] = rand() % 10;
+  }
+  std::vector<int64_t> rotated3(slots);
+  std::vector<int64_t> sum(slots);
+  for (uint32_t i = 0; i < slots; i++) {
+    rotated3[i] = input[(i + 3) % slots];
+    for (int32_t index : indices) sum[i] += input[(i + slots + index) % slots];
+  }
+
+  // Generate encryption keys
+  LPKeyPair<Element> kp = cc->KeyGen();
+  // Generate rotation keys
+  cc->EvalAtIndexKeyGen(kp.secretKey, {1, 3, -2});
+
+  Ciphertext<Element> ciphertext =
+      cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(input));
+  Plaintext results;
+
+  auto batch = cc->EvalAtIndexBatch(ciphertext, indices);
+
+  cc->Decrypt(kp.secretKey, cc->KeySwitchDown(batch[2]), &results);
+  results->SetLength(slots);
+  checkEquality(rotated3, results->GetPackedValue(),
+                failmsg + " EvalAtIndexBatch(3) fails");
+
+  // the rotations are summed in the extended basis
+  Ciphertext<Element> cSum = batch[0];
+  for (size_t j = 1; j < batch.size(); j++) cc->EvalAddInPlace(cSum, batch[j]);
+  cc->Decrypt(kp.secretKey, cc->KeySwitchDown(cSum), &results);
+  results->SetLength(slots);
+  checkEquality(sum, results->GetPackedValue(),
+                failmsg + " sum of EvalAtIndexBatch fails");
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTBGVrns, UnitTest_EvalAtIndexBatch, ORDER, PTM,
+                            SIZEMODULI, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTBGVrns, UnitTest_EvalAtIndexBatch, ORDER, PTM,
+                             SIZEMODULI, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTBGVrns, UnitTest_EvalAtIndexBatch, ORDER,
+                                PTM, SIZEMODULI, NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests whether EvalSum and EvalInnerProduct with radix 2, 4 and 8 work
+ * properly for BGVrns.
+ */
+template <class Element>
+static void UnitTest_EvalSumRadix(const CryptoContext<Element> cc,
+                                  const string& failmsg) {
+  uint32_t slots = cc->GetRingDimension() >> 1;
+
+  // both rows of slots are filled; each row is summed separately
+  std::vector<int64_t> input(slots << 1);
+  for (uint32_t i = 0; i < (slots << 1); i++) {
+    input[i] = rand() % 10;
+  }
+
+  // Generate encryption keys
+  LPKeyPair<Element> kp = cc->KeyGen();
+  // Generate multiplication keys
+  cc->EvalMultKeyGen(kp.secretKey);
+
+  Ciphertext<Element> ciphertext =
+      cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(input));
+  Plaintext results;
+
+  for (usint radix : {2, 4, 8}) {
+    cc->EvalSumRadixKeyGen(kp.secretKey, radix);
+
+    // the smaller batch ends with a partial step for the larger radices
+    for (usint batchSize : {BATCH, BATCH / 2}) {
+      std::vector<int64_t> sum(slots << 1);
+      std::vector<int64_t> innerProduct(slots << 1);
+      for (uint32_t row = 0; row < (slots << 1); row += slots) {
+        for (uint32_t i = 0; i < slots; i++) {
+          for (uint32_t j = 0; j < batchSize; j++) {
+            int64_t value = input[row + (i + j) % slots];
+            sum[row + i] += value;
+            innerProduct[row + i] += value * value;
+          }
+        }
+      }
+
+      string radixmsg = " radix " + std::to_string(radix) + " batch " +
+                        std::to_string(batchSize);
+
+      cc->Decrypt(kp.secretKey, cc->EvalSum(ciphertext, batchSize, radix),
+                  &results);
+      results->SetLength(slots << 1);
+      checkEquality(sum, results->GetPackedValue(),
+                    failmsg + " EvalSum" + radixmsg + " fails");
+
+      cc->Decrypt(kp.secretKey,
+                  cc->EvalInnerProduct(ciphertext, ciphertext, batchSize,
+                                       radix),
+                  &results);
+      results->SetLength(slots << 1);
+      checkEquality(innerProduct, results->GetPackedValue(),
+                    failmsg + " EvalInnerProduct" + radixmsg + " fails");
+    }
+  }
+
+  // batch sizes that are zero or not a power of two are rejected
+  for (usint batchSize : {0u, 5u}) {
+    EXPECT_THROW(cc->EvalSum(ciphertext, batchSize, 4), config_error)
+        << failmsg << " EvalSum accepts batch size " << batchSize;
+  }
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTBGVrns, UnitTest_EvalSumRadix, ORDER, PTM,
+                            SIZEMODULI, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTBGVrns, UnitTest_EvalSumRadix, ORDER, PTM,
+                             SIZEMODULI, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTBGVrns, UnitTest_EvalSumRadix, ORDER, PTM,
+                                SIZEMODULI, NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests whether EvalLinearTransform for BGVrns works properly.
+ */
+template <class Element>
+static void UnitTest_EvalLinearTransform(const CryptoContext<Element> cc,
+                                         const string& failmsg) {
+  uint32_t slots = cc->GetRingDimension() >> 1;
+
+  // both rows of slots are filled; the matrix acts on each row
+  std::vector<int64_t> input(slots << 1);
+  for (uint32_t i = 0; i < (slots << 1); i++) {
+    input[i] = rand() % 10;
+  }
+
+  // A banded matrix with one far diagonal, so that both positive and
+  // negative baby and giant steps are needed.
+  std::vector<uint32_t> offsets = {0, 1, 2, 5, slots / 4, slots - 3, slots - 1};
+  std::vector<Plaintext> diagonals(slots);
+  std::vector<int64_t> expected(slots << 1);
+  for (uint32_t k : offsets) {
+    std::vector<int64_t> diagonal(slots << 1);
+    for (uint32_t row = 0; row < (slots << 1); row += slots) {
+      for (uint32_t i = 0; i < slots; i++) {
+        diagonal[row + i] = rand() % 7 - 3;
+        expected[row + i] +=
+            diagonal[row + i] * input[row + (i + k) % slots];
+      }
+    }
+    diagonals[k] = cc->MakePackedPlaintext(diagonal);
+  }
+
+  // Generate encryption keys
+  LPKeyPair<Element> kp = cc->KeyGen();
+
+  Ciphertext<Element> ciphertext =
+      cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(input));
+
+  // The ciphertext is level-reduced to level 1 by EvalLinearTransform.
+  auto transform = cc->EvalLinearTransformPrecompute(diagonals, 1);
+  cc->EvalAtIndexKeyGen(kp.secretKey, transform->GetRotationIndices());
+
+  Ciphertext<Element> cResult = cc->EvalLinearTransform(ciphertext, transform);
+  Plaintext results;
+  cc->Decrypt(kp.secretKey, cResult, &results);
+  results->SetLength(slots << 1);
+  checkEquality(expected, results->GetPackedValue(),
+                failmsg + " EvalLinearTransform fails");
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTBGVrns, UnitTest_EvalLinearTransform, ORDER, PTM,
+                            SIZEMODULI, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTBGVrns, UnitTest_EvalLinearTransform, ORDER,
+                             PTM, SIZEMODULI, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTBGVrns, UnitTest_EvalLinearTransform, ORDER,
+                                PTM, SIZEMODULI, NUMPRIME, RELIN, BATCH)
+
 /**
  * Tests whether metadata is carried over for several operations in BGVrns
  */
@@ -1115,6 +1115,200 @@ GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalFastRotation, ORDER, SCALE,
 GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalFastRotation, ORDER, SCALE,
                                 NUMPRIME, RELIN, BATCH)
 
+/**
+ * Tests whether EvalAtIndexBatch and KeySwitchDown for CKKS work properly.
+ */
+template <class Element>
+static void UnitTest_EvalAtIndexBatch(const CryptoContext<Element> cc,
+                                      const string& failmsg) {
+  uint32_t slots = cc->GetRingDimension() >> 1;
+
+  double eps = 0.0001;
+
+  std::vector<int32_t> indices = {0, 1, 3, -2};
+  std::vector<std::complex<double>> input(slots);
+  for (uint32_t i = 0; i < slots; i++) {
+    input[i] = rand() % 10;
+  }
+  std::vector<std::complex<double>> rotated3(slots);
+  std::vector<std::complex<double>> sum(slots);
+  for (uint32_t i = 0; i < slots; i++) {
+    rotated3[i] = input[(i + 3) % slots];
+    for (int32_t index : indices) sum[i] += input[(i + slots + index) % slots];
+  }
+
+  // Generate encryption keys
+  LPKeyPair<Element> kp = cc->KeyGen();
+  // Generate rotation keys
+  cc->EvalAtIndexKeyGen(kp.secretKey, {1, 3, -2});
+
+  Ciphertext<Element> ciphertext =
+      cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(input));
+  Plaintext results;
+
+  auto batch = cc->EvalAtIndexBatch(ciphertext, indices);
+
+  cc->Decrypt(kp.secretKey, cc->KeySwitchDown(batch[2]), &results);
+  results->SetLength(slots);
+  auto values = results->GetCKKSPackedValue();
+  checkApproximateEquality(rotated3, values, slots, eps,
+                           failmsg + " EvalAtIndexBatch(3) fails");
+
+  // the rotations are summed in the extended basis
+  Ciphertext<Element> cSum = batch[0];
+  for (size_t j = 1; j < batch.size(); j++) cc->EvalAddInPlace(cSum, batch[j]);
+  cc->Decrypt(kp.secretKey, cc->KeySwitchDown(cSum), &results);
+  results->SetLength(slots);
+  values = results->GetCKKSPackedValue();
+  checkApproximateEquality(sum, values, slots, eps,
+                           failmsg + " sum of EvalAtIndexBatch fails");
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_EvalAtIndexBatch, ORDER, SCALE,
+                            NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalAtIndexBatch, ORDER, SCALE,
+                             NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalAtIndexBatch, ORDER, SCALE,
+                                NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests whether EvalSum and EvalInnerProduct with radix 2, 4 and 8 work
+ * properly for CKKS.
+ */
+template <class Element>
+static void UnitTest_EvalSumRadix(const CryptoContext<Element> cc,
+                                  const string& failmsg) {
+  uint32_t slots = cc->GetRingDimension() >> 1;
+
+  double eps = 0.001;
+
+  std::vector<std::complex<double>> input(slots);
+  for (uint32_t i = 0; i < slots; i++) {
+    input[i] = rand() % 10;
+  }
+
+  // Generate encryption keys
+  LPKeyPair<Element> kp = cc->KeyGen();
+  // Generate multiplication keys
+  cc->EvalMultKeyGen(kp.secretKey);
+
+  Ciphertext<Element> ciphertext =
+      cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(input));
+  Plaintext results;
+
+  for (usint radix : {2, 4, 8}) {
+    cc->EvalSumRadixKeyGen(kp.secretKey, radix);
+
+    // the smaller batch ends with a partial step for the larger radices
+    for (usint batchSize : {BATCH, BATCH / 2}) {
+      std::vector<std::complex<double>> sum(slots);
+      std::vector<std::complex<double>> innerProduct(slots);
+      for (uint32_t i = 0; i < slots; i++) {
+        for (uint32_t j = 0; j < batchSize; j++) {
+          sum[i] += input[(i + j) % slots];
+          innerProduct[i] += input[(i + j) % slots] * input[(i + j) % slots];
+        }
+      }
+
+      string radixmsg = " radix " + std::to_string(radix) + " batch " +
+                        std::to_string(batchSize);
+
+      cc->Decrypt(kp.secretKey, cc->EvalSum(ciphertext, batchSize, radix),
+                  &results);
+      results->SetLength(slots);
+      auto values = results->GetCKKSPackedValue();
+      checkApproximateEquality(sum, values, slots, eps,
+                               failmsg + " EvalSum" + radixmsg + " fails");
+
+      cc->Decrypt(kp.secretKey,
+                  cc->EvalInnerProduct(ciphertext, ciphertext, batchSize,
+                                       radix),
+                  &results);
+      results->SetLength(slots);
+      values = results->GetCKKSPackedValue();
+      checkApproximateEquality(
+          innerProduct, values, slots, eps,
+          failmsg + " EvalInnerProduct" + radixmsg + " fails");
+    }
+  }
+
+  // batch sizes that are zero or not a power of two are rejected
+  for (usint batchSize : {0u, 5u}) {
+    EXPECT_THROW(cc->EvalSum(ciphertext, batchSize, 4), config_error)
+        << failmsg << " EvalSum accepts batch size " << batchSize;
+  }
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_EvalSumRadix, ORDER, SCALE,
+                            NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalSumRadix, ORDER, SCALE,
+                             NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalSumRadix, ORDER, SCALE,
+                                NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests whether EvalLinearTransform for CKKS works properly.
+ */
+template <class Element>
+static void UnitTest_EvalLinearTransform(const CryptoContext<Element> cc,
+                                         const string& failmsg) {
+  uint32_t slots = cc->GetRingDimension() >> 1;
+
+  double eps = 0.0001;
+
+  std::vector<std::complex<double>> input(slots);
+  for (uint32_t i = 0; i < slots; i++) {
+    input[i] = rand() % 10;
+  }
+
+  // A banded matrix with one far diagonal, so that both positive and
+  // negative baby and giant steps are needed.
+  std::vector<uint32_t> offsets = {0, 1, 2, 5, slots / 4, slots - 3, slots - 1};
+  std::vector<Plaintext> diagonals(slots);
+  std::vector<std::complex<double>> expected(slots);
+  for (uint32_t k : offsets) {
+    std::vector<std::complex<double>> diagonal(slots);
+    for (uint32_t i = 0; i < slots; i++) {
+      diagonal[i] = (rand() % 7 - 3) / 4.0;
+      expected[i] += diagonal[i] * input[(i + k) % slots];
+    }
+    diagonals[k] = cc->MakeCKKSPackedPlaintext(diagonal);
+  }
+
+  std::vector<std::complex<double>> vOnes(slots, 1);
+
+  // Generate encryption keys
+  LPKeyPair<Element> kp = cc->KeyGen();
+  // Generate multiplication keys
+  cc->EvalMultKeyGen(kp.secretKey);
+
+  Ciphertext<Element> ciphertext =
+      cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(input));
+  Ciphertext<Element> cOnes =
+      cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(vOnes));
+
+  // The product is rescaled to level 1 by EvalLinearTransform.
+  ciphertext *= cOnes;
+
+  auto transform = cc->EvalLinearTransformPrecompute(diagonals, 1);
+  cc->EvalAtIndexKeyGen(kp.secretKey, transform->GetRotationIndices());
+
+  Ciphertext<Element> cResult = cc->EvalLinearTransform(ciphertext, transform);
+  Plaintext results;
+  cc->Decrypt(kp.secretKey, cResult, &results);
+  results->SetLength(slots);
+  auto values = results->GetCKKSPackedValue();
+  checkApproximateEquality(expected, values, slots, eps,
+                           failmsg + " EvalLinearTransform fails");
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_EvalLinearTransform, ORDER, SCALE,
+                            NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalLinearTransform, ORDER,
+                             SCALE, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalLinearTransform, ORDER,
+                                SCALE, NUMPRIME, RELIN, BATCH)
+
 /**
  * Tests whether EvalAtIndex for CKKS works properly.
  */
@@ -1570,6 +1764,150 @@ GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalPoly, 1024, 35, 6, 20, BATCH)
 GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalPoly, 1024, 35, 6, 20,
                                 BATCH)
 
+/**
+ * Tests EvalChebyshevSeries and the Chebyshev approximations of the
+ * logistic function, exp and the inverse.
+ */
+template <class Element>
+static void UnitTest_EvalChebyshevSeries(const CryptoContext<Element> cc,
+                                         const string& failmsg) {
+  double eps = 0.001;
+
+  LPKeyPair<Element> kp = cc->KeyGen();
+  cc->EvalMultKeyGen(kp.secretKey);
+
+  auto check = [&](const std::vector<double>& input,
+                   const std::function<double(double)>& func,
+                   const std::function<Ciphertext<Element>(
+                       ConstCiphertext<Element>)>& eval,
+                   const string& msg) {
+    std::vector<std::complex<double>> inputComplex(input.begin(),
+                                                   input.end());
+    std::vector<std::complex<double>> expected;
+    for (double x : input) expected.push_back(func(x));
+
+    auto ciphertext =
+        cc->Encrypt(kp.publicKey, cc->MakeCKKSPackedPlaintext(inputComplex));
+    Plaintext result;
+    cc->Decrypt(kp.secretKey, eval(ciphertext), &result);
+    result->SetLength(input.size());
+    auto values = result->GetCKKSPackedValue();
+    checkApproximateEquality(expected, values, input.size(), eps,
+                             failmsg + msg);
+  };
+
+  // sum_j (-1)^j / (j + 1) T_j(x) of degree 31 on [-1, 1]
+  std::vector<double> coefficients(32);
+  for (size_t j = 0; j < coefficients.size(); j++)
+    coefficients[j] = ((j % 2) ? -1.0 : 1.0) / (j + 1);
+  auto series = [&coefficients](double x) {
+    double tPrev = 1, t = x;
+    double sum = coefficients[0] + coefficients[1] * x;
+    for (size_t j = 2; j < coefficients.size(); j++) {
+      double tNext = 2 * x * t - tPrev;
+      tPrev = t;
+      t = tNext;
+      sum += coefficients[j] * t;
+    }
+    return sum;
+  };
+  check({-0.9, -0.3, 0.1, 0.5, 0.95}, series,
+        [&](ConstCiphertext<Element> ct) {
+          return cc->EvalChebyshevSeries(ct, coefficients, -1, 1);
+        },
+        " EvalChebyshevSeries on [-1, 1] failed");
+
+  check({-3.9, -2, -0.5, 0.7, 3.5},
+        [](double x) { return 1 / (1 + std::exp(-x)); },
+        [&](ConstCiphertext<Element> ct) {
+          return cc->EvalLogistic(ct, -4, 4, 15);
+        },
+        " EvalLogistic failed");
+
+  check({-1, -0.4, 0, 0.6, 1}, [](double x) { return std::exp(x); },
+        [&](ConstCiphertext<Element> ct) {
+          return cc->EvalExp(ct, -1, 1, 10);
+        },
+        " EvalExp failed");
+
+  check({1, 1.5, 2.2, 3, 4}, [](double x) { return 1 / x; },
+        [&](ConstCiphertext<Element> ct) {
+          return cc->EvalDivide(ct, 1, 4, 20);
+        },
+        " EvalDivide failed");
+}
+
+GENERATE_TEST_CASES_FUNC_BV(UTCKKS, UnitTest_EvalChebyshevSeries, ORDER, SCALE,
+                            NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_GHS(UTCKKS, UnitTest_EvalChebyshevSeries, ORDER,
+                             SCALE, NUMPRIME, RELIN, BATCH)
+GENERATE_TEST_CASES_FUNC_HYBRID(UTCKKS, UnitTest_EvalChebyshevSeries, ORDER,
+                                SCALE, NUMPRIME, RELIN, BATCH)
+
+/**
+ * Tests CKKS bootstrapping: a ciphertext reduced to a single tower is
+ * refreshed, checked against the input and multiplied once more.
+ */
+static void UnitTest_Bootstrap(RescalingTechnique rsTech, double eps,
+                               const string& failmsg) {
+  std::vector<uint32_t> levelBudget({2, 2});
+  uint32_t levelsAfterBootstrap = 2;
+  auto cc = CryptoContextFactory<DCRTPoly>::genCryptoContextCKKSWithBootstrap(
+      levelsAfterBootstrap, SCALE, BATCH, HEStd_NotSet, ORDER / 2, levelBudget,
+      rsTech);
+  cc->Enable(ENCRYPTION);
+  cc->Enable(SHE);
+  cc->Enable(LEVELEDSHE);
+  cc->Enable(FHE);
+
+  cc->EvalBootstrapSetup(levelBudget);
+  auto keyPair = cc->KeyGen();
+  cc->EvalMultKeyGen(keyPair.secretKey);
+  cc->EvalBootstrapKeyGen(keyPair.secretKey);
+
+  // bootstrapping refreshes all N/2 slots
+  size_t slots = cc->GetRingDimension() / 2;
+  std::vector<std::complex<double>> input(slots);
+  std::vector<std::complex<double>> squares(slots);
+  for (size_t i = 0; i < slots; i++) {
+    input[i] = 0.9 * std::sin(0.37 * i);
+    squares[i] = input[i] * input[i];
+  }
+
+  auto ciphertext =
+      cc->Encrypt(keyPair.publicKey, cc->MakeCKKSPackedPlaintext(input));
+  ciphertext = cc->Compress(ciphertext, 1);
+
+  auto refreshed = cc->EvalBootstrap(ciphertext);
+  EXPECT_EQ(LPAlgorithmFHECKKS<DCRTPoly>::GetBootstrapDepth(levelBudget,
+                                                            SPARSE),
+            refreshed->GetLevel())
+      << failmsg << " EvalBootstrap returned an unexpected level";
+
+  Plaintext result;
+  cc->Decrypt(keyPair.secretKey, refreshed, &result);
+  result->SetLength(slots);
+  auto values = result->GetCKKSPackedValue();
+  checkApproximateEquality(values, input, slots, eps,
+                           failmsg + " EvalBootstrap failed");
+
+  cc->Decrypt(keyPair.secretKey, cc->EvalMult(refreshed, refreshed), &result);
+  result->SetLength(slots);
+  values = result->GetCKKSPackedValue();
+  checkApproximateEquality(values, squares, slots, eps,
+                           failmsg + " EvalMult after EvalBootstrap failed");
+}
+
+#if NATIVEINT != 128
+TEST_F(UTCKKS, UnitTest_Bootstrap_EXACTRESCALE) {
+  UnitTest_Bootstrap(EXACTRESCALE, 0.001, "CKKS EXACTRESCALE");
+}
+#endif
+
+TEST_F(UTCKKS, UnitTest_Bootstrap_APPROXAUTO) {
+  UnitTest_Bootstrap(APPROXAUTO, 0.01, "CKKS APPROXAUTO");
+}
+
 /**
  * Tests whether metadata is carried over for several operations in CKKS
  */